@@ -0,0 +1,141 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2014, Image Engine Design Inc. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+//     * Neither the name of Image Engine Design nor the names of any
+//       other contributors to this software may be used to endorse or
+//       promote products derived from this software without specific prior
+//       written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#ifndef IECORE_BLOBSTORE_H
+#define IECORE_BLOBSTORE_H
+
+#include <string>
+#include <vector>
+
+#include "tbb/spin_rw_mutex.h"
+
+#include "IECore/RefCounted.h"
+#include "IECore/MurmurHash.h"
+
+namespace IECore
+{
+
+IE_CORE_FORWARDDECLARE( BlobStore );
+
+/// A content-addressed store of data blocks, which can be shared by many files so that
+/// data common to all of them (static geometry repeated across the caches of a shot,
+/// for instance) is only stored once. See StreamIndexedIO::setBlobStore().
+///
+/// The store is a directory holding a single pack file, which is memory mapped by
+/// readers, plus any number of loose blobs written since the pack was last built.
+/// New blobs are always written as loose files, renamed into place once complete,
+/// so any number of processes may write to the same store concurrently. The repack()
+/// method moves the loose blobs into the pack, and should be run periodically (see
+/// BlobStoreRepackOp).
+///
+/// \threading All methods are thread safe.
+/// \ingroup ioGroup
+class BlobStore : public RefCounted
+{
+
+	public :
+
+		IE_CORE_DECLAREMEMBERPTR( BlobStore );
+
+		/// Returns the store located in the given directory. Stores are shared
+		/// by all the files referring to them within the process, so that the
+		/// pack is only mapped once, and are released as soon as nothing refers
+		/// to them any more. The directory is created by the first call to write(),
+		/// if it doesn't exist yet.
+		static BlobStorePtr open( const std::string &directory );
+
+		virtual ~BlobStore();
+
+		/// Returns the absolute path of the directory holding the store.
+		const std::string &directory() const;
+
+		/// Stores the given data, unless identical data is already stored,
+		/// and returns the hash by which it can be retrieved.
+		MurmurHash write( const char *data, size_t size );
+
+		/// Returns true if a blob with the given hash is stored.
+		bool contains( const MurmurHash &hash ) const;
+		/// Returns the size in bytes of the blob, throwing if it isn't stored.
+		size_t size( const MurmurHash &hash ) const;
+		/// Reads the blob into the buffer, throwing if bufferSize isn't size( hash ).
+		void read( const MurmurHash &hash, char *buffer, size_t bufferSize ) const;
+
+		/// Returns a pointer to the blob within the memory mapped pack, or 0 if the blob
+		/// is still loose (or the pack couldn't be mapped), in which case read() must be
+		/// used instead. The owner is set to an object which keeps the mapping alive, and
+		/// must be held for as long as the pointer is used.
+		const char *mappedData( const MurmurHash &hash, ConstRefCountedPtr &owner ) const;
+
+		/// Moves all loose blobs into the pack, returning how many were moved. Files
+		/// referencing the store are unaffected, and readers in other processes pick up
+		/// the new pack automatically. Repacking must not run concurrently with another
+		/// repack of the same store, but writes may continue while it runs, in which case
+		/// the blobs they create are simply left loose.
+		size_t repack();
+
+		/// Returns the number of blobs in the pack and the number still loose.
+		void stats( size_t &numPacked, size_t &numLoose ) const;
+
+	private :
+
+		BlobStore( const std::string &directory );
+
+		class Pack;
+		IE_CORE_DECLAREPTR( Pack );
+
+		std::string loosePath( const MurmurHash &hash ) const;
+		std::string packPath() const;
+
+		// Returns the current pack, reloading it first if it has been replaced
+		// on disk (by a repack in this or another process) and reload is true.
+		ConstPackPtr pack( bool reload = false ) const;
+		// Returns the pack holding the blob (reloading if it isn't found in the current one)
+		// and the index of the blob within it, or 0 if the blob is loose or missing.
+		ConstPackPtr find( const MurmurHash &hash, size_t &index ) const;
+
+		std::string m_directory;
+
+		typedef tbb::spin_rw_mutex Mutex;
+		mutable Mutex m_mutex;
+		mutable ConstPackPtr m_pack;
+
+};
+
+/// Overrides the release of the reference count for BlobStorePtr, so that
+/// open() never returns a store which is being destroyed.
+void intrusive_ptr_release( const BlobStore *store );
+
+} // namespace IECore
+
+#endif // IECORE_BLOBSTORE_H
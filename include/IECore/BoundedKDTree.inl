@@ -35,6 +35,10 @@
 #include <algorithm>
 #include <cassert>
 
+#include "boost/bind.hpp"
+
+#include "tbb/parallel_invoke.h"
+
 #include "IECore/VectorTraits.h"
 #include "IECore/VectorOps.h"
 #include "IECore/BoxOps.h"
@@ -169,50 +173,33 @@ unsigned char BoundedKDTree<BoundIterator>::majorAxis( PermutationConstIterator
 }
 
 template<class BoundIterator>
-void BoundedKDTree<BoundIterator>::bound( NodeIndex nodeIndex  )
+typename BoundedKDTree<BoundIterator>::NodeIndex BoundedKDTree<BoundIterator>::lastNodeIndex( size_t numBounds ) const
 {
-	assert( nodeIndex < m_nodes.size() );
-
-	Node &node = m_nodes[nodeIndex];
-
-	assert( BoxTraits<Bound>::isEmpty( node.bound() ) );
-
-	if( node.isLeaf() )
+	// build() always gives the high child at least as many bounds as the low
+	// child, so the deepest and rightmost node is found by following the
+	// high children down from the root.
+	NodeIndex result = rootIndex();
+	while( numBounds > (size_t)m_maxLeafSize )
 	{
-		BoundIterator *permLast = node.permLast();
-		for( BoundIterator *perm = node.permFirst(); perm!=permLast; perm++ )
-		{
-			boxExtend( node.bound(), **perm );
-		}
-	}
-	else
-	{
-		assert( node.isBranch() );
-
-		assert( lowChildIndex( nodeIndex ) < m_nodes.size() );
-		assert( highChildIndex( nodeIndex ) < m_nodes.size() );
-
-		bound( lowChildIndex( nodeIndex ) );
-		bound( highChildIndex( nodeIndex ) );
-		boxExtend( node.bound(), m_nodes[lowChildIndex( nodeIndex )].bound() );
-		boxExtend( node.bound(), m_nodes[highChildIndex( nodeIndex )].bound() );
+		numBounds -= numBounds / 2;
+		result = highChildIndex( result );
 	}
+	return result;
 }
 
-
 template<class BoundIterator>
 void BoundedKDTree<BoundIterator>::build( NodeIndex nodeIndex, PermutationIterator permFirst, PermutationIterator permLast )
 {
-	// make room for the new node
-	if( nodeIndex>=m_nodes.size() )
-	{
-		m_nodes.resize( nodeIndex+1 );
-	}
+	// subtrees with fewer bounds than this aren't worth the overhead of
+	// building in parallel.
+	const typename Permutation::difference_type parallelThreshold = 10000;
 
 	assert( nodeIndex < m_nodes.size() );
 
 	Node &node = m_nodes[nodeIndex];
 
+	assert( BoxTraits<Bound>::isEmpty( node.bound() ) );
+
 	if( permLast - permFirst > m_maxLeafSize )
 	{
 		unsigned int cutAxis = majorAxis( permFirst, permLast );
@@ -222,13 +209,32 @@ void BoundedKDTree<BoundIterator>::build( NodeIndex nodeIndex, PermutationIterat
 		// insert node
 		node.makeBranch( cutAxis );
 
-		build( lowChildIndex( nodeIndex ), permFirst, permMid );
-		build( highChildIndex( nodeIndex ), permMid, permLast );
+		// the children operate on disjoint ranges of the permutation and
+		// on disjoint nodes, so they can safely be built concurrently.
+		if( permLast - permFirst > parallelThreshold )
+		{
+			tbb::parallel_invoke(
+				boost::bind( &BoundedKDTree<BoundIterator>::build, this, lowChildIndex( nodeIndex ), permFirst, permMid ),
+				boost::bind( &BoundedKDTree<BoundIterator>::build, this, highChildIndex( nodeIndex ), permMid, permLast )
+			);
+		}
+		else
+		{
+			build( lowChildIndex( nodeIndex ), permFirst, permMid );
+			build( highChildIndex( nodeIndex ), permMid, permLast );
+		}
+
+		boxExtend( node.bound(), m_nodes[lowChildIndex( nodeIndex )].bound() );
+		boxExtend( node.bound(), m_nodes[highChildIndex( nodeIndex )].bound() );
 	}
 	else
 	{
 		// leaf node
 		node.makeLeaf( permFirst, permLast );
+		for( PermutationIterator it = permFirst; it!=permLast; it++ )
+		{
+			boxExtend( node.bound(), **it );
+		}
 	}
 }
 
@@ -256,9 +262,12 @@ void BoundedKDTree<BoundIterator>::init( BoundIterator first, BoundIterator last
 		m_perm[i++] = it;
 	}
 
-	/// \todo Can we reserve() enough space for m_nodes before doing this?
+	// allocate all the nodes up front so that build() never needs to
+	// reallocate, and can therefore fill in subtrees in parallel.
+	m_nodes.clear();
+	m_nodes.resize( lastNodeIndex( m_perm.size() ) + 1 );
+
 	build( rootIndex(), m_perm.begin(), m_perm.end() );
-	bound( rootIndex() );
 }
 
 template<class BoundIterator>
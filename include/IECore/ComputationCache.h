@@ -106,7 +106,7 @@ class ComputationCache : public RefCounted
 		ComputeFn m_computeFn;
 		HashFn m_hashFn;
 
-		typedef IECore::LRUCache<MurmurHash, MurmurHash> Cache;
+		typedef IECore::LRUCache<MurmurHash, MurmurHash, IECore::LRUCachePolicy::SecondChance> Cache;
 		Cache m_cache;
 
 		ObjectPoolPtr m_objectPool;
@@ -0,0 +1,59 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2014, Image Engine Design Inc. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+//     * Neither the name of Image Engine Design nor the names of any
+//       other contributors to this software may be used to endorse or
+//       promote products derived from this software without specific prior
+//       written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+
+//! \file DecimateAlgo.h
+/// Defines algorithms for producing reduced versions of primitives.
+/// \ingroup geometryProcessingGroup
+
+#ifndef IECORE_DECIMATEALGO_H
+#define IECORE_DECIMATEALGO_H
+
+#include "IECore/Primitive.h"
+
+namespace IECore
+{
+
+/// Reduces a MeshPrimitive or PointsPrimitive to at most targetVertices vertices by
+/// clustering the vertices on a uniform grid, using the finest grid which meets the
+/// budget, and replacing each cluster with the average of its positions. Mesh faces
+/// which collapse to fewer than three distinct vertices are removed. Only the topology
+/// and the "P" primitive variable are retained, so the result is suitable for use as
+/// a lightweight proxy. On return, error holds the greatest distance between an original
+/// vertex and the vertex which replaced it. Returns 0 if the primitive is of any other
+/// type, or doesn't have vertex positions.
+PrimitivePtr clusterDecimate( const Primitive *primitive, size_t targetVertices, float &error );
+
+} // namespace IECore
+
+#endif // IECORE_DECIMATEALGO_H
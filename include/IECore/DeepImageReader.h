@@ -39,6 +39,7 @@
 #include "OpenEXR/ImathMatrix.h"
 
 #include "IECore/DeepPixel.h"
+#include "IECore/DeepTile.h"
 #include "IECore/Reader.h"
 
 namespace IECore
@@ -84,6 +85,12 @@ class DeepImageReader : public Reader
 		/// It is up to the derived classes to account for that fact if necessary.
 		DeepPixelPtr readPixel( int x, int y );
 
+		/// Reads all the pixels within the specified window, which must be contained
+		/// by the dataWindow. This is considerably more efficient than reading the
+		/// pixels individually. Samples are returned in the order they are stored in
+		/// the file, so DeepTile::sortSamples() should be called before compositing.
+		DeepTilePtr readTile( const Imath::Box2i &window );
+
 	protected :
 
 		/// Returns an ImagePrimitive, having composited all the DeepPixels into flat pixels
@@ -97,6 +104,13 @@ class DeepImageReader : public Reader
 		/// for that fact if necessary.
 		virtual DeepPixelPtr doReadPixel( int x, int y ) = 0;
 
+		/// Reads the pixels within the specified window. This is called by the public
+		/// readTile() method, and it is guaranteed that the window will be within the
+		/// dataWindow. The default implementation reads each pixel in turn using
+		/// doReadPixel() - derived classes are encouraged to override it with a more
+		/// efficient implementation.
+		virtual DeepTilePtr doReadTile( const Imath::Box2i &window );
+
 };
 
 IE_CORE_DECLAREPTR( DeepImageReader );
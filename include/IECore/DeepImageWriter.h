@@ -36,6 +36,7 @@
 #define IECORE_DEEPIMAGEWRITER_H
 
 #include "IECore/DeepPixel.h"
+#include "IECore/DeepTile.h"
 #include "IECore/Parameterised.h"
 #include "IECore/SimpleTypedParameter.h"
 #include "IECore/VectorTypedParameter.h"
@@ -95,6 +96,12 @@ class DeepImageWriter : public Parameterised
 		/// the derived classes to account for that fact if necessary.
 		void writePixel( int x, int y, const DeepPixel *pixel );
 
+		/// Writes all the pixels in a DeepTile to the file. The tile must have the same
+		/// number of channels as channelNamesParameter(), and as with writePixel(), the
+		/// coordinates of the tile window are relative to the upper left corner of the
+		/// displayWindow. Should throw if the data could not be written.
+		void writeTile( const DeepTile *tile );
+
 		/// Fills the passed vector with all the extensions for which a DeepImageWriter is
 		/// available. Extensions are of the form "exr" - ie without a preceding '.'.
 		static void supportedExtensions( std::vector<std::string> &extensions );
@@ -115,6 +122,13 @@ class DeepImageWriter : public Parameterised
 		/// the upper left corner of the displayWindow. It is up to the derived classes to
 		/// account for that fact if necessary.
 		virtual void doWritePixel( int x, int y, const DeepPixel *pixel ) = 0;
+
+		/// Writes all the pixels in a DeepTile. This is called by the public writeTile()
+		/// method, and it is guaranteed that the tile is a valid pointer with the correct
+		/// number of channels. The default implementation calls doWritePixel() for each
+		/// pixel with samples - derived classes are encouraged to override it with a more
+		/// efficient implementation.
+		virtual void doWriteTile( const DeepTile *tile );
 		
 		/// Definition of a function which can create a DeepImageWriter when given a fileName.
 		typedef DeepImageWriterPtr (*CreatorFn)( const std::string &fileName );
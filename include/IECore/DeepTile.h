@@ -0,0 +1,153 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2014, Image Engine Design Inc. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+//     * Neither the name of Image Engine Design nor the names of any
+//       other contributors to this software may be used to endorse or
+//       promote products derived from this software without specific prior
+//       written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#ifndef IECORE_DEEPTILE_H
+#define IECORE_DEEPTILE_H
+
+#include <string>
+#include <vector>
+
+#include "OpenEXR/ImathBox.h"
+
+#include "IECore/DeepPixel.h"
+#include "IECore/ImagePrimitive.h"
+
+namespace IECore
+{
+
+IE_CORE_FORWARDDECLARE( DeepTile )
+
+/// A DeepTile stores the deep samples for a rectangular region of a deep image.
+/// Rather than allocating a DeepPixel for every pixel, the samples for all pixels
+/// are stored contiguously in scanline order, with a separate array for the depths
+/// and for each channel. Per pixel sample counts are stored as a running sum of
+/// offsets into those arrays. This makes it much cheaper to read, write and composite
+/// entire images than the equivalent per-pixel operations.
+/// \ingroup deepCompositingGroup
+class DeepTile : public RefCounted
+{
+
+	public :
+
+		IE_CORE_DECLAREMEMBERPTR( DeepTile );
+
+		/// Constructs a tile covering the specified window, with all pixels
+		/// initially having no samples.
+		DeepTile( const Imath::Box2i &window, const std::vector<std::string> &channelNames );
+		virtual ~DeepTile();
+
+		//! @name Pixels
+		//////////////////////////////////////////////////////////////////////////////
+		//@{
+		/// The region of the image covered by the tile, specified in the same
+		/// coordinate system as DeepImageReader::readPixel().
+		const Imath::Box2i &window() const;
+		/// The number of pixels in the tile.
+		unsigned numPixels() const;
+		/// Returns the index of the given pixel, which must be within window().
+		/// Pixels are indexed in scanline order.
+		unsigned pixelIndex( int x, int y ) const;
+		//@}
+
+		//! @name Channels
+		/// As with DeepPixel, depth is not considered to be a channel.
+		//////////////////////////////////////////////////////////////////////////////
+		//@{
+		unsigned numChannels() const;
+		/// Get the index for the named channel, returning -1 if it doesn't exist.
+		int channelIndex( const std::string &name ) const;
+		const std::vector<std::string> &channelNames() const;
+		//@}
+
+		//! @name Samples
+		/// The samples for pixel p are stored at indices from sampleOffset( p )
+		/// to sampleOffset( p ) + sampleCount( p ) in the depths() and channelData()
+		/// arrays.
+		//////////////////////////////////////////////////////////////////////////////
+		//@{
+		/// Sets the number of samples in each pixel, in scanline order. All depths
+		/// and channel data are reset to 0.
+		void setSampleCounts( const std::vector<unsigned> &sampleCounts );
+		/// The total number of samples in the tile.
+		unsigned numSamples() const;
+		unsigned sampleCount( unsigned pixelIndex ) const;
+		unsigned sampleOffset( unsigned pixelIndex ) const;
+		/// The depths of all samples.
+		std::vector<float> &depths();
+		const std::vector<float> &depths() const;
+		/// The data for the specified channel for all samples.
+		std::vector<float> &channelData( unsigned channelIndex );
+		const std::vector<float> &channelData( unsigned channelIndex ) const;
+		//@}
+
+		/// Returns a new DeepPixel containing the samples for the specified pixel,
+		/// or 0 if the pixel has no samples.
+		DeepPixelPtr pixel( int x, int y ) const;
+
+		//! @name Deep Compositing
+		/// These are the equivalents of the DeepPixel compositing methods, operating
+		/// on all pixels in parallel.
+		//////////////////////////////////////////////////////////////////////////////
+		//@{
+		/// Sorts the samples within each pixel by depth. Pixels which are already
+		/// sorted are left untouched.
+		void sortSamples();
+		/// Merges the samples from the given tile into this one. The tile must have
+		/// the same window and channels, and both tiles must have sorted samples.
+		void merge( const DeepTile *tile );
+		/// Returns an ImagePrimitive with a data window of window(), containing the
+		/// composited channel data for each pixel. Samples must be sorted.
+		ImagePrimitivePtr composite() const;
+		//@}
+
+	private :
+
+		class SortSamples;
+		class MergeSamples;
+		class CompositeSamples;
+
+		Imath::Box2i m_window;
+		std::vector<std::string> m_channelNames;
+		// numPixels() + 1 entries, with the last being numSamples().
+		std::vector<unsigned> m_sampleOffsets;
+		std::vector<float> m_depths;
+		std::vector<std::vector<float> > m_channelData;
+
+};
+
+IE_CORE_DECLAREPTR( DeepTile );
+
+} // namespace IECore
+
+#endif // IECORE_DEEPTILE_H
@@ -69,6 +69,9 @@ class EXRDeepImageReader : public DeepImageReader
 	protected :
 
 		virtual DeepPixelPtr doReadPixel( int x, int y );
+		/// Reads the samples directly into the DeepTile, converting half
+		/// channels to float as it goes.
+		virtual DeepTilePtr doReadTile( const Imath::Box2i &window );
 
 	private :
 
@@ -73,6 +73,12 @@ class EXRDeepImageWriter : public DeepImageWriter
 	protected :
 		
 		virtual void doWritePixel( int x, int y, const DeepPixel *pixel );
+		/// Tiles spanning the full width of the image are written directly from the
+		/// DeepTile arrays. Other tiles are written pixel by pixel. In both cases the
+		/// result is the same as writing each pixel of the tile with writePixel(), so
+		/// pixels already written to the first scanline of the tile are kept unless
+		/// the tile has samples for them.
+		virtual void doWriteTile( const DeepTile *tile );
 		
 		Imf::Compression compression() const;
 
@@ -72,10 +72,12 @@ class EXRImageReader : public ImageReader
 
 	private:
 
-		template<class T>
-		DataPtr readTypedChannel( const std::string &name, const Imath::Box2i &dataWindow, const Imf::Channel *channel );
-
 		virtual DataPtr readChannel( const std::string &name, const Imath::Box2i &dataWindow, bool raw );
+		/// Reads all the channels with a single pass over the file, so each block of pixels
+		/// is decompressed only once. Blocks are decompressed in parallel only if the
+		/// host application has enabled the OpenEXR global thread pool with
+		/// Imf::setGlobalThreadCount() - the reader never changes its size itself.
+		virtual void readChannels( const std::vector<std::string> &names, const Imath::Box2i &dataWindow, bool raw, std::vector<DataPtr> &channels );
 
 		static const ReaderDescription<EXRImageReader> g_readerDescription;
 
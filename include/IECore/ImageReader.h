@@ -140,6 +140,13 @@ class ImageReader : public Reader
 		/// invalid names or dataWindows which are not wholly within the dataWindow in the file.
 		virtual DataPtr readChannel( const std::string &name, const Imath::Box2i &dataWindow, bool raw ) = 0;
 
+		/// Reads the specified area from all the named channels, filling channels with one result
+		/// per name - this is called by the doOperation() method. The default implementation calls
+		/// readChannel() for each name in turn, but derived classes may reimplement it for file formats
+		/// where all the channels can be read more efficiently at once. The same guarantees on names
+		/// and dataWindow as for readChannel() apply.
+		virtual void readChannels( const std::vector<std::string> &names, const Imath::Box2i &dataWindow, bool raw, std::vector<DataPtr> &channels );
+
 	private :
 
 		Box2iParameterPtr m_dataWindowParameter;
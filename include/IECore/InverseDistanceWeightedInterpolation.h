@@ -87,9 +87,19 @@ class InverseDistanceWeightedInterpolation
 		/// has to allocate a NeighbourVector each time.
 		Value operator()( const Point &p, NeighbourVector &neighbours ) const;
 
+		/// Evaluates the interpolated values for all the points in the random access
+		/// range [first, last), in parallel, writing them to the random access range
+		/// starting at result. This is much quicker than making the equivalent
+		/// individual calls.
+		template<typename QueryIterator, typename ResultIterator>
+		void operator()( QueryIterator first, QueryIterator last, ResultIterator result ) const;
+
 
 	private :
 
+		template<typename QueryIterator, typename ResultIterator>
+		class Interpolate;
+
 		Tree *m_tree;
 		PointIterator m_firstPoint;
 		ValueIterator m_firstValue;
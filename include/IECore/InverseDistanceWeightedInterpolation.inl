@@ -33,6 +33,9 @@
 //////////////////////////////////////////////////////////////////////////
 
 #include <algorithm>
+
+#include "tbb/parallel_for.h"
+
 #include "IECore/VectorOps.h"
 #include "OpenEXR/ImathLimits.h"
 
@@ -50,7 +53,7 @@ InverseDistanceWeightedInterpolation<PointIterator, ValueIterator>::InverseDista
 ) : m_firstPoint( firstPoint ), m_firstValue( firstValue ), m_numNeighbours( numNeighbours )
 {
 	assert( lastPoint-firstPoint == lastValue-firstValue );
-	m_tree = new Tree( firstPoint, lastPoint );
+	m_tree = new Tree( firstPoint, lastPoint, maxLeafSize );
 }
 
 template<typename PointIterator, typename ValueIterator>
@@ -111,5 +114,44 @@ typename InverseDistanceWeightedInterpolation<PointIterator, ValueIterator>::Val
 	return result;
 }
 
+template<typename PointIterator, typename ValueIterator>
+template<typename QueryIterator, typename ResultIterator>
+class InverseDistanceWeightedInterpolation<PointIterator, ValueIterator>::Interpolate
+{
+	public :
+
+		Interpolate( const InverseDistanceWeightedInterpolation *interpolation, QueryIterator first, ResultIterator result )
+			:	m_interpolation( interpolation ), m_first( first ), m_result( result )
+		{
+		}
+
+		void operator()( const tbb::blocked_range<size_t> &range ) const
+		{
+			// reused for every query in the range, to avoid an allocation per query
+			NeighbourVector neighbours;
+			neighbours.reserve( m_interpolation->m_numNeighbours );
+			for( size_t i = range.begin(); i != range.end(); ++i )
+			{
+				*(m_result + i) = (*m_interpolation)( *(m_first + i), neighbours );
+			}
+		}
+
+	private :
+
+		const InverseDistanceWeightedInterpolation *m_interpolation;
+		QueryIterator m_first;
+		ResultIterator m_result;
+
+};
+
+template<typename PointIterator, typename ValueIterator>
+template<typename QueryIterator, typename ResultIterator>
+void InverseDistanceWeightedInterpolation<PointIterator, ValueIterator>::operator()( QueryIterator first, QueryIterator last, ResultIterator result ) const
+{
+	tbb::parallel_for(
+		tbb::blocked_range<size_t>( 0, last - first ),
+		Interpolate<QueryIterator, ResultIterator>( this, first, result )
+	);
+}
 
 } // namespace IECore
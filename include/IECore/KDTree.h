@@ -74,6 +74,7 @@ class KDTree
 		/// Builds the tree for the specified points - the iterator range
 		/// must remain valid and unchanged as long as the tree is in use.
 		/// This method can be called again to rebuild the tree at any time.
+		/// Large trees are built in parallel using TBB.
 		/// \threading This can't be called while other threads are
 		/// making queries.
 		void init( PointIterator first, PointIterator last, int maxLeafSize=4  );
@@ -101,6 +102,27 @@ class KDTree
 		/// \threading May be called by multiple concurrent threads provided they are each using a different vector for the result.
 		unsigned int nearestNNeighbours( const Point &p, unsigned int numNeighbours, std::vector<Neighbour> &nearNeighbours ) const;
 
+		//! @name Batched queries
+		/// These perform a query for every point in the random access range
+		/// [first, last), in parallel, placing the results into flat arrays.
+		/// The arrays are resized as necessary, so they can be reused between
+		/// calls to avoid reallocation.
+		//////////////////////////////////////////////////////////////
+		//@{
+		/// Performs nearestNeighbours() for each query point. The neighbours of the ith
+		/// query point are placed in the range [ nearNeighbours[offsets[i]], nearNeighbours[offsets[i+1]] ),
+		/// so offsets has one more element than there are query points.
+		/// \threading May be called by multiple concurrent threads provided they are each using different vectors for the result.
+		template<typename QueryIterator>
+		void nearestNeighbours( QueryIterator first, QueryIterator last, BaseType r, std::vector<PointIterator> &nearNeighbours, std::vector<size_t> &offsets ) const;
+		/// Performs nearestNNeighbours() for each query point. The neighbours of the ith query
+		/// point are placed in nearNeighbours starting at index i * numNeighbours, sorted with the
+		/// closest first, and the number found is placed in numFound[i].
+		/// \threading May be called by multiple concurrent threads provided they are each using different vectors for the result.
+		template<typename QueryIterator>
+		void nearestNNeighbours( QueryIterator first, QueryIterator last, unsigned int numNeighbours, std::vector<Neighbour> &nearNeighbours, std::vector<unsigned int> &numFound ) const;
+		//@}
+
 		/// Finds all the points contained by the specified bound, outputting them to the specified iterator.
 		/// \threading May be called by multiple concurrent threads.
 		template<typename Box, typename OutputIterator>
@@ -128,8 +150,13 @@ class KDTree
 		typedef typename Permutation::const_iterator PermutationConstIterator;
 
 		class AxisSort;
+		template<typename QueryIterator>
+		class NearestNeighboursTask;
+		template<typename QueryIterator>
+		class NearestNNeighboursTask;
 
 		unsigned char majorAxis( PermutationConstIterator permFirst, PermutationConstIterator permLast );
+		NodeIndex lastNodeIndex( size_t numPoints ) const;
 		void build( NodeIndex nodeIndex, PermutationIterator permFirst, PermutationIterator permLast );
 
 		void nearestNeighbourWalk( NodeIndex nodeIndex, const Point &p, PointIterator &closestPoint, BaseType &distSquared ) const;
@@ -33,6 +33,13 @@
 //////////////////////////////////////////////////////////////////////////
 
 #include <algorithm>
+#include <cassert>
+
+#include "boost/bind.hpp"
+
+#include "tbb/parallel_for.h"
+#include "tbb/parallel_invoke.h"
+
 #include "OpenEXR/ImathLimits.h"
 #include "IECore/VectorOps.h"
 #include "IECore/BoxOps.h"
@@ -133,7 +140,11 @@ void KDTree<PointIterator>::init( PointIterator first, PointIterator last, int m
 		m_perm[i++] = it;
 	}
 
-	/// \todo Can we reserve() enough space for m_nodes before doing this?
+	// allocate all the nodes up front so that build() never needs to
+	// reallocate, and can therefore fill in subtrees in parallel.
+	m_nodes.clear();
+	m_nodes.resize( lastNodeIndex( m_perm.size() ) + 1 );
+
 	build( rootIndex(), m_perm.begin(), m_perm.end() );
 }
 
@@ -172,13 +183,28 @@ unsigned char KDTree<PointIterator>::majorAxis( PermutationConstIterator permFir
 }
 
 template<class PointIterator>
-void KDTree<PointIterator>::build( NodeIndex nodeIndex, PermutationIterator permFirst, PermutationIterator permLast )
+typename KDTree<PointIterator>::NodeIndex KDTree<PointIterator>::lastNodeIndex( size_t numPoints ) const
 {
-	// make room for the new node
-	if( nodeIndex>=m_nodes.size() )
+	// build() always gives the high child at least as many points as the low
+	// child, so the deepest and rightmost node is found by following the
+	// high children down from the root.
+	NodeIndex result = rootIndex();
+	while( numPoints > (size_t)m_maxLeafSize )
 	{
-		m_nodes.resize( nodeIndex+1 );
+		numPoints -= numPoints / 2;
+		result = highChildIndex( result );
 	}
+	return result;
+}
+
+template<class PointIterator>
+void KDTree<PointIterator>::build( NodeIndex nodeIndex, PermutationIterator permFirst, PermutationIterator permLast )
+{
+	// subtrees with fewer points than this aren't worth the overhead of
+	// building in parallel.
+	const typename Permutation::difference_type parallelThreshold = 10000;
+
+	assert( nodeIndex < m_nodes.size() );
 
 	if( permLast - permFirst > m_maxLeafSize )
 	{
@@ -189,8 +215,20 @@ void KDTree<PointIterator>::build( NodeIndex nodeIndex, PermutationIterator perm
 		// insert node
 		m_nodes[nodeIndex].makeBranch( cutAxis, cutValue );
 
-		build( lowChildIndex( nodeIndex ), permFirst, permMid );
-		build( highChildIndex( nodeIndex ), permMid, permLast );
+		// the children operate on disjoint ranges of the permutation and
+		// on disjoint nodes, so they can safely be built concurrently.
+		if( permLast - permFirst > parallelThreshold )
+		{
+			tbb::parallel_invoke(
+				boost::bind( &KDTree<PointIterator>::build, this, lowChildIndex( nodeIndex ), permFirst, permMid ),
+				boost::bind( &KDTree<PointIterator>::build, this, highChildIndex( nodeIndex ), permMid, permLast )
+			);
+		}
+		else
+		{
+			build( lowChildIndex( nodeIndex ), permFirst, permMid );
+			build( highChildIndex( nodeIndex ), permMid, permLast );
+		}
 	}
 	else
 	{
@@ -250,6 +288,136 @@ unsigned int KDTree<PointIterator>::nearestNNeighbours( const Point &p, unsigned
 	return nearNeighbours.size();
 }
 
+// batched queries
+
+template<class PointIterator>
+template<typename QueryIterator>
+class KDTree<PointIterator>::NearestNeighboursTask
+{
+	public :
+
+		NearestNeighboursTask( const KDTree *tree, QueryIterator first, size_t numQueries, size_t blockSize, BaseType r2, std::vector<PointIterator> *blockNeighbours, size_t *counts )
+			:	m_tree( tree ), m_first( first ), m_numQueries( numQueries ), m_blockSize( blockSize ), m_r2( r2 ), m_blockNeighbours( blockNeighbours ), m_counts( counts )
+		{
+		}
+
+		void operator()( const tbb::blocked_range<size_t> &blocks ) const
+		{
+			for( size_t b = blocks.begin(); b != blocks.end(); ++b )
+			{
+				std::vector<PointIterator> &neighbours = m_blockNeighbours[b];
+				const size_t end = std::min( (b + 1) * m_blockSize, m_numQueries );
+				for( size_t i = b * m_blockSize; i < end; ++i )
+				{
+					const size_t numBefore = neighbours.size();
+					m_tree->nearestNeighboursWalk( m_tree->rootIndex(), *(m_first + i), m_r2, neighbours );
+					m_counts[i] = neighbours.size() - numBefore;
+				}
+			}
+		}
+
+	private :
+
+		const KDTree *m_tree;
+		QueryIterator m_first;
+		size_t m_numQueries;
+		size_t m_blockSize;
+		BaseType m_r2;
+		std::vector<PointIterator> *m_blockNeighbours;
+		size_t *m_counts;
+
+};
+
+template<class PointIterator>
+template<typename QueryIterator>
+class KDTree<PointIterator>::NearestNNeighboursTask
+{
+	public :
+
+		NearestNNeighboursTask( const KDTree *tree, QueryIterator first, unsigned int numNeighbours, Neighbour *nearNeighbours, unsigned int *numFound )
+			:	m_tree( tree ), m_first( first ), m_numNeighbours( numNeighbours ), m_nearNeighbours( nearNeighbours ), m_numFound( numFound )
+		{
+		}
+
+		void operator()( const tbb::blocked_range<size_t> &range ) const
+		{
+			// reused for every query in the range, to avoid an allocation per query
+			std::vector<Neighbour> neighbours;
+			neighbours.reserve( m_numNeighbours );
+			for( size_t i = range.begin(); i != range.end(); ++i )
+			{
+				m_numFound[i] = m_tree->nearestNNeighbours( *(m_first + i), m_numNeighbours, neighbours );
+				std::copy( neighbours.begin(), neighbours.end(), m_nearNeighbours + i * m_numNeighbours );
+			}
+		}
+
+	private :
+
+		const KDTree *m_tree;
+		QueryIterator m_first;
+		unsigned int m_numNeighbours;
+		Neighbour *m_nearNeighbours;
+		unsigned int *m_numFound;
+
+};
+
+template<class PointIterator>
+template<typename QueryIterator>
+void KDTree<PointIterator>::nearestNeighbours( QueryIterator first, QueryIterator last, BaseType r, std::vector<PointIterator> &nearNeighbours, std::vector<size_t> &offsets ) const
+{
+	const size_t numQueries = last - first;
+	offsets.resize( numQueries + 1 );
+	offsets[0] = 0;
+	if( !numQueries )
+	{
+		nearNeighbours.clear();
+		return;
+	}
+
+	// we can't know in advance how many neighbours each query will find, so
+	// the queries are made in blocks, each gathering its neighbours into its
+	// own vector. these are then concatenated to form the result.
+	const size_t blockSize = 1024;
+	const size_t numBlocks = ( numQueries + blockSize - 1 ) / blockSize;
+	std::vector<std::vector<PointIterator> > blockNeighbours( numBlocks );
+
+	tbb::parallel_for(
+		tbb::blocked_range<size_t>( 0, numBlocks, 1 ),
+		NearestNeighboursTask<QueryIterator>( this, first, numQueries, blockSize, r * r, &blockNeighbours[0], &offsets[1] )
+	);
+
+	// convert the counts into offsets
+	for( size_t i = 0; i < numQueries; ++i )
+	{
+		offsets[i+1] += offsets[i];
+	}
+
+	nearNeighbours.resize( offsets[numQueries] );
+	for( size_t b = 0; b < numBlocks; ++b )
+	{
+		std::copy( blockNeighbours[b].begin(), blockNeighbours[b].end(), nearNeighbours.begin() + offsets[b * blockSize] );
+	}
+}
+
+template<class PointIterator>
+template<typename QueryIterator>
+void KDTree<PointIterator>::nearestNNeighbours( QueryIterator first, QueryIterator last, unsigned int numNeighbours, std::vector<Neighbour> &nearNeighbours, std::vector<unsigned int> &numFound ) const
+{
+	const size_t numQueries = last - first;
+	numFound.resize( numQueries );
+	nearNeighbours.resize( numQueries * numNeighbours, Neighbour( m_lastPoint, 0 ) );
+	if( !numQueries || !numNeighbours )
+	{
+		std::fill( numFound.begin(), numFound.end(), 0 );
+		return;
+	}
+
+	tbb::parallel_for(
+		tbb::blocked_range<size_t>( 0, numQueries ),
+		NearestNNeighboursTask<QueryIterator>( this, first, numNeighbours, &nearNeighbours[0], &numFound[0] )
+	);
+}
+
 template<class PointIterator>
 void KDTree<PointIterator>::nearestNeighbourWalk( NodeIndex nodeIndex, const Point &p, PointIterator &closestPoint, BaseType &distSquared ) const
 {
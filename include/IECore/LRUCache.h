@@ -44,10 +44,47 @@
 namespace IECore
 {
 
+/// Policies determining how an LRUCache tracks the least recently used items,
+/// passed to it as the Policy template parameter.
+namespace LRUCachePolicy
+{
+
+/// Tracks the least recently used items exactly. Every access moves the item to the
+/// end of a list protected by a single mutex, which can become a point of contention
+/// when many threads hit the cache at once.
+struct Exact
+{
+	/// Called with the entry mutex held when an item is stored or retrieved. Returns
+	/// true if the item must be moved to the end of the list.
+	template<typename Entry>
+	static bool accessed( Entry &entry );
+	/// Called with the list and entry mutexes held when the item at the start of the
+	/// list is about to be discarded. Returns true if it should be moved to the end
+	/// of the list instead.
+	template<typename Entry>
+	static bool secondChance( Entry &entry );
+};
+
+/// Approximates the least recently used items with the Second Chance algorithm.
+/// Storing or retrieving an item just flags it as referenced, so cache hits don't
+/// acquire any lock shared between items. When the cost must be reduced, items are
+/// considered in the order they were stored. Referenced items have their flag
+/// cleared and are sent to the back of the queue, and the others are discarded.
+struct SecondChance
+{
+	template<typename Entry>
+	static bool accessed( Entry &entry );
+	template<typename Entry>
+	static bool secondChance( Entry &entry );
+};
+
+} // namespace LRUCachePolicy
+
 /// A mapping from keys to values, where values are computed from keys using a user
 /// supplied function. Recently computed values are stored in the cache to accelerate
 /// subsequent lookups. Each value has a cost associated with it, and the cache has
-/// a maximum total cost above which it will remove the least recently accessed items. 
+/// a maximum total cost above which it will remove the least recently accessed items,
+/// as determined by the Policy.
 ///
 /// The Key type must have a tbb_hasher implementation.
 ///
@@ -57,7 +94,7 @@ namespace IECore
 ///
 /// \threading It is safe to call the methods of LRUCache from concurrent threads.
 /// \ingroup utilityGroup
-template<typename Key, typename Value>
+template<typename Key, typename Value, typename Policy = LRUCachePolicy::Exact>
 class LRUCache : private boost::noncopyable
 {
 	public:
@@ -154,7 +191,7 @@ class LRUCache : private boost::noncopyable
 		// CacheEntry implementation - a single item of the cache.
 		struct CacheEntry
 		{
-			CacheEntry(); // status == New, previous == next == NULL
+			CacheEntry(); // status == New, previous == next == NULL, referenced == false
 			
 			Value value; // value for this item
 			Cost cost; // the cost for this item
@@ -174,6 +211,10 @@ class LRUCache : private boost::noncopyable
 			MapValue *next;
 			
 			char status; // status of this item
+			// Set when the item is stored or retrieved, and cleared
+			// when it is given a second chance. Only used by the
+			// SecondChance policy.
+			bool referenced;
 			// Mutex - must be held before accessing any
 			// fields other than the list fields (previous
 			// and next). To access the list fields, m_listMutex
@@ -182,7 +223,7 @@ class LRUCache : private boost::noncopyable
 		};
 
 		// Dummy MapValues to represent the start and end of our LRU list.
-		// Items are moved to the end when they are accessed, and removed
+		// Items are moved to the end when the Policy requires it, and removed
 		// from the start when we need to reduce costs.
 		MapValue m_listStart;
 		MapValue m_listEnd;
@@ -225,9 +266,10 @@ class LRUCache : private boost::noncopyable
 		void limitCost();
 
 		// Either erases the item from the list, or moves it to
-		// the end, depending on whether or not it is cached.
-		// Caller must not hold any locks.
-		void updateListPosition( MapValue *mapValue );
+		// the end, depending on whether or not it is cached. If
+		// moveToEnd is false, items already in the list keep their
+		// position. Caller must not hold any locks.
+		void updateListPosition( MapValue *mapValue, bool moveToEnd );
 
 		// If the item is in the list, erases it, otherwise
 		// does nothing. Caller must hold m_listMutex.
@@ -44,14 +44,46 @@
 namespace IECore
 {
 
-template<typename Key, typename Value>
-LRUCache<Key, Value>::CacheEntry::CacheEntry()
-	:	value(), cost( 0 ), previous( NULL ), next( NULL ), status( New )
+template<typename Entry>
+bool LRUCachePolicy::Exact::accessed( Entry &entry )
+{
+	return true;
+}
+
+template<typename Entry>
+bool LRUCachePolicy::Exact::secondChance( Entry &entry )
+{
+	return false;
+}
+
+template<typename Entry>
+bool LRUCachePolicy::SecondChance::accessed( Entry &entry )
+{
+	// Items already in the list keep their position - the
+	// referenced flag is enough to give them a second chance.
+	entry.referenced = true;
+	return false;
+}
+
+template<typename Entry>
+bool LRUCachePolicy::SecondChance::secondChance( Entry &entry )
+{
+	if( entry.referenced )
+	{
+		entry.referenced = false;
+		return true;
+	}
+	return false;
+}
+
+template<typename Key, typename Value, typename Policy>
+LRUCache<Key, Value, Policy>::CacheEntry::CacheEntry()
+	:	value(), cost( 0 ), previous( NULL ), next( NULL ), status( New ), referenced( false )
 {
 }
 			
-template<typename Key, typename Value>
-LRUCache<Key, Value>::LRUCache( GetterFunction getter )
+template<typename Key, typename Value, typename Policy>
+LRUCache<Key, Value, Policy>::LRUCache( GetterFunction getter )
 	:	m_getter( getter ), m_removalCallback( nullRemovalCallback ), m_maxCost( 500 )
 {
 	m_currentCost = 0;
@@ -63,8 +95,8 @@ LRUCache<Key, Value>::LRUCache( GetterFunction getter )
 	m_listEnd.second.next = NULL;
 }
 
-template<typename Key, typename Value>
-LRUCache<Key, Value>::LRUCache( GetterFunction getter, Cost maxCost )
+template<typename Key, typename Value, typename Policy>
+LRUCache<Key, Value, Policy>::LRUCache( GetterFunction getter, Cost maxCost )
 	:	m_getter( getter ), m_removalCallback( nullRemovalCallback ), m_maxCost( maxCost )
 {
 	m_currentCost = 0;
@@ -76,8 +108,8 @@ LRUCache<Key, Value>::LRUCache( GetterFunction getter, Cost maxCost )
 	m_listEnd.second.next = NULL;
 }
 
-template<typename Key, typename Value>
-LRUCache<Key, Value>::LRUCache( GetterFunction getter, RemovalCallback removalCallback, Cost maxCost )
+template<typename Key, typename Value, typename Policy>
+LRUCache<Key, Value, Policy>::LRUCache( GetterFunction getter, RemovalCallback removalCallback, Cost maxCost )
 	:	m_getter( getter ), m_removalCallback( removalCallback ), m_maxCost( maxCost )
 {
 	m_currentCost = 0;
@@ -89,13 +121,13 @@ LRUCache<Key, Value>::LRUCache( GetterFunction getter, RemovalCallback removalCa
 	m_listEnd.second.next = NULL;
 }
 
-template<typename Key, typename Value>
-LRUCache<Key, Value>::~LRUCache()
+template<typename Key, typename Value, typename Policy>
+LRUCache<Key, Value, Policy>::~LRUCache()
 {
 }
 
-template<typename Key, typename Value>
-void LRUCache<Key, Value>::clear()
+template<typename Key, typename Value, typename Policy>
+void LRUCache<Key, Value, Policy>::clear()
 {
 	ListMutex::scoped_lock listLock( m_listMutex );	
 	for( typename Map::iterator it = m_map.begin(); it != m_map.end(); ++it )
@@ -104,30 +136,36 @@ void LRUCache<Key, Value>::clear()
 	}
 }
 
-template<typename Key, typename Value>
-void LRUCache<Key, Value>::setMaxCost( Cost maxCost )
+template<typename Key, typename Value, typename Policy>
+void LRUCache<Key, Value, Policy>::setMaxCost( Cost maxCost )
 {
 	m_maxCost = maxCost;
 	limitCost();
 }
 
-template<typename Key, typename Value>
-typename LRUCache<Key, Value>::Cost LRUCache<Key, Value>::getMaxCost() const
+template<typename Key, typename Value, typename Policy>
+typename LRUCache<Key, Value, Policy>::Cost LRUCache<Key, Value, Policy>::getMaxCost() const
 {
 	return m_maxCost;
 }
 
-template<typename Key, typename Value>
-typename LRUCache<Key, Value>::Cost LRUCache<Key, Value>::currentCost() const
+template<typename Key, typename Value, typename Policy>
+typename LRUCache<Key, Value, Policy>::Cost LRUCache<Key, Value, Policy>::currentCost() const
 {
 	return m_currentCost;
 }
 
-template<typename Key, typename Value>
-Value LRUCache<Key, Value>::get( const Key& key )
+template<typename Key, typename Value, typename Policy>
+Value LRUCache<Key, Value, Policy>::get( const Key& key )
 {
+	// Most calls are expected to be hits, so we try find() first to
+	// avoid constructing a CacheEntry just to have insert() discard it.
+	MapIterator it = m_map.find( key );
+	if( it == m_map.end() )
+	{
+		it = m_map.insert( MapValue( key, CacheEntry() ) ).first;
+	}
 
-	MapIterator it = m_map.insert( MapValue( key, CacheEntry() ) ).first;
 	CacheEntry &cacheEntry = it->second;
 	tbb::spin_mutex::scoped_lock lock( cacheEntry.mutex );
 		
@@ -155,13 +193,10 @@ Value LRUCache<Key, Value>::get( const Key& key )
 		
 		assert( cacheEntry.status == Cached || cacheEntry.status == TooCostly );
 	
+		const bool moveToEnd = Policy::accessed( cacheEntry );
 		lock.release();
 		
-		/// \todo We might want to consider ways of avoiding having to manipulate the
-		/// list for cache hits, because we want this to be our fastest code path.
-		/// Adopting an approximate LRU heuristic like Second Chance would be one way
-		/// of doing this.
-		updateListPosition( &*it );
+		updateListPosition( &*it, moveToEnd );
 		limitCost();
 	
 		return value;
@@ -169,8 +204,13 @@ Value LRUCache<Key, Value>::get( const Key& key )
 	else if( cacheEntry.status==Cached )
 	{
 		Value result = cacheEntry.value;
-		lock.release();
-		updateListPosition( &*it );
+		// This is our fastest code path, so policies may avoid
+		// having to manipulate the list here.
+		if( Policy::accessed( cacheEntry ) )
+		{
+			lock.release();
+			updateListPosition( &*it, true );
+		}
 		return result;
 	}
 	else
@@ -180,24 +220,25 @@ Value LRUCache<Key, Value>::get( const Key& key )
 	}
 }
 
-template<typename Key, typename Value>
-bool LRUCache<Key, Value>::set( const Key &key, const Value &value, Cost cost )
+template<typename Key, typename Value, typename Policy>
+bool LRUCache<Key, Value, Policy>::set( const Key &key, const Value &value, Cost cost )
 {
 	MapIterator it = m_map.insert( MapValue( key, CacheEntry() ) ).first;
 	CacheEntry &cacheEntry = it->second;
 	tbb::spin_mutex::scoped_lock lock( cacheEntry.mutex );
 
 	const bool result = setInternal( &*it, value, cost );
+	const bool moveToEnd = Policy::accessed( cacheEntry );
 	
 	lock.release();
-	updateListPosition( &*it );
+	updateListPosition( &*it, moveToEnd );
 	limitCost();
 	
 	return result;
 }
 
-template<typename Key, typename Value>
-bool LRUCache<Key, Value>::setInternal( MapValue *mapValue, const Value &value, Cost cost )
+template<typename Key, typename Value, typename Policy>
+bool LRUCache<Key, Value, Policy>::setInternal( MapValue *mapValue, const Value &value, Cost cost )
 {
 	CacheEntry &cacheEntry = mapValue->second;
 	if( cacheEntry.status==Cached )
@@ -224,8 +265,8 @@ bool LRUCache<Key, Value>::setInternal( MapValue *mapValue, const Value &value,
 	return result;
 }
 
-template<typename Key, typename Value>
-bool LRUCache<Key, Value>::cached( const Key &key ) const
+template<typename Key, typename Value, typename Policy>
+bool LRUCache<Key, Value, Policy>::cached( const Key &key ) const
 {
 	ConstMapIterator it = m_map.find( key );
 	if( it == m_map.end() )
@@ -236,8 +277,8 @@ bool LRUCache<Key, Value>::cached( const Key &key ) const
 	return it->second.status==Cached;
 }
 
-template<typename Key, typename Value>
-bool LRUCache<Key, Value>::erase( const Key &key )
+template<typename Key, typename Value, typename Policy>
+bool LRUCache<Key, Value, Policy>::erase( const Key &key )
 {
 	MapIterator it = m_map.find( key );
 	if( it == m_map.end() )
@@ -249,8 +290,8 @@ bool LRUCache<Key, Value>::erase( const Key &key )
 	return eraseInternal( &*it );
 }
 
-template<typename Key, typename Value>
-bool LRUCache<Key, Value>::eraseInternal( MapValue *mapValue )
+template<typename Key, typename Value, typename Policy>
+bool LRUCache<Key, Value, Policy>::eraseInternal( MapValue *mapValue )
 {	
 	CacheEntry &cacheEntry = mapValue->second;
 	tbb::spin_mutex::scoped_lock lock( cacheEntry.mutex );
@@ -259,6 +300,7 @@ bool LRUCache<Key, Value>::eraseInternal( MapValue *mapValue )
 
 	listErase( mapValue );
 	cacheEntry.status = Erased;
+	cacheEntry.referenced = false;
 	
 	if( originalStatus != Cached ) 
 	{
@@ -272,39 +314,65 @@ bool LRUCache<Key, Value>::eraseInternal( MapValue *mapValue )
 	return true;
 }
 
-template<typename Key, typename Value>
-void LRUCache<Key, Value>::limitCost()
+template<typename Key, typename Value, typename Policy>
+void LRUCache<Key, Value, Policy>::limitCost()
 {
+	if( m_currentCost <= m_maxCost )
+	{
+		// Avoid contention on the list mutex in the common case.
+		return;
+	}
+
 	ListMutex::scoped_lock lock( m_listMutex );
 
 	// While we're above the cost limit, and there are still things
-	// in the list, erase the first item in the list. Note that it _is_
+	// in the list, erase the first item in the list, unless the Policy
+	// gives it a second chance by moving it to the end. Note that it _is_
 	// possible for the list to become empty before we meet the cost limit,
 	// because another thread may have cached an item and incremented
 	// m_currentCost, but still be waiting to add the item to the list,
 	// because we hold m_listMutex.
 	while( m_currentCost > m_maxCost && m_listStart.second.next != &m_listEnd )
 	{
-		eraseInternal( m_listStart.second.next );
+		MapValue *mapValue = m_listStart.second.next;
+		{
+			tbb::spin_mutex::scoped_lock mapValueMutex( mapValue->second.mutex );
+			if( Policy::secondChance( mapValue->second ) )
+			{
+				listErase( mapValue );
+				listInsertAtEnd( mapValue );
+				continue;
+			}
+		}
+		eraseInternal( mapValue );
 	}
 }
 
-template<typename Key, typename Value>
-void LRUCache<Key, Value>::updateListPosition( MapValue *mapValue )
+template<typename Key, typename Value, typename Policy>
+void LRUCache<Key, Value, Policy>::updateListPosition( MapValue *mapValue, bool moveToEnd )
 {
 	ListMutex::scoped_lock lock( m_listMutex );
 	
-	listErase( mapValue );
-	
 	tbb::spin_mutex::scoped_lock mapValueMutex( mapValue->second.mutex );
 	if( mapValue->second.status == Cached )
 	{
-		listInsertAtEnd( mapValue );
+		if( moveToEnd )
+		{
+			listErase( mapValue );
+		}
+		if( !mapValue->second.previous )
+		{
+			listInsertAtEnd( mapValue );
+		}
+	}
+	else
+	{
+		listErase( mapValue );
 	}
 }
 
-template<typename Key, typename Value>
-void LRUCache<Key, Value>::listErase( MapValue *mapValue )
+template<typename Key, typename Value, typename Policy>
+void LRUCache<Key, Value, Policy>::listErase( MapValue *mapValue )
 {	
 	MapValue *previous = mapValue->second.previous;	
 	if( !previous )
@@ -317,8 +385,8 @@ void LRUCache<Key, Value>::listErase( MapValue *mapValue )
 	mapValue->second.next = mapValue->second.previous = NULL;
 }
 
-template<typename Key, typename Value>
-void LRUCache<Key, Value>::listInsertAtEnd( MapValue *mapValue )
+template<typename Key, typename Value, typename Policy>
+void LRUCache<Key, Value, Policy>::listInsertAtEnd( MapValue *mapValue )
 {
 	assert( mapValue->second.previous == NULL );
 	assert( mapValue->second.next == NULL );
@@ -331,8 +399,8 @@ void LRUCache<Key, Value>::listInsertAtEnd( MapValue *mapValue )
 	m_listEnd.second.previous = mapValue;
 }
 
-template<typename Key, typename Value>
-void LRUCache<Key, Value>::nullRemovalCallback( const Key &key, const Value &value )
+template<typename Key, typename Value, typename Policy>
+void LRUCache<Key, Value, Policy>::nullRemovalCallback( const Key &key, const Value &value )
 {
 }
 
@@ -0,0 +1,113 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2014, Image Engine Design Inc. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+//     * Neither the name of Image Engine Design nor the names of any
+//       other contributors to this software may be used to endorse or
+//       promote products derived from this software without specific prior
+//       written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#ifndef IECORE_MAPPEDVECTORDATA_H
+#define IECORE_MAPPEDVECTORDATA_H
+
+#include <vector>
+
+#include "IECore/RefCounted.h"
+#include "IECore/VectorTypedData.h"
+
+namespace IECore
+{
+
+/// Provides zero-copy access to an array of T stored in a memory mapped file,
+/// such as those returned by StreamIndexedIO::readMapped(). The elements are
+/// referenced in place until writable() or data() is called, at which point
+/// they are copied into a regular TypedData<std::vector<T> >, giving
+/// copy-on-write semantics similar to those of VectorTypedData itself. An
+/// owner object is held to keep the mapping alive for as long as it is
+/// referenced.
+///
+/// Note that TypedData<std::vector<T> > can't adopt memory it didn't allocate,
+/// so code which requires a VectorTypedData must call data(), which copies
+/// unless the view has already been copied.
+///
+/// \threading It's safe for multiple concurrent threads to call the const
+/// methods on the same instance, provided that no concurrent modifications
+/// are being made.
+/// \ingroup ioGroup
+template<typename T>
+class MappedVectorData : public RefCounted
+{
+
+	public :
+
+		IE_CORE_DECLAREMEMBERPTR( MappedVectorData );
+
+		typedef T ValueType;
+		typedef TypedData<std::vector<T> > DataType;
+		typedef typename DataType::Ptr DataTypePtr;
+
+		/// Constructs a view of size elements starting at begin. The owner is
+		/// referenced for the lifetime of the view, and must keep the memory
+		/// valid for at least that long.
+		MappedVectorData( const T *begin, size_t size, ConstRefCountedPtr owner );
+		/// Constructs from existing data, which is shared rather than copied.
+		MappedVectorData( DataTypePtr data );
+
+		/// Returns true if the elements are still referenced from the mapped
+		/// file, and false if they have been copied.
+		bool isMapped() const;
+
+		size_t size() const;
+		const T *begin() const;
+		const T *end() const;
+		const T &operator[]( size_t i ) const;
+
+		/// Copies the elements out of the mapped file if necessary, and then
+		/// returns them for modification.
+		std::vector<T> &writable();
+
+		/// Returns the elements as TypedData, copying them out of the mapped
+		/// file if necessary. Subsequent calls return the same object.
+		DataTypePtr data();
+
+	private :
+
+		void copyFromMapping();
+
+		const T *m_begin;
+		size_t m_size;
+		ConstRefCountedPtr m_owner;
+		DataTypePtr m_data;
+
+};
+
+} // namespace IECore
+
+#include "IECore/MappedVectorData.inl"
+
+#endif // IECORE_MAPPEDVECTORDATA_H
@@ -0,0 +1,134 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2014, Image Engine Design Inc. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+//     * Neither the name of Image Engine Design nor the names of any
+//       other contributors to this software may be used to endorse or
+//       promote products derived from this software without specific prior
+//       written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#ifndef IECORE_MAPPEDVECTORDATA_INL
+#define IECORE_MAPPEDVECTORDATA_INL
+
+#include <cassert>
+
+#include "IECore/Exception.h"
+
+namespace IECore
+{
+
+template<typename T>
+MappedVectorData<T>::MappedVectorData( const T *begin, size_t size, ConstRefCountedPtr owner )
+	:	m_begin( begin ), m_size( size ), m_owner( owner ), m_data( 0 )
+{
+	if( m_size && !m_begin )
+	{
+		throw InvalidArgumentException( "MappedVectorData : Null data" );
+	}
+}
+
+template<typename T>
+MappedVectorData<T>::MappedVectorData( DataTypePtr data )
+	:	m_begin( 0 ), m_size( 0 ), m_owner( 0 ), m_data( data )
+{
+	if( !m_data )
+	{
+		throw InvalidArgumentException( "MappedVectorData : Null data" );
+	}
+}
+
+template<typename T>
+bool MappedVectorData<T>::isMapped() const
+{
+	return !m_data;
+}
+
+template<typename T>
+size_t MappedVectorData<T>::size() const
+{
+	return m_data ? m_data->readable().size() : m_size;
+}
+
+template<typename T>
+const T *MappedVectorData<T>::begin() const
+{
+	if( m_data )
+	{
+		const std::vector<T> &v = m_data->readable();
+		return v.empty() ? 0 : &v[0];
+	}
+	return m_begin;
+}
+
+template<typename T>
+const T *MappedVectorData<T>::end() const
+{
+	return begin() + size();
+}
+
+template<typename T>
+const T &MappedVectorData<T>::operator[]( size_t i ) const
+{
+	assert( i < size() );
+	return begin()[i];
+}
+
+template<typename T>
+std::vector<T> &MappedVectorData<T>::writable()
+{
+	copyFromMapping();
+	return m_data->writable();
+}
+
+template<typename T>
+typename MappedVectorData<T>::DataTypePtr MappedVectorData<T>::data()
+{
+	copyFromMapping();
+	return m_data;
+}
+
+template<typename T>
+void MappedVectorData<T>::copyFromMapping()
+{
+	if( m_data )
+	{
+		return;
+	}
+
+	m_data = new DataType;
+	m_data->writable().assign( m_begin, m_begin + m_size );
+
+	// we no longer need the mapping
+	m_begin = 0;
+	m_size = 0;
+	m_owner = 0;
+}
+
+} // namespace IECore
+
+#endif // IECORE_MAPPEDVECTORDATA_INL
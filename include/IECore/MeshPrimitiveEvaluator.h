@@ -38,10 +38,12 @@
 #include <vector>
 
 #include "tbb/mutex.h"
+#include "tbb/blocked_range.h"
 
 #include "IECore/PrimitiveEvaluator.h"
 #include "IECore/MeshPrimitive.h"
 #include "IECore/BoundedKDTree.h"
+#include "IECore/TriangleBVH.h"
 
 namespace IECore
 {
@@ -103,7 +105,17 @@ class MeshPrimitiveEvaluator : public PrimitiveEvaluator
 
 		static PrimitiveEvaluatorPtr create( ConstPrimitivePtr primitive );
 
-		MeshPrimitiveEvaluator( ConstMeshPrimitivePtr mesh );
+		/// The acceleration structure used for closestPoint(), signedDistance()
+		/// and the ray intersection queries.
+		enum Accelerator
+		{
+			/// A BoundedKDTree of the triangle bounds.
+			KDTreeAccelerator,
+			/// A TriangleBVH, which is much faster for ray intersection queries.
+			BVHAccelerator
+		};
+
+		MeshPrimitiveEvaluator( ConstMeshPrimitivePtr mesh, Accelerator accelerator = KDTreeAccelerator );
 
 		virtual ~MeshPrimitiveEvaluator();
 
@@ -127,6 +139,24 @@ class MeshPrimitiveEvaluator : public PrimitiveEvaluator
 		/// A query specific to the MeshPrimitiveEvaluator, this just chooses a barycentric position on a specific triangle.
 		bool barycentricPosition( unsigned int triangleIndex, const Imath::V3f &barycentricCoordinates, PrimitiveEvaluator::Result *result ) const;
 
+		//! @name Batched queries
+		/// These perform many queries in parallel, writing the results into arrays
+		/// with one element per query. They avoid the allocation of a Result per
+		/// query and so are much faster than making the equivalent individual calls.
+		/// The output arrays are resized to match the number of queries, and the
+		/// triangle index is set to -1 for any query which fails. The positions and
+		/// normals are only computed if the corresponding arrays are passed.
+		//////////////////////////////////////////////////////////////////////////
+		//@{
+		/// Equivalent to calling closestPoint() for each point.
+		void closestPoints( const std::vector<Imath::V3f> &points, std::vector<int> &triangleIndices,
+			std::vector<Imath::V3f> &barycentricCoordinates, std::vector<Imath::V3f> *positions = 0, std::vector<Imath::V3f> *normals = 0 ) const;
+		/// Equivalent to calling intersectionPoint() for each origin and direction pair.
+		void nearestIntersections( const std::vector<Imath::V3f> &origins, const std::vector<Imath::V3f> &directions,
+			std::vector<int> &triangleIndices, std::vector<Imath::V3f> &barycentricCoordinates, std::vector<Imath::V3f> *positions = 0,
+			std::vector<Imath::V3f> *normals = 0, float maxDistance = Imath::limits<float>::max() ) const;
+		//@}
+
 		virtual bool signedDistance( const Imath::V3f &p, float &distance ) const;
 
 		virtual float volume() const;
@@ -155,7 +185,11 @@ class MeshPrimitiveEvaluator : public PrimitiveEvaluator
 		const TriangleBoundVector *triangleBounds() const;
 		/// Returns a pointer to a tree that can be used for performing fast spacial queries.
 		///  The iterators in this tree point to elements in the vector returned by triangleBounds().
+		/// Note that this function returns 0 if the evaluator was constructed using the BVHAccelerator.
 		const TriangleBoundTree *triangleBoundTree() const;
+		/// Returns a pointer to the TriangleBVH used to perform queries, or 0 if the evaluator
+		/// was constructed using the KDTreeAccelerator.
+		const TriangleBVH *triangleBVH() const;
 		
 		/// A type for storing the uv bounding box for a triangle.
 		typedef Imath::Box2f UVBound;
@@ -184,11 +218,19 @@ class MeshPrimitiveEvaluator : public PrimitiveEvaluator
 		UVBoundVector m_uvTriangles;		
 		UVBoundTree *m_uvTree;
 
+		TriangleBVH *m_bvh;
+
 		bool pointAtUVWalk( UVBoundTree::NodeIndex nodeIndex, const Imath::V2f &targetUV, Result *result ) const;
 		void closestPointWalk( TriangleBoundTree::NodeIndex nodeIndex, const Imath::V3f &p, float &closestDistanceSqrd, Result *result ) const;
 		bool intersectionPointWalk( TriangleBoundTree::NodeIndex nodeIndex, const Imath::Line3f &ray, float &maxDistSqrd, Result *result, bool &hit ) const;
 		void intersectionPointsWalk( TriangleBoundTree::NodeIndex nodeIndex, const Imath::Line3f &ray, float maxDistSqrd, std::vector<PrimitiveEvaluator::ResultPtr> &results ) const;
 
+		void calculateTriangleBounds( const tbb::blocked_range<size_t> &range );
+		void closestPointsRange( const tbb::blocked_range<size_t> &range, const std::vector<Imath::V3f> *points, std::vector<int> *triangleIndices,
+			std::vector<Imath::V3f> *barycentricCoordinates, std::vector<Imath::V3f> *positions, std::vector<Imath::V3f> *normals ) const;
+		void nearestIntersectionsRange( const tbb::blocked_range<size_t> &range, const std::vector<Imath::V3f> *origins, const std::vector<Imath::V3f> *directions,
+			float maxDistance, std::vector<int> *triangleIndices, std::vector<Imath::V3f> *barycentricCoordinates, std::vector<Imath::V3f> *positions, std::vector<Imath::V3f> *normals ) const;
+
 		void calculateMassProperties() const;
 		void calculateAverageNormals() const;
 		
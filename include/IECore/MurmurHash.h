@@ -67,6 +67,10 @@ class MurmurHash
 
 		MurmurHash();
 		MurmurHash( const MurmurHash &other );
+		/// Constructs from the two halves of a hash previously
+		/// obtained from h1() and h2(), for instance when it
+		/// has been serialised.
+		MurmurHash( uint64_t h1, uint64_t h2 );
 		
 		inline MurmurHash &append( char data );
 		inline MurmurHash &append( unsigned char data );
@@ -151,6 +155,10 @@ class MurmurHash
 		
 		std::string toString() const;
 
+		/// Returns the two 64 bit halves of the hash.
+		inline uint64_t h1() const;
+		inline uint64_t h2() const;
+
 	private :
 	
 		void append( const void *data, size_t bytes, int elementSize );
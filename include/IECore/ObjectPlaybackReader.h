@@ -0,0 +1,109 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2014, Image Engine Design Inc. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+//     * Neither the name of Image Engine Design nor the names of any
+//       other contributors to this software may be used to endorse or
+//       promote products derived from this software without specific prior
+//       written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#ifndef IECORE_OBJECTPLAYBACKREADER_H
+#define IECORE_OBJECTPLAYBACKREADER_H
+
+#include <vector>
+
+#include "IECore/SampledSceneInterface.h"
+#include "IECore/Primitive.h"
+#include "IECore/MurmurHash.h"
+
+namespace IECore
+{
+
+IE_CORE_FORWARDDECLARE( ObjectPlaybackReader );
+
+/// The ObjectPlaybackReader reads the object from a single location of a
+/// SampledSceneInterface at a succession of times, as happens during
+/// interactive playback. Where SceneInterface::readObject() allocates a new
+/// interpolated object on every call, the ObjectPlaybackReader keeps the
+/// window of samples bracketing the current time resident, and interpolates
+/// into a destination primitive which is reused from one call to the next.
+/// When the location has constant topology, only the primitive variables listed
+/// by the SceneCache::animatedObjectPrimVarsAttribute are interpolated - all
+/// other data is shared with the samples and left untouched.
+/// \threading Instances may not be used by multiple threads concurrently,
+/// but separate instances may be used in parallel.
+/// \ingroup ioGroup
+class ObjectPlaybackReader : public RefCounted
+{
+
+	public :
+
+		IE_CORE_DECLAREMEMBERPTR( ObjectPlaybackReader );
+
+		ObjectPlaybackReader( ConstSampledSceneInterfacePtr scene );
+		virtual ~ObjectPlaybackReader();
+
+		/// Returns the location this reader was constructed with.
+		const SampledSceneInterface *scene() const;
+
+		/// Returns the object at the specified time. When interpolation is
+		/// performed in place the result is owned by the reader, and will be
+		/// modified by the next call to readObject() - callers wishing to
+		/// keep it must take a copy.
+		ConstObjectPtr readObject( double time );
+
+	private :
+
+		bool interpolateInPlace( const Primitive *primitive0, const Primitive *primitive1, double x );
+		void interpolatePrimitiveVariable( const std::string &name, const Primitive *primitive0, const Primitive *primitive1, double x );
+
+		ConstSampledSceneInterfacePtr m_scene;
+		bool m_animatedTopology;
+		bool m_allPrimVarsAnimated;
+		std::vector<InternedString> m_animatedPrimVars;
+
+		struct Sample
+		{
+			Sample();
+			size_t index;
+			ConstObjectPtr object;
+			// Only computed when m_allPrimVarsAnimated is true.
+			MurmurHash topologyHash;
+		};
+		// The samples bracketing the last time read.
+		Sample m_window[2];
+
+		// The destination of the in-place interpolation.
+		PrimitivePtr m_result;
+		MurmurHash m_resultTopologyHash;
+
+};
+
+} // namespace IECore
+
+#endif // IECORE_OBJECTPLAYBACKREADER_H
@@ -74,8 +74,38 @@ class RadixSort
 		/// found in indices[3].
 		const std::vector<unsigned int> &operator()( const std::vector<int> &input );
 
+		//! @name In place sorting
+		/// These sort keys in place using a parallel least significant digit
+		/// radix sort, with per-thread histograms for each pass. Rather than
+		/// returning an index permutation they can move an array of values
+		/// along with the keys, so no separate pass is needed to apply the
+		/// permutation. The sort is stable. Supported key types are int,
+		/// unsigned int, float, int64_t, uint64_t and double, and negative
+		/// signed and floating point keys are ordered correctly, with -0.0
+		/// ordered before 0.0. The values
+		/// may be of any default constructible and copyable type, and there must
+		/// be exactly one value per key.
+		/// Passes in which every key has the same digit are skipped, so keys
+		/// using only their low bits, such as Morton codes, sort quicker.
+		//////////////////////////////////////////////////////////////
+		//@{
+		template<typename Key>
+		static void sort( std::vector<Key> &keys );
+		template<typename Key, typename Value>
+		static void sort( std::vector<Key> &keys, std::vector<Value> &values );
+		//@}
+
 	private:
 
+		template<typename Key>
+		struct KeyTraits;
+		template<typename Key>
+		class Histogram;
+		template<typename Key, typename Value>
+		class Scatter;
+		template<typename Key, typename Value>
+		static void sortInternal( Key *keys, Value *values, size_t size );
+
 		template<typename T>
 		bool createHistograms( const std::vector<T> &input );
 
@@ -96,4 +126,6 @@ class RadixSort
 
 } // namespace IECore
 
+#include "IECore/RadixSort.inl"
+
 #endif // IE_CORE_RADIXSORT_H
@@ -0,0 +1,292 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2014, Image Engine Design Inc. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+//     * Neither the name of Image Engine Design nor the names of any
+//       other contributors to this software may be used to endorse or
+//       promote products derived from this software without specific prior
+//       written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#ifndef IE_CORE_RADIXSORT_INL
+#define IE_CORE_RADIXSORT_INL
+
+#include <algorithm>
+#include <cstring>
+
+#include "tbb/parallel_for.h"
+
+#include "IECore/Exception.h"
+
+namespace IECore
+{
+
+// Maps each supported key type onto an unsigned integer of the same size,
+// whose unsigned ordering matches the ordering of the original keys.
+
+template<>
+struct RadixSort::KeyTraits<unsigned int>
+{
+	typedef uint32_t Bits;
+	static Bits bits( unsigned int k )
+	{
+		return k;
+	}
+};
+
+template<>
+struct RadixSort::KeyTraits<int>
+{
+	typedef uint32_t Bits;
+	static Bits bits( int k )
+	{
+		return Bits( k ) ^ 0x80000000u;
+	}
+};
+
+template<>
+struct RadixSort::KeyTraits<float>
+{
+	typedef uint32_t Bits;
+	static Bits bits( float k )
+	{
+		Bits b;
+		memcpy( &b, &k, sizeof( b ) );
+		// flip all the bits of negative values so that they order in reverse,
+		// and just the sign bit of positive values so they order after the
+		// negative ones.
+		return ( b & 0x80000000u ) ? ~b : b | 0x80000000u;
+	}
+};
+
+template<>
+struct RadixSort::KeyTraits<uint64_t>
+{
+	typedef uint64_t Bits;
+	static Bits bits( uint64_t k )
+	{
+		return k;
+	}
+};
+
+template<>
+struct RadixSort::KeyTraits<int64_t>
+{
+	typedef uint64_t Bits;
+	static Bits bits( int64_t k )
+	{
+		return Bits( k ) ^ ( Bits( 1 ) << 63 );
+	}
+};
+
+template<>
+struct RadixSort::KeyTraits<double>
+{
+	typedef uint64_t Bits;
+	static Bits bits( double k )
+	{
+		Bits b;
+		memcpy( &b, &k, sizeof( b ) );
+		const Bits signBit = Bits( 1 ) << 63;
+		return ( b & signBit ) ? ~b : b | signBit;
+	}
+};
+
+// Counts the occurrences of each digit within each block of keys.
+template<typename Key>
+class RadixSort::Histogram
+{
+
+	public :
+
+		Histogram( const Key *keys, size_t size, size_t blockSize, unsigned shift, size_t *counts )
+			:	m_keys( keys ), m_size( size ), m_blockSize( blockSize ), m_shift( shift ), m_counts( counts )
+		{
+		}
+
+		void operator()( const tbb::blocked_range<size_t> &blocks ) const
+		{
+			for( size_t b = blocks.begin(); b != blocks.end(); ++b )
+			{
+				size_t *counts = m_counts + b * 256;
+				std::fill( counts, counts + 256, 0 );
+				const size_t end = std::min( ( b + 1 ) * m_blockSize, m_size );
+				for( size_t i = b * m_blockSize; i < end; ++i )
+				{
+					counts[( KeyTraits<Key>::bits( m_keys[i] ) >> m_shift ) & 0xff]++;
+				}
+			}
+		}
+
+	private :
+
+		const Key *m_keys;
+		size_t m_size;
+		size_t m_blockSize;
+		unsigned m_shift;
+		size_t *m_counts;
+
+};
+
+// Moves each block of keys and values to their positions in the destination
+// arrays, given the offset at which each block starts writing each digit.
+template<typename Key, typename Value>
+class RadixSort::Scatter
+{
+
+	public :
+
+		Scatter( const Key *srcKeys, const Value *srcValues, Key *dstKeys, Value *dstValues, size_t size, size_t blockSize, unsigned shift, size_t *offsets )
+			:	m_srcKeys( srcKeys ), m_srcValues( srcValues ), m_dstKeys( dstKeys ), m_dstValues( dstValues ),
+				m_size( size ), m_blockSize( blockSize ), m_shift( shift ), m_offsets( offsets )
+		{
+		}
+
+		void operator()( const tbb::blocked_range<size_t> &blocks ) const
+		{
+			for( size_t b = blocks.begin(); b != blocks.end(); ++b )
+			{
+				size_t *offsets = m_offsets + b * 256;
+				const size_t end = std::min( ( b + 1 ) * m_blockSize, m_size );
+				for( size_t i = b * m_blockSize; i < end; ++i )
+				{
+					const size_t position = offsets[( KeyTraits<Key>::bits( m_srcKeys[i] ) >> m_shift ) & 0xff]++;
+					m_dstKeys[position] = m_srcKeys[i];
+					if( m_srcValues )
+					{
+						m_dstValues[position] = m_srcValues[i];
+					}
+				}
+			}
+		}
+
+	private :
+
+		const Key *m_srcKeys;
+		const Value *m_srcValues;
+		Key *m_dstKeys;
+		Value *m_dstValues;
+		size_t m_size;
+		size_t m_blockSize;
+		unsigned m_shift;
+		size_t *m_offsets;
+
+};
+
+template<typename Key, typename Value>
+void RadixSort::sortInternal( Key *keys, Value *values, size_t size )
+{
+	// each block is processed serially by a single task, and the blocks write
+	// their elements for each digit in order, which keeps the sort stable.
+	const size_t blockSize = 65536;
+	const size_t numBlocks = ( size + blockSize - 1 ) / blockSize;
+
+	std::vector<Key> tmpKeys( size );
+	std::vector<Value> tmpValues( values ? size : 0 );
+	std::vector<size_t> counts( numBlocks * 256 );
+
+	Key *srcKeys = keys;
+	Key *dstKeys = &tmpKeys[0];
+	Value *srcValues = values;
+	Value *dstValues = values ? &tmpValues[0] : 0;
+
+	for( unsigned shift = 0; shift < sizeof( Key ) * 8; shift += 8 )
+	{
+		tbb::parallel_for(
+			tbb::blocked_range<size_t>( 0, numBlocks, 1 ),
+			Histogram<Key>( srcKeys, size, blockSize, shift, &counts[0] )
+		);
+
+		// convert the counts into the offset at which each block starts
+		// writing each digit. if every key has the same digit then the
+		// pass wouldn't change anything, so we skip it.
+		bool skip = false;
+		size_t offset = 0;
+		for( size_t digit = 0; digit < 256 && !skip; ++digit )
+		{
+			const size_t digitBegin = offset;
+			for( size_t b = 0; b < numBlocks; ++b )
+			{
+				size_t &c = counts[b * 256 + digit];
+				const size_t count = c;
+				c = offset;
+				offset += count;
+			}
+			skip = offset - digitBegin == size;
+		}
+
+		if( skip )
+		{
+			continue;
+		}
+
+		tbb::parallel_for(
+			tbb::blocked_range<size_t>( 0, numBlocks, 1 ),
+			Scatter<Key, Value>( srcKeys, srcValues, dstKeys, dstValues, size, blockSize, shift, &counts[0] )
+		);
+
+		std::swap( srcKeys, dstKeys );
+		std::swap( srcValues, dstValues );
+	}
+
+	if( srcKeys != keys )
+	{
+		std::copy( srcKeys, srcKeys + size, keys );
+		if( values )
+		{
+			std::copy( srcValues, srcValues + size, values );
+		}
+	}
+}
+
+template<typename Key>
+void RadixSort::sort( std::vector<Key> &keys )
+{
+	if( keys.size() < 2 )
+	{
+		return;
+	}
+	sortInternal<Key, Key>( &keys[0], 0, keys.size() );
+}
+
+template<typename Key, typename Value>
+void RadixSort::sort( std::vector<Key> &keys, std::vector<Value> &values )
+{
+	if( keys.size() != values.size() )
+	{
+		throw InvalidArgumentException( "RadixSort::sort : keys and values must be the same size" );
+	}
+	if( keys.size() < 2 )
+	{
+		return;
+	}
+	sortInternal<Key, Value>( &keys[0], &values[0], keys.size() );
+}
+
+} // namespace IECore
+
+#endif // IE_CORE_RADIXSORT_INL
@@ -48,6 +48,10 @@ IE_CORE_FORWARDDECLARE( SceneCache );
 /// The destruction of the root scene will trigger the recursive computation of the bounding boxes for all the
 /// locations that no bounds were written. It will also store (without duplication) all the
 /// sample times used by objects, transforms, bounds and attributes.
+/// Different locations may be written concurrently from multiple threads, as long as each location is
+/// only used by one thread at a time. This lets independent subtrees be built, serialised and compressed
+/// in parallel, with only the allocation of space in the file being serialised. The file layout (sample
+/// time ids, block positions) then depends on thread scheduling, but the scene read back is the same.
 /// \ingroup ioGroup
 class SceneCache : public SampledSceneInterface
 {
@@ -133,14 +137,88 @@ class SceneCache : public SampledSceneInterface
 		
 		virtual void hash( HashType hashType, double time, MurmurHash &h ) const;
 
+		/// Reimplemented to use the index of tagged locations stored at the root of
+		/// the file, falling back to a traversal for files which don't have one. The
+		/// "ObjectType:" tags written automatically with each object aren't indexed,
+		/// so they are always found by traversal. Only available in Read mode.
+		virtual void taggedPaths( const Name &tag, std::vector<Path> &paths ) const;
+
+		/// Reimplemented to resolve the locations in path order, so that each
+		/// shared ancestor is visited once, and to read their data in parallel.
+		/// Only available in Read mode.
+		virtual void readBounds( const std::vector<Path> &paths, double time, std::vector<Imath::Box3d> &bounds ) const;
+		virtual void readTransformsAsMatrices( const std::vector<Path> &paths, double time, std::vector<Imath::M44d> &transforms ) const;
+		virtual void readObjects( const std::vector<Path> &paths, double time, std::vector<ConstObjectPtr> &objects ) const;
+
 		/// tells you if this scene cache is read only or writable:
 		bool readOnly() const;
+
+		/// Flags used by prefetch() to specify which data should be loaded for each location.
+		enum PrefetchData {
+			PrefetchBound = 1,
+			PrefetchTransform = 2,
+			PrefetchAttributes = 4,
+			PrefetchObject = 8,
+			PrefetchAll = PrefetchBound | PrefetchTransform | PrefetchAttributes | PrefetchObject
+		};
+
+		/// Finalises this location and everything below it, computing their bounds, writing any
+		/// pending data to the file and releasing them from memory. The parent location accumulates
+		/// the bounds straight away, so a large scene can be written in a streaming fashion, finalising
+		/// each subtree once it is complete, with memory usage that depends on the locations which are
+		/// still open rather than on the size of the whole scene. Neither this location nor any location
+		/// below it can be modified afterwards, and handles to the locations below it must not be used.
+		/// Tags must be written to the ancestors before this is called, so they are recorded as
+		/// ancestor tags - writing tags to an ancestor afterwards throws an Exception. Only available
+		/// in Write mode, and not at the root, which is finalised when it is destroyed.
+		void finalise();
+
+		IE_CORE_FORWARDDECLARE( Prefetch );
+
+		/// Starts loading, from TBB tasks running in the background, the data specified by the PrefetchData
+		/// flags for the given paths and all the locations below them, so that later reads at the given time
+		/// are served from the caches shared by all the locations of this file. The paths are absolute, as in scene(),
+		/// and the ones missing from the file are ignored. Returns immediately with a handle that can be used
+		/// to wait for completion. Read errors are reported by Prefetch::wait(), or as error messages if the
+		/// prefetch isn't waited for. Only available in Read mode.
+		PrefetchPtr prefetch( const std::vector<Path> &paths, double time, int what = PrefetchAll ) const;
 		
 		// The attribute names used to mark animated topology and primitive variables
 		// when SceneCache objects are Primitives.
 		static const Name &animatedObjectTopologyAttribute;
 		static const Name &animatedObjectPrimVarsAttribute;
 
+		//! @name Level of detail proxies
+		/// Decimated proxies of the objects may be stored alongside them, so that clients
+		/// such as viewers and culling tools can load a representation with an appropriate
+		/// amount of detail rather than choosing between the full object and its bound.
+		/// They are stored apart from the attributes, so they don't appear in attributeNames()
+		/// and don't affect the attributes hash.
+		/////////////////////////////////////////////////////////////////////////////
+		//@{
+		/// Sets the vertex budgets used to generate proxies for the objects subsequently written
+		/// to this location, and to locations created below it afterwards. Each budget defines one
+		/// level, generated with clusterDecimate() from every object sample, and levels are ordered
+		/// from the largest budget to the smallest. Only MeshPrimitives and PointsPrimitives get
+		/// proxies, and levels whose budget isn't smaller than the vertex count of the first object
+		/// sample are omitted. Only available in Write mode.
+		void setProxyVertexBudgets( const std::vector<size_t> &budgets );
+		/// Fills errors with the object space error of each proxy level stored for the object at
+		/// this location, finest first - the greatest distance, over all samples, between a vertex
+		/// of the object and the proxy vertex which replaced it. Empty if there are no proxies.
+		/// Only available in Read mode.
+		void proxyErrors( std::vector<float> &errors ) const;
+		/// Reads the proxy for the given level, interpolated as for readObject(). Throws if
+		/// there is no such level. Only available in Read mode.
+		ConstObjectPtr readProxy( size_t level, double time ) const;
+		/// Returns the coarsest proxy whose error, converted to pixels by multiplying by pixelsPerUnit,
+		/// is no greater than maxScreenError, or the object itself when no proxy is accurate enough.
+		/// For a perspective camera with horizontal field of view fov and a resolution of width pixels,
+		/// pixelsPerUnit at distance d from the camera is width / ( 2 * d * tan( fov / 2 ) ).
+		/// Only available in Read mode.
+		ConstObjectPtr readObjectProxy( double time, float maxScreenError, float pixelsPerUnit ) const;
+		//@}
+
 	protected:
 	
 		IE_CORE_FORWARDDECLARE( Implementation );
@@ -162,6 +240,32 @@ class SceneCache : public SampledSceneInterface
 	
 };
 
+/// Handle returned by SceneCache::prefetch(), tracking the background tasks that are loading the data.
+/// Destroying the handle cancels the tasks which haven't started yet, without waiting for the ones
+/// which are running.
+class SceneCache::Prefetch : public RefCounted
+{
+	public :
+
+		virtual ~Prefetch();
+
+		/// Blocks until all the data requested by the prefetch is loaded, and then
+		/// throws if any of it failed to load.
+		void wait();
+		/// Returns true if all the data requested by the prefetch is loaded, without blocking.
+		bool done() const;
+
+	private :
+
+		friend class SceneCache;
+
+		Prefetch();
+
+		class Implementation;
+		Implementation *m_implementation;
+
+};
+
 } // namespace IECore
 
 #endif // IECORE_SCENECACHE_H
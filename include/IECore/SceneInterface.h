@@ -242,6 +242,28 @@ class SceneInterface : public RunTimeTyped
 		/// Returns a const interface for querying the scene at the given path (full path). 
 		virtual ConstSceneInterfacePtr scene( const Path &path, MissingBehaviour missingBehaviour = ThrowIfMissing ) const = 0;
 
+		/*
+		 * Batch queries
+		 */
+
+		/// Reads the bounds of many locations at once, filling bounds with one
+		/// entry per path. The paths are absolute, as for scene(), and an exception
+		/// is thrown if any of them is missing. The default implementation simply
+		/// calls scene() and readBound() for each path, but derived classes may
+		/// reimplement it to avoid the per-location overhead and to read in parallel.
+		virtual void readBounds( const std::vector<Path> &paths, double time, std::vector<Imath::Box3d> &bounds ) const;
+		/// As for readBounds(), but reading the transforms as matrices.
+		virtual void readTransformsAsMatrices( const std::vector<Path> &paths, double time, std::vector<Imath::M44d> &transforms ) const;
+		/// As for readBounds(), but reading the objects. Locations without
+		/// an object result in a null entry.
+		virtual void readObjects( const std::vector<Path> &paths, double time, std::vector<ConstObjectPtr> &objects ) const;
+		/// Fills paths with the absolute paths of all the locations from this one
+		/// down which have the given tag stored locally, suitable for passing to the
+		/// batch reading methods above. The default implementation traverses the
+		/// hierarchy, using hasTag() with DescendantTag to skip branches which can't
+		/// contain the tag.
+		virtual void taggedPaths( const Name &tag, std::vector<Path> &paths ) const;
+
 		/*
 		 * Hash
 		 */
@@ -45,12 +45,16 @@
 #include "IndexedIO.h"
 #include "Exception.h"
 #include "VectorTypedData.h"
+#include "MappedVectorData.h"
+#include "BlobStore.h"
 
 namespace IECore
 {
 /// Abstract base class implementation of IndexedIO which operates with a stream file handle.
 /// It handles data instancing transparently for compact file sizes.
-/// Read operations are thread safe on read-only opened files.
+/// Read operations are thread safe on read-only opened files, and data reads
+/// from derived classes which implement StreamFile::readAt() without locking
+/// can run fully in parallel.
 /// \ingroup ioGroup
 class StreamIndexedIO : public IndexedIO
 {
@@ -58,6 +62,20 @@ class StreamIndexedIO : public IndexedIO
 
 		IE_CORE_DECLARERUNTIMETYPED( StreamIndexedIO, IndexedIO );
 
+		/// Compression codecs for array data blocks. The codec is recorded with each
+		/// entry, so files may mix compressed and uncompressed entries and are always
+		/// read transparently. The index itself is always compressed.
+		enum DataCompression
+		{
+			/// Data is stored raw. This is the default, and is required for readMapped().
+			Uncompressed = 0,
+			/// Best compression ratio, at the expense of speed.
+			GzipCompression = 1,
+			/// Fastest compression level of the zlib codec, intended to keep reading
+			/// faster than the I/O it saves.
+			FastCompression = 2
+		};
+
 		virtual ~StreamIndexedIO();
 
 		virtual IndexedIO::OpenMode openMode() const;
@@ -94,6 +112,24 @@ class StreamIndexedIO : public IndexedIO
 
 		void commit();
 
+		/// Sets the compression applied to numeric array data written from now on, by this
+		/// and all other instances accessing the same file. When shuffle is true, the bytes of
+		/// multi-byte elements are reordered before compression, which typically improves the
+		/// compression of floating point data significantly. Small arrays, and arrays which don't
+		/// get smaller, are always stored uncompressed.
+		void setDataCompression( DataCompression compression, bool shuffle = true );
+		DataCompression getDataCompression() const;
+
+		/// Makes array data blocks of at least minSize bytes (after compression, if any) written
+		/// from now on go to the given BlobStore, with the file only holding references to them.
+		/// Many files can share a store, so that data common to them is only stored once. The
+		/// store is recorded in the file, and used transparently when reading it, and by
+		/// readMapped() which can then map the data from the store's pack. A file can only refer
+		/// to a single store, so an exception is thrown if a different one was already set.
+		void setBlobStore( BlobStorePtr store, size_t minSize = 4096 );
+		/// Returns the BlobStore used by the file, or 0 if there is none.
+		BlobStore *getBlobStore() const;
+
 		void write(const IndexedIO::EntryID &name, const float *x, unsigned long arrayLength);
 		void write(const IndexedIO::EntryID &name, const double *x, unsigned long arrayLength);
 		void write(const IndexedIO::EntryID &name, const half *x, unsigned long arrayLength);
@@ -146,6 +182,16 @@ class StreamIndexedIO : public IndexedIO
 		void read(const IndexedIO::EntryID &name, short &x) const;
 		void read(const IndexedIO::EntryID &name, unsigned short &x) const;
 
+		/// Returns a view of the named array entry directly in the file's memory
+		/// mapping, without any allocation or copying. This is only possible for files
+		/// opened read-only by a StreamFile that provides a mapping (see StreamFile::mappedData()),
+		/// on little endian platforms, and for entries whose data is suitably aligned.
+		/// Returns 0 if these conditions aren't met, in which case the regular read()
+		/// methods must be used instead. Throws if the entry doesn't exist or doesn't
+		/// hold an array of T. T may be any of the numeric array types supported by read().
+		template<typename T>
+		typename MappedVectorData<T>::Ptr readMapped( const IndexedIO::EntryID &name ) const;
+
 	protected:
 
 		class Index;
@@ -166,11 +212,29 @@ class StreamIndexedIO : public IndexedIO
 				void seekp( size_t pos, std::ios_base::seekdir dir );
 				void read( char *buffer, size_t size );
 				void write( const char *buffer, size_t size );
+
+				/// Reads size bytes starting at the absolute position pos. This function is
+				/// thread safe and doesn't move the get pointer used by seekg() and read().
+				/// The default implementation serialises access using mutex(), but derived
+				/// classes may override it to provide concurrent reads without locking
+				/// (using positional reads or a memory map, for instance).
+				virtual void readAt( char *buffer, size_t size, Imf::Int64 pos );
+
+				/// Returns a pointer to size bytes starting at the absolute position pos
+				/// in a read-only memory mapping of the file, or 0 if no mapping is available.
+				/// The pointer remains valid for the lifetime of the StreamFile. The default
+				/// implementation returns 0.
+				virtual const char *mappedData( Imf::Int64 pos, size_t size ) const;
 				Imf::Int64 tellg();
 				Imf::Int64 tellp();
 
 				IndexedIO::OpenMode openMode() const;
 
+				/// Returns the absolute path of the directory holding the file, against which
+				/// relative paths stored in the file are resolved. The default implementation
+				/// returns an empty string, in which case such paths are stored as absolute paths.
+				virtual std::string directory() const;
+
 				// returns a read lock, when thread-safety is required.
 				typedef tbb::recursive_mutex Mutex;
 				typedef Mutex::scoped_lock MutexLock;
@@ -44,6 +44,15 @@
 namespace IECore
 {
 
+/// Finds all pairs of intersecting bounds in a range, by sorting the bound
+/// endpoints along one axis and sweeping through them, testing each bound only
+/// against those whose intervals are open on that axis. The sweep is divided
+/// into slabs along the sort axis which are processed in parallel, but the
+/// Callback is always invoked serially, so it need not be threadsafe.
+///
+/// The sorted endpoints are retained between calls, so that incrementalIntersectingBounds()
+/// can exploit the temporal coherence of animated bounds, re-sorting the nearly
+/// sorted endpoints with an insertion sort rather than sorting from scratch.
 /// \ingroup mathGroup
 template<typename BoundIterator, template<typename> class CB>
 class SweepAndPrune
@@ -67,13 +76,57 @@ class SweepAndPrune
 		SweepAndPrune();
 		virtual ~SweepAndPrune();
 
+		/// Calls cb( b1, b2 ) once for each pair of intersecting bounds in the range,
+		/// sorting the endpoints from scratch.
 		void intersectingBounds( BoundIterator first, BoundIterator last, Callback &cb, AxisOrder axisOrder = XZY );
+		/// As above, but reuses the endpoints sorted by the previous call, updating
+		/// them with the current bound values and re-sorting them with an insertion
+		/// sort. This is much faster when the bounds have moved only a little since
+		/// the previous call, as they do from frame to frame in an animation. The range
+		/// must refer to the same bounds as the previous call - if the start of the
+		/// range, the number of bounds or the axis order differ then a full sort is
+		/// performed instead.
+		void incrementalIntersectingBounds( BoundIterator first, BoundIterator last, Callback &cb, AxisOrder axisOrder = XZY );
+		/// Discards the endpoints retained from the previous call.
+		void clear();
 
 	protected:
 
-		inline bool axisIntersects( const Bound &b1, const Bound &b2, char axis );
+		static inline bool axisIntersects( const Bound &b1, const Bound &b2, char axis );
 
+		/// \todo Remove. This is no longer used, as the endpoints are sorted
+		/// with RadixSort::sort(), but is kept for source compatibility with
+		/// subclasses.
 		RadixSort m_radixSort;
+
+	private :
+
+		/// An endpoint of a bound on the sort axis. The id is twice the index of
+		/// the bound, plus one for the maximum endpoint.
+		struct Endpoint
+		{
+			float value;
+			unsigned int id;
+
+			bool operator < ( const Endpoint &other ) const;
+		};
+
+		typedef std::vector<Endpoint> EndpointVector;
+		typedef std::vector<BoundIterator> BoundVector;
+		typedef std::vector<std::pair<unsigned int, unsigned int> > PairVector;
+
+		class SweepSlab;
+
+		static void axes( AxisOrder axisOrder, char result[3] );
+
+		void fullSort( BoundIterator first, BoundIterator last, const char axes[3] );
+		void insertionSort();
+		void sweep( Callback &cb, const char axes[3] );
+
+		BoundIterator m_first;
+		AxisOrder m_axisOrder;
+		BoundVector m_bounds;
+		EndpointVector m_endpoints;
 };
 
 } // namespace IECore
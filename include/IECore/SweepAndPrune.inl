@@ -42,6 +42,9 @@
 
 #include "boost/static_assert.hpp"
 
+#include "tbb/parallel_for.h"
+#include "tbb/blocked_range.h"
+
 #include "IECore/BoxTraits.h"
 #include "IECore/VectorOps.h"
 
@@ -50,6 +53,7 @@ namespace IECore
 
 template<typename BoundIterator, template<typename> class CB>
 SweepAndPrune<BoundIterator, CB>::SweepAndPrune( )
+	:	m_axisOrder( XZY )
 {
 }
 
@@ -72,106 +76,278 @@ bool SweepAndPrune<BoundIterator, CB>::axisIntersects( const Bound &b0, const Bo
 }
 
 template<typename BoundIterator, template<typename> class CB>
-void SweepAndPrune<BoundIterator, CB>::intersectingBounds( BoundIterator first, BoundIterator last, typename SweepAndPrune<BoundIterator, CB>::Callback &cb, AxisOrder axisOrder )
+bool SweepAndPrune<BoundIterator, CB>::Endpoint::operator < ( const Endpoint &other ) const
 {
-	unsigned long numBounds = std::distance( first, last );
+	// minimum endpoints sort before coincident maximum endpoints, so that
+	// touching bounds are reported as intersecting, just as Box::intersects()
+	// considers them to be.
+	return value < other.value || ( value == other.value && ( id & 1 ) < ( other.id & 1 ) );
+}
 
-	/// Can't radix sort more than this!
-	assert( numBounds <= std::numeric_limits< uint32_t >::max() );
+template<typename BoundIterator, template<typename> class CB>
+class SweepAndPrune<BoundIterator, CB>::SweepSlab
+{
 
-	if (! numBounds )
-	{
-		return;
-	}
+	public :
+
+		SweepSlab( const BoundVector &bounds, const EndpointVector &endpoints, const std::vector<unsigned int> &ranks, const std::vector<std::vector<unsigned int> > &slabActive, size_t slabSize, const char axes[3], std::vector<PairVector> &slabPairs )
+			:	m_bounds( bounds ), m_endpoints( endpoints ), m_ranks( ranks ), m_slabActive( slabActive ), m_slabSize( slabSize ), m_slabPairs( slabPairs )
+		{
+			m_axes[1] = axes[1];
+			m_axes[2] = axes[2];
+		}
+
+		void operator()( const tbb::blocked_range<size_t> &r ) const
+		{
+			for( size_t slab = r.begin(); slab != r.end(); ++slab )
+			{
+				std::vector<unsigned int> active = m_slabActive[slab];
+				PairVector &pairs = m_slabPairs[slab];
 
-	char axes[3] = { 0, 1, 2 };
+				const size_t begin = slab * m_slabSize;
+				const size_t end = std::min( begin + m_slabSize, m_endpoints.size() );
+				for( size_t i = begin; i < end; ++i )
+				{
+					const unsigned int id = m_endpoints[i].id;
+					if( ( id & 1 ) || m_ranks[id+1] < i )
+					{
+						// maximum endpoints are removed from the active set lazily
+						// below, and a bound whose maximum sorts before its minimum
+						// is empty and can't intersect anything.
+						continue;
+					}
 
+					const unsigned int index0 = id >> 1;
+					const Bound &bound0 = *m_bounds[index0];
+
+					size_t j = 0;
+					while( j < active.size() )
+					{
+						const unsigned int index1 = active[j];
+						if( m_ranks[index1 * 2 + 1] < i )
+						{
+							active[j] = active.back();
+							active.pop_back();
+							continue;
+						}
+
+						const Bound &bound1 = *m_bounds[index1];
+						if( axisIntersects( bound0, bound1, m_axes[1] ) && axisIntersects( bound0, bound1, m_axes[2] ) )
+						{
+							assert( bound0.intersects( bound1 ) );
+							pairs.push_back( typename PairVector::value_type( index0, index1 ) );
+						}
+						else
+						{
+							assert( !bound0.intersects( bound1 ) );
+						}
+						++j;
+					}
+
+					active.push_back( index0 );
+				}
+			}
+		}
+
+	private :
+
+		const BoundVector &m_bounds;
+		const EndpointVector &m_endpoints;
+		const std::vector<unsigned int> &m_ranks;
+		const std::vector<std::vector<unsigned int> > &m_slabActive;
+		size_t m_slabSize;
+		char m_axes[3];
+		std::vector<PairVector> &m_slabPairs;
+
+};
+
+template<typename BoundIterator, template<typename> class CB>
+void SweepAndPrune<BoundIterator, CB>::axes( AxisOrder axisOrder, char result[3] )
+{
 	switch (axisOrder)
 	{
 		case XYZ :
-			axes[0] = 0; axes[1] = 1; axes[2] = 2; break;
+			result[0] = 0; result[1] = 1; result[2] = 2; break;
 		case XZY :
-			axes[0] = 0; axes[1] = 2; axes[2] = 1; break;
+			result[0] = 0; result[1] = 2; result[2] = 1; break;
 		case YXZ :
-			axes[0] = 1; axes[1] = 0; axes[2] = 2; break;
+			result[0] = 1; result[1] = 0; result[2] = 2; break;
 		case YZX :
-			axes[0] = 1; axes[1] = 2; axes[2] = 0; break;
+			result[0] = 1; result[1] = 2; result[2] = 0; break;
 		case ZXY :
-			axes[0] = 2; axes[1] = 0; axes[2] = 1; break;
+			result[0] = 2; result[1] = 0; result[2] = 1; break;
 		case ZYX :
-			axes[0] = 2; axes[1] = 1; axes[2] = 0; break;
+			result[0] = 2; result[1] = 1; result[2] = 0; break;
 		default:
 			assert( false );
+			result[0] = 0; result[1] = 2; result[2] = 1;
 	}
 
-	assert( axes[0] + axes[1] + axes[2] == 3 );
+	assert( result[0] + result[1] + result[2] == 3 );
+}
 
-	typedef std::pair< bool, BoundIterator> IntervalId;
+template<typename BoundIterator, template<typename> class CB>
+void SweepAndPrune<BoundIterator, CB>::fullSort( BoundIterator first, BoundIterator last, const char axes[3] )
+{
+	m_bounds.clear();
+	m_endpoints.clear();
 
-	std::vector<IntervalId> intervalIds;
 	std::vector<float> boundExtents;
-	boundExtents.reserve( numBounds * 2 );
-	intervalIds.reserve( numBounds * 2 );
+	std::vector<unsigned int> ids;
 
+	unsigned int id = 0;
 	for ( BoundIterator it = first; it != last; ++it )
 	{
+		m_bounds.push_back( it );
+
 		boundExtents.push_back( vecGet( BoxTraits<Bound>::min(*it), axes[0] ) );
-		intervalIds.push_back( IntervalId( true, it  ) );
+		ids.push_back( id++ );
 
 		boundExtents.push_back( vecGet( BoxTraits<Bound>::max(*it), axes[0] ) );
-		intervalIds.push_back( IntervalId( false, it ) );
+		ids.push_back( id++ );
 	}
 
-	assert( boundExtents.size() == intervalIds.size() );
+	RadixSort::sort( boundExtents, ids );
 
-	const std::vector<unsigned int> &sortedIndices = m_radixSort( boundExtents );
+	m_endpoints.resize( ids.size() );
+	for( size_t i = 0, e = ids.size(); i < e; ++i )
+	{
+		m_endpoints[i].value = boundExtents[i];
+		m_endpoints[i].id = ids[i];
+	}
 
-	typedef std::vector<BoundIterator> ActiveSet;
-	ActiveSet activeSet;
+	// the radix sort leaves coincident endpoints in their original order,
+	// so we must still put minimums before maximums.
+	insertionSort();
+}
 
-	for ( std::vector<unsigned int>::const_iterator st = sortedIndices.begin(); st != sortedIndices.end(); ++st )
+template<typename BoundIterator, template<typename> class CB>
+void SweepAndPrune<BoundIterator, CB>::insertionSort()
+{
+	for( size_t i = 1, e = m_endpoints.size(); i < e; ++i )
 	{
-		const IntervalId &id = intervalIds[ *st ];
-
-		if ( id.first )
+		const Endpoint endpoint = m_endpoints[i];
+		size_t j = i;
+		while( j > 0 && endpoint < m_endpoints[j-1] )
 		{
-			const Bound& bound0 = *id.second;
+			m_endpoints[j] = m_endpoints[j-1];
+			--j;
+		}
+		m_endpoints[j] = endpoint;
+	}
+}
 
-			for ( typename ActiveSet::const_iterator it = activeSet.begin(); it != activeSet.end(); it++ )
-			{
-				assert( id.second != *it );
+template<typename BoundIterator, template<typename> class CB>
+void SweepAndPrune<BoundIterator, CB>::sweep( Callback &cb, const char axes[3] )
+{
+	const size_t numEndpoints = m_endpoints.size();
+	const size_t numSlabs = std::min<size_t>( 256, ( numEndpoints + 4095 ) / 4096 );
+	const size_t slabSize = ( numEndpoints + numSlabs - 1 ) / numSlabs;
 
-				if ( axisIntersects( bound0, **it, axes[1] ) )
-				{
-					if ( axisIntersects( bound0, **it, axes[2] ) )
-					{
-						assert( bound0.intersects( **it ) );
+	// the position of each endpoint in sorted order, indexed by id
+	std::vector<unsigned int> ranks( numEndpoints );
+	for( size_t i = 0; i < numEndpoints; ++i )
+	{
+		ranks[m_endpoints[i].id] = i;
+	}
 
-						cb( id.second, *it );
-					}
-					else
-					{
-						assert( !bound0.intersects( **it ) );
-					}
-				}
-				else
+	// find the bounds which are open at the start of each slab, so that
+	// the slabs can then be swept independently.
+	std::vector<std::vector<unsigned int> > slabActive( numSlabs );
+	std::vector<unsigned int> active;
+	for( size_t i = 0; i < numEndpoints; ++i )
+	{
+		if( i % slabSize == 0 )
+		{
+			std::vector<unsigned int> &open = slabActive[i / slabSize];
+			open.reserve( active.size() );
+			for( std::vector<unsigned int>::const_iterator it = active.begin(); it != active.end(); ++it )
+			{
+				if( ranks[*it * 2 + 1] > i )
 				{
-					assert( !bound0.intersects( **it ) );
+					open.push_back( *it );
 				}
 			}
+			active = open;
+		}
 
-			activeSet.push_back( id.second );
+		const unsigned int id = m_endpoints[i].id;
+		if( !( id & 1 ) && ranks[id+1] > i )
+		{
+			active.push_back( id >> 1 );
 		}
-		else
+	}
+
+	std::vector<PairVector> slabPairs( numSlabs );
+	SweepSlab sweepSlab( m_bounds, m_endpoints, ranks, slabActive, slabSize, axes, slabPairs );
+	tbb::parallel_for( tbb::blocked_range<size_t>( 0, numSlabs ), sweepSlab );
+
+	// the callback needn't be threadsafe, so we call it serially now the
+	// expensive part is done.
+	for( typename std::vector<PairVector>::const_iterator it = slabPairs.begin(); it != slabPairs.end(); ++it )
+	{
+		for( typename PairVector::const_iterator pIt = it->begin(); pIt != it->end(); ++pIt )
 		{
-			assert( activeSet.size() );
-			typename ActiveSet::iterator it = std::find ( activeSet.begin(), activeSet.end(), id.second );
-			assert( it != activeSet.end() );
-			activeSet.erase( it );
+			cb( m_bounds[pIt->first], m_bounds[pIt->second] );
 		}
 	}
 }
 
+template<typename BoundIterator, template<typename> class CB>
+void SweepAndPrune<BoundIterator, CB>::intersectingBounds( BoundIterator first, BoundIterator last, typename SweepAndPrune<BoundIterator, CB>::Callback &cb, AxisOrder axisOrder )
+{
+	unsigned long numBounds = std::distance( first, last );
+
+	/// Can't radix sort more than this!
+	assert( numBounds <= std::numeric_limits< uint32_t >::max() / 2 );
+
+	if (! numBounds )
+	{
+		clear();
+		return;
+	}
+
+	char a[3];
+	axes( axisOrder, a );
+
+	fullSort( first, last, a );
+	m_first = first;
+	m_axisOrder = axisOrder;
+
+	sweep( cb, a );
+}
+
+template<typename BoundIterator, template<typename> class CB>
+void SweepAndPrune<BoundIterator, CB>::incrementalIntersectingBounds( BoundIterator first, BoundIterator last, typename SweepAndPrune<BoundIterator, CB>::Callback &cb, AxisOrder axisOrder )
+{
+	unsigned long numBounds = std::distance( first, last );
+	if( !numBounds || numBounds != m_bounds.size() || first != m_first || axisOrder != m_axisOrder )
+	{
+		intersectingBounds( first, last, cb, axisOrder );
+		return;
+	}
+
+	char a[3];
+	axes( axisOrder, a );
+
+	for( typename EndpointVector::iterator it = m_endpoints.begin(), eIt = m_endpoints.end(); it != eIt; ++it )
+	{
+		const Bound &bound = *m_bounds[it->id >> 1];
+		it->value = vecGet( ( it->id & 1 ) ? BoxTraits<Bound>::max( bound ) : BoxTraits<Bound>::min( bound ), a[0] );
+	}
+
+	insertionSort();
+
+	sweep( cb, a );
+}
+
+template<typename BoundIterator, template<typename> class CB>
+void SweepAndPrune<BoundIterator, CB>::clear()
+{
+	BoundVector().swap( m_bounds );
+	EndpointVector().swap( m_endpoints );
+}
+
 } // namespace IECore
 
 
@@ -0,0 +1,135 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2014, Image Engine Design Inc. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+//     * Neither the name of Image Engine Design nor the names of any
+//       other contributors to this software may be used to endorse or
+//       promote products derived from this software without specific prior
+//       written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#ifndef IECORE_TRIANGLEBVH_H
+#define IECORE_TRIANGLEBVH_H
+
+#include <vector>
+
+#include "boost/noncopyable.hpp"
+
+#include "OpenEXR/ImathVec.h"
+#include "OpenEXR/ImathBox.h"
+
+namespace IECore
+{
+
+/// The TriangleBVH class provides accelerated ray intersection and closest point
+/// queries on a triangle mesh. It is a bounding volume hierarchy built using the
+/// surface area heuristic, and stores its nodes and a copy of the triangles in
+/// depth first order so that traversals touch memory as coherently as possible.
+/// For ray queries it is typically very much faster than a BoundedKDTree of the
+/// triangle bounds.
+/// \ingroup mathGroup
+class TriangleBVH : public boost::noncopyable
+{
+
+	public :
+
+		/// Describes the result of a query.
+		struct Hit
+		{
+			/// The index of the triangle in the original vertexIds.
+			unsigned triangleIndex;
+			/// The barycentric coordinates of the point on the triangle.
+			Imath::V3f barycentricCoordinates;
+			/// The distance from the ray origin or query point.
+			float distance;
+		};
+
+		/// Builds a hierarchy for the triangles specified by vertexIds, with
+		/// every 3 vertex ids defining a triangle. Unlike BoundedKDTree, the
+		/// hierarchy takes a copy of the data it needs, so the arguments need
+		/// not remain valid after construction.
+		TriangleBVH( const std::vector<Imath::V3f> &points, const std::vector<int> &vertexIds, int maxLeafSize = 4 );
+
+		/// Finds the nearest intersection of a ray with the triangles, ignoring
+		/// intersections further than maxDistance from the origin. The direction
+		/// must be normalised. Returns true
+		/// if an intersection was found, filling in hit appropriately.
+		/// \threading May be called by multiple concurrent threads.
+		bool intersect( const Imath::V3f &origin, const Imath::V3f &direction, float maxDistance, Hit &hit ) const;
+		/// Appends all intersections closer than maxDistance to hits, in no
+		/// particular order, returning the number appended.
+		/// \threading May be called by multiple concurrent threads provided they each use a different vector for the result.
+		unsigned intersectAll( const Imath::V3f &origin, const Imath::V3f &direction, float maxDistance, std::vector<Hit> &hits ) const;
+		/// Finds the closest point on the triangles to p. Returns false only
+		/// if there are no triangles.
+		/// \threading May be called by multiple concurrent threads.
+		bool closestPoint( const Imath::V3f &p, Hit &hit ) const;
+
+		/// Returns the number of triangles.
+		size_t numTriangles() const;
+		/// Returns the number of nodes in the hierarchy.
+		size_t numNodes() const;
+		/// Returns the bound of all the triangles.
+		const Imath::Box3f &bound() const;
+
+	private :
+
+		// 32 bytes, so that two nodes fit in a cache line.
+		struct Node
+		{
+			Imath::Box3f bound;
+			// For leaves this is the index of the first triangle, and
+			// for branches it is the index of the high child - the low
+			// child always immediately follows its parent.
+			unsigned offset;
+			// Zero for branches.
+			unsigned short numTriangles;
+			// The axis the children were split on.
+			unsigned short axis;
+		};
+
+		struct Triangle
+		{
+			Imath::V3f p0;
+			Imath::V3f p1;
+			Imath::V3f p2;
+		};
+
+		struct BuildTriangle;
+
+		size_t build( std::vector<BuildTriangle> &triangles, size_t first, size_t last, int depth );
+
+		std::vector<Node> m_nodes;
+		std::vector<Triangle> m_triangles;
+		std::vector<unsigned> m_triangleIndices;
+		int m_maxLeafSize;
+
+};
+
+} // namespace IECore
+
+#endif // IECORE_TRIANGLEBVH_H
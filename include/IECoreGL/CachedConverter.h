@@ -56,7 +56,34 @@ class CachedConverter : public IECore::RefCounted
 		/// Returns the object converted to an appropriate IECoreGL type, reusing
 		/// a previous conversion where possible.
 		IECore::ConstRunTimeTypedPtr convert( const IECore::Object *object );
-		
+
+		//! @name Asynchronous conversion
+		/// These methods allow conversions to be performed without stalling
+		/// the GL thread. Converters which don't require a GL context run in
+		/// TBB tasks in the background, and only the remaining conversions are
+		/// performed on the GL thread, within a per-frame time budget.
+		//////////////////////////////////////////////////////////////////////
+		//@{
+		/// Returns the converted object if it is already in the cache. Otherwise
+		/// schedules the conversion and returns 0, in which case the caller should
+		/// draw a placeholder (the bounding box of the object, for instance) and
+		/// try again on a subsequent frame. The object must not be modified until
+		/// the conversion is complete. Conversions which fail are reported via
+		/// IECore::msg() and return 0 until they are retried - the first retry is
+		/// made a second after the failure, and the interval doubles each time the
+		/// conversion fails again.
+		IECore::ConstRunTimeTypedPtr convertAsync( const IECore::Object *object );
+		/// Transfers completed background conversions into the cache, and performs
+		/// pending conversions which require a GL context until timeBudget seconds
+		/// have elapsed. The buffers for converted Primitives are uploaded using
+		/// Primitive::uploadBuffers() within the same budget, so that the first
+		/// draw doesn't have to create them. At least one conversion is always performed if one is
+		/// available, so that progress is guaranteed. Must be called on the main
+		/// opengl thread, typically once per frame. Returns the number of conversions
+		/// which are still pending.
+		size_t processPendingConversions( double timeBudget );
+		//@}
+
 		/// Returns the maximum amount of memory (in bytes) the cache will use.
 		size_t getMaxMemory() const;
 		/// Sets the maximum amount of memory the cache will use. If this
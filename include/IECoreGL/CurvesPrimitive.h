@@ -60,6 +60,8 @@ class CurvesPrimitive : public Primitive
 		virtual void render( const State *currentState, IECore::TypeId style ) const;
 		/// Just renders each segment as linear with GL_LINES.
 		virtual void renderInstances( size_t numInstances = 1 ) const;
+		/// Also creates the index buffer needed to render in the default State.
+		virtual void uploadBuffers() const;
 
 		//! @name StateComponents
 		/// The following StateComponent classes have an effect only on
@@ -42,7 +42,7 @@
 namespace IECoreGL
 {
 
-/// \todo Fast drawing, uvs etc. Consider using NVIDIA tristrip library? something else? GLU?
+/// \todo Consider using NVIDIA tristrip library? something else? GLU?
 class MeshPrimitive : public Primitive
 {
 
@@ -60,8 +60,16 @@ class MeshPrimitive : public Primitive
 		/// the conversions from addPrimitiveVariable, and just rely on the work the ToGLMeshConverter
 		/// already does.
 		MeshPrimitive( IECore::ConstIntVectorDataPtr vertIds );
+		/// Constructs an indexed mesh with numVertices vertices, with each consecutive triple
+		/// of vertIds specifying a triangle. Vertex and Varying primitive variables must provide
+		/// numVertices values and are drawn with glDrawElements(), and only Constant primitive
+		/// variables may be added in addition. A reference to vertIds is kept, so it must not be
+		/// modified afterwards. This is the form created by the ToGLMeshConverter.
+		MeshPrimitive( IECore::ConstIntVectorDataPtr vertIds, size_t numVertices );
 		virtual ~MeshPrimitive();
 
+		/// Returns the triangle vertex indices. For meshes created with the deprecated
+		/// constructor these are the original vertex ids for each face-varying value.
 		IECore::ConstIntVectorDataPtr vertexIds() const;
 
 		virtual Imath::Box3f bound() const;
@@ -69,6 +77,8 @@ class MeshPrimitive : public Primitive
 		virtual void addPrimitiveVariable( const std::string &name, const IECore::PrimitiveVariable &primVar );
 
 		virtual void renderInstances( size_t numInstances = 1 ) const;
+		/// Also creates the index buffer for indexed meshes.
+		virtual void uploadBuffers() const;
 
 	private :
 
@@ -68,6 +68,9 @@ class Primitive : public Renderable
 		/// The default implementation calls addUniformAttribute() for uniform primitive variables and
 		/// addVertexAttribute() for all others.
 		virtual void addPrimitiveVariable( const std::string &name, const IECore::PrimitiveVariable &primVar ) = 0;
+		/// Returns the data registered for the named vertex attribute by addPrimitiveVariable(),
+		/// or 0 if there is none.
+		IECore::ConstDataPtr vertexAttribute( const std::string &name ) const;
 
 		/// Returns the bounding box for the primitive.
 		virtual Imath::Box3f bound() const = 0;
@@ -113,6 +116,12 @@ class Primitive : public Renderable
 		/// glDrawElementsInstanced() or glDrawArraysInstanced(). A Shader::Setup created for this
 		/// primitive must be bound before calling this method.
 		virtual void renderInstances( size_t numInstances = 1 ) const = 0;
+		/// Creates the Buffers needed to render the primitive, so that they don't need
+		/// to be created on the first call to render(). Buffers are shared via the
+		/// CachedConverter::defaultCachedConverter(), and a valid GL context is required.
+		/// The default implementation converts the vertex attributes - derived classes
+		/// which draw using other buffers should override it to create those too.
+		virtual void uploadBuffers() const;
 		///@}
 		
 		//! @name StateComponents
@@ -66,6 +66,13 @@ class ToGLConverter : public IECore::FromCoreConverter
 		/// type.
 		IECore::RunTimeTypedPtr convert();
 
+		/// Returns true if convert() must be called from a thread with a current
+		/// GL context. Converters which only prepare data on the CPU, deferring
+		/// all GL calls until rendering, may override this to return false, allowing
+		/// CachedConverter::convertAsync() to perform their conversions in the
+		/// background. The default implementation returns true.
+		virtual bool requiresGLContext() const;
+
 		//! @name Factory
 		/////////////////////////////////////////////////////////////////////////////////
 		//@{
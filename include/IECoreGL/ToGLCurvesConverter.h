@@ -62,6 +62,9 @@ class ToGLCurvesConverter : public ToGLConverter
 		ToGLCurvesConverter( IECore::ConstCurvesPrimitivePtr toConvert = 0 );
 		virtual ~ToGLCurvesConverter();
 
+		/// Returns false - the conversion makes no GL calls.
+		virtual bool requiresGLContext() const;
+
 	protected :
 
 		virtual IECore::RunTimeTypedPtr doConversion( IECore::ConstObjectPtr src, IECore::ConstCompoundObjectPtr operands ) const;
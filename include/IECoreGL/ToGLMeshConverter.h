@@ -62,6 +62,9 @@ class ToGLMeshConverter : public ToGLConverter
 		ToGLMeshConverter( IECore::ConstMeshPrimitivePtr toConvert = 0 );
 		virtual ~ToGLMeshConverter();
 
+		/// Returns false - the conversion makes no GL calls.
+		virtual bool requiresGLContext() const;
+
 	protected :
 
 		virtual IECore::RunTimeTypedPtr doConversion( IECore::ConstObjectPtr src, IECore::ConstCompoundObjectPtr operands ) const;
@@ -62,6 +62,9 @@ class ToGLPointsConverter : public ToGLConverter
 		ToGLPointsConverter( IECore::ConstPointsPrimitivePtr toConvert = 0 );
 		virtual ~ToGLPointsConverter();
 
+		/// Returns false - the conversion makes no GL calls.
+		virtual bool requiresGLContext() const;
+
 	protected :
 
 		virtual IECore::RunTimeTypedPtr doConversion( IECore::ConstObjectPtr src, IECore::ConstCompoundObjectPtr operands ) const;
@@ -0,0 +1,107 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2014, Image Engine Design Inc. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+//     * Neither the name of Image Engine Design nor the names of any
+//       other contributors to this software may be used to endorse or
+//       promote products derived from this software without specific prior
+//       written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#ifndef IECOREPYTHON_VECTORDATABUFFER_H
+#define IECOREPYTHON_VECTORDATABUFFER_H
+
+#include "boost/python.hpp"
+
+#include "IECore/VectorTypedData.h"
+
+namespace IECorePython
+{
+
+/// Signature of a function used to notify a Data object that its
+/// contents have been modified via a writable buffer.
+typedef void (*VectorDataBufferModifiedFn)( IECore::Data *data );
+/// Signature of a function used to find the address and number of
+/// elements of the contents of a Data object. If writable is true,
+/// the function must first ensure the data has sole ownership of its
+/// contents, by calling TypedData::writable().
+typedef void *(*VectorDataBufferAddressFn)( IECore::Data *data, bool writable, size_t &numElements );
+
+/// Returns a Python object which exposes the contents of data via the buffer
+/// protocol, allowing it to be viewed without copying using memoryview or
+/// numpy.asarray(). Elements composed of several components of the base type
+/// (V3f, M44f etc) are presented as a second dimension with numComponents
+/// entries. The buffer holds a reference to data, and uses address to look up
+/// the location of its contents each time a view is requested. Format is a
+/// struct module style format string for the base type. If modified is non-zero
+/// then the buffer is writable, and modified will be called when the last
+/// writable view is released. While writable views exist, the data must not be
+/// resized or share its contents with a copy, because the views would be left
+/// referring to memory the data no longer owns - bindings for such operations
+/// should call checkNoWritableVectorDataBufferViews() first. Read only buffers
+/// should be given a copy of the data, so that they keep the contents alive
+/// regardless of what happens to the original. This is typically called via
+/// the toBuffer() method bound for each VectorTypedData type, rather than directly.
+boost::python::object createVectorDataBuffer(
+	IECore::DataPtr data, size_t numComponents, size_t componentSize, const char *format,
+	VectorDataBufferAddressFn address, VectorDataBufferModifiedFn modified
+);
+
+/// Raises a Python BufferError if writable views of data are currently
+/// exported by a buffer created with createVectorDataBuffer().
+void checkNoWritableVectorDataBufferViews( const IECore::Data *data );
+
+/// Provides the buffer protocol format string for base types.
+template<typename T>
+struct VectorDataBufferFormat;
+
+#define IECOREPYTHON_VECTORDATABUFFERFORMAT( TYPE, FORMAT ) \
+template<> \
+struct VectorDataBufferFormat<TYPE> \
+{ \
+	static const char *value() { return FORMAT; } \
+};
+
+IECOREPYTHON_VECTORDATABUFFERFORMAT( half, "e" )
+IECOREPYTHON_VECTORDATABUFFERFORMAT( float, "f" )
+IECOREPYTHON_VECTORDATABUFFERFORMAT( double, "d" )
+IECOREPYTHON_VECTORDATABUFFERFORMAT( int, "i" )
+IECOREPYTHON_VECTORDATABUFFERFORMAT( unsigned int, "I" )
+IECOREPYTHON_VECTORDATABUFFERFORMAT( char, "b" )
+IECOREPYTHON_VECTORDATABUFFERFORMAT( unsigned char, "B" )
+IECOREPYTHON_VECTORDATABUFFERFORMAT( short, "h" )
+IECOREPYTHON_VECTORDATABUFFERFORMAT( unsigned short, "H" )
+IECOREPYTHON_VECTORDATABUFFERFORMAT( int64_t, "q" )
+IECOREPYTHON_VECTORDATABUFFERFORMAT( uint64_t, "Q" )
+
+#undef IECOREPYTHON_VECTORDATABUFFERFORMAT
+
+void bindVectorDataBuffer();
+
+} // namespace IECorePython
+
+#endif // IECOREPYTHON_VECTORDATABUFFER_H
@@ -37,6 +37,7 @@
 
 #include "IECorePython/IECoreBinding.h"
 #include "IECorePython/RunTimeTypedBinding.h"
+#include "IECorePython/VectorDataBuffer.h"
 
 #include <sstream>
 
@@ -167,14 +168,14 @@ class VectorTypedDataFunctions
 					data_type value = convertValue( v.ptr() );
 					if ( from <= to )
 					{
-						Container &xData = x.writable();
+						Container &xData = resizable( x );
 						xData.erase( xData.begin()+from, xData.begin()+to );
 						xData.insert( xData.begin()+from, value );
 					}
 					return;
 				}
 			}
-			Container &xData = x.writable();
+			Container &xData = resizable( x );
 			// we have vData pointing to a valid vector
 			if ( from > to )
 			{
@@ -190,7 +191,7 @@ class VectorTypedDataFunctions
 		/// binding for append function
 		static void append( ThisClass &x, PyObject* v )
 		{
-			Container &xData = x.writable();
+			Container &xData = resizable( x );
 			boost::python::extract<data_type&> elem( v );
 			xData.push_back( convertValue( v ) );
 		}
@@ -203,7 +204,7 @@ class VectorTypedDataFunctions
 				delSlice( x, reinterpret_cast<PySliceObject*>( i ) );
 				return;
 			}
-			Container &xData = x.writable();
+			Container &xData = resizable( x );
 			index_type index = convertIndex( x, i );
 			xData.erase( xData.begin()+index );
 		}
@@ -213,7 +214,7 @@ class VectorTypedDataFunctions
 		{
 			long from, to;
 			convertSlice( x, i, from, to );
-			Container &xData = x.writable();
+			Container &xData = resizable( x );
 			xData.erase( xData.begin()+from, xData.begin()+to );
 		}
 
@@ -232,12 +233,12 @@ class VectorTypedDataFunctions
 
 		static void resize( ThisClass &x, size_t s )
 		{
-			x.writable().resize( s );
+			resizable( x ).resize( s );
 		}
 
 		static void resizeWithValue( ThisClass &x, size_t s, const data_type &v )
 		{
-			x.writable().resize( s, v );
+			resizable( x ).resize( s, v );
 		}
 
 		/// binding for append function
@@ -282,7 +283,7 @@ class VectorTypedDataFunctions
 				}
 			}
 			// now concatenate the given list to the object
-			Container &xData = x.writable();
+			Container &xData = resizable( x );
 			const_iterator iterV = vData->begin();
 			for ( ; iterV != vData->end(); iterV++ )
 			{
@@ -340,7 +341,7 @@ class VectorTypedDataFunctions
 		/// binding for insert function
 		static void insert( ThisClass &x, PyObject *i, PyObject *v )
 		{
-			Container &xData = x.writable();
+			Container &xData = resizable( x );
 			typename Container::iterator iterX = xData.begin() + convertIndex( x, i, true );
 			xData.insert( iterX, convertValue( v ) );
 		}
@@ -514,12 +515,62 @@ class VectorTypedDataFunctions
 			);
 		}
 
+		static boost::python::object toBuffer( ThisClassPtr x, bool writable )
+		{
+			typedef typename ThisClass::BaseType BaseType;
+			// Read only buffers get their own copy, which shares the
+			// contents with x (so is cheap to make) but keeps them alive
+			// and unchanged whatever is subsequently done to x.
+			return createVectorDataBuffer(
+				writable ? x : x->copy(), sizeof( data_type ) / sizeof( BaseType ), sizeof( BaseType ),
+				VectorDataBufferFormat<BaseType>::value(), &bufferAddress, writable ? &modified : 0
+			);
+		}
+
+		/// binding for copy function
+		static ThisClassPtr copy( ThisClass &x )
+		{
+			// a copy would share the contents being modified by writable buffers
+			checkNoWritableVectorDataBufferViews( &x );
+			return x.copy();
+		}
 
 	protected:
 		/*
 		 * Utility functions
 		 */
 
+		static void modified( IECore::Data *data )
+		{
+			static_cast<ThisClass *>( data )->writable();
+		}
+
+		static void *bufferAddress( IECore::Data *data, bool writable, size_t &numElements )
+		{
+			ThisClass *typedData = static_cast<ThisClass *>( data );
+			if( writable )
+			{
+				// calling writable() performs any copy needed to
+				// give us sole ownership of the data.
+				Container &container = typedData->writable();
+				numElements = container.size();
+				return numElements ? &container[0] : 0;
+			}
+
+			const Container &container = typedData->readable();
+			numElements = container.size();
+			return numElements ? const_cast<data_type *>( &container[0] ) : 0;
+		}
+
+		/// Returns x.writable() for use by operations which may reallocate
+		/// the container, first raising BufferError if that would invalidate
+		/// writable buffer views.
+		static Container &resizable( ThisClass &x )
+		{
+			checkNoWritableVectorDataBufferViews( &x );
+			return x.writable();
+		}
+
 		/// converts from python indexes to non-negative C++ indexes.
 		static index_type convertIndex( ThisClass & container, PyObject *i_, bool acceptExpand = false )
 		{
@@ -660,6 +711,14 @@ std::string str<TypedData<std::vector<TYPE> > >( TypedData<std::vector<TYPE> > &
 	return s.str();																						\
 }																										\
 
+#define TOBUFFER_DOC \
+	"Returns an IECore.VectorDataBuffer providing access to the vector via the buffer\n" \
+	"protocol, so that it may be viewed using memoryview or numpy.asarray() without copying.\n" \
+	"A read only buffer keeps the current contents alive, and later modifications to the\n" \
+	"vector are not visible through it. If writable is True the data may be modified\n" \
+	"through the buffer, in which case the vector cannot be resized or copied, and should\n" \
+	"not be hashed, until all views of the buffer have been released."
+
 /// \todo Get rid of these macros
 #define BASIC_VECTOR_BINDING(ThisClass, Tname)																	\
 		typedef VectorTypedDataFunctions< ThisClass > ThisBinder;												\
@@ -693,6 +752,7 @@ std::string str<TypedData<std::vector<TYPE> > >( TypedData<std::vector<TYPE> > &
 			.def("size", &ThisBinder::len, "s.size()\nReturns the number of elements on s. Same result as the len operator.")	\
 			.def("resize", &ThisBinder::resize, "s.resize( size )\nAdjusts the size of s.")	\
 			.def("resize", &ThisBinder::resizeWithValue, "s.resize( size, value )\nAdjusts the size of s, inserting elements of value as necessary.")	\
+			.def("copy", &ThisBinder::copy, "s.copy()\nReturns a copy of s. Raises BufferError if writable buffer views of s exist.")	\
 			.def("hasBase", &ThisClass::hasBase ).staticmethod( "hasBase" ) \
 			.def("__str__", &str<ThisClass> )	\
 			.def("__repr__", &repr<ThisClass> )	\
@@ -705,6 +765,16 @@ std::string str<TypedData<std::vector<TYPE> > >( TypedData<std::vector<TYPE> > &
 			;																						\
 		}
 
+// bind a VectorTypedData class that does not support Math operators, but
+// which has a base type and can therefore be accessed as a buffer
+#define BIND_BUFFERED_VECTOR_TYPEDDATA(T, Tname)													\
+		{																							\
+			BASIC_VECTOR_BINDING(TypedData< std::vector< T > >, Tname)																	\
+				.def("__cmp__", &ThisBinder::invalidOperator, "Raises an exception. This vector type does not support comparison operators.")		\
+				.def("toBuffer", &ThisBinder::toBuffer, ( boost::python::arg_( "writable" ) = false ), TOBUFFER_DOC )\
+			;																						\
+		}
+
 // bind a VectorTypedData class that supports simple Math operators (+=, -= and *=)
 #define BIND_SIMPLE_OPERATED_VECTOR_TYPEDDATA(T, Tname)									\
 		{																							\
@@ -718,6 +788,7 @@ std::string str<TypedData<std::vector<TYPE> > >( TypedData<std::vector<TYPE> > &
 				.def("__imul__", &ThisBinder::imul, "inplace multiplication (s *= v) : accepts another vector of the same type or a single " Tname)		\
 				.def("__cmp__", &ThisBinder::invalidOperator, "Raises an exception. This vector type does not support comparison operators.")		\
 				.def("toString", &ThisBinder::toString, "Returns a string with a copy of the bytes in the vector.")\
+				.def("toBuffer", &ThisBinder::toBuffer, ( boost::python::arg_( "writable" ) = false ), TOBUFFER_DOC )\
 			;																						\
 		}
 
@@ -736,6 +807,7 @@ std::string str<TypedData<std::vector<TYPE> > >( TypedData<std::vector<TYPE> > &
 				.def("__idiv__", &ThisBinder::idiv, "inplace division (s /= v) : accepts another vector of the same type or a single " Tname)			\
 				.def("__cmp__", &ThisBinder::invalidOperator, "Raises an exception. This vector type does not support comparison operators.")		\
 				.def("toString", &ThisBinder::toString, "Returns a string with a copy of the bytes in the vector.")\
+				.def("toBuffer", &ThisBinder::toBuffer, ( boost::python::arg_( "writable" ) = false ), TOBUFFER_DOC )\
 			;																						\
 		}
 
@@ -754,6 +826,7 @@ std::string str<TypedData<std::vector<TYPE> > >( TypedData<std::vector<TYPE> > &
 				.def("__idiv__", &ThisBinder::idiv, "inplace division (s /= v) : accepts another vector of the same type or a single " Tname)			\
 				.def("__cmp__", &ThisBinder::cmp, "comparison operators (<, >, >=, <=) : The comparison is element-wise, like a string comparison. \n")	\
 				.def("toString", &ThisBinder::toString, "Returns a string with a copy of the bytes in the vector.")\
+				.def("toBuffer", &ThisBinder::toBuffer, ( boost::python::arg_( "writable" ) = false ), TOBUFFER_DOC )\
 			;																						\
 		}
 
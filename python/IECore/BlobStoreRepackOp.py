@@ -0,0 +1,76 @@
+##########################################################################
+#
+#  Copyright (c) 2014, Image Engine Design Inc. All rights reserved.
+#
+#  Redistribution and use in source and binary forms, with or without
+#  modification, are permitted provided that the following conditions are
+#  met:
+#
+#     * Redistributions of source code must retain the above copyright
+#       notice, this list of conditions and the following disclaimer.
+#
+#     * Redistributions in binary form must reproduce the above copyright
+#       notice, this list of conditions and the following disclaimer in the
+#       documentation and/or other materials provided with the distribution.
+#
+#     * Neither the name of Image Engine Design nor the names of any
+#       other contributors to this software may be used to endorse or
+#       promote products derived from this software without specific prior
+#       written permission.
+#
+#  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+#  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+#  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+#  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+#  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+#  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+#  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+#  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+#  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+#  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+#  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#
+##########################################################################
+
+from IECore import *
+
+## Moves the loose blobs written to a BlobStore into its pack, so that they can
+# be memory mapped and shared by all the processes reading the files using the store.
+# This should be run periodically, for instance once the caches of a shot have been
+# written. It's safe to run while files are still being written to the store, but it
+# mustn't be run more than once at the same time for the same store.
+class BlobStoreRepackOp( Op ) :
+
+	def __init__( self ) :
+
+		Op.__init__( self, "Moves the loose blobs of a BlobStore into its pack.",
+			IntParameter(
+				name = "result",
+				description = "The number of blobs moved into the pack.",
+				defaultValue = 0,
+			)
+		)
+
+		self.parameters().addParameters(
+			[
+				DirNameParameter(
+					name = "store",
+					description = "The directory holding the BlobStore.",
+					defaultValue = "",
+					check = DirNameParameter.CheckType.MustExist,
+					allowEmptyString = False,
+				),
+			]
+		)
+
+	def doOperation( self, operands ) :
+
+		store = BlobStore.open( operands["store"].value )
+		numPacked = store.repack()
+
+		packed, loose = store.stats()
+		info( "BlobStoreRepackOp", "Moved %d blobs into the pack of \"%s\", which now holds %d blobs (%d still loose)." % ( numPacked, store.directory(), packed, loose ) )
+
+		return IntData( numPacked )
+
+registerRunTimeTyped( BlobStoreRepackOp )
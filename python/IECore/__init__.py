@@ -73,6 +73,7 @@ from PointsExpressionOp import PointsExpressionOp
 from Struct import Struct
 import Enum
 from LsHeaderOp import LsHeaderOp
+from BlobStoreRepackOp import BlobStoreRepackOp
 from curry import curry
 from MenuItemDefinition import MenuItemDefinition
 from MenuDefinition import MenuDefinition
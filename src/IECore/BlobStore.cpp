@@ -0,0 +1,730 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2014, Image Engine Design Inc. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+//     * Neither the name of Image Engine Design nor the names of any
+//       other contributors to this software may be used to endorse or
+//       promote products derived from this software without specific prior
+//       written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <stdio.h>
+#include <errno.h>
+#include <string.h>
+#include <stdlib.h>
+
+#include <fstream>
+#include <map>
+#include <vector>
+#include <algorithm>
+
+#include "boost/version.hpp"
+#include "boost/format.hpp"
+#include "boost/tokenizer.hpp"
+#include "boost/filesystem/operations.hpp"
+#include "boost/filesystem/path.hpp"
+#include "boost/iostreams/device/mapped_file.hpp"
+
+#include "tbb/spin_mutex.h"
+#include "tbb/atomic.h"
+
+#include "IECore/BlobStore.h"
+#include "IECore/ByteOrder.h"
+#include "IECore/Exception.h"
+#include "IECore/MessageHandler.h"
+
+#if BOOST_VERSION < 104400
+
+	// Boost 1.44.0 introduced Filesystem v3, see FileSequenceFunctions.cpp.
+	#define PATH_TO_STRING filename()
+
+#else
+
+	#define PATH_TO_STRING filename().string()
+
+#endif
+
+using namespace IECore;
+
+namespace fs = boost::filesystem;
+
+/// Pack file format :
+///
+/// Pack ::= Header Table Data
+/// Header ::= MagicNumber Version NumBlobs
+/// MagicNumber ::= int64
+/// Version ::= int64
+/// NumBlobs ::= int64
+/// Table ::= Entry* ( sorted by hash, so blobs can be found with a binary search )
+/// Entry ::= HashH1 HashH2 BlobOffset BlobSize ( all int64 )
+/// Data ::= the blobs, each starting at an offset multiple of g_blobAlignment from the start of the file
+///
+/// All numbers are stored little endian.
+
+static const Imf::Int64 g_packMagicNumber = 0xB10B5BAC;
+static const Imf::Int64 g_packVersion = 1;
+static const size_t g_headerSize = 3 * sizeof( Imf::Int64 );
+static const size_t g_entrySize = 4 * sizeof( Imf::Int64 );
+/// Blobs are aligned so that numeric arrays can be used straight from the mapping.
+static const size_t g_blobAlignment = 16;
+
+static const char *g_packFileName = "blobs.pack";
+static const char *g_looseDirectoryName = "loose";
+static const char *g_tmpSuffix = ".tmp";
+
+static std::string tmpFileName( const std::string &fileName )
+{
+	static tbb::atomic<unsigned int> g_counter;
+	return ( boost::format( "%s%s.%d.%d" ) % fileName % g_tmpSuffix % getpid() % g_counter.fetch_and_increment() ).str();
+}
+
+static bool hashFromString( const std::string &s, MurmurHash &hash )
+{
+	if ( s.size() != 32 || s.find_first_not_of( "0123456789abcdef" ) != std::string::npos )
+	{
+		return false;
+	}
+	uint64_t h1 = strtoull( s.substr( 0, 16 ).c_str(), 0, 16 );
+	uint64_t h2 = strtoull( s.substr( 16, 16 ).c_str(), 0, 16 );
+	hash = MurmurHash( h1, h2 );
+	return true;
+}
+
+static void writeInt64( std::ostream &f, Imf::Int64 n )
+{
+	const Imf::Int64 nl = asLittleEndian<>( n );
+	f.write( (const char *)&nl, sizeof( nl ) );
+}
+
+namespace
+{
+
+/// A blob to be written to a new pack by BlobStore::repack().
+struct NewEntry
+{
+	MurmurHash hash;
+	/// Index in the old pack, used when path is empty.
+	size_t index;
+	/// Path of the loose blob.
+	std::string path;
+	size_t size;
+	size_t offset;
+
+	bool operator < ( const NewEntry &other ) const
+	{
+		return hash < other.hash;
+	}
+};
+
+} // namespace
+
+//////////////////////////////////////////////////////////////////////////
+// BlobStore::Pack
+//////////////////////////////////////////////////////////////////////////
+
+class BlobStore::Pack : public RefCounted
+{
+
+	public :
+
+		Pack( const std::string &fileName )
+			:	m_fileName( fileName ), m_table( 0 ), m_numBlobs( 0 ), m_exists( false )
+		{
+			struct stat s;
+			if ( stat( fileName.c_str(), &s ) != 0 )
+			{
+				// no pack yet, all the blobs are loose.
+				return;
+			}
+			m_exists = true;
+			m_device = s.st_dev;
+			m_inode = s.st_ino;
+
+			try
+			{
+				m_file.open( fileName );
+			}
+			catch( std::exception &e )
+			{
+				throw IOException( ( boost::format( "BlobStore: Unable to map pack '%s' : %s" ) % fileName % e.what() ).str() );
+			}
+
+			if ( m_file.size() < g_headerSize )
+			{
+				throw IOException( "BlobStore: Corrupted pack '" + fileName + "'" );
+			}
+			const Imf::Int64 *header = reinterpret_cast<const Imf::Int64 *>( m_file.data() );
+			if ( asLittleEndian( header[0] ) != g_packMagicNumber || asLittleEndian( header[1] ) > g_packVersion )
+			{
+				throw IOException( "BlobStore: Unrecognised pack '" + fileName + "'" );
+			}
+			m_numBlobs = asLittleEndian( header[2] );
+			if ( m_file.size() < g_headerSize + m_numBlobs * g_entrySize )
+			{
+				throw IOException( "BlobStore: Corrupted pack '" + fileName + "'" );
+			}
+			m_table = header + 3;
+		}
+
+		/// Returns true if the file on disk is still the one which was mapped.
+		bool isCurrent() const
+		{
+			struct stat s;
+			if ( stat( m_fileName.c_str(), &s ) != 0 )
+			{
+				return !m_exists;
+			}
+			return m_exists && s.st_dev == m_device && s.st_ino == m_inode;
+		}
+
+		size_t numBlobs() const
+		{
+			return m_numBlobs;
+		}
+
+		bool find( const MurmurHash &hash, size_t &index ) const
+		{
+			size_t begin = 0, end = m_numBlobs;
+			while( begin < end )
+			{
+				size_t middle = begin + ( end - begin ) / 2;
+				MurmurHash h = this->hash( middle );
+				if ( h == hash )
+				{
+					index = middle;
+					return true;
+				}
+				if ( h < hash )
+				{
+					begin = middle + 1;
+				}
+				else
+				{
+					end = middle;
+				}
+			}
+			return false;
+		}
+
+		MurmurHash hash( size_t index ) const
+		{
+			return MurmurHash( field( index, 0 ), field( index, 1 ) );
+		}
+
+		size_t size( size_t index ) const
+		{
+			return field( index, 3 );
+		}
+
+		const char *data( size_t index ) const
+		{
+			size_t offset = field( index, 2 );
+			if ( offset + size( index ) > m_file.size() )
+			{
+				throw IOException( "BlobStore: Corrupted pack '" + m_fileName + "'" );
+			}
+			return m_file.data() + offset;
+		}
+
+	private :
+
+		Imf::Int64 field( size_t index, size_t field ) const
+		{
+			return asLittleEndian( m_table[ index * 4 + field ] );
+		}
+
+		std::string m_fileName;
+		boost::iostreams::mapped_file_source m_file;
+		const Imf::Int64 *m_table;
+		size_t m_numBlobs;
+		bool m_exists;
+		dev_t m_device;
+		ino_t m_inode;
+
+};
+
+//////////////////////////////////////////////////////////////////////////
+// BlobStore
+//////////////////////////////////////////////////////////////////////////
+
+namespace
+{
+
+// The stores are only referenced weakly, so they are released as soon as
+// no file uses them. Releasing the last reference to a store is synchronised
+// with open() by g_storesMutex - see intrusive_ptr_release().
+typedef std::map<std::string, BlobStore *> StoreMap;
+StoreMap g_stores;
+tbb::spin_mutex g_storesMutex;
+
+// Returns the absolute path with any "." and ".." resolved, so that
+// a store is found in g_stores however the directory is referred to.
+std::string normalisedPath( const std::string &directory )
+{
+	std::vector<std::string> names;
+	typedef boost::tokenizer<boost::char_separator<char> > Tokenizer;
+	const std::string path = fs::system_complete( fs::path( directory ) ).string();
+	Tokenizer tokens( path, boost::char_separator<char>( "/" ) );
+	for ( Tokenizer::iterator it = tokens.begin(); it != tokens.end(); ++it )
+	{
+		if ( *it == ".." )
+		{
+			if ( names.size() )
+			{
+				names.pop_back();
+			}
+		}
+		else if ( *it != "." )
+		{
+			names.push_back( *it );
+		}
+	}
+
+	std::string result;
+	for ( std::vector<std::string>::const_iterator it = names.begin(); it != names.end(); ++it )
+	{
+		result += "/" + *it;
+	}
+	return result.empty() ? "/" : result;
+}
+
+} // namespace
+
+BlobStorePtr BlobStore::open( const std::string &directory )
+{
+	const std::string path = normalisedPath( directory );
+
+	tbb::spin_mutex::scoped_lock lock( g_storesMutex );
+	StoreMap::const_iterator it = g_stores.find( path );
+	if ( it != g_stores.end() )
+	{
+		return it->second;
+	}
+	BlobStorePtr result = new BlobStore( path );
+	g_stores[path] = result.get();
+	return result;
+}
+
+BlobStore::BlobStore( const std::string &directory )
+	:	m_directory( directory ), m_pack( new Pack( packPath() ) )
+{
+}
+
+BlobStore::~BlobStore()
+{
+	// normally done by intrusive_ptr_release(), but the last reference
+	// may have been held by a pointer to a base class.
+	tbb::spin_mutex::scoped_lock lock( g_storesMutex );
+	StoreMap::iterator it = g_stores.find( m_directory );
+	if ( it != g_stores.end() && it->second == this )
+	{
+		g_stores.erase( it );
+	}
+}
+
+const std::string &BlobStore::directory() const
+{
+	return m_directory;
+}
+
+std::string BlobStore::packPath() const
+{
+	return ( fs::path( m_directory ) / g_packFileName ).string();
+}
+
+std::string BlobStore::loosePath( const MurmurHash &hash ) const
+{
+	// spread the loose blobs over subdirectories, to keep directory sizes reasonable.
+	const std::string s = hash.toString();
+	return ( fs::path( m_directory ) / g_looseDirectoryName / s.substr( 0, 2 ) / s.substr( 2 ) ).string();
+}
+
+BlobStore::ConstPackPtr BlobStore::pack( bool reload ) const
+{
+	{
+		Mutex::scoped_lock lock( m_mutex, false );
+		if ( !reload || m_pack->isCurrent() )
+		{
+			return m_pack;
+		}
+	}
+
+	ConstPackPtr newPack = new Pack( packPath() );
+	Mutex::scoped_lock lock( m_mutex, true );
+	m_pack = newPack;
+	return newPack;
+}
+
+BlobStore::ConstPackPtr BlobStore::find( const MurmurHash &hash, size_t &index ) const
+{
+	ConstPackPtr p = pack();
+	if ( p->find( hash, index ) )
+	{
+		return p;
+	}
+	if ( fs::exists( loosePath( hash ) ) )
+	{
+		return 0;
+	}
+	// the blob may have been packed since we loaded the pack
+	p = pack( true );
+	if ( p->find( hash, index ) )
+	{
+		return p;
+	}
+	return 0;
+}
+
+MurmurHash BlobStore::write( const char *data, size_t size )
+{
+	MurmurHash hash;
+	hash.append( data, size );
+
+	if ( contains( hash ) )
+	{
+		return hash;
+	}
+
+	const fs::path path( loosePath( hash ) );
+	try
+	{
+		fs::create_directories( path.parent_path() );
+	}
+	catch( std::exception &e )
+	{
+		throw IOException( ( boost::format( "BlobStore: Unable to create directory '%s' : %s" ) % path.parent_path().string() % e.what() ).str() );
+	}
+
+	// write to a temporary file and rename it once complete, so that readers
+	// and other writers never see a partial blob.
+	const std::string tmpPath = tmpFileName( path.string() );
+	{
+		std::ofstream f( tmpPath.c_str(), std::ios::binary | std::ios::trunc );
+		f.write( data, size );
+		f.close();
+		if ( !f )
+		{
+			::remove( tmpPath.c_str() );
+			throw IOException( "BlobStore: Unable to write '" + tmpPath + "'" );
+		}
+	}
+
+	if ( ::rename( tmpPath.c_str(), path.string().c_str() ) != 0 )
+	{
+		::remove( tmpPath.c_str() );
+		throw IOException( ( boost::format( "BlobStore: Unable to rename '%s' : %s" ) % tmpPath % strerror( errno ) ).str() );
+	}
+
+	return hash;
+}
+
+bool BlobStore::contains( const MurmurHash &hash ) const
+{
+	size_t index;
+	return find( hash, index ) || fs::exists( loosePath( hash ) );
+}
+
+size_t BlobStore::size( const MurmurHash &hash ) const
+{
+	size_t index;
+	ConstPackPtr p = find( hash, index );
+	if ( p )
+	{
+		return p->size( index );
+	}
+
+	struct stat s;
+	if ( stat( loosePath( hash ).c_str(), &s ) == 0 )
+	{
+		return s.st_size;
+	}
+
+	// it may have just been packed
+	p = pack( true );
+	if ( p->find( hash, index ) )
+	{
+		return p->size( index );
+	}
+
+	throw IOException( "BlobStore: Blob '" + hash.toString() + "' not found in '" + m_directory + "'" );
+}
+
+void BlobStore::read( const MurmurHash &hash, char *buffer, size_t bufferSize ) const
+{
+	size_t index;
+	ConstPackPtr p = find( hash, index );
+	if ( !p )
+	{
+		const std::string path = loosePath( hash );
+		std::ifstream f( path.c_str(), std::ios::binary );
+		if ( f.is_open() )
+		{
+			f.seekg( 0, std::ios::end );
+			size_t size = f.tellg();
+			if ( size != bufferSize )
+			{
+				throw IOException( "BlobStore: Blob '" + hash.toString() + "' doesn't have the expected size" );
+			}
+			f.seekg( 0, std::ios::beg );
+			f.read( buffer, size );
+			if ( !f )
+			{
+				throw IOException( "BlobStore: Unable to read '" + path + "'" );
+			}
+			return;
+		}
+
+		// it may have just been packed
+		p = pack( true );
+		if ( !p->find( hash, index ) )
+		{
+			throw IOException( "BlobStore: Blob '" + hash.toString() + "' not found in '" + m_directory + "'" );
+		}
+	}
+
+	if ( p->size( index ) != bufferSize )
+	{
+		throw IOException( "BlobStore: Blob '" + hash.toString() + "' doesn't have the expected size" );
+	}
+	memcpy( buffer, p->data( index ), bufferSize );
+}
+
+const char *BlobStore::mappedData( const MurmurHash &hash, ConstRefCountedPtr &owner ) const
+{
+	size_t index;
+	ConstPackPtr p = find( hash, index );
+	if ( !p )
+	{
+		return 0;
+	}
+	owner = p;
+	return p->data( index );
+}
+
+size_t BlobStore::repack()
+{
+	ConstPackPtr oldPack = pack( true );
+
+	// find all the loose blobs which aren't in the pack already
+
+	std::vector<NewEntry> entries;
+	entries.reserve( oldPack->numBlobs() );
+	for ( size_t i = 0; i < oldPack->numBlobs(); i++ )
+	{
+		NewEntry e;
+		e.hash = oldPack->hash( i );
+		e.index = i;
+		e.size = oldPack->size( i );
+		entries.push_back( e );
+	}
+
+	std::vector<std::string> packedLooseFiles;
+	const fs::path looseDirectory = fs::path( m_directory ) / g_looseDirectoryName;
+	if ( fs::is_directory( looseDirectory ) )
+	{
+		fs::directory_iterator end;
+		for ( fs::directory_iterator dit( looseDirectory ); dit != end; ++dit )
+		{
+			if ( !fs::is_directory( dit->path() ) )
+			{
+				continue;
+			}
+			const std::string prefix = dit->path().PATH_TO_STRING;
+			for ( fs::directory_iterator fit( dit->path() ); fit != end; ++fit )
+			{
+				NewEntry e;
+				// temporary files in the middle of being written don't parse as a hash, and are skipped.
+				if ( !hashFromString( prefix + fit->path().PATH_TO_STRING, e.hash ) )
+				{
+					continue;
+				}
+				e.path = fit->path().string();
+				size_t index;
+				if ( !oldPack->find( e.hash, index ) )
+				{
+					e.index = 0;
+					e.size = fs::file_size( fit->path() );
+					entries.push_back( e );
+				}
+				packedLooseFiles.push_back( e.path );
+			}
+		}
+	}
+
+	if ( packedLooseFiles.empty() )
+	{
+		return 0;
+	}
+
+	// lay out the new pack
+
+	std::sort( entries.begin(), entries.end() );
+	size_t offset = g_headerSize + entries.size() * g_entrySize;
+	for ( std::vector<NewEntry>::iterator it = entries.begin(); it != entries.end(); it++ )
+	{
+		offset = ( ( offset + g_blobAlignment - 1 ) / g_blobAlignment ) * g_blobAlignment;
+		it->offset = offset;
+		offset += it->size;
+	}
+
+	// write it to a temporary file and rename it over the old one, so that readers in other processes
+	// keep their mapping of the old pack until they notice the new one.
+
+	const std::string tmpPath = tmpFileName( packPath() );
+	std::ofstream f( tmpPath.c_str(), std::ios::binary | std::ios::trunc );
+	if ( !f.is_open() )
+	{
+		throw IOException( "BlobStore: Unable to write '" + tmpPath + "'" );
+	}
+
+	writeInt64( f, g_packMagicNumber );
+	writeInt64( f, g_packVersion );
+	writeInt64( f, entries.size() );
+	for ( std::vector<NewEntry>::const_iterator it = entries.begin(); it != entries.end(); it++ )
+	{
+		writeInt64( f, it->hash.h1() );
+		writeInt64( f, it->hash.h2() );
+		writeInt64( f, it->offset );
+		writeInt64( f, it->size );
+	}
+
+	std::vector<char> buffer;
+	for ( std::vector<NewEntry>::const_iterator it = entries.begin(); it != entries.end(); it++ )
+	{
+		size_t padding = it->offset - (size_t)f.tellp();
+		if ( padding )
+		{
+			const char zeros[g_blobAlignment] = { 0 };
+			f.write( zeros, padding );
+		}
+
+		if ( it->path.empty() )
+		{
+			f.write( oldPack->data( it->index ), it->size );
+		}
+		else
+		{
+			buffer.resize( it->size );
+			std::ifstream blob( it->path.c_str(), std::ios::binary );
+			blob.read( buffer.size() ? &buffer[0] : 0, buffer.size() );
+			if ( !blob )
+			{
+				f.close();
+				::remove( tmpPath.c_str() );
+				throw IOException( "BlobStore: Unable to read '" + it->path + "'" );
+			}
+			f.write( buffer.size() ? &buffer[0] : 0, buffer.size() );
+		}
+	}
+
+	f.close();
+	if ( !f )
+	{
+		::remove( tmpPath.c_str() );
+		throw IOException( "BlobStore: Unable to write '" + tmpPath + "'" );
+	}
+
+	if ( ::rename( tmpPath.c_str(), packPath().c_str() ) != 0 )
+	{
+		::remove( tmpPath.c_str() );
+		throw IOException( ( boost::format( "BlobStore: Unable to rename '%s' : %s" ) % tmpPath % strerror( errno ) ).str() );
+	}
+
+	pack( true );
+
+	// the loose blobs can go now that they're in the pack
+	for ( std::vector<std::string>::const_iterator it = packedLooseFiles.begin(); it != packedLooseFiles.end(); it++ )
+	{
+		if ( ::remove( it->c_str() ) != 0 )
+		{
+			msg( Msg::Warning, "BlobStore::repack", boost::format( "Unable to remove '%s' : %s" ) % *it % strerror( errno ) );
+		}
+	}
+
+	return packedLooseFiles.size();
+}
+
+void BlobStore::stats( size_t &numPacked, size_t &numLoose ) const
+{
+	numPacked = pack( true )->numBlobs();
+	numLoose = 0;
+
+	const fs::path looseDirectory = fs::path( m_directory ) / g_looseDirectoryName;
+	if ( !fs::is_directory( looseDirectory ) )
+	{
+		return;
+	}
+
+	fs::directory_iterator end;
+	for ( fs::directory_iterator dit( looseDirectory ); dit != end; ++dit )
+	{
+		if ( !fs::is_directory( dit->path() ) )
+		{
+			continue;
+		}
+		const std::string prefix = dit->path().PATH_TO_STRING;
+		for ( fs::directory_iterator fit( dit->path() ); fit != end; ++fit )
+		{
+			MurmurHash hash;
+			if ( hashFromString( prefix + fit->path().PATH_TO_STRING, hash ) )
+			{
+				numLoose++;
+			}
+		}
+	}
+}
+
+void IECore::intrusive_ptr_release( const BlobStore *store )
+{
+	bool last = false;
+	{
+		tbb::spin_mutex::scoped_lock lock( g_storesMutex );
+		if ( store->refCount() == 1 )
+		{
+			// once the store is removed from the map, open() can't make
+			// a new reference to it, so it's safe to destroy it.
+			StoreMap::iterator it = g_stores.find( store->directory() );
+			if ( it != g_stores.end() && it->second == store )
+			{
+				g_stores.erase( it );
+			}
+			last = true;
+		}
+		else
+		{
+			store->removeRef();
+		}
+	}
+
+	if ( last )
+	{
+		store->removeRef();
+	}
+}
@@ -0,0 +1,243 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2014, Image Engine Design Inc. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+//     * Neither the name of Image Engine Design nor the names of any
+//       other contributors to this software may be used to endorse or
+//       promote products derived from this software without specific prior
+//       written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <cmath>
+
+#include "boost/cstdint.hpp"
+
+#include "OpenEXR/ImathBox.h"
+
+#include "IECore/DecimateAlgo.h"
+#include "IECore/MeshPrimitive.h"
+#include "IECore/PointsPrimitive.h"
+#include "IECore/VectorTypedData.h"
+
+using namespace IECore;
+using namespace Imath;
+
+namespace
+{
+
+typedef boost::uint64_t CellKey;
+typedef std::vector< std::pair<CellKey, int> > CellKeys;
+
+// Fills keys with the grid cell containing each point, sorted by cell,
+// and returns the number of distinct cells.
+size_t clusterPoints( const std::vector<V3f> &p, const V3f &origin, float cellSize, CellKeys &keys )
+{
+	// 21 bits per axis packs a cell into 63 bits
+	const float maxCell = (float)( ( 1 << 21 ) - 1 );
+
+	keys.resize( p.size() );
+	for( size_t i = 0; i < p.size(); ++i )
+	{
+		const V3f c = ( p[i] - origin ) / cellSize;
+		const CellKey x = (CellKey)std::min( std::max( c.x, 0.0f ), maxCell );
+		const CellKey y = (CellKey)std::min( std::max( c.y, 0.0f ), maxCell );
+		const CellKey z = (CellKey)std::min( std::max( c.z, 0.0f ), maxCell );
+		keys[i] = CellKeys::value_type( ( x << 42 ) | ( y << 21 ) | z, i );
+	}
+
+	std::sort( keys.begin(), keys.end() );
+
+	size_t result = 0;
+	for( size_t i = 0; i < keys.size(); ++i )
+	{
+		if( i == 0 || keys[i].first != keys[i-1].first )
+		{
+			result++;
+		}
+	}
+	return result;
+}
+
+// Clusters p into at most targetVertices clusters, filling vertexClusters with the
+// cluster of each point and clusterPositions with the average position of each cluster.
+void cluster( const std::vector<V3f> &p, size_t targetVertices, std::vector<int> &vertexClusters, std::vector<V3f> &clusterPositions, float &error )
+{
+	targetVertices = std::max( targetVertices, (size_t)1 );
+
+	Box3f bound;
+	for( std::vector<V3f>::const_iterator it = p.begin(); it != p.end(); ++it )
+	{
+		bound.extendBy( *it );
+	}
+
+	CellKeys keys;
+	const V3f size = bound.isEmpty() ? V3f( 0 ) : bound.size();
+	const float extent = std::max( size.x, std::max( size.y, size.z ) );
+	if( extent > 0.0f )
+	{
+		// bisect geometrically for the smallest cell size which meets the budget,
+		// to within a few percent. a cell larger than the extent always yields a
+		// single cluster.
+		float lo = extent / (float)( 1 << 20 );
+		float hi = extent * 1.001f;
+		if( clusterPoints( p, bound.min, lo, keys ) <= targetVertices )
+		{
+			hi = lo;
+		}
+		else
+		{
+			for( int i = 0; i < 8; ++i )
+			{
+				const float mid = sqrtf( lo * hi );
+				if( clusterPoints( p, bound.min, mid, keys ) <= targetVertices )
+				{
+					hi = mid;
+				}
+				else
+				{
+					lo = mid;
+				}
+			}
+		}
+		clusterPoints( p, bound.min, hi, keys );
+	}
+	else
+	{
+		clusterPoints( p, bound.min, 1.0f, keys );
+	}
+
+	vertexClusters.resize( p.size() );
+	clusterPositions.clear();
+	std::vector<int> clusterSizes;
+	for( size_t i = 0; i < keys.size(); ++i )
+	{
+		if( i == 0 || keys[i].first != keys[i-1].first )
+		{
+			clusterPositions.push_back( V3f( 0 ) );
+			clusterSizes.push_back( 0 );
+		}
+		vertexClusters[keys[i].second] = clusterPositions.size() - 1;
+		clusterPositions.back() += p[keys[i].second];
+		clusterSizes.back()++;
+	}
+
+	for( size_t i = 0; i < clusterPositions.size(); ++i )
+	{
+		clusterPositions[i] /= (float)clusterSizes[i];
+	}
+
+	error = 0.0f;
+	for( size_t i = 0; i < p.size(); ++i )
+	{
+		error = std::max( error, ( p[i] - clusterPositions[vertexClusters[i]] ).length() );
+	}
+}
+
+} // namespace
+
+namespace IECore
+{
+
+PrimitivePtr clusterDecimate( const Primitive *primitive, size_t targetVertices, float &error )
+{
+	const V3fVectorData *pData = primitive->variableData<V3fVectorData>( "P", PrimitiveVariable::Vertex );
+	if( !pData )
+	{
+		return 0;
+	}
+	const std::vector<V3f> &p = pData->readable();
+
+	if( primitive->isInstanceOf( PointsPrimitiveTypeId ) )
+	{
+		std::vector<int> vertexClusters;
+		V3fVectorDataPtr newP = new V3fVectorData;
+		cluster( p, targetVertices, vertexClusters, newP->writable(), error );
+		return new PointsPrimitive( newP );
+	}
+
+	const MeshPrimitive *mesh = runTimeCast<const MeshPrimitive>( primitive );
+	if( !mesh )
+	{
+		return 0;
+	}
+
+	std::vector<int> vertexClusters;
+	std::vector<V3f> clusterPositions;
+	cluster( p, targetVertices, vertexClusters, clusterPositions, error );
+
+	const std::vector<int> &verticesPerFace = mesh->verticesPerFace()->readable();
+	const std::vector<int> &vertexIds = mesh->vertexIds()->readable();
+
+	IntVectorDataPtr newVerticesPerFaceData = new IntVectorData;
+	IntVectorDataPtr newVertexIdsData = new IntVectorData;
+	V3fVectorDataPtr newPData = new V3fVectorData;
+	std::vector<int> &newVerticesPerFace = newVerticesPerFaceData->writable();
+	std::vector<int> &newVertexIds = newVertexIdsData->writable();
+	std::vector<V3f> &newP = newPData->writable();
+
+	// clusters are only output once they're used by a surviving face
+	std::vector<int> clusterVertices( clusterPositions.size(), -1 );
+	std::vector<int> face;
+	std::vector<int>::const_iterator vertexIt = vertexIds.begin();
+	for( std::vector<int>::const_iterator it = verticesPerFace.begin(); it != verticesPerFace.end(); ++it )
+	{
+		face.clear();
+		for( int i = 0; i < *it; ++i, ++vertexIt )
+		{
+			const int c = vertexClusters[*vertexIt];
+			if( face.empty() || face.back() != c )
+			{
+				face.push_back( c );
+			}
+		}
+		while( face.size() > 1 && face.front() == face.back() )
+		{
+			face.pop_back();
+		}
+		if( face.size() < 3 )
+		{
+			continue;
+		}
+
+		for( std::vector<int>::const_iterator cIt = face.begin(); cIt != face.end(); ++cIt )
+		{
+			int &vertex = clusterVertices[*cIt];
+			if( vertex < 0 )
+			{
+				vertex = newP.size();
+				newP.push_back( clusterPositions[*cIt] );
+			}
+			newVertexIds.push_back( vertex );
+		}
+		newVerticesPerFace.push_back( face.size() );
+	}
+
+	return new MeshPrimitive( newVerticesPerFaceData, newVertexIdsData, mesh->interpolation(), newPData );
+}
+
+} // namespace IECore
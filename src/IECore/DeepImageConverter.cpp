@@ -32,6 +32,8 @@
 //
 //////////////////////////////////////////////////////////////////////////
 
+#include <algorithm>
+
 #include "boost/algorithm/string/join.hpp"
 #include "boost/filesystem/convenience.hpp"
 
@@ -114,13 +116,19 @@ ObjectPtr DeepImageConverter::doOperation( const CompoundObject *operands )
 		writer->worldToNDCParameter()->setValue( worldToNDC );
 	}
 	
-	for ( int y=dataWindow.min.y; y <= dataWindow.max.y; ++y )
+	// Convert in bands of scanlines, so that we never need
+	// to hold all the deep samples in memory at once.
+	const int bandHeight = 64;
+	for ( int y=dataWindow.min.y; y <= dataWindow.max.y; y += bandHeight )
 	{
-		for ( int x=dataWindow.min.x; x <= dataWindow.max.x; ++x )
-		{
-			DeepPixelPtr pixel = reader->readPixel( x, y );
-			writer->writePixel( x, y, pixel.get() );
-		}
+		const Imath::Box2i band(
+			Imath::V2i( dataWindow.min.x, y ),
+			Imath::V2i( dataWindow.max.x, std::min( y + bandHeight - 1, dataWindow.max.y ) )
+		);
+		
+		DeepTilePtr tile = reader->readTile( band );
+		tile->sortSamples();
+		writer->writeTile( tile.get() );
 	}
 	
 	return new StringData( writer->fileName() );
@@ -32,6 +32,8 @@
 //
 //////////////////////////////////////////////////////////////////////////
 
+#include <algorithm>
+
 #include "IECore/DeepImageReader.h"
 #include "IECore/FileNameParameter.h"
 #include "IECore/ImagePrimitive.h"
@@ -75,27 +77,25 @@ ObjectPtr DeepImageReader::doOperation( const CompoundObject *operands )
 		image->variables[*cIt] = PrimitiveVariable( PrimitiveVariable::Vertex, data );
 	}
 
-	DeepPixelPtr pixel = 0;
-	float channelData[channels.size()];
-	
-	unsigned p = 0;
-	for ( int y=dataWind.min.y; y < dataWind.max.y + 1; ++y )
+	// Composite the image in bands of scanlines, so that we never
+	// need to hold all the deep samples in memory at once.
+	const int bandHeight = 64;
+	for ( int y=dataWind.min.y; y <= dataWind.max.y; y += bandHeight )
 	{
-		for ( int x=dataWind.min.x; x < dataWind.max.x + 1; ++x, ++p )
+		const Imath::Box2i band(
+			Imath::V2i( dataWind.min.x, y ),
+			Imath::V2i( dataWind.max.x, std::min( y + bandHeight - 1, dataWind.max.y ) )
+		);
+
+		DeepTilePtr tile = readTile( band );
+		tile->sortSamples();
+		ConstImagePrimitivePtr bandImage = tile->composite();
+
+		const size_t offset = ( y - dataWind.min.y ) * pixelDimensions.x;
+		for ( unsigned c=0; c < numChannels; ++c )
 		{
-			pixel = readPixel( x, y );
-			
-			if ( !pixel )
-			{
-				continue;
-			}
-			
-			pixel->composite( channelData );
-			
-			for ( unsigned c=0; c < numChannels; ++c )
-			{
-				(*primVarData[c])[p] = channelData[c];
-			}
+			const std::vector<float> &bandData = bandImage->getChannel<float>( channels[c] )->readable();
+			std::copy( bandData.begin(), bandData.end(), primVarData[c]->begin() + offset );
 		}
 	}
 	
@@ -113,6 +113,62 @@ DeepPixelPtr DeepImageReader::readPixel( int x, int y )
 	return doReadPixel( x, y );
 }
 
+DeepTilePtr DeepImageReader::readTile( const Imath::Box2i &window )
+{
+	const Imath::Box2i dataWind = dataWindow();
+	if( window.isEmpty() || !dataWind.intersects( window.min ) || !dataWind.intersects( window.max ) )
+	{
+		throw Exception( "Requested tile not in available data window." );
+	}
+
+	return doReadTile( window );
+}
+
+DeepTilePtr DeepImageReader::doReadTile( const Imath::Box2i &window )
+{
+	std::vector<std::string> channels;
+	channelNames( channels );
+	const unsigned numChannels = channels.size();
+
+	DeepTilePtr tile = new DeepTile( window, channels );
+	const unsigned numPixels = tile->numPixels();
+
+	std::vector<DeepPixelPtr> pixels( numPixels );
+	std::vector<unsigned> sampleCounts( numPixels, 0 );
+
+	unsigned p = 0;
+	for ( int y=window.min.y; y <= window.max.y; ++y )
+	{
+		for ( int x=window.min.x; x <= window.max.x; ++x, ++p )
+		{
+			pixels[p] = doReadPixel( x, y );
+			if ( pixels[p] )
+			{
+				sampleCounts[p] = pixels[p]->numSamples();
+			}
+		}
+	}
+
+	tile->setSampleCounts( sampleCounts );
+
+	std::vector<float> &depths = tile->depths();
+	for ( p=0; p < numPixels; ++p )
+	{
+		const unsigned offset = tile->sampleOffset( p );
+		for ( unsigned i=0; i < sampleCounts[p]; ++i )
+		{
+			depths[offset+i] = pixels[p]->getDepth( i );
+			const float *data = pixels[p]->channelData( i );
+			for ( unsigned c=0; c < numChannels; ++c )
+			{
+				tile->channelData( c )[offset+i] = data[c];
+			}
+		}
+	}
+
+	return tile;
+}
+
 CompoundObjectPtr DeepImageReader::readHeader()
 {
 	std::vector<std::string> names;
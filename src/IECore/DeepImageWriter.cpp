@@ -125,6 +125,37 @@ void DeepImageWriter::writePixel( int x, int y, const DeepPixel *pixel )
 	doWritePixel( x, y, pixel );
 }
 
+void DeepImageWriter::writeTile( const DeepTile *tile )
+{
+	if ( !tile )
+	{
+		return;
+	}
+	
+	if ( tile->numChannels() != m_channelsParameter->getTypedValue().size() )
+	{
+		throw InvalidArgumentException( std::string( "DeepTile does not have the correct channels." ) );
+	}
+	
+	doWriteTile( tile );
+}
+
+void DeepImageWriter::doWriteTile( const DeepTile *tile )
+{
+	const Imath::Box2i &window = tile->window();
+	for ( int y=window.min.y; y <= window.max.y; ++y )
+	{
+		for ( int x=window.min.x; x <= window.max.x; ++x )
+		{
+			ConstDeepPixelPtr pixel = tile->pixel( x, y );
+			if ( pixel )
+			{
+				doWritePixel( x, y, pixel.get() );
+			}
+		}
+	}
+}
+
 void DeepImageWriter::registerDeepImageWriter( const std::string &extensions, CanWriteFn canWrite, CreatorFn creator, TypeId typeId )
 {
 	assert( canWrite );
@@ -0,0 +1,449 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2014, Image Engine Design Inc. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+//     * Neither the name of Image Engine Design nor the names of any
+//       other contributors to this software may be used to endorse or
+//       promote products derived from this software without specific prior
+//       written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+
+#include "boost/format.hpp"
+
+#include "tbb/parallel_for.h"
+
+#include "IECore/DeepTile.h"
+#include "IECore/Exception.h"
+#include "IECore/VectorTypedData.h"
+
+using namespace IECore;
+using namespace tbb;
+
+DeepTile::DeepTile( const Imath::Box2i &window, const std::vector<std::string> &channelNames )
+	:	m_window( window ), m_channelNames( channelNames ), m_channelData( channelNames.size() )
+{
+	if( window.isEmpty() )
+	{
+		throw InvalidArgumentException( "DeepTile: Window must not be empty" );
+	}
+
+	m_sampleOffsets.resize( numPixels() + 1, 0 );
+}
+
+DeepTile::~DeepTile()
+{
+}
+
+const Imath::Box2i &DeepTile::window() const
+{
+	return m_window;
+}
+
+unsigned DeepTile::numPixels() const
+{
+	const Imath::V2i size = m_window.size() + Imath::V2i( 1 );
+	return size.x * size.y;
+}
+
+unsigned DeepTile::pixelIndex( int x, int y ) const
+{
+	if( !m_window.intersects( Imath::V2i( x, y ) ) )
+	{
+		throw InvalidArgumentException( ( boost::format( "DeepTile::pixelIndex: Pixel %d, %d is not within the tile" ) % x % y ).str() );
+	}
+
+	return ( y - m_window.min.y ) * ( m_window.size().x + 1 ) + x - m_window.min.x;
+}
+
+unsigned DeepTile::numChannels() const
+{
+	return m_channelNames.size();
+}
+
+int DeepTile::channelIndex( const std::string &name ) const
+{
+	std::vector<std::string>::const_iterator it = std::find( m_channelNames.begin(), m_channelNames.end(), name );
+	if ( it == m_channelNames.end() )
+	{
+		return -1;
+	}
+
+	return it - m_channelNames.begin();
+}
+
+const std::vector<std::string> &DeepTile::channelNames() const
+{
+	return m_channelNames;
+}
+
+void DeepTile::setSampleCounts( const std::vector<unsigned> &sampleCounts )
+{
+	const unsigned numPixels = this->numPixels();
+	if( sampleCounts.size() != numPixels )
+	{
+		throw InvalidArgumentException( ( boost::format( "DeepTile::setSampleCounts: Expected %d sample counts" ) % numPixels ).str() );
+	}
+
+	unsigned offset = 0;
+	for( unsigned p = 0; p < numPixels; ++p )
+	{
+		m_sampleOffsets[p] = offset;
+		offset += sampleCounts[p];
+	}
+	m_sampleOffsets[numPixels] = offset;
+
+	m_depths.assign( offset, 0.0f );
+	for( std::vector<std::vector<float> >::iterator it = m_channelData.begin(); it != m_channelData.end(); ++it )
+	{
+		it->assign( offset, 0.0f );
+	}
+}
+
+unsigned DeepTile::numSamples() const
+{
+	return m_sampleOffsets.back();
+}
+
+unsigned DeepTile::sampleCount( unsigned pixelIndex ) const
+{
+	return m_sampleOffsets[pixelIndex+1] - m_sampleOffsets[pixelIndex];
+}
+
+unsigned DeepTile::sampleOffset( unsigned pixelIndex ) const
+{
+	return m_sampleOffsets[pixelIndex];
+}
+
+std::vector<float> &DeepTile::depths()
+{
+	return m_depths;
+}
+
+const std::vector<float> &DeepTile::depths() const
+{
+	return m_depths;
+}
+
+std::vector<float> &DeepTile::channelData( unsigned channelIndex )
+{
+	if( channelIndex >= m_channelData.size() )
+	{
+		throw InvalidArgumentException( ( boost::format( "DeepTile::channelData: Channel index %d does not exist" ) % channelIndex ).str() );
+	}
+
+	return m_channelData[channelIndex];
+}
+
+const std::vector<float> &DeepTile::channelData( unsigned channelIndex ) const
+{
+	return const_cast<DeepTile *>( this )->channelData( channelIndex );
+}
+
+DeepPixelPtr DeepTile::pixel( int x, int y ) const
+{
+	const unsigned p = pixelIndex( x, y );
+	const unsigned numSamples = sampleCount( p );
+	if( !numSamples )
+	{
+		return 0;
+	}
+
+	const unsigned numChannels = this->numChannels();
+	DeepPixelPtr result = new DeepPixel( m_channelNames, numSamples );
+
+	std::vector<float> channelData( numChannels );
+	for( unsigned i = m_sampleOffsets[p], e = m_sampleOffsets[p+1]; i < e; ++i )
+	{
+		for( unsigned c = 0; c < numChannels; ++c )
+		{
+			channelData[c] = m_channelData[c][i];
+		}
+		result->addSample( m_depths[i], numChannels ? &channelData[0] : 0 );
+	}
+
+	return result;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Sorting
+//////////////////////////////////////////////////////////////////////////
+
+class DeepTile::SortSamples
+{
+
+	public :
+
+		SortSamples( DeepTile *tile )
+			:	m_tile( tile )
+		{
+		}
+
+		void operator()( const blocked_range<unsigned> &range ) const
+		{
+			std::vector<unsigned> order;
+			std::vector<float> scratch;
+
+			std::vector<float> &depths = m_tile->m_depths;
+			for( unsigned p = range.begin(); p != range.end(); ++p )
+			{
+				const unsigned begin = m_tile->m_sampleOffsets[p];
+				const unsigned end = m_tile->m_sampleOffsets[p+1];
+
+				bool sorted = true;
+				for( unsigned i = begin + 1; i < end; ++i )
+				{
+					if( depths[i] < depths[i-1] )
+					{
+						sorted = false;
+						break;
+					}
+				}
+
+				if( sorted )
+				{
+					continue;
+				}
+
+				order.resize( end - begin );
+				for( unsigned i = 0; i < order.size(); ++i )
+				{
+					order[i] = begin + i;
+				}
+				std::stable_sort( order.begin(), order.end(), DepthComparison( depths ) );
+
+				permute( order, begin, depths, scratch );
+				for( std::vector<std::vector<float> >::iterator it = m_tile->m_channelData.begin(); it != m_tile->m_channelData.end(); ++it )
+				{
+					permute( order, begin, *it, scratch );
+				}
+			}
+		}
+
+	private :
+
+		struct DepthComparison
+		{
+			DepthComparison( const std::vector<float> &depths )
+				:	m_depths( depths )
+			{
+			}
+
+			bool operator()( unsigned a, unsigned b ) const
+			{
+				return m_depths[a] < m_depths[b];
+			}
+
+			const std::vector<float> &m_depths;
+		};
+
+		static void permute( const std::vector<unsigned> &order, unsigned begin, std::vector<float> &data, std::vector<float> &scratch )
+		{
+			scratch.resize( order.size() );
+			for( unsigned i = 0; i < order.size(); ++i )
+			{
+				scratch[i] = data[order[i]];
+			}
+			std::copy( scratch.begin(), scratch.end(), data.begin() + begin );
+		}
+
+		DeepTile *m_tile;
+
+};
+
+void DeepTile::sortSamples()
+{
+	parallel_for( blocked_range<unsigned>( 0, numPixels() ), SortSamples( this ) );
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Merging
+//////////////////////////////////////////////////////////////////////////
+
+class DeepTile::MergeSamples
+{
+
+	public :
+
+		MergeSamples( const DeepTile *a, const DeepTile *b, DeepTile *result )
+			:	m_a( a ), m_b( b ), m_result( result )
+		{
+		}
+
+		void operator()( const blocked_range<unsigned> &range ) const
+		{
+			const unsigned numChannels = m_result->numChannels();
+			for( unsigned p = range.begin(); p != range.end(); ++p )
+			{
+				unsigned i = m_a->m_sampleOffsets[p];
+				unsigned j = m_b->m_sampleOffsets[p];
+				const unsigned iEnd = m_a->m_sampleOffsets[p+1];
+				const unsigned jEnd = m_b->m_sampleOffsets[p+1];
+				unsigned k = m_result->m_sampleOffsets[p];
+
+				while( i < iEnd || j < jEnd )
+				{
+					const bool fromA = j >= jEnd || ( i < iEnd && m_a->m_depths[i] <= m_b->m_depths[j] );
+					const DeepTile *source = fromA ? m_a : m_b;
+					unsigned &s = fromA ? i : j;
+
+					m_result->m_depths[k] = source->m_depths[s];
+					for( unsigned c = 0; c < numChannels; ++c )
+					{
+						m_result->m_channelData[c][k] = source->m_channelData[c][s];
+					}
+
+					++s;
+					++k;
+				}
+			}
+		}
+
+	private :
+
+		const DeepTile *m_a;
+		const DeepTile *m_b;
+		DeepTile *m_result;
+
+};
+
+void DeepTile::merge( const DeepTile *tile )
+{
+	if( tile->m_window != m_window || tile->m_channelNames != m_channelNames )
+	{
+		throw InvalidArgumentException( "DeepTile::merge: Tiles must have the same window and channels" );
+	}
+
+	const unsigned numPixels = this->numPixels();
+	std::vector<unsigned> sampleCounts( numPixels );
+	for( unsigned p = 0; p < numPixels; ++p )
+	{
+		sampleCounts[p] = sampleCount( p ) + tile->sampleCount( p );
+	}
+
+	DeepTilePtr result = new DeepTile( m_window, m_channelNames );
+	result->setSampleCounts( sampleCounts );
+
+	parallel_for( blocked_range<unsigned>( 0, numPixels ), MergeSamples( this, tile, result.get() ) );
+
+	m_sampleOffsets.swap( result->m_sampleOffsets );
+	m_depths.swap( result->m_depths );
+	m_channelData.swap( result->m_channelData );
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Compositing
+//////////////////////////////////////////////////////////////////////////
+
+class DeepTile::CompositeSamples
+{
+
+	public :
+
+		CompositeSamples( const DeepTile *tile, const std::vector<float *> &result )
+			:	m_tile( tile ), m_alphaChannel( tile->channelIndex( "A" ) ), m_result( result )
+		{
+		}
+
+		void operator()( const blocked_range<unsigned> &range ) const
+		{
+			const unsigned numChannels = m_tile->numChannels();
+			std::vector<float> weights;
+
+			for( unsigned p = range.begin(); p != range.end(); ++p )
+			{
+				const unsigned begin = m_tile->m_sampleOffsets[p];
+				const unsigned numSamples = m_tile->m_sampleOffsets[p+1] - begin;
+				if( !numSamples )
+				{
+					continue;
+				}
+
+				if( m_alphaChannel < 0 )
+				{
+					for( unsigned c = 0; c < numChannels; ++c )
+					{
+						m_result[c][p] = m_tile->m_channelData[c][begin];
+					}
+					continue;
+				}
+
+				// Find the contribution of each sample using only the alpha channel,
+				// so that every channel can then be accumulated as a dot product
+				// over contiguous memory.
+				const float *alpha = &m_tile->m_channelData[m_alphaChannel][begin];
+				weights.resize( numSamples );
+				float accumulatedAlpha = 0.0f;
+				float weight = 1.0f;
+				unsigned n = 0;
+				for( ; n < numSamples && accumulatedAlpha < 1.0f; ++n )
+				{
+					weights[n] = weight;
+					accumulatedAlpha += alpha[n] * weight;
+					weight = std::max( 1.0f - accumulatedAlpha, 0.0f );
+				}
+
+				for( unsigned c = 0; c < numChannels; ++c )
+				{
+					const float *data = &m_tile->m_channelData[c][begin];
+					float sum = 0.0f;
+					for( unsigned i = 0; i < n; ++i )
+					{
+						sum += data[i] * weights[i];
+					}
+					m_result[c][p] = sum;
+				}
+			}
+		}
+
+	private :
+
+		const DeepTile *m_tile;
+		int m_alphaChannel;
+		const std::vector<float *> &m_result;
+
+};
+
+ImagePrimitivePtr DeepTile::composite() const
+{
+	const unsigned numPixels = this->numPixels();
+	ImagePrimitivePtr result = new ImagePrimitive( m_window, m_window );
+
+	std::vector<float *> channelResults;
+	channelResults.reserve( m_channelNames.size() );
+	for( std::vector<std::string>::const_iterator it = m_channelNames.begin(); it != m_channelNames.end(); ++it )
+	{
+		FloatVectorDataPtr data = new FloatVectorData( std::vector<float>( numPixels, 0.0f ) );
+		channelResults.push_back( &data->writable()[0] );
+		result->variables[*it] = PrimitiveVariable( PrimitiveVariable::Vertex, data );
+	}
+
+	parallel_for( blocked_range<unsigned>( 0, numPixels ), CompositeSamples( this, channelResults ) );
+
+	return result;
+}
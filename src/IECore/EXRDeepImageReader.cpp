@@ -235,6 +235,99 @@ DeepPixelPtr EXRDeepImageReader::doReadPixel( int x, int y )
 	return pixel;
 }
 
+DeepTilePtr EXRDeepImageReader::doReadTile( const Imath::Box2i &window )
+{
+	open( true );
+	
+	const Imath::Box2i dataWindow = m_inputFile->header().dataWindow();
+	const size_t width = dataWindow.max.x - dataWindow.min.x + 1;
+	const size_t height = window.max.y - window.min.y + 1;
+	
+	// The file can only be read in whole scanlines, so we read the sample
+	// counts for the full width of the dataWindow, and will discard any
+	// samples outside the window when we read the pixels.
+	std::vector<unsigned> scanlineSampleCounts( width * height );
+	
+	Imf::DeepFrameBuffer frameBuffer;
+	frameBuffer.insertSampleCountSlice(
+		Imf::Slice(
+			Imf::UINT, reinterpret_cast< char * >( &scanlineSampleCounts[0] - dataWindow.min.x - window.min.y * width ),
+			sizeof( unsigned ), sizeof( unsigned ) * width
+		)
+	);
+	
+	m_inputFile->setFrameBuffer( frameBuffer );
+	m_inputFile->readPixelSampleCounts( window.min.y, window.max.y );
+	
+	DeepTilePtr tile = new DeepTile( window, m_channelNames );
+	
+	std::vector<unsigned> sampleCounts( tile->numPixels() );
+	unsigned maxSampleCount = 0;
+	for ( size_t row=0, p=0; row < height; ++row )
+	{
+		for ( int x=window.min.x; x <= window.max.x; ++x, ++p )
+		{
+			sampleCounts[p] = scanlineSampleCounts[ row * width + x - dataWindow.min.x ];
+		}
+		for ( size_t i=0; i < width; ++i )
+		{
+			maxSampleCount = std::max( maxSampleCount, scanlineSampleCounts[ row * width + i ] );
+		}
+	}
+	
+	tile->setSampleCounts( sampleCounts );
+	
+	// Samples for pixels outside the window are read into a scratch buffer.
+	// Each scanline has its own region of the buffer, as the library may
+	// decode different scanlines concurrently.
+	const size_t numFileChannels = m_channelTypes.size();
+	std::vector<float> scratch( height * numFileChannels * maxSampleCount + 1 );
+	
+	// The library performs the conversion from half to float for us,
+	// so every slice can point directly at the tile's float arrays.
+	std::vector<std::vector<float *> > pointers( numFileChannels, std::vector<float *>( width * height ) );
+	
+	const Imf::ChannelList &channels = m_inputFile->header().channels();
+	int c = 0;
+	for ( Imf::ChannelList::ConstIterator it = channels.begin(); it != channels.end(); ++it, ++c )
+	{
+		std::vector<float> &samples = ( c == m_depthChannel ) ? tile->depths() : tile->channelData( c > m_depthChannel ? c - 1 : c );
+		float *samplesBase = samples.empty() ? 0 : &samples[0];
+		std::vector<float *> &channelPointers = pointers[c];
+		
+		for ( size_t row=0; row < height; ++row )
+		{
+			const int y = window.min.y + row;
+			float *scratchBase = &scratch[ ( row * numFileChannels + c ) * maxSampleCount ];
+			for ( size_t i=0; i < width; ++i )
+			{
+				const int x = dataWindow.min.x + i;
+				if ( x >= window.min.x && x <= window.max.x )
+				{
+					channelPointers[ row * width + i ] = samplesBase + tile->sampleOffset( tile->pixelIndex( x, y ) );
+				}
+				else
+				{
+					channelPointers[ row * width + i ] = scratchBase;
+				}
+			}
+		}
+		
+		frameBuffer.insert(
+			it.name(),
+			Imf::DeepSlice(
+				Imf::FLOAT, reinterpret_cast< char * >( &channelPointers[0] - dataWindow.min.x - window.min.y * width ),
+				sizeof( float * ), sizeof( float * ) * width, sizeof( float )
+			)
+		);
+	}
+	
+	m_inputFile->setFrameBuffer( frameBuffer );
+	m_inputFile->readPixels( window.min.y, window.max.y );
+	
+	return tile;
+}
+
 EXRDeepImageReader::Scanline::Scanline( size_t width, size_t numChannels )
 	: sampleCount( width ), pointers( width * numChannels ), data()
 {
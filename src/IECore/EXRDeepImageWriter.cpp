@@ -31,6 +31,9 @@
 //  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 //
 //////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+
 #include "OpenEXR/ImfChannelList.h"
 #include "OpenEXR/ImfPartType.h"
 #include "OpenEXR/ImfDeepFrameBuffer.h"
@@ -277,6 +280,104 @@ void EXRDeepImageWriter::doWritePixel( int x, int y, const DeepPixel *pixel )
 	}
 }
 
+void EXRDeepImageWriter::doWriteTile( const DeepTile *tile )
+{
+	open();
+	
+	const Imath::Box2i &window = tile->window();
+	Imath::Box2i dataWindow( m_outputFile->header().dataWindow() );
+	if (
+		window.min.x != dataWindow.min.x || window.max.x != dataWindow.max.x ||
+		window.min.y < m_currentSlice || window.max.y > m_lastSlice
+	)
+	{
+		// Writing pixel by pixel will report any ordering problems for us.
+		DeepImageWriter::doWriteTile( tile );
+		return;
+	}
+	
+	// Write any scanlines preceding the tile.
+	while ( m_currentSlice < window.min.y )
+	{
+		writeScanline();
+	}
+	
+	// If pixels have already been written to the first scanline of the tile,
+	// merge the tile's pixels into the scanline buffer and write it out, so
+	// that the result is the same as writing the tile pixel by pixel.
+	if ( std::count( m_sampleCount.begin(), m_sampleCount.end(), 0u ) != (std::ptrdiff_t)m_sampleCount.size() )
+	{
+		for ( int x = window.min.x; x <= window.max.x; ++x )
+		{
+			ConstDeepPixelPtr pixel = tile->pixel( x, m_currentSlice );
+			if ( pixel )
+			{
+				doWritePixel( x, m_currentSlice, pixel.get() );
+			}
+		}
+		writeScanline();
+		
+		if ( m_currentSlice > window.max.y )
+		{
+			return;
+		}
+	}
+	
+	const unsigned numPixels = tile->numPixels();
+	std::vector<unsigned> sampleCounts( numPixels );
+	for ( unsigned p = 0; p < numPixels; ++p )
+	{
+		sampleCounts[p] = tile->sampleCount( p );
+	}
+	
+	Imf::DeepFrameBuffer frameBuffer;
+	frameBuffer.insertSampleCountSlice( 
+		Imf::Slice( Imf::UINT, reinterpret_cast< char *>( &sampleCounts[0] - dataWindow.min.x - window.min.y * m_width ),
+			sizeof( unsigned int ),
+			sizeof( unsigned int ) * m_width
+		)
+	);
+	
+	// The library performs the conversion from float to half for us,
+	// so every slice can point directly at the tile's float arrays.
+	std::vector< std::vector< const float * > > pointers( numberOfChannels() + 1, std::vector< const float * >( numPixels ) );
+	for ( unsigned int c = 0; c <= numberOfChannels(); ++c )
+	{
+		const std::vector<float> *samples = &tile->depths();
+		std::string name = "Z";
+		if ( c < numberOfChannels() )
+		{
+			name = channelName( c );
+			int channelIndex = tile->channelIndex( name );
+			if ( channelIndex < 0 )
+			{
+				throw InvalidArgumentException( "DeepTile does not have channel \"" + name + "\"." );
+			}
+			samples = &tile->channelData( channelIndex );
+		}
+		
+		const float *samplesBase = samples->empty() ? 0 : &(*samples)[0];
+		for ( unsigned p = 0; p < numPixels; ++p )
+		{
+			pointers[c][p] = samplesBase + tile->sampleOffset( p );
+		}
+		
+		frameBuffer.insert(
+			name,
+			Imf::DeepSlice(
+				Imf::FLOAT, reinterpret_cast< char * >( &pointers[c][0] - dataWindow.min.x - window.min.y * m_width ),
+				sizeof( float * ), sizeof( float * ) * m_width, sizeof( float )
+			)
+		);
+	}
+	
+	m_outputFile->setFrameBuffer( frameBuffer );
+	m_outputFile->writePixels( window.max.y - m_currentSlice + 1 );
+	
+	m_currentSlice = window.max.y + 1;
+	clearScanlineBuffer();
+}
+
 Imf::Compression EXRDeepImageWriter::compression() const
 {
 	return static_cast< Imf::Compression >( parameters()->parameter<IECore::IntParameter>("compression")->getNumericValue() );
@@ -176,134 +176,170 @@ std::string EXRImageReader::sourceColorSpace() const
 	return "linear";
 }
 
-template<class T>
-DataPtr EXRImageReader::readTypedChannel( const std::string &name, const Imath::Box2i &dataWindow, const Imf::Channel *channel )
+DataPtr EXRImageReader::readChannel( const string &name, const Imath::Box2i &dataWindow, bool raw )
 {
-	assert( channel );
-	Imath::V2i pixelDimensions = dataWindow.size() + Imath::V2i( 1 );
-	unsigned numPixels = pixelDimensions.x * pixelDimensions.y;
-
-	typedef TypedData<vector<T> > DataType;
-	typename DataType::Ptr data = new DataType;
-	data->writable().resize( numPixels );
-
-	Imath::Box2i fullDataWindow = this->dataWindow();
-	if( fullDataWindow.min.x==dataWindow.min.x && fullDataWindow.max.x==dataWindow.max.x )
-	{
-		// the width we want to read matches the width in the file, so we can read straight
-		// into the result buffer
-		FrameBuffer frameBuffer;
-		T *buffer00 = data->baseWritable() - dataWindow.min.y * pixelDimensions.x - fullDataWindow.min.x;
-		Slice slice( channel->type, (char *)buffer00, sizeof(T), sizeof(T) * pixelDimensions.x );
-		frameBuffer.insert( name.c_str(), slice );
-		m_inputFile->setFrameBuffer( frameBuffer );
-		// exr library will choose the best order to read scanlines automatically (increasing or decreasing)
-		try
-		{
-			m_inputFile->readPixels( dataWindow.min.y, dataWindow.max.y );
-		}
-		catch( Iex::InputExc &e )
-		{
-			// so we can read incomplete files
-			msg( Msg::Warning, "EXRImageReader::readChannel", e.what() );
-			return data;
-		}
-	}
-	else
-	{
-		// widths don't match, we need to read into a temporary buffer and then transfer just
-		// the bits we need into the result buffer.
-		int numTmpPixels = fullDataWindow.size().x + 1;
-		vector<T> tmpBuffer( numTmpPixels );
-		T *tmpBufferTransferStart = &(tmpBuffer[0]) + dataWindow.min.x - fullDataWindow.min.x;
-		size_t tmpBufferTransferLength = pixelDimensions.x * sizeof( T );
-		T *transferDestination = &(data->writable()[0]);
-
-		// slice has yStride of 0 so each successive scanline just overwrites the previous one
-		Slice slice( channel->type, (char *)(&(tmpBuffer[0]) - fullDataWindow.min.x), sizeof(T), 0 );
-		FrameBuffer frameBuffer;
-		frameBuffer.insert( name.c_str(), slice );
-		m_inputFile->setFrameBuffer( frameBuffer );
-
-		int yStart = dataWindow.min.y;
-		int yEnd = dataWindow.max.y;
-		int yStep = 1;
-		try
-		{
-			for( int y=yStart; y!=(yEnd+yStep); y+=yStep )
-			{
-				m_inputFile->readPixels( y );
-				memcpy( (char *)transferDestination, (const char *)tmpBufferTransferStart, tmpBufferTransferLength );
-				transferDestination += pixelDimensions.x;
-			}
-		}
-		catch( Iex::InputExc &e )
-		{
-			// so we can read incomplete files
-			msg( Msg::Warning, "EXRImageReader::readChannel", e.what() );
-			return data;
-		}
-	}
+	vector<string> names( 1, name );
+	vector<DataPtr> channels;
+	readChannels( names, dataWindow, raw, channels );
+	return channels[0];
+}
 
-#ifndef NDEBUG
-	for ( typename DataType::ValueType::const_iterator it = data->readable().begin(); it != data->readable().end(); ++it )
-	{
-		assert( *it == *it ); // Will fail iff NaN
-	}
-#endif
+// Maximum size of the temporary buffers used when reading a data window
+// narrower than the one in the file.
+static const size_t g_maxBandSize = 32 * 1024 * 1024;
 
-	return data;
+template<typename T>
+static char *allocateChannel( size_t numPixels, DataPtr &data )
+{
+	typename TypedData<vector<T> >::Ptr typedData = new TypedData<vector<T> >;
+	typedData->writable().resize( numPixels );
+	data = typedData;
+	return (char *)typedData->baseWritable();
 }
 
-DataPtr EXRImageReader::readChannel( const string &name, const Imath::Box2i &dataWindow, bool raw )
+void EXRImageReader::readChannels( const std::vector<std::string> &names, const Imath::Box2i &dataWindow, bool raw, std::vector<DataPtr> &channels )
 {
 	open( true );
 
 	try
 	{
+		const Imath::V2i pixelDimensions = dataWindow.size() + Imath::V2i( 1 );
+		const size_t numPixels = pixelDimensions.x * pixelDimensions.y;
+		const Box2i fullDataWindow = this->dataWindow();
+		const size_t fullWidth = fullDataWindow.size().x + 1;
+
+		// allocate the result buffers for all the channels
+
+		channels.clear();
+		channels.resize( names.size() );
+		vector<const Channel *> exrChannels( names.size() );
+		vector<char *> buffers( names.size() );
+		vector<size_t> elementSizes( names.size() );
+		size_t pixelSize = 0;
+		for( size_t i = 0; i < names.size(); ++i )
+		{
+			const Channel *channel = m_inputFile->header().channels().findChannel( names[i].c_str() );
+			assert( channel );
+			assert( channel->xSampling==1 ); /// \todo Support subsampling when we have a need for it
+			assert( channel->ySampling==1 );
+
+			switch( channel->type )
+			{
+				case UINT :
+					BOOST_STATIC_ASSERT( sizeof( unsigned int ) == 4 );
+					buffers[i] = allocateChannel<unsigned int>( numPixels, channels[i] );
+					elementSizes[i] = sizeof( unsigned int );
+					break;
+				case HALF :
+					buffers[i] = allocateChannel<half>( numPixels, channels[i] );
+					elementSizes[i] = sizeof( half );
+					break;
+				case FLOAT :
+					BOOST_STATIC_ASSERT( sizeof( float ) == 4 );
+					buffers[i] = allocateChannel<float>( numPixels, channels[i] );
+					elementSizes[i] = sizeof( float );
+					break;
+				default:
+					throw IOException( ( boost::format( "EXRImageReader : Unsupported data type for channel \"%s\"" ) % names[i] ).str() );
+			}
+			exrChannels[i] = channel;
+			pixelSize += elementSizes[i];
+		}
 
-		const Channel *channel = m_inputFile->header().channels().findChannel( name.c_str() );
-		assert( channel );
-		assert( channel->xSampling==1 ); /// \todo Support subsampling when we have a need for it
-		assert( channel->ySampling==1 );
+		// read the pixels for all the channels at once. the exr library will choose the
+		// best order to read scanlines automatically (increasing or decreasing), and will
+		// decompress blocks of scanlines in parallel if the host application has enabled
+		// the global thread pool.
 
-		DataPtr res;
-		switch( channel->type )
+		try
 		{
-			case UINT :
-				BOOST_STATIC_ASSERT( sizeof( unsigned int ) == 4 );
-				res = readTypedChannel<unsigned int>( name, dataWindow, channel );
-				if ( raw )
+			if( fullDataWindow.min.x==dataWindow.min.x && fullDataWindow.max.x==dataWindow.max.x )
+			{
+				// the width we want to read matches the width in the file, so we can read straight
+				// into the result buffers
+				FrameBuffer frameBuffer;
+				for( size_t i = 0; i < names.size(); ++i )
 				{
-					return res;
+					char *buffer00 = buffers[i] - ( dataWindow.min.y * pixelDimensions.x + fullDataWindow.min.x ) * elementSizes[i];
+					frameBuffer.insert( names[i].c_str(), Slice( exrChannels[i]->type, buffer00, elementSizes[i], elementSizes[i] * pixelDimensions.x ) );
 				}
-				else
+				m_inputFile->setFrameBuffer( frameBuffer );
+				m_inputFile->readPixels( dataWindow.min.y, dataWindow.max.y );
+			}
+			else
+			{
+				// widths don't match, so we read bands of full width scanlines into temporary
+				// buffers and then transfer just the bits we need into the result buffers.
+				const int bandHeight = std::max<int>( 1, std::min<int>( pixelDimensions.y, g_maxBandSize / ( fullWidth * std::max<size_t>( pixelSize, 1 ) ) ) );
+				vector< vector<char> > bands( names.size() );
+				for( size_t i = 0; i < names.size(); ++i )
 				{
-					DataConvert< UIntVectorData, FloatVectorData, ScaledDataConversion< unsigned int, float > > converter;
-					ConstUIntVectorDataPtr vec = boost::static_pointer_cast< UIntVectorData >(res);
-					return converter( vec );
+					bands[i].resize( fullWidth * bandHeight * elementSizes[i] );
 				}
 
-			case HALF :
-				res = readTypedChannel<half>( name, dataWindow, channel );
-				if ( raw )
+				for( int bandMinY = dataWindow.min.y; bandMinY <= dataWindow.max.y; bandMinY += bandHeight )
 				{
-					return res;
+					const int bandMaxY = std::min( bandMinY + bandHeight - 1, dataWindow.max.y );
+
+					FrameBuffer frameBuffer;
+					for( size_t i = 0; i < names.size(); ++i )
+					{
+						char *band00 = &(bands[i][0]) - ( bandMinY * fullWidth + fullDataWindow.min.x ) * elementSizes[i];
+						frameBuffer.insert( names[i].c_str(), Slice( exrChannels[i]->type, band00, elementSizes[i], elementSizes[i] * fullWidth ) );
+					}
+					m_inputFile->setFrameBuffer( frameBuffer );
+					m_inputFile->readPixels( bandMinY, bandMaxY );
+
+					for( size_t i = 0; i < names.size(); ++i )
+					{
+						const size_t rowLength = pixelDimensions.x * elementSizes[i];
+						const char *source = &(bands[i][0]) + ( dataWindow.min.x - fullDataWindow.min.x ) * elementSizes[i];
+						char *destination = buffers[i] + ( bandMinY - dataWindow.min.y ) * rowLength;
+						for( int y = bandMinY; y <= bandMaxY; ++y )
+						{
+							memcpy( destination, source, rowLength );
+							source += fullWidth * elementSizes[i];
+							destination += rowLength;
+						}
+					}
 				}
-				else
-				{
-					DataConvert< HalfVectorData, FloatVectorData, ScaledDataConversion< half, float > > converter;
-					ConstHalfVectorDataPtr vec = boost::static_pointer_cast< HalfVectorData >(res);
-					return converter( vec );
-				}
-
-			case FLOAT :
-				BOOST_STATIC_ASSERT( sizeof( float ) == 4 );
-				return readTypedChannel<float>( name, dataWindow, channel );
+			}
+		}
+		catch( Iex::InputExc &e )
+		{
+			// so we can read incomplete files
+			for( size_t i = 0; i < names.size(); ++i )
+			{
+				msg( Msg::Warning, "EXRImageReader::readChannel", boost::format( "Channel \"%s\" is incomplete : %s" ) % names[i] % e.what() );
+			}
+		}
 
-			default:
-				throw IOException( ( boost::format( "EXRImageReader : Unsupported data type for channel \"%s\"" ) % name ).str() );
+		if( raw )
+		{
+			return;
+		}
 
+		for( size_t i = 0; i < names.size(); ++i )
+		{
+			switch( exrChannels[i]->type )
+			{
+				case UINT :
+					{
+						DataConvert< UIntVectorData, FloatVectorData, ScaledDataConversion< unsigned int, float > > converter;
+						ConstUIntVectorDataPtr vec = boost::static_pointer_cast< UIntVectorData >( channels[i] );
+						channels[i] = converter( vec );
+					}
+					break;
+				case HALF :
+					{
+						DataConvert< HalfVectorData, FloatVectorData, ScaledDataConversion< half, float > > converter;
+						ConstHalfVectorDataPtr vec = boost::static_pointer_cast< HalfVectorData >( channels[i] );
+						channels[i] = converter( vec );
+					}
+					break;
+				default :
+					break;
+			}
 		}
 	}
 	catch ( Exception &e )
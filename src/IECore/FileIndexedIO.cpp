@@ -32,7 +32,10 @@
 //
 //////////////////////////////////////////////////////////////////////////
 
+#include <string.h>
+
 #include "boost/filesystem/operations.hpp"
+#include "boost/iostreams/device/mapped_file.hpp"
 
 #include "IECore/MessageHandler.h"
 #include "IECore/FileIndexedIO.h"
@@ -66,6 +69,20 @@ class FileIndexedIO::StreamFile : public StreamIndexedIO::StreamFile
 
 		void flush( size_t endPosition );
 
+		/// Reads directly from the memory mapped file when opened in read-only mode,
+		/// so that concurrent reads don't have to be serialised by the stream mutex.
+		virtual void readAt( char *buffer, size_t size, Imf::Int64 pos );
+
+		virtual const char *mappedData( Imf::Int64 pos, size_t size ) const;
+
+		virtual std::string directory() const;
+
+	private :
+
+		void mapFile();
+
+		boost::iostreams::mapped_file_source m_mappedFile;
+
 };
 
 FileIndexedIO::StreamFile::StreamFile( const std::string &filename, IndexedIO::OpenMode mode ) : StreamIndexedIO::StreamFile(mode), m_filename( filename ), m_endPosition(0)
@@ -143,7 +160,51 @@ FileIndexedIO::StreamFile::StreamFile( const std::string &filename, IndexedIO::O
 			throw IOException( "FileIndexedIO: Caught error reading file '" + filename + "'" );
 		}
 
+		mapFile();
+	}
+}
+
+void FileIndexedIO::StreamFile::mapFile()
+{
+	try
+	{
+		m_mappedFile.open( m_filename );
 	}
+	catch( std::exception &e )
+	{
+		// not fatal - we'll fall back to reading through the stream.
+		msg( Msg::Debug, "FileIndexedIO::StreamFile", boost::format( "Unable to memory map file '%s' : %s" ) % m_filename % e.what() );
+	}
+}
+
+void FileIndexedIO::StreamFile::readAt( char *buffer, size_t size, Imf::Int64 pos )
+{
+	if ( !m_mappedFile.is_open() )
+	{
+		StreamIndexedIO::StreamFile::readAt( buffer, size, pos );
+		return;
+	}
+
+	if ( pos + size > m_mappedFile.size() )
+	{
+		throw IOException( ( boost::format( "FileIndexedIO: Attempt to read beyond the end of file '%s'" ) % m_filename ).str() );
+	}
+
+	memcpy( buffer, m_mappedFile.data() + pos, size );
+}
+
+const char *FileIndexedIO::StreamFile::mappedData( Imf::Int64 pos, size_t size ) const
+{
+	if ( !m_mappedFile.is_open() || pos + size > m_mappedFile.size() )
+	{
+		return 0;
+	}
+	return m_mappedFile.data() + pos;
+}
+
+std::string FileIndexedIO::StreamFile::directory() const
+{
+	return fs::system_complete( fs::path( m_filename ) ).parent_path().string();
 }
 
 void FileIndexedIO::StreamFile::flush( size_t endPosition )
@@ -34,10 +34,11 @@
 
 #include <string.h>
 
-#include "tbb/spin_rw_mutex.h"
+#include "tbb/spin_mutex.h"
+#include "tbb/atomic.h"
 #include "tbb/concurrent_hash_map.h"
 
-#include "boost/multi_index_container.hpp"
+#include "boost/noncopyable.hpp"
 #include "boost/lexical_cast.hpp"
 
 #include "IECore/HashTable.h"
@@ -49,68 +50,143 @@ namespace IECore
 namespace Detail
 {
 
-typedef boost::multi_index::multi_index_container<
-	std::string,
-	boost::multi_index::indexed_by<
-		boost::multi_index::hashed_unique<
-			boost::multi_index::identity<std::string>,
-			Hash<std::string>
-		>
-	>
-> HashSet;
-
-typedef HashSet::nth_index<0>::type Index;
-typedef HashSet::nth_index_const_iterator<0>::type ConstIterator;
-typedef tbb::spin_rw_mutex Mutex;
-
-static HashSet *hashSet()
+/// An insert-only hash table of unique strings, which allows strings which
+/// have already been interned to be found without taking any locks. Nodes are
+/// never modified once they have been published to the readers, and when the
+/// table grows a new array of buckets is built with its own nodes and published
+/// atomically. The old buckets are never deleted, because other threads may
+/// still be searching them - this wastes at most as much memory as the
+/// current buckets use.
+class StringTable : boost::noncopyable
 {
-	static HashSet g_hashSet;
-	return &g_hashSet;
-}
 
-static Mutex *mutex()
-{
-	static Detail::Mutex g_mutex;
-	return &g_mutex;
-}
+	public :
+
+		StringTable()
+		{
+			m_size = 0;
+			m_buckets = new Buckets( 1024 );
+		}
+
+		/// Returns the unique string matching value, or 0 if there
+		/// isn't one. Takes no locks.
+		const std::string *find( const char *value, size_t hash ) const
+		{
+			const Buckets *buckets = m_buckets;
+			for( const Node *node = buckets->heads[hash & buckets->mask]; node; node = node->next )
+			{
+				if( node->hash == hash && strcmp( node->value->c_str(), value ) == 0 )
+				{
+					return node->value;
+				}
+			}
+			return 0;
+		}
+
+		/// Returns the unique string matching value, inserting it
+		/// if necessary.
+		const std::string *insert( const char *value, size_t hash )
+		{
+			Mutex::scoped_lock lock( m_mutex );
+
+			// another thread may have inserted the string while
+			// we were waiting for the lock.
+			if( const std::string *result = find( value, hash ) )
+			{
+				return result;
+			}
+
+			Buckets *buckets = m_buckets;
+			if( m_size >= buckets->mask + 1 )
+			{
+				Buckets *newBuckets = new Buckets( ( buckets->mask + 1 ) * 2 );
+				for( size_t i = 0; i <= buckets->mask; ++i )
+				{
+					for( const Node *node = buckets->heads[i]; node; node = node->next )
+					{
+						newBuckets->add( node->value, node->hash );
+					}
+				}
+				m_buckets = buckets = newBuckets;
+			}
+
+			const std::string *result = new std::string( value );
+			buckets->add( result, hash );
+			m_size++;
+			return result;
+		}
+
+		size_t size() const
+		{
+			return m_size;
+		}
+
+	private :
+
+		struct Node
+		{
+			Node( const std::string *v, size_t h, const Node *n ) : value( v ), hash( h ), next( n )
+			{
+			}
+
+			const std::string *value;
+			size_t hash;
+			const Node *next;
+		};
+
+		struct Buckets
+		{
+			Buckets( size_t size ) : mask( size - 1 ), heads( new tbb::atomic<const Node *>[size] )
+			{
+				for( size_t i = 0; i < size; ++i )
+				{
+					heads[i] = 0;
+				}
+			}
+
+			// Must only be called by the thread holding m_mutex. The
+			// node is completely constructed before the atomic store
+			// publishes it to the readers.
+			void add( const std::string *value, size_t hash )
+			{
+				tbb::atomic<const Node *> &head = heads[hash & mask];
+				head = new Node( value, hash, head );
+			}
+
+			const size_t mask;
+			tbb::atomic<const Node *> *heads;
+		};
+
+		tbb::atomic<Buckets *> m_buckets;
+		tbb::atomic<size_t> m_size;
+
+		typedef tbb::spin_mutex Mutex;
+		Mutex m_mutex;
 
-struct StringCStringEqual
-{
-	bool operator()( const char *c, const std::string &s ) const
-	{
-		return strcmp( c, s.c_str() )==0;
-	}
-	bool operator()( const std::string &s, const char *c ) const
-	{
-		return strcmp( c, s.c_str() )==0;
-	}
 };
 
+static StringTable *stringTable()
+{
+	static StringTable g_stringTable;
+	return &g_stringTable;
+}
+
 } // namespace Detail
 
 const std::string *InternedString::internedString( const char *value )
 {
-	Detail::HashSet *hashSet = Detail::hashSet();
-	Detail::Index &hashIndex = hashSet->get<0>();
-	Detail::Mutex::scoped_lock lock( *Detail::mutex(), false ); // read-only lock
-	Detail::HashSet::const_iterator it = hashIndex.find( value, Hash<const char *>(), Detail::StringCStringEqual() );
-	if( it!=hashIndex.end() )
+	Detail::StringTable *stringTable = Detail::stringTable();
+	const size_t hash = Hash<const char *>()( value );
+	if( const std::string *result = stringTable->find( value, hash ) )
 	{
-		return &(*it);
-	}
-	else
-	{
-		lock.upgrade_to_writer();
-		return &(*(hashSet->insert( std::string( value ) ).first ) );
+		return result;
 	}
+	return stringTable->insert( value, hash );
 }
 
 size_t InternedString::numUniqueStrings()
 {
-	Detail::Mutex::scoped_lock lock( *Detail::mutex(), false ); // read-only lock
-	Detail::HashSet *hashSet = Detail::hashSet();
-	return hashSet->size();
+	return Detail::stringTable()->size();
 }
 
 static InternedString g_emptyString("");
@@ -131,6 +207,15 @@ const InternedString &InternedString::numberString( int64_t number )
 	{
 		g_numbers = new NumbersMap;
 	}
+	{
+		// the common case is that the number has been used before,
+		// so we avoid the write lock taken by insert().
+		NumbersMap::const_accessor it;
+		if ( g_numbers->find( it, number ) )
+		{
+			return it->second;
+		}
+	}
 	NumbersMap::accessor it;
 	if ( g_numbers->insert( it, number ) )
 	{
@@ -34,6 +34,11 @@
 
 #include <cassert>
 
+#include "boost/bind.hpp"
+
+#include "tbb/parallel_for.h"
+#include "tbb/parallel_invoke.h"
+
 #include "OpenEXR/ImathBoxAlgo.h"
 #include "OpenEXR/ImathLineAlgo.h"
 #include "OpenEXR/ImathMatrix.h"
@@ -205,7 +210,7 @@ const V3i &MeshPrimitiveEvaluator::Result::vertexIds() const
 	return m_vertexIds;
 }
 
-MeshPrimitiveEvaluator::MeshPrimitiveEvaluator( ConstMeshPrimitivePtr mesh ) : m_uvTree(0), m_haveMassProperties( false ), m_haveSurfaceArea( false ), m_haveAverageNormals( false )
+MeshPrimitiveEvaluator::MeshPrimitiveEvaluator( ConstMeshPrimitivePtr mesh, Accelerator accelerator ) : m_tree(0), m_uvTree(0), m_bvh(0), m_haveMassProperties( false ), m_haveSurfaceArea( false ), m_haveAverageNormals( false )
 {
 	if (! mesh )
 	{
@@ -250,61 +255,82 @@ MeshPrimitiveEvaluator::MeshPrimitiveEvaluator( ConstMeshPrimitivePtr mesh ) : m
 	}
 
 	const std::vector<int> &verticesPerFace = m_mesh->verticesPerFace()->readable();
-	m_triangles.reserve( verticesPerFace.size() );
-	m_uvTriangles.reserve( verticesPerFace.size() );
-	unsigned int triangleIdx = 0;
-	IntVectorData::ValueType::const_iterator vertexIdIt = m_meshVertexIds->begin();
-	for ( IntVectorData::ValueType::const_iterator it = verticesPerFace.begin();
-		it != verticesPerFace.end(); ++it, ++triangleIdx)
+	for ( IntVectorData::ValueType::const_iterator it = verticesPerFace.begin(); it != verticesPerFace.end(); ++it )
 	{
-
 		if (*it != 3 )
 		{
 			throw InvalidArgumentException( "Non-triangular mesh given to MeshPrimitiveEvaluator");
 		}
+	}
 
-		Imath::V3i triangleVertexIds;
+	const bool haveUVs = m_u.interpolation != PrimitiveVariable::Invalid && m_v.interpolation != PrimitiveVariable::Invalid;
 
-		triangleVertexIds[0] = *vertexIdIt++;
-		assert( triangleVertexIds[0] < (int)( m_verts->readable().size() ) );
-		triangleVertexIds[1] = *vertexIdIt++;
-		assert( triangleVertexIds[1] < (int)( m_verts->readable().size() ) );
-		triangleVertexIds[2] = *vertexIdIt++;
-		assert( triangleVertexIds[2] < (int)( m_verts->readable().size() ) );
+	m_triangles.resize( verticesPerFace.size() );
+	if ( haveUVs )
+	{
+		m_uvTriangles.resize( verticesPerFace.size() );
+	}
 
-		const V3f &p0 = m_verts->readable()[ triangleVertexIds[0] ];
-		const V3f &p1 = m_verts->readable()[ triangleVertexIds[1] ];
-		const V3f &p2 = m_verts->readable()[ triangleVertexIds[2] ];
+	tbb::parallel_for( tbb::blocked_range<size_t>( 0, verticesPerFace.size() ), boost::bind( &MeshPrimitiveEvaluator::calculateTriangleBounds, this, _1 ) );
 
-		Box3f bound( p0 );
-		bound.extendBy( p1 );
-		bound.extendBy( p2 );
+	if ( accelerator == BVHAccelerator )
+	{
+		m_bvh = new TriangleBVH( m_verts->readable(), *m_meshVertexIds );
+		if ( haveUVs )
+		{
+			m_uvTree = new UVBoundTree( m_uvTriangles.begin(), m_uvTriangles.end() );
+		}
+	}
+	else
+	{
+		m_tree = new TriangleBoundTree();
+		if ( haveUVs )
+		{
+			m_uvTree = new UVBoundTree();
+			tbb::parallel_invoke(
+				boost::bind( &TriangleBoundTree::init, m_tree, m_triangles.begin(), m_triangles.end(), 4 ),
+				boost::bind( &UVBoundTree::init, m_uvTree, m_uvTriangles.begin(), m_uvTriangles.end(), 4 )
+			);
+		}
+		else
+		{
+			m_tree->init( m_triangles.begin(), m_triangles.end() );
+		}
+	}
+}
 
-		m_triangles.push_back( bound );
+void MeshPrimitiveEvaluator::calculateTriangleBounds( const tbb::blocked_range<size_t> &range )
+{
+	const std::vector<V3f> &verts = m_verts->readable();
+	const bool haveUVs = m_u.interpolation != PrimitiveVariable::Invalid && m_v.interpolation != PrimitiveVariable::Invalid;
 
-		if ( m_u.interpolation != PrimitiveVariable::Invalid && m_v.interpolation != PrimitiveVariable::Invalid )
+	for ( size_t triangleIdx = range.begin(); triangleIdx != range.end(); ++triangleIdx )
+	{
+		size_t vertIdOffset = triangleIdx * 3;
+		Imath::V3i triangleVertexIds( (*m_meshVertexIds)[vertIdOffset], (*m_meshVertexIds)[vertIdOffset+1], (*m_meshVertexIds)[vertIdOffset+2] );
+
+		assert( triangleVertexIds[0] < (int)( verts.size() ) );
+		assert( triangleVertexIds[1] < (int)( verts.size() ) );
+		assert( triangleVertexIds[2] < (int)( verts.size() ) );
+
+		Box3f &bound = m_triangles[triangleIdx];
+		bound.makeEmpty();
+		bound.extendBy( verts[ triangleVertexIds[0] ] );
+		bound.extendBy( verts[ triangleVertexIds[1] ] );
+		bound.extendBy( verts[ triangleVertexIds[2] ] );
+
+		if ( haveUVs )
 		{
 			Imath::V2f uv[3];
 			triangleUVs( triangleIdx, triangleVertexIds, uv );
 
-			Box2f uvBound( uv[0] );
+			Box2f &uvBound = m_uvTriangles[triangleIdx];
+			uvBound.makeEmpty();
+			uvBound.extendBy( uv[0] );
 			uvBound.extendBy( uv[1] );
 			uvBound.extendBy( uv[2] );
-
-			m_uvTriangles.push_back( uvBound );
 		}
 	}
-	
-	m_tree = new TriangleBoundTree( m_triangles.begin(), m_triangles.end() );
-
-	if ( m_u.interpolation != PrimitiveVariable::Invalid && m_v.interpolation != PrimitiveVariable::Invalid )
-	{
-		m_uvTree = new UVBoundTree( m_uvTriangles.begin(), m_uvTriangles.end() );
-	}
-	else
-	{
-		m_uvTree = 0;
-	}
 }
 
 PrimitiveEvaluatorPtr MeshPrimitiveEvaluator::create( ConstPrimitivePtr primitive )
@@ -317,13 +343,14 @@ PrimitiveEvaluatorPtr MeshPrimitiveEvaluator::create( ConstPrimitivePtr primitiv
 
 MeshPrimitiveEvaluator::~MeshPrimitiveEvaluator()
 {
-	assert( m_tree );
-
 	delete m_tree;
 	m_tree = 0;
 
 	delete m_uvTree;
 	m_uvTree = 0;
+
+	delete m_bvh;
+	m_bvh = 0;
 }
 
 ConstPrimitivePtr MeshPrimitiveEvaluator::primitive() const
@@ -766,10 +793,17 @@ bool MeshPrimitiveEvaluator::closestPoint( const V3f &p, PrimitiveEvaluator::Res
 		return false;
 	}
 
-	assert( m_tree );
-
 	Result *mr = static_cast<Result *>( result );
 
+	if ( m_bvh )
+	{
+		TriangleBVH::Hit hit;
+		m_bvh->closestPoint( p, hit );
+		return barycentricPosition( hit.triangleIndex, hit.barycentricCoordinates, mr );
+	}
+
+	assert( m_tree );
+
 	float maxDistSqrd = limits<float>::max();
 
 	closestPointWalk( m_tree->rootIndex(), p, maxDistSqrd, mr );
@@ -802,10 +836,20 @@ bool MeshPrimitiveEvaluator::intersectionPoint( const Imath::V3f &origin, const
 		return false;
 	}
 
-	assert( m_tree );
-
 	Result *mr = static_cast<Result *>( result );
 
+	if ( m_bvh )
+	{
+		TriangleBVH::Hit hit;
+		if ( !m_bvh->intersect( origin, direction.normalized(), maxDistance, hit ) )
+		{
+			return false;
+		}
+		return barycentricPosition( hit.triangleIndex, hit.barycentricCoordinates, mr );
+	}
+
+	assert( m_tree );
+
 	float maxDistSqrd = maxDistance * maxDistance;
 
 	Imath::Line3f ray;
@@ -828,6 +872,19 @@ int MeshPrimitiveEvaluator::intersectionPoints( const Imath::V3f &origin, const
 		return 0;
 	}
 
+	if ( m_bvh )
+	{
+		std::vector<TriangleBVH::Hit> hits;
+		m_bvh->intersectAll( origin, direction.normalized(), maxDistance, hits );
+		for ( std::vector<TriangleBVH::Hit>::const_iterator it = hits.begin(); it != hits.end(); ++it )
+		{
+			ResultPtr result = new Result();
+			barycentricPosition( it->triangleIndex, it->barycentricCoordinates, result.get() );
+			results.push_back( result );
+		}
+		return results.size();
+	}
+
 	assert( m_tree );
 
 	float maxDistSqrd = maxDistance * maxDistance;
@@ -841,6 +898,103 @@ int MeshPrimitiveEvaluator::intersectionPoints( const Imath::V3f &origin, const
 	return results.size();
 }
 
+void MeshPrimitiveEvaluator::closestPoints( const std::vector<Imath::V3f> &points, std::vector<int> &triangleIndices,
+	std::vector<Imath::V3f> &barycentricCoordinates, std::vector<Imath::V3f> *positions, std::vector<Imath::V3f> *normals ) const
+{
+	triangleIndices.resize( points.size() );
+	barycentricCoordinates.resize( points.size() );
+	if( positions )
+	{
+		positions->resize( points.size() );
+	}
+	if( normals )
+	{
+		normals->resize( points.size() );
+	}
+
+	tbb::parallel_for(
+		tbb::blocked_range<size_t>( 0, points.size() ),
+		boost::bind( &MeshPrimitiveEvaluator::closestPointsRange, this, _1, &points, &triangleIndices, &barycentricCoordinates, positions, normals )
+	);
+}
+
+void MeshPrimitiveEvaluator::closestPointsRange( const tbb::blocked_range<size_t> &range, const std::vector<Imath::V3f> *points, std::vector<int> *triangleIndices,
+	std::vector<Imath::V3f> *barycentricCoordinates, std::vector<Imath::V3f> *positions, std::vector<Imath::V3f> *normals ) const
+{
+	// a single result is reused for the whole range, avoiding an allocation per query.
+	Result result;
+	for( size_t i = range.begin(); i != range.end(); ++i )
+	{
+		if( !closestPoint( (*points)[i], &result ) )
+		{
+			(*triangleIndices)[i] = -1;
+			continue;
+		}
+
+		(*triangleIndices)[i] = result.m_triangleIdx;
+		(*barycentricCoordinates)[i] = result.m_bary;
+		if( positions )
+		{
+			(*positions)[i] = result.m_p;
+		}
+		if( normals )
+		{
+			(*normals)[i] = result.m_n;
+		}
+	}
+}
+
+void MeshPrimitiveEvaluator::nearestIntersections( const std::vector<Imath::V3f> &origins, const std::vector<Imath::V3f> &directions,
+	std::vector<int> &triangleIndices, std::vector<Imath::V3f> &barycentricCoordinates, std::vector<Imath::V3f> *positions,
+	std::vector<Imath::V3f> *normals, float maxDistance ) const
+{
+	if( origins.size() != directions.size() )
+	{
+		throw InvalidArgumentException( "MeshPrimitiveEvaluator::nearestIntersections : Number of origins and directions differ" );
+	}
+
+	triangleIndices.resize( origins.size() );
+	barycentricCoordinates.resize( origins.size() );
+	if( positions )
+	{
+		positions->resize( origins.size() );
+	}
+	if( normals )
+	{
+		normals->resize( origins.size() );
+	}
+
+	tbb::parallel_for(
+		tbb::blocked_range<size_t>( 0, origins.size() ),
+		boost::bind( &MeshPrimitiveEvaluator::nearestIntersectionsRange, this, _1, &origins, &directions, maxDistance, &triangleIndices, &barycentricCoordinates, positions, normals )
+	);
+}
+
+void MeshPrimitiveEvaluator::nearestIntersectionsRange( const tbb::blocked_range<size_t> &range, const std::vector<Imath::V3f> *origins, const std::vector<Imath::V3f> *directions,
+	float maxDistance, std::vector<int> *triangleIndices, std::vector<Imath::V3f> *barycentricCoordinates, std::vector<Imath::V3f> *positions, std::vector<Imath::V3f> *normals ) const
+{
+	Result result;
+	for( size_t i = range.begin(); i != range.end(); ++i )
+	{
+		if( !intersectionPoint( (*origins)[i], (*directions)[i], &result, maxDistance ) )
+		{
+			(*triangleIndices)[i] = -1;
+			continue;
+		}
+
+		(*triangleIndices)[i] = result.m_triangleIdx;
+		(*barycentricCoordinates)[i] = result.m_bary;
+		if( positions )
+		{
+			(*positions)[i] = result.m_p;
+		}
+		if( normals )
+		{
+			(*normals)[i] = result.m_n;
+		}
+	}
+}
+
 bool MeshPrimitiveEvaluator::barycentricPosition( unsigned int triangleIndex, const Imath::V3f &barycentricCoordinates, PrimitiveEvaluator::Result *result ) const
 {
 	if( triangleIndex > m_triangles.size() )
@@ -1303,6 +1457,11 @@ const MeshPrimitiveEvaluator::TriangleBoundTree *MeshPrimitiveEvaluator::triangl
 	return m_tree;
 }
 
+const TriangleBVH *MeshPrimitiveEvaluator::triangleBVH() const
+{
+	return m_bvh;
+}
+
 const MeshPrimitiveEvaluator::UVBoundVector *MeshPrimitiveEvaluator::uvBounds() const
 {
 	return m_uvTree ? &m_uvTriangles : 0;
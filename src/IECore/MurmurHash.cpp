@@ -65,6 +65,11 @@ MurmurHash::MurmurHash( const MurmurHash &other )
 {
 }
 
+MurmurHash::MurmurHash( uint64_t h1, uint64_t h2 )
+	:	m_h1( h1 ), m_h2( h2 )
+{
+}
+
 void MurmurHash::append( const void *data, size_t bytes, int elementSize )
 {
 	const int nBlocks = bytes / 16;
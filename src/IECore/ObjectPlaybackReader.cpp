@@ -0,0 +1,287 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2014, Image Engine Design Inc. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+//     * Neither the name of Image Engine Design nor the names of any
+//       other contributors to this software may be used to endorse or
+//       promote products derived from this software without specific prior
+//       written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#include "boost/static_assert.hpp"
+
+#include "IECore/ObjectPlaybackReader.h"
+#include "IECore/ObjectInterpolator.h"
+#include "IECore/SceneCache.h"
+#include "IECore/VectorTypedData.h"
+
+using namespace IECore;
+
+namespace
+{
+
+// Computes result[i] = y0[i] + ( y1[i] - y0[i] ) * x for n floats, with the
+// arithmetic done in the precision of x. The loop is kept simple so that the
+// compiler can vectorise it.
+template<typename S>
+void linearInterpolate( const float *y0, const float *y1, S x, float *result, size_t n )
+{
+	for( size_t i = 0; i < n; i++ )
+	{
+		result[i] = static_cast<float>( y0[i] + ( y1[i] - y0[i] ) * x );
+	}
+}
+
+// Interpolates the arrays of floats held by data0 and data1 directly into
+// result, giving the same values as LinearInterpolator. Float data is
+// interpolated in double precision and V3f data in float precision, as
+// LinearInterpolator<float> and LinearInterpolator<V3f> do. Returns false
+// if the data isn't of type T, or if the arrays differ in length.
+template<typename T, typename S>
+bool interpolateFloatArrays( const Data *data0, const Data *data1, S x, Data *result )
+{
+	typedef typename T::ValueType::value_type ElementType;
+	BOOST_STATIC_ASSERT( sizeof( ElementType ) % sizeof( float ) == 0 );
+
+	const T *typed0 = runTimeCast<const T>( data0 );
+	const T *typed1 = runTimeCast<const T>( data1 );
+	T *typedResult = runTimeCast<T>( result );
+	if( !typed0 || !typed1 || !typedResult )
+	{
+		return false;
+	}
+
+	const typename T::ValueType &y0 = typed0->readable();
+	const typename T::ValueType &y1 = typed1->readable();
+	if( y0.size() != y1.size() )
+	{
+		return false;
+	}
+
+	typename T::ValueType &y = typedResult->writable();
+	y.resize( y0.size() );
+	if( y0.size() )
+	{
+		const size_t n = y0.size() * sizeof( ElementType ) / sizeof( float );
+		linearInterpolate( reinterpret_cast<const float *>( &y0[0] ), reinterpret_cast<const float *>( &y1[0] ), x, reinterpret_cast<float *>( &y[0] ), n );
+	}
+	return true;
+}
+
+} // namespace
+
+ObjectPlaybackReader::Sample::Sample()
+	:	index( 0 )
+{
+}
+
+ObjectPlaybackReader::ObjectPlaybackReader( ConstSampledSceneInterfacePtr scene )
+	:	m_scene( scene ), m_animatedTopology( true ), m_allPrimVarsAnimated( false )
+{
+	if( !m_scene )
+	{
+		throw InvalidArgumentException( "ObjectPlaybackReader : Null scene!" );
+	}
+
+	if( m_scene->hasAttribute( SceneCache::animatedObjectTopologyAttribute ) )
+	{
+		return;
+	}
+
+	if( m_scene->hasAttribute( SceneCache::animatedObjectPrimVarsAttribute ) )
+	{
+		ConstInternedStringVectorDataPtr names = runTimeCast<const InternedStringVectorData>(
+			m_scene->readAttributeAtSample( SceneCache::animatedObjectPrimVarsAttribute, 0 )
+		);
+		if( names )
+		{
+			m_animatedTopology = false;
+			m_animatedPrimVars = names->readable();
+		}
+		return;
+	}
+
+	// The scene doesn't tell us what is animated, so we interpolate every
+	// primitive variable whenever the bracketing samples share a topology.
+	m_animatedTopology = false;
+	m_allPrimVarsAnimated = true;
+}
+
+ObjectPlaybackReader::~ObjectPlaybackReader()
+{
+}
+
+const SampledSceneInterface *ObjectPlaybackReader::scene() const
+{
+	return m_scene.get();
+}
+
+ConstObjectPtr ObjectPlaybackReader::readObject( double time )
+{
+	size_t floorIndex, ceilIndex;
+	double x = m_scene->objectSampleInterval( time, floorIndex, ceilIndex );
+
+	// slide the window, keeping any samples we already hold
+	Sample window[2];
+	window[0].index = floorIndex;
+	window[1].index = ceilIndex;
+	for( int i = 0; i < 2; i++ )
+	{
+		for( int j = 0; j < 2; j++ )
+		{
+			if( m_window[j].object && m_window[j].index == window[i].index )
+			{
+				window[i] = m_window[j];
+				break;
+			}
+		}
+	}
+	for( int i = 0; i < 2; i++ )
+	{
+		if( !window[i].object )
+		{
+			window[i].object = m_scene->readObjectAtSample( window[i].index );
+			if( m_allPrimVarsAnimated )
+			{
+				if( const Primitive *primitive = runTimeCast<const Primitive>( window[i].object.get() ) )
+				{
+					primitive->topologyHash( window[i].topologyHash );
+				}
+			}
+		}
+		m_window[i] = window[i];
+	}
+
+	if( x == 0 )
+	{
+		return m_window[0].object;
+	}
+	if( x == 1 )
+	{
+		return m_window[1].object;
+	}
+
+	if( !m_animatedTopology )
+	{
+		const Primitive *primitive0 = runTimeCast<const Primitive>( m_window[0].object.get() );
+		const Primitive *primitive1 = runTimeCast<const Primitive>( m_window[1].object.get() );
+		if( primitive0 && primitive1 && interpolateInPlace( primitive0, primitive1, x ) )
+		{
+			return m_result;
+		}
+	}
+
+	ObjectPtr object = linearObjectInterpolation( m_window[0].object.get(), m_window[1].object.get(), x );
+	if( !object )
+	{
+		// failed to interpolate, return the closest one
+		return ( x >= 0.5 ? m_window[1].object : m_window[0].object );
+	}
+	return object;
+}
+
+bool ObjectPlaybackReader::interpolateInPlace( const Primitive *primitive0, const Primitive *primitive1, double x )
+{
+	if( primitive0->typeId() != primitive1->typeId() )
+	{
+		return false;
+	}
+
+	if( m_allPrimVarsAnimated && m_window[0].topologyHash != m_window[1].topologyHash )
+	{
+		return false;
+	}
+
+	if( !m_result || m_result->typeId() != primitive0->typeId() || m_resultTopologyHash != m_window[0].topologyHash )
+	{
+		// All the data is shared with the sample until it is first written to,
+		// after which the animated primitive variables own their storage and
+		// are overwritten in place on each subsequent call.
+		m_result = runTimeCast<Primitive>( primitive0->copy() );
+		m_resultTopologyHash = m_window[0].topologyHash;
+	}
+
+	if( m_allPrimVarsAnimated )
+	{
+		for( PrimitiveVariableMap::const_iterator it = primitive0->variables.begin(); it != primitive0->variables.end(); ++it )
+		{
+			interpolatePrimitiveVariable( it->first, primitive0, primitive1, x );
+		}
+	}
+	else
+	{
+		for( std::vector<InternedString>::const_iterator it = m_animatedPrimVars.begin(); it != m_animatedPrimVars.end(); ++it )
+		{
+			interpolatePrimitiveVariable( it->value(), primitive0, primitive1, x );
+		}
+	}
+
+	return true;
+}
+
+void ObjectPlaybackReader::interpolatePrimitiveVariable( const std::string &name, const Primitive *primitive0, const Primitive *primitive1, double x )
+{
+	PrimitiveVariableMap::const_iterator it0 = primitive0->variables.find( name );
+	PrimitiveVariableMap::const_iterator it1 = primitive1->variables.find( name );
+	PrimitiveVariableMap::iterator itResult = m_result->variables.find( name );
+	if( it0 == primitive0->variables.end() || it1 == primitive1->variables.end() || itResult == m_result->variables.end() )
+	{
+		return;
+	}
+
+	const Data *data0 = it0->second.data.get();
+	const Data *data1 = it1->second.data.get();
+	if( !data0 || !data1 || data0->typeId() != data1->typeId() || it0->second.interpolation != it1->second.interpolation )
+	{
+		return;
+	}
+
+	if( !itResult->second.data || itResult->second.data->typeId() != data0->typeId() )
+	{
+		itResult->second.data = data0->copy();
+	}
+
+	// Float and V3f arrays make up the bulk of most primitives, so
+	// we interpolate those in place. Everything else goes through
+	// the generic interpolation, which allocates a new result.
+	if(
+		interpolateFloatArrays<FloatVectorData>( data0, data1, x, itResult->second.data.get() ) ||
+		interpolateFloatArrays<V3fVectorData>( data0, data1, static_cast<float>( x ), itResult->second.data.get() )
+	)
+	{
+		return;
+	}
+
+	ObjectPtr result = itResult->second.data;
+	LinearInterpolator<Object>()( data0, data1, x, result );
+	if( !result )
+	{
+		// not interpolable, so use the closest sample. we take a copy
+		// so that we never write into data owned by the samples.
+		itResult->second.data = ( x >= 0.5 ? data1 : data0 )->copy();
+	}
+}
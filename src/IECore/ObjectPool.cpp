@@ -49,7 +49,7 @@ struct ObjectPool::MemberData
 	{
 	}
 
-	LRUCache< MurmurHash, ConstObjectPtr > cache;
+	LRUCache< MurmurHash, ConstObjectPtr, LRUCachePolicy::SecondChance > cache;
 
 	/// our getter always returns NULL
 	static ConstObjectPtr getter( const MurmurHash &h, size_t &cost )
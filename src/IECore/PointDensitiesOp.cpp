@@ -40,6 +40,7 @@
 #include "IECore/Object.h"
 #include "IECore/KDTree.h"
 
+#include <algorithm>
 #include <cassert>
 
 using namespace IECore;
@@ -128,19 +129,29 @@ static void densities( const vector<Vec3<T> > &points, int numNeighbours, T mult
 	multiplier *= (T)numNeighbours / ((4.0/3.0) * M_PI);
 
 	Tree tree( points.begin(), points.end() );
-	vector<typename Tree::Neighbour> neighbours;
 
 	result.resize( points.size() );
-	for( unsigned int i=0; i<points.size(); i++ )
+
+	// the neighbours are found in parallel for batches of points at a time,
+	// which keeps the storage for the neighbours reasonably small.
+	const size_t batchSize = 65536;
+	vector<typename Tree::Neighbour> neighbours;
+	vector<unsigned int> numFound;
+	for( size_t batchBegin = 0; batchBegin < points.size(); batchBegin += batchSize )
 	{
-		tree.nearestNNeighbours( points[i], numNeighbours, neighbours );
-		T r = ((*(neighbours.rbegin()->point)) - points[i]).length();
-		result[i] = multiplier / (r*r*r);
+		const size_t batchEnd = std::min( batchBegin + batchSize, points.size() );
+		tree.nearestNNeighbours( points.begin() + batchBegin, points.begin() + batchEnd, numNeighbours, neighbours, numFound );
+		for( size_t i=batchBegin; i<batchEnd; i++ )
+		{
+			const size_t q = i - batchBegin;
+			const typename Tree::Neighbour &furthest = neighbours[q * numNeighbours + numFound[q] - 1];
+			T r = ((*(furthest.point)) - points[i]).length();
+			result[i] = multiplier / (r*r*r);
+		}
 	}
 }
 
 /// \todo Support 2d point types?
-/// \todo Threading?
 ObjectPtr PointDensitiesOp::doOperation( const CompoundObject * operands )
 {
 	const int numNeighbours = m_numNeighboursParameter->getNumericValue();
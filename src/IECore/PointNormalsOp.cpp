@@ -32,6 +32,8 @@
 //
 //////////////////////////////////////////////////////////////////////////
 
+#include <algorithm>
+
 #include "IECore/PointNormalsOp.h"
 #include "IECore/VectorTypedData.h"
 #include "IECore/ObjectParameter.h"
@@ -99,13 +101,13 @@ const IntParameter * PointNormalsOp::numNeighboursParameter() const
 	return m_numNeighboursParameter.get();
 }
 
-/// Calculates density at a point by finding the volume of a sphere holding numNeighbours. Doesn't bother
-/// with any constant factors for the density (PI, 4/3, numNeighbours) as these are factored out in the use below anyway.
+/// Calculates density at a point by finding the volume of a sphere holding the neighbours found for it by
+/// KDTree::nearestNNeighbours(). Doesn't bother with any constant factors for the density (PI, 4/3, numNeighbours)
+/// as these are factored out in the use below anyway.
 template<typename T>
-static inline typename T::Point::BaseType density( const T tree, const typename T::Point &p, int numNeighbours, vector<typename T::Neighbour> &neighbours )
+static inline typename T::Point::BaseType density( const typename T::Point &p, const typename T::Neighbour *neighbours, unsigned int numFound )
 {
-	tree.nearestNNeighbours( p, numNeighbours, neighbours );
-	typename T::Point::BaseType r = ((*(neighbours.rbegin()->point)) - p).length();
+	typename T::Point::BaseType r = ((*(neighbours[numFound-1].point)) - p).length();
 	return 1.0/(r*r*r);
 }
 
@@ -117,18 +119,43 @@ static void normals( const vector<T> &points, int numNeighbours, vector<T> &resu
 	typedef typename T::BaseType Real;
 
 	Tree tree( points.begin(), points.end() );
-	vector<typename Tree::Neighbour> neighbours;
 
 	result.resize( points.size() );
 
-	for( unsigned int i=0; i<points.size(); i++ )
+	// each normal needs the density at the point itself and at an offset along
+	// each axis. we find the neighbours for all four positions in parallel, for
+	// batches of points at a time, which keeps the storage for the neighbours
+	// reasonably small.
+	const size_t batchSize = 16384;
+	float o = Real( 0.1 ) ; // should we scale offset for gradient by the radius of the neighbours sphere?
+	vector<T> queries;
+	vector<typename Tree::Neighbour> neighbours;
+	vector<unsigned int> numFound;
+	for( size_t batchBegin = 0; batchBegin < points.size(); batchBegin += batchSize )
 	{
-		Real d = density( tree, points[i], numNeighbours, neighbours );
-		float o = Real( 0.1 ) ; // should we scale offset for gradient by the radius of the neighbours sphere?
-		Real dx = d - density( tree, points[i] + T( o, 0, 0 ), numNeighbours, neighbours );
-		Real dy = d - density( tree, points[i] + T( 0, o, 0 ), numNeighbours, neighbours );
-		Real dz = d - density( tree, points[i] + T( 0, 0, o ), numNeighbours, neighbours );
-		result[i] = T( dx, dy, dz ).normalized();
+		const size_t batchEnd = std::min( batchBegin + batchSize, points.size() );
+
+		queries.resize( ( batchEnd - batchBegin ) * 4 );
+		for( size_t i=batchBegin; i<batchEnd; i++ )
+		{
+			const size_t q = ( i - batchBegin ) * 4;
+			queries[q] = points[i];
+			queries[q+1] = points[i] + T( o, 0, 0 );
+			queries[q+2] = points[i] + T( 0, o, 0 );
+			queries[q+3] = points[i] + T( 0, 0, o );
+		}
+
+		tree.nearestNNeighbours( queries.begin(), queries.end(), numNeighbours, neighbours, numFound );
+
+		for( size_t i=batchBegin; i<batchEnd; i++ )
+		{
+			const size_t q = ( i - batchBegin ) * 4;
+			Real d = density<Tree>( queries[q], &neighbours[q * numNeighbours], numFound[q] );
+			Real dx = d - density<Tree>( queries[q+1], &neighbours[(q+1) * numNeighbours], numFound[q+1] );
+			Real dy = d - density<Tree>( queries[q+2], &neighbours[(q+2) * numNeighbours], numFound[q+2] );
+			Real dz = d - density<Tree>( queries[q+3], &neighbours[(q+3) * numNeighbours], numFound[q+3] );
+			result[i] = T( dx, dy, dz ).normalized();
+		}
 	}
 }
 
@@ -37,6 +37,8 @@
 
 #include "boost/format.hpp"
 
+#include "tbb/parallel_for.h"
+
 #include "IECore/PointsPrimitive.h"
 #include "IECore/MeshPrimitive.h"
 #include "IECore/ObjectParameter.h"
@@ -56,6 +58,95 @@ using namespace std;
 
 IE_CORE_DEFINERUNTIMETYPED( PointSmoothSkinningOp );
 
+//////////////////////////////////////////////////////////////////////////
+// Skinning kernels
+//////////////////////////////////////////////////////////////////////////
+
+struct PointTransform
+{
+	static inline void transform( const V3f &v, const M44f &m, float weight, V3f &result )
+	{
+		result += v * m * weight;
+	}
+};
+
+struct NormalTransform
+{
+	static inline void transform( const V3f &v, const M44f &m, float weight, V3f &result )
+	{
+		V3f unweighted;
+		m.multDirMatrix( v, unweighted );
+		result += unweighted * weight;
+	}
+};
+
+// Deforms a range of elements in place by blending the skinning matrices
+// of their influences. Each element is independent of all the others, so
+// ranges may be processed concurrently, and the arithmetic for each element
+// is performed in the same order regardless of how the range is split, so the
+// results are identical to a serial evaluation.
+template<typename Transform>
+class LinearSkinning
+{
+	public :
+
+		LinearSkinning( std::vector<V3f> &data, const std::vector<int> *vertexIndices, const std::vector<int> *refIndices,
+			const SmoothSkinningData *ssd, const std::vector<M44f> &skinningMatrices )
+			:	m_data( data ), m_vertexIndices( vertexIndices ), m_refIndices( refIndices ),
+				m_pointIndexOffsets( ssd->pointIndexOffsets()->readable() ),
+				m_pointInfluenceCounts( ssd->pointInfluenceCounts()->readable() ),
+				m_pointInfluenceIndices( ssd->pointInfluenceIndices()->readable() ),
+				m_pointInfluenceWeights( ssd->pointInfluenceWeights()->readable() ),
+				m_skinningMatrices( skinningMatrices )
+		{
+		}
+
+		void operator()( const tbb::blocked_range<size_t> &range ) const
+		{
+			for( size_t i = range.begin(); i != range.end(); ++i )
+			{
+				int pointIndex = i;
+				if( m_vertexIndices )
+				{
+					pointIndex = (*m_vertexIndices)[pointIndex];
+				}
+				if( m_refIndices )
+				{
+					// get the actual index to look up in the smooth skinning data
+					pointIndex = (*m_refIndices)[pointIndex];
+				}
+
+				const int first = m_pointIndexOffsets[pointIndex];
+				const int last = first + m_pointInfluenceCounts[pointIndex];
+
+				const V3f v = m_data[i];
+				V3f result( 0 );
+				for( int influence = first; influence < last; ++influence )
+				{
+					Transform::transform( v, m_skinningMatrices[m_pointInfluenceIndices[influence]], m_pointInfluenceWeights[influence], result );
+				}
+
+				m_data[i] = result;
+			}
+		}
+
+	private :
+
+		std::vector<V3f> &m_data;
+		const std::vector<int> *m_vertexIndices;
+		const std::vector<int> *m_refIndices;
+		const std::vector<int> &m_pointIndexOffsets;
+		const std::vector<int> &m_pointInfluenceCounts;
+		const std::vector<int> &m_pointInfluenceIndices;
+		const std::vector<float> &m_pointInfluenceWeights;
+		const std::vector<M44f> &m_skinningMatrices;
+
+};
+
+//////////////////////////////////////////////////////////////////////////
+// PointSmoothSkinningOp
+//////////////////////////////////////////////////////////////////////////
+
 PointSmoothSkinningOp::PointSmoothSkinningOp() :
 	        ModifyOp(
 	                "Deforms points and normals based on a pose and SmoothSkinningData.",
@@ -320,95 +411,39 @@ void PointSmoothSkinningOp::modify( Object *input, const CompoundObject *operand
 	// iterate through all the points in the source primitive and deform using the weighted skinning matrices
 	if ( blend == Linear )
 	{
-        std::vector<V3f>::iterator p_it = p_data.begin();
+		const SmoothSkinningData *constSsd = ssd.get();
 
-	const std::vector<int> &pointIndexOffsets = ssd->pointIndexOffsets()->readable();
-	const std::vector<int> &pointInfluenceCounts = ssd->pointInfluenceCounts()->readable();
-	const std::vector<int> &pointInfluenceIndices = ssd->pointInfluenceIndices()->readable();
-	const std::vector<float> &pointInfluenceWeights = ssd->pointInfluenceWeights()->readable();
-	
-		// todo, thread this
-        // deform our P
-        for ( p_it=p_data.begin(); p_it!=p_data.end(); ++p_it )
-        {
-			V3f p_new(0,0,0);
-
-			int p_id = p_it - p_data.begin();
-			
-			if( refId_size )
-			{
-				// get the actual index to look up in the smooth skinning data
-				p_id = refId_data[p_id];
-			}
-			
-			int p_influence_count = pointInfluenceCounts[p_id];
-			int p_index_offset = pointIndexOffsets[p_id];
+		// deform our P
+		tbb::parallel_for(
+			tbb::blocked_range<size_t>( 0, p_data.size(), 1000 ),
+			LinearSkinning<PointTransform>( p_data, 0, refId_size ? &refId_data : 0, constSsd, skin_data )
+		);
 
-			for (int p_influence_id = p_index_offset; p_influence_id < (p_index_offset+p_influence_count);
-					p_influence_id++)
-			{
-				int influence_id = pointInfluenceIndices[p_influence_id];
-				float weight = pointInfluenceWeights[p_influence_id];
-				p_new += (*p_it) * skin_data[influence_id] * weight;
-			}
-
-			(*p_it) = p_new;
-
-        }
-
-        // deform our N
-        if ( deform_n )
-        {
-		PrimitiveVariableMap::const_iterator it = pt->variables.find(normal_var);
-		if ( it != pt->variables.end() )
+		// deform our N
+		if ( deform_n )
 		{
-			V3fVectorData *n = pt->variableData<V3fVectorData>(normal_var);
-			std::vector<V3f> &n_data =  n->writable();
-	
-			std::vector<V3f>::iterator n_it = n_data.begin();
-			V3f n_unw;
-			
-			std::vector<int> vertexIndicesData;
-			if (it->second.interpolation == PrimitiveVariable::FaceVarying )
-			{
-				MeshPrimitive *mesh = dynamic_cast<MeshPrimitive *>( pt );
-				if( mesh )
-				{
-					vertexIndicesData = mesh->vertexIds()->readable();
-				}
-			}
-			
-			for ( n_it=n_data.begin(); n_it!=n_data.end(); ++n_it )
+			PrimitiveVariableMap::const_iterator it = pt->variables.find(normal_var);
+			if ( it != pt->variables.end() )
 			{
-				V3f n_new(0,0,0);
-	
-				int n_id = n_it - n_data.begin();
+				V3fVectorData *n = pt->variableData<V3fVectorData>(normal_var);
+				std::vector<V3f> &n_data =  n->writable();
 
-				if( vertexIndicesData.size() )
+				const std::vector<int> *vertexIndices = 0;
+				if (it->second.interpolation == PrimitiveVariable::FaceVarying )
 				{
-					n_id = vertexIndicesData[n_id];
-				}
-				if( refId_size )
-				{
-					n_id = refId_data[n_id];
+					MeshPrimitive *mesh = dynamic_cast<MeshPrimitive *>( pt );
+					if( mesh && mesh->vertexIds()->readable().size() )
+					{
+						vertexIndices = &mesh->vertexIds()->readable();
+					}
 				}
-				
-				int n_influence_count = pointInfluenceCounts[n_id];
-				int n_index_offset = pointIndexOffsets[n_id];
-	
-				for (int n_influence_id = n_index_offset; n_influence_id < (n_index_offset+n_influence_count);
-						n_influence_id++)
-				{
-					int influence_id = pointInfluenceIndices[n_influence_id];
-					float weight = pointInfluenceWeights[n_influence_id];
-	
-					skin_data[influence_id].multDirMatrix((*n_it),n_unw);
-					n_new += n_unw * weight;
-				}	
-				(*n_it) = n_new;
+
+				tbb::parallel_for(
+					tbb::blocked_range<size_t>( 0, n_data.size(), 1000 ),
+					LinearSkinning<NormalTransform>( n_data, vertexIndices, refId_size ? &refId_data : 0, constSsd, skin_data )
+				);
 			}
 		}
-        }
 	}
 	else
 	{
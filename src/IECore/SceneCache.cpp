@@ -32,8 +32,20 @@
 //
 //////////////////////////////////////////////////////////////////////////
 
+#include <algorithm>
+#include <set>
+#include <functional>
+
 #include"boost/tuple/tuple.hpp"
+#include "boost/thread/mutex.hpp"
+#include "boost/thread/locks.hpp"
+#include "boost/thread/condition_variable.hpp"
+#include "boost/format.hpp"
 #include "tbb/concurrent_hash_map.h"
+#include "tbb/task.h"
+#include "tbb/atomic.h"
+#include "tbb/parallel_for.h"
+#include "tbb/spin_mutex.h"
 
 #include "OpenEXR/ImathBoxAlgo.h"
 
@@ -43,7 +55,9 @@
 #include "IECore/VisibleRenderable.h"
 #include "IECore/ObjectInterpolator.h"
 #include "IECore/Primitive.h"
+#include "IECore/DecimateAlgo.h"
 #include "IECore/SimpleTypedData.h"
+#include "IECore/VectorTypedData.h"
 #include "IECore/TransformationMatrixData.h"
 #include "IECore/SharedSceneInterfaces.h"
 #include "IECore/MessageHandler.h"
@@ -78,10 +92,27 @@ static InternedString tagsEntry("tags");
 static InternedString localTagsEntry("localTags");
 static InternedString ancestorTagsEntry("ancestorTags");
 static InternedString descendentTagsEntry("descendentTags");
+static InternedString tagIndexEntry("tagIndex");
+static InternedString tagIndexPrefixesEntry("prefixes");
+static InternedString tagIndexNamesEntry("names");
+static InternedString proxiesEntry("proxies");
+static InternedString proxyErrorsEntry("errors");
+
+// The number of paths the tag index accumulates in memory before finalise()
+// writes them to the file.
+static const size_t g_tagIndexChunkSize = 10000;
 
 const SceneInterface::Name &SceneCache::animatedObjectTopologyAttribute = InternedString( "sceneInterface:animatedObjectTopology" );
 const SceneInterface::Name &SceneCache::animatedObjectPrimVarsAttribute = InternedString( "sceneInterface:animatedObjectPrimVars" );
 
+// The "ObjectType:" tags are written automatically for every location holding an
+// object, so they are left out of the tag index to keep it proportional to the number
+// of locations the user has tagged.
+static bool isObjectTypeTag( const SceneInterface::Name &tag )
+{
+	return strncmp( tag.c_str(), "ObjectType:", 11 ) == 0;
+}
+
 typedef std::vector<double> SampleTimes;
 
 class SceneCache::Implementation : public RefCounted
@@ -292,7 +323,7 @@ class SceneCache::ReaderImplementation : public SceneCache::Implementation
 
 		IE_CORE_DECLAREPTR( ReaderImplementation )
 
-		ReaderImplementation( IndexedIOPtr io, SceneCache::Implementation *parent = 0) : SceneCache::Implementation( io ), m_parent(static_cast< ReaderImplementation* >( parent )), m_sharedData(0), m_boundSampleTimes(0), m_transformSampleTimes(0), m_objectSampleTimes(0)
+		ReaderImplementation( IndexedIOPtr io, SceneCache::Implementation *parent = 0) : SceneCache::Implementation( io ), m_parent(static_cast< ReaderImplementation* >( parent )), m_sharedData(0), m_boundSampleTimes(0), m_transformSampleTimes(0), m_objectSampleTimes(0), m_proxySampleTimes(0)
 		{
 			if ( m_parent )
 			{
@@ -592,6 +623,61 @@ class SceneCache::ReaderImplementation : public SceneCache::Implementation
 			return attributeObj;
 		}
 
+		void proxyErrors( std::vector<float> &errors ) const
+		{
+			errors.clear();
+			ConstIndexedIOPtr io = m_indexedIO->subdirectory( proxiesEntry, IndexedIO::NullIfMissing );
+			if ( io )
+			{
+				errors.resize( io->entry( proxyErrorsEntry ).arrayLength() );
+				float *errorsPtr = &errors[0];
+				io->read( proxyErrorsEntry, errorsPtr, errors.size() );
+			}
+		}
+
+		inline const SampleTimes &proxySampleTimes() const
+		{
+			if ( !m_proxySampleTimes )
+			{
+				m_proxySampleTimes = restoreSampleTimes( proxiesEntry, true );
+			}
+			return *m_proxySampleTimes;
+		}
+
+		ConstObjectPtr readProxyAtSample( size_t level, size_t sampleIndex ) const
+		{
+			return m_sharedData->readProxyAtSample( this, sampleEntry( level ), sampleIndex );
+		}
+
+		ConstObjectPtr readProxy( size_t level, double time ) const
+		{
+			if ( !m_indexedIO->hasEntry( proxiesEntry ) || !m_indexedIO->subdirectory( proxiesEntry )->hasEntry( sampleEntry( level ) ) )
+			{
+				throw Exception( ( boost::format( "No proxy stored for level %d" ) % level ).str() );
+			}
+
+			size_t sample1, sample2;
+			double x = sampleInterval( proxySampleTimes(), time, sample1, sample2 );
+			if ( x == 0 )
+			{
+				return readProxyAtSample( level, sample1 );
+			}
+			if ( x == 1 )
+			{
+				return readProxyAtSample( level, sample2 );
+			}
+
+			ConstObjectPtr proxy1 = readProxyAtSample( level, sample1 );
+			ConstObjectPtr proxy2 = readProxyAtSample( level, sample2 );
+			ObjectPtr proxy = linearObjectInterpolation( proxy1.get(), proxy2.get(), x );
+			if ( !proxy )
+			{
+				// failed to interpolate, return the closest one
+				return ( x >= 0.5 ? proxy2 : proxy1 );
+			}
+			return proxy;
+		}
+
 		inline const SampleTimes &objectSampleTimes() const
 		{
 			if ( !m_objectSampleTimes )
@@ -719,6 +805,151 @@ class SceneCache::ReaderImplementation : public SceneCache::Implementation
 			return location;
 		}
 
+		/// Resolves many locations at once. The paths are visited in sorted order so that
+		/// siblings are found together and each shared ancestor is only opened once.
+		void scenes( const std::vector<Path> &paths, std::vector<ReaderImplementationPtr> &locations )
+		{
+			ReaderImplementation *root = this;
+			while( root->m_parent )
+			{
+				root = root->m_parent.get();
+			}
+
+			std::vector<size_t> order( paths.size() );
+			for ( size_t i = 0; i < order.size(); i++ )
+			{
+				order[i] = i;
+			}
+			std::sort( order.begin(), order.end(), PathIndexLess( paths ) );
+
+			locations.resize( paths.size() );
+			std::vector<ReaderImplementationPtr> ancestors( 1, root );
+			const Path *previous = 0;
+			for ( std::vector<size_t>::const_iterator it = order.begin(); it != order.end(); it++ )
+			{
+				const Path &path = paths[*it];
+				size_t common = 0;
+				if ( previous )
+				{
+					size_t n = std::min( path.size(), previous->size() );
+					while( common < n && path[common] == (*previous)[common] )
+					{
+						common++;
+					}
+				}
+				ancestors.resize( common + 1 );
+				for ( size_t d = common; d < path.size(); d++ )
+				{
+					ancestors.push_back( ancestors.back()->child( path[d], SceneInterface::ThrowIfMissing ) );
+				}
+				locations[*it] = ancestors.back();
+				previous = &path;
+			}
+		}
+
+		/// Returns the paths holding the tag locally, from this location down, using the index
+		/// stored by the writer. Returns false if the file predates the index or the tag is an
+		/// object type tag, in which case the caller must walk the hierarchy instead. A tag
+		/// which was never written isn't in the index, and yields true with no paths.
+		bool taggedPaths( const Name &tag, std::vector<Path> &paths ) const
+		{
+			if ( isObjectTypeTag( tag ) )
+			{
+				return false;
+			}
+
+			const ReaderImplementation *root = this;
+			while( root->m_parent )
+			{
+				root = root->m_parent.get();
+			}
+
+			paths.clear();
+			ConstIndexedIOPtr indexIO = root->m_indexedIO->subdirectory( tagIndexEntry, IndexedIO::NullIfMissing );
+			if ( !indexIO )
+			{
+				return false;
+			}
+			ConstIndexedIOPtr io = indexIO->subdirectory( tag, IndexedIO::NullIfMissing );
+			if ( !io )
+			{
+				return true;
+			}
+
+			Path location;
+			path( location );
+
+			std::vector<unsigned int> prefixes;
+			std::vector<InternedString> names;
+			for ( size_t chunk = 0; io->hasEntry( sampleEntry( chunk ) ); chunk++ )
+			{
+				ConstIndexedIOPtr chunkIO = io->subdirectory( sampleEntry( chunk ) );
+
+				prefixes.resize( chunkIO->entry( tagIndexPrefixesEntry ).arrayLength() );
+				unsigned int *prefixesPtr = &prefixes[0];
+				chunkIO->read( tagIndexPrefixesEntry, prefixesPtr, prefixes.size() );
+
+				names.clear();
+				if ( chunkIO->hasEntry( tagIndexNamesEntry ) )
+				{
+					names.resize( chunkIO->entry( tagIndexNamesEntry ).arrayLength() );
+					InternedString *namesPtr = &names[0];
+					chunkIO->read( tagIndexNamesEntry, namesPtr, names.size() );
+				}
+
+				Path current;
+				std::vector<InternedString>::const_iterator nameIt = names.begin();
+				for ( size_t i = 0; i + 1 < prefixes.size(); i += 2 )
+				{
+					if ( prefixes[i] > current.size() || prefixes[i+1] > (size_t)( names.end() - nameIt ) )
+					{
+						throw Exception( "Corrupted tag index!" );
+					}
+					current.resize( prefixes[i] );
+					current.insert( current.end(), nameIt, nameIt + prefixes[i+1] );
+					nameIt += prefixes[i+1];
+
+					if ( current.size() >= location.size() && std::equal( location.begin(), location.end(), current.begin() ) )
+					{
+						paths.push_back( current );
+					}
+				}
+			}
+			return true;
+		}
+
+		/// Reads the same kind of data from many locations in parallel.
+		template<typename T, typename Reader>
+		static void readBatch( const std::vector<ReaderImplementationPtr> &locations, double time, std::vector<T> &results )
+		{
+			results.resize( locations.size() );
+			tbb::parallel_for( tbb::blocked_range<size_t>( 0, locations.size() ), BatchReader<T, Reader>( locations, time, results ) );
+		}
+
+		struct BoundReader
+		{
+			static Imath::Box3d read( const ReaderImplementation *location, double time )
+			{
+				return location->readBound( time );
+			}
+		};
+
+		struct TransformReader
+		{
+			static Imath::M44d read( const ReaderImplementation *location, double time )
+			{
+				return location->readTransformAsMatrix( time );
+			}
+		};
+
+		struct ObjectReader
+		{
+			static ConstObjectPtr read( const ReaderImplementation *location, double time )
+			{
+				return location->hasObject() ? location->readObject( time ) : ConstObjectPtr();
+			}
+		};
+
 		void hash( HashType hashType, double time, MurmurHash &h, bool ignoreSceneHash = false ) const
 		{
 			size_t s0, s1;
@@ -810,6 +1041,63 @@ class SceneCache::ReaderImplementation : public SceneCache::Implementation
 			}
 		}
 
+		/// Loads the data specified by the SceneCache::PrefetchData flags for this location, reading the
+		/// same samples that the read calls would need at the given time, so that they are found in the caches.
+		void prefetch( double time, int what ) const
+		{
+			size_t sample1, sample2;
+			double x;
+
+			if ( what & SceneCache::PrefetchBound )
+			{
+				readBound( time );
+			}
+
+			if ( ( what & SceneCache::PrefetchTransform ) && m_indexedIO->hasEntry( transformEntry ) )
+			{
+				x = transformSampleInterval( time, sample1, sample2 );
+				if ( x < 1 )
+				{
+					readTransformAtSample( sample1 );
+				}
+				if ( x > 0 )
+				{
+					readTransformAtSample( sample2 );
+				}
+			}
+
+			if ( what & SceneCache::PrefetchAttributes )
+			{
+				NameList attrs;
+				attributeNames( attrs );
+				for ( NameList::const_iterator it = attrs.begin(); it != attrs.end(); it++ )
+				{
+					x = attributeSampleInterval( *it, time, sample1, sample2 );
+					if ( x < 1 )
+					{
+						readAttributeAtSample( *it, sample1 );
+					}
+					if ( x > 0 )
+					{
+						readAttributeAtSample( *it, sample2 );
+					}
+				}
+			}
+
+			if ( ( what & SceneCache::PrefetchObject ) && hasObject() )
+			{
+				x = objectSampleInterval( time, sample1, sample2 );
+				if ( x < 1 )
+				{
+					readObjectAtSample( sample1 );
+				}
+				if ( x > 0 )
+				{
+					readObjectAtSample( sample2 );
+				}
+			}
+		}
+
 		static ReaderImplementation *reader( Implementation *impl, bool throwException = true )
 		{
 			ReaderImplementation *reader = dynamic_cast< ReaderImplementation* >( impl );
@@ -821,6 +1109,49 @@ class SceneCache::ReaderImplementation : public SceneCache::Implementation
 		}
 
 	private :
+
+		class PathIndexLess
+		{
+			public :
+
+				PathIndexLess( const std::vector<Path> &paths ) : m_paths( paths )
+				{
+				}
+
+				bool operator()( size_t a, size_t b ) const
+				{
+					return m_paths[a] < m_paths[b];
+				}
+
+			private :
+
+				const std::vector<Path> &m_paths;
+		};
+
+		template<typename T, typename Reader>
+		class BatchReader
+		{
+			public :
+
+				BatchReader( const std::vector<ReaderImplementationPtr> &locations, double time, std::vector<T> &results )
+					:	m_locations( locations ), m_time( time ), m_results( results )
+				{
+				}
+
+				void operator()( const tbb::blocked_range<size_t> &range ) const
+				{
+					for ( size_t i = range.begin(); i != range.end(); i++ )
+					{
+						m_results[i] = Reader::read( m_locations[i].get(), m_time );
+					}
+				}
+
+			private :
+
+				const std::vector<ReaderImplementationPtr> &m_locations;
+				double m_time;
+				std::vector<T> &m_results;
+		};
 	
 		// \todo Consider using concurrent_vector for constant access time.
 		typedef tbb::concurrent_hash_map< uint64_t, SampleTimes > SampleTimesMap;
@@ -841,7 +1172,8 @@ class SceneCache::ReaderImplementation : public SceneCache::Implementation
 				SharedData() : 
 					objectCache( new SimpleCache( doReadObjectAtSample, simpleHash,  10000 )  ), 
 					attributeCache( new AttributeCache( doReadAttributeAtSample, attributeHash, 1000) ), 
-					transformCache( new SimpleCache(  doReadTransformAtSample, simpleHash, 1000) )
+					transformCache( new SimpleCache(  doReadTransformAtSample, simpleHash, 1000) ),
+					proxyCache( new AttributeCache( doReadProxyAtSample, attributeHash, 1000 ) )
 				{
 				}
 
@@ -901,11 +1233,18 @@ class SceneCache::ReaderImplementation : public SceneCache::Implementation
 					return attributeCache->get( AttributeCacheKey(reader,name,sample) );
 				}
 
+				/// utility function used by the ReaderImplementation to use the LRUCache for proxy reading
+				IECore::ConstObjectPtr readProxyAtSample( const ReaderImplementation *reader, const IndexedIO::EntryID &level, size_t sample )
+				{
+					return proxyCache->get( AttributeCacheKey(reader,level,sample) );
+				}
+
 				// \todo Consider adding "ReaderImplementation *rootScene" to optimize the scene() calls.
 				SampleTimesMap sampleTimesMap;
 				SimpleCache::Ptr objectCache;
 				AttributeCache::Ptr attributeCache;
 				SimpleCache::Ptr transformCache;
+				AttributeCache::Ptr proxyCache;
 
 			private :
 
@@ -946,6 +1285,7 @@ class SceneCache::ReaderImplementation : public SceneCache::Implementation
 		mutable AttributeSamplesMap m_attributeSampleTimes;
 		mutable AttributeMapMutex m_attributeMutex;
 		mutable const SampleTimes *m_objectSampleTimes;
+		mutable const SampleTimes *m_proxySampleTimes;
 
 		IndexedIOPtr globalSampleTimes() const
 		{
@@ -1084,6 +1424,12 @@ class SceneCache::ReaderImplementation : public SceneCache::Implementation
 			return Object::load( get<0>(key)->m_indexedIO->subdirectory(attributesEntry)->subdirectory(get<1>(key)), sampleEntry(get<2>(key)) );
 		}
 
+		// static function used by the cache mechanism to actually load the proxy data from file.
+		static ObjectPtr doReadProxyAtSample( const AttributeCacheKey &key )
+		{
+			return Object::load( get<0>(key)->m_indexedIO->subdirectory(proxiesEntry)->subdirectory(get<1>(key)), sampleEntry(get<2>(key)) );
+		}
+
 		/// Determine defaults when transform and bounds are not stored in the file.
 		/// The reader will return one sample at time 0 with empty bounding box and
 		/// with identity transform.
@@ -1106,6 +1452,145 @@ class SceneCache::ReaderImplementation : public SceneCache::Implementation
 
 SceneCache::ReaderImplementation::Defaults SceneCache::ReaderImplementation::g_defaults;
 
+/// Holds the state of the tasks launched by SceneCache::prefetch(). Each task prefetches one location and
+/// launches new tasks for its children, so the hierarchy is traversed in parallel. The tasks are enqueued
+/// rather than spawned, so that they make progress without anyone waiting for them, and each one references
+/// the Implementation, so that the Prefetch handle can be destroyed before they complete.
+class SceneCache::Prefetch::Implementation : public RefCounted
+{
+	public :
+
+		IE_CORE_DECLAREMEMBERPTR( Implementation )
+
+		typedef ReaderImplementation::ReaderImplementationPtr ReaderImplementationPtr;
+
+		Implementation() : m_errorsReported( false )
+		{
+			m_pending = 0;
+		}
+
+		virtual ~Implementation()
+		{
+			if ( !m_errorsReported )
+			{
+				for ( std::vector<std::string>::const_iterator it = m_errors.begin(); it != m_errors.end(); it++ )
+				{
+					msg( Msg::Error, "SceneCache::prefetch", *it );
+				}
+			}
+		}
+
+		void launch( ReaderImplementationPtr location, double time, int what )
+		{
+			m_pending++;
+			tbb::task::enqueue( *new( tbb::task::allocate_root( m_context ) ) Task( this, location, time, what ) );
+		}
+
+		/// Stops the tasks which haven't started yet from running at all.
+		void cancel()
+		{
+			m_context.cancel_group_execution();
+		}
+
+		void wait()
+		{
+			boost::unique_lock<boost::mutex> lock( m_mutex );
+			while ( m_pending )
+			{
+				m_condition.wait( lock );
+			}
+
+			if ( m_errors.size() && !m_errorsReported )
+			{
+				m_errorsReported = true;
+				throw Exception( ( boost::format( "SceneCache::prefetch : %d location(s) failed to load. The first error was : %s" ) % m_errors.size() % m_errors[0] ).str() );
+			}
+		}
+
+		bool done() const
+		{
+			return m_pending == 0;
+		}
+
+	private :
+
+		void taskDone()
+		{
+			boost::lock_guard<boost::mutex> lock( m_mutex );
+			if ( --m_pending == 0 )
+			{
+				m_condition.notify_all();
+			}
+		}
+
+		void taskFailed( const std::string &error )
+		{
+			boost::lock_guard<boost::mutex> lock( m_mutex );
+			m_errors.push_back( error );
+		}
+
+		class Task : public tbb::task
+		{
+			public :
+
+				Task( Implementation *prefetch, ReaderImplementationPtr location, double time, int what )
+					:	m_prefetch( prefetch ), m_location( location ), m_time( time ), m_what( what )
+				{
+				}
+
+				/// Cancelled tasks are destroyed without being executed, so the
+				/// task is only accounted for as done here.
+				virtual ~Task()
+				{
+					m_prefetch->taskDone();
+				}
+
+				virtual tbb::task *execute()
+				{
+					try
+					{
+						m_location->prefetch( m_time, m_what );
+
+						NameList children;
+						m_location->childNames( children );
+						for ( NameList::const_iterator it = children.begin(); it != children.end() && !is_cancelled(); it++ )
+						{
+							ReaderImplementationPtr child = m_location->child( *it, SceneInterface::NullIfMissing );
+							if ( child )
+							{
+								m_prefetch->launch( child, m_time, m_what );
+							}
+						}
+					}
+					catch( const std::exception &e )
+					{
+						m_prefetch->taskFailed( e.what() );
+					}
+					catch( ... )
+					{
+						m_prefetch->taskFailed( "Unknown error" );
+					}
+					return 0;
+				}
+
+			private :
+
+				ImplementationPtr m_prefetch;
+				ReaderImplementationPtr m_location;
+				double m_time;
+				int m_what;
+		};
+
+		tbb::task_group_context m_context;
+		tbb::atomic<size_t> m_pending;
+
+		boost::mutex m_mutex;
+		boost::condition_variable m_condition;
+		std::vector<std::string> m_errors;
+		bool m_errorsReported;
+
+};
+
 /// Writer implementation for SceneCache
 /// Each location keeps refcount pointers to their child locations, so they can always return the same (unfinished child) and when the root is destroyed, it
 /// can trigger the recursive computation of bounding boxes and the global storage of all sampleTime vectors used in the file.
@@ -1115,17 +1600,18 @@ class SceneCache::WriterImplementation : public SceneCache::Implementation
 
 		IE_CORE_DECLAREPTR( WriterImplementation )
 
-		WriterImplementation( IndexedIOPtr io, Implementation *parent = 0) : SceneCache::Implementation( io ), m_parent(static_cast< WriterImplementation* >( parent ))
+		WriterImplementation( IndexedIOPtr io, Implementation *parent = 0) : SceneCache::Implementation( io ), m_parent(static_cast< WriterImplementation* >( parent )), m_finalisedDescendants( false ), m_explicitBounds( false )
 		{
 			if ( m_parent )
 			{
-				// use same map from the root
-				m_sampleTimesMap = m_parent->m_sampleTimesMap;
+				// use same data from the root
+				m_sharedData = m_parent->m_sharedData;
+				m_proxyVertexBudgets = m_parent->m_proxyVertexBudgets;
 			}
 			else
 			{
-				// only the root instance allocate the map.
-				m_sampleTimesMap = new SampleTimesMap;
+				// only the root instance allocate the shared data.
+				m_sharedData = new SharedData;
 			}
 		}
 
@@ -1176,18 +1662,32 @@ class SceneCache::WriterImplementation : public SceneCache::Implementation
 		{
 			writable();
 
-			if ( m_boundSampleTimes.size() )
+			size_t sampleIndex = 0;
 			{
-				if ( *(m_boundSampleTimes.rbegin()) >= time )
+				// children finalised from other threads accumulate their bounds in this location.
+				ChildrenMutex::scoped_lock lock( m_childrenMutex );
+
+				if ( !m_explicitBounds )
 				{
-					throw Exception( "Times must be incremental amongst calls to writeBound!" );
+					// discard any bounds accumulated from finalised children, they are overridden.
+					m_boundSampleTimes.clear();
+					m_boundSamples.clear();
+					m_explicitBounds = true;
 				}
-			}
-			size_t sampleIndex = m_boundSampleTimes.size();
-			m_boundSampleTimes.push_back( time );
-			m_boundSamples.push_back( bound );
-			IndexedIOPtr io = m_indexedIO->subdirectory( boundEntry, IndexedIO::CreateIfMissing );
-			io->write( sampleEntry(sampleIndex), bound.min.getValue(), 6 );
+
+				if ( m_boundSampleTimes.size() )
+				{
+					if ( *(m_boundSampleTimes.rbegin()) >= time )
+					{
+						throw Exception( "Times must be incremental amongst calls to writeBound!" );
+					}
+				}
+				sampleIndex = m_boundSampleTimes.size();
+				m_boundSampleTimes.push_back( time );
+				m_boundSamples.push_back( bound );
+			}
+			IndexedIOPtr io = m_indexedIO->subdirectory( boundEntry, IndexedIO::CreateIfMissing );
+			io->write( sampleEntry(sampleIndex), bound.min.getValue(), 6 );
 		}
 
 		void writeTransform( const Data *transform, double time )
@@ -1253,6 +1753,7 @@ class SceneCache::WriterImplementation : public SceneCache::Implementation
 		void writeLocalTag( const char *tag )
 		{
 			writable();
+			checkLocalTagsWritable();
 			IndexedIOPtr io = m_indexedIO->subdirectory( localTagsEntry, IndexedIO::CreateIfMissing );
 			// we just create a IndexedIO::Directory
 			io->subdirectory( tag, IndexedIO::CreateIfMissing );
@@ -1268,6 +1769,7 @@ class SceneCache::WriterImplementation : public SceneCache::Implementation
 			IndexedIOPtr io(0);
 			if ( tagLocation == SceneInterface::LocalTag )
 			{
+				checkLocalTagsWritable();
 				io = m_indexedIO->subdirectory( localTagsEntry, IndexedIO::CreateIfMissing );
 			}
 			else if ( tagLocation == SceneInterface::AncestorTag )
@@ -1313,6 +1815,7 @@ class SceneCache::WriterImplementation : public SceneCache::Implementation
 			m_objectSampleTimes.push_back( time );
 			IndexedIOPtr io = m_indexedIO->subdirectory( objectEntry, IndexedIO::CreateIfMissing );
 			object->save( io, sampleEntry(sampleIndex) );
+			writeObjectProxies( object, time );
 			
 			const VisibleRenderable *renderable = runTimeCast< const VisibleRenderable >( object );
 			if ( renderable )
@@ -1383,6 +1886,72 @@ class SceneCache::WriterImplementation : public SceneCache::Implementation
 			}
 		}
 
+		void setProxyVertexBudgets( const std::vector<size_t> &budgets )
+		{
+			writable();
+			m_proxyVertexBudgets = budgets;
+			std::sort( m_proxyVertexBudgets.begin(), m_proxyVertexBudgets.end(), std::greater<size_t>() );
+		}
+
+		void writeObjectProxies( const Object *object, double time )
+		{
+			const Primitive *primitive = runTimeCast< const Primitive >( object );
+			if ( !primitive || m_proxyVertexBudgets.empty() )
+			{
+				return;
+			}
+
+			if ( m_objectSampleTimes.size() == 1 )
+			{
+				// the first sample decides which levels are worth storing
+				size_t numVertices = primitive->variableSize( PrimitiveVariable::Vertex );
+				for ( std::vector<size_t>::const_iterator it = m_proxyVertexBudgets.begin(); it != m_proxyVertexBudgets.end(); it++ )
+				{
+					if ( *it < numVertices )
+					{
+						m_proxyLevelBudgets.push_back( *it );
+						m_proxyErrors.push_back( 0.0f );
+					}
+				}
+			}
+
+			// all the levels share the proxy sample times, so either all of them
+			// are written for this sample or none are.
+			std::vector<PrimitivePtr> proxies;
+			std::vector<float> errors;
+			for ( size_t level = 0; level < m_proxyLevelBudgets.size(); level++ )
+			{
+				float error = 0.0f;
+				PrimitivePtr proxy = clusterDecimate( primitive, m_proxyLevelBudgets[level], error );
+				if ( !proxy )
+				{
+					if ( m_objectSampleTimes.size() == 1 )
+					{
+						// not a type we can make proxies for
+						m_proxyLevelBudgets.clear();
+						m_proxyErrors.clear();
+					}
+					return;
+				}
+				proxies.push_back( proxy );
+				errors.push_back( error );
+			}
+
+			if ( proxies.empty() )
+			{
+				return;
+			}
+
+			size_t sampleIndex = m_proxySampleTimes.size();
+			m_proxySampleTimes.push_back( time );
+			IndexedIOPtr io = m_indexedIO->subdirectory( proxiesEntry, IndexedIO::CreateIfMissing );
+			for ( size_t level = 0; level < proxies.size(); level++ )
+			{
+				proxies[level]->save( io->subdirectory( sampleEntry( level ), IndexedIO::CreateIfMissing ), sampleEntry( sampleIndex ) );
+				m_proxyErrors[level] = std::max( m_proxyErrors[level], errors[level] );
+			}
+		}
+
 		WriterImplementationPtr child( const Name &name, MissingBehaviour missingBehaviour )
 		{
 			if ( missingBehaviour == SceneInterface::CreateIfMissing )
@@ -1390,6 +1959,7 @@ class SceneCache::WriterImplementation : public SceneCache::Implementation
 				writable();
 			}
 
+			ChildrenMutex::scoped_lock lock( m_childrenMutex );
 			std::map< SceneCache::Name, WriterImplementationPtr >::const_iterator it = m_children.find( name );
 			if ( it != m_children.end() )
 			{
@@ -1401,6 +1971,14 @@ class SceneCache::WriterImplementation : public SceneCache::Implementation
 			{
 				return 0;
 			}
+
+			// every child is created through this writer, so one which is in the file
+			// but not in m_children must have been finalised and released already.
+			if ( children->hasEntry( name ) )
+			{
+				throw Exception( "This scene has already been flushed to disk. You can't make further changes to it." );
+			}
+
 			IndexedIOPtr childIO = children->subdirectory( name, (IndexedIO::MissingBehaviour)missingBehaviour );
 			if ( !childIO )
 			{
@@ -1414,6 +1992,7 @@ class SceneCache::WriterImplementation : public SceneCache::Implementation
 		SceneCache::ImplementationPtr createChild( const SceneCache::Name &name )
 		{
 			writable();
+			ChildrenMutex::scoped_lock lock( m_childrenMutex );
 			IndexedIOPtr children = m_indexedIO->subdirectory( childrenEntry, IndexedIO::CreateIfMissing );
 			if ( children->hasEntry( name ) )
 			{
@@ -1425,6 +2004,33 @@ class SceneCache::WriterImplementation : public SceneCache::Implementation
 			return result;
 		}
 
+		/// Flushes this location and all the locations below it to the file, and commits them so the
+		/// IndexedIO can release their index from memory. Only the bounds and transforms needed by
+		/// the parent location survive, and they are released as soon as the parent accumulated them.
+		void finalise()
+		{
+			writable();
+
+			if ( !m_parent )
+			{
+				throw Exception( "Call to finalise at the root scene is not allowed!" );
+			}
+
+			// the ancestor tags of the finalised locations can't be updated any more
+			WriterImplementation *root = this;
+			for ( ; root->m_parent; root = root->m_parent )
+			{
+				ChildrenMutex::scoped_lock lock( root->m_parent->m_childrenMutex );
+				root->m_parent->m_finalisedDescendants = true;
+			}
+
+			flush();
+			m_parent->childFinalised( this );
+			m_indexedIO->commit();
+
+			root->writeTagIndex( false );
+		}
+
 		static WriterImplementation *writer( Implementation *impl, bool throwException = true )
 		{
 			WriterImplementation *writer = dynamic_cast< WriterImplementation* >( impl );
@@ -1440,6 +2046,7 @@ class SceneCache::WriterImplementation : public SceneCache::Implementation
 		typedef std::vector< Imath::Box3d > BoxSamples;
 		typedef ConstDataPtr TransformSample;
 		typedef std::vector< TransformSample > TransformSamples;
+		typedef std::map< SceneCache::Name, std::vector< SceneCache::Path > > TagIndex;
 
 		IndexedIOPtr globalSampleTimes()
 		{
@@ -1452,26 +2059,39 @@ class SceneCache::WriterImplementation : public SceneCache::Implementation
 
 		void writable() const
 		{
-			if ( !m_sampleTimesMap )
+			if ( !m_sharedData )
 			{
 				throw Exception( "This scene has already been flushed to disk. You can't make further changes to it." );
 			}
 		}
 
+		// The local tags of a location are recorded as ancestor tags of its descendants
+		// when they're flushed, so they can't be added once one of them has been finalised.
+		void checkLocalTagsWritable()
+		{
+			ChildrenMutex::scoped_lock lock( m_childrenMutex );
+			if ( m_finalisedDescendants )
+			{
+				throw Exception( "Tags can't be written to a location after finalising one of its descendants." );
+			}
+		}
+
 		// Function to store intelligently the given sample times in the file location.
 		// It actually saves the index there, and stores the unique sample times in a global shared location.
 		void storeSampleTimes( const SampleTimes &sampleTimes, IndexedIOPtr location )
 		{
-			assert( m_sampleTimesMap );
+			assert( m_sharedData );
 			uint64_t sampleTimesIndex = 	0;
 			IndexedIO::EntryID samplesEntry;
-			std::pair< SampleTimesMap::iterator, bool > it = m_sampleTimesMap->insert( std::pair< SampleTimes, uint64_t >( sampleTimes, 0 ) );
+			SharedData::Mutex::scoped_lock lock( m_sharedData->mutex );
+			std::pair< SampleTimesMap::iterator, bool > it = m_sharedData->sampleTimesMap.insert( std::pair< SampleTimes, uint64_t >( sampleTimes, 0 ) );
 			if ( it.second )
 			{
 				// Unique Id for the sampleTimes (incremental integer)
-				sampleTimesIndex = m_sampleTimesMap->size() - 1;
+				sampleTimesIndex = m_sharedData->sampleTimesMap.size() - 1;
 				// store the uniqueId in the global map
 				it.first->second = sampleTimesIndex;
+				lock.release();
 				// find the global location for the sample times from the root Scene.
 				IndexedIOPtr sampleTimesIO = globalSampleTimes();
 				samplesEntry = sampleEntry(sampleTimesIndex);
@@ -1482,6 +2102,7 @@ class SceneCache::WriterImplementation : public SceneCache::Implementation
 			{
 				// already saved in the global sample times section...
 				sampleTimesIndex = it.first->second;
+				lock.release();
 				samplesEntry = sampleEntry(sampleTimesIndex);
 			}
 			location->createSubdirectory( sampleTimesEntry )->createSubdirectory( samplesEntry );
@@ -1665,25 +2286,49 @@ class SceneCache::WriterImplementation : public SceneCache::Implementation
 
 		// Called from the destructor of the root location. 
 		// It triggers flush recursivelly on all the child locations.
-		// It also sets m_sampleTimesMap to NULL which prevents further modification on this and all child scene interface objects through their call to writable().
+		// It also sets m_sharedData to NULL which prevents further modification on this and all child scene interface objects through their call to writable().
 		// Responsible for writing missing data such as all the sample 
 		// times from object,transform,attributes and bounds. And also computes the 
 		// animated bounding boxes in case they were not explicitly writen.
 		//
 		void flush()
 		{
-			if ( m_parent )
+			// get ancestor tags from the local tags of all the parents. They can't be read from
+			// the ancestor tags of the parent, because it is not flushed yet when finalise() is used.
+			NameList tags, parentTags;
+			for ( const WriterImplementation *parent = m_parent; parent; parent = parent->m_parent )
 			{
-				NameList tags;
-				// get ancestor tags from parent
-				m_parent->readTags( tags, SceneInterface::LocalTag | SceneInterface::AncestorTag );
-				writeTags( tags, SceneInterface::AncestorTag );
+				parent->readTags( parentTags, SceneInterface::LocalTag );
+				tags.insert( tags.end(), parentTags.begin(), parentTags.end() );
+			}
+			writeTags( tags, SceneInterface::AncestorTag );
+
+			// register this location in the tag index
+			NameList localTags;
+			readTags( localTags, SceneInterface::LocalTag );
+			if ( localTags.size() )
+			{
+				SceneCache::Path p;
+				path( p );
+				SharedData::Mutex::scoped_lock lock( m_sharedData->mutex );
+				for ( NameList::const_iterator tIt = localTags.begin(); tIt != localTags.end(); tIt++ )
+				{
+					if ( !isObjectTypeTag( *tIt ) )
+					{
+						m_sharedData->tagIndex[ *tIt ].push_back( p );
+						m_sharedData->tagIndexSize++;
+					}
+				}
 			}
-			/// first call flush recursively on children...
+
+			/// first call flush on children, in parallel since they are independent subtrees...
+			std::vector< WriterImplementation * > children;
+			children.reserve( m_children.size() );
 			for ( std::map< SceneCache::Name, WriterImplementationPtr >::const_iterator cit = m_children.begin(); cit != m_children.end(); cit++ )
 			{
-				cit->second->flush();
+				children.push_back( cit->second.get() );
 			}
+			tbb::parallel_for( tbb::blocked_range<size_t>( 0, children.size() ), FlushChildren( children ) );
 
 			IndexedIOPtr io;
 			// save the transform sample times
@@ -1715,6 +2360,7 @@ class SceneCache::WriterImplementation : public SceneCache::Implementation
 					writeAttribute( animatedObjectPrimVarsAttribute, primVarData.get(), 0 );
 				}
 			}
+
 			
 			// save the attribute sample times
 			if ( m_attributeSampleTimes.size() )
@@ -1731,157 +2377,21 @@ class SceneCache::WriterImplementation : public SceneCache::Implementation
 				io = m_indexedIO->subdirectory( objectEntry, IndexedIO::CreateIfMissing );
 				storeSampleTimes( m_objectSampleTimes, io );				
 			}
+			// save the proxy sample times and the error of each level
+			if ( m_proxySampleTimes.size() )
+			{
+				io = m_indexedIO->subdirectory( proxiesEntry, IndexedIO::CreateIfMissing );
+				storeSampleTimes( m_proxySampleTimes, io );
+				io->write( proxyErrorsEntry, &m_proxyErrors[0], m_proxyErrors.size() );
+			}
 			// We have to compute the bounding box over time for the object and each child if there's no bound overrides writen.
 			bool computedBounds = false;
-			if ( m_boundSampleTimes.size() == 0 )
+			if ( !m_explicitBounds )
 			{
 				computedBounds = true;
 				for ( std::map< SceneCache::Name, WriterImplementationPtr >::const_iterator cit = m_children.begin(); cit != m_children.end(); cit++ )
 				{
-					const SampleTimes &childBoundTimes = cit->second->m_boundSampleTimes;
-					const BoxSamples &childBoxSamples = cit->second->m_boundSamples;
-					const SampleTimes &childTransformTimes = cit->second->m_transformSampleTimes;
-					const TransformSamples &childTransformSamples = cit->second->m_transformSamples; 
-
-					if ( childBoundTimes.size() == 0 )
-					{
-						continue;
-					}
-
-					if ( childTransformTimes.size() == 0 )
-					{
-						// no transform or animation applied to this child... we just accumulate it.
-						accumulateBoxSamples( childBoundTimes, childBoxSamples );
-					}
-					else if ( childTransformTimes.size() == 1 )
-					{
-						M44d m = dataToMatrix( childTransformSamples[0].get() );
-						// there's just one constant transform applied to the children, very simple case 
-						// (we can ignore it's time and just use the child box one)
-						BoxSamples transformedChildBoxes;
-						transformedChildBoxes.reserve( childBoundTimes.size() );
-						for ( BoxSamples::const_iterator cbit = childBoxSamples.begin(); cbit != childBoxSamples.end(); cbit++ )
-						{
-							transformedChildBoxes.push_back( transform( *cbit, m ) );
-						}
-						// accumulate the resulting transformed bounding boxes
-						accumulateBoxSamples( childBoundTimes, transformedChildBoxes );
-					}
-					else // childTransformTimes.size() > 1
-					{
-						BoxSamples transformedChildBoxes;
-
-						if ( childBoundTimes.size() > 1 )
-						{
-							// complex case: animated transforms. 
-
-							// Step 1: Apply bbox interpolation for each transform sample that doesn't have a corresponding bbox sample.
-							SampleTimes transformedChildSampleTimes;
-
-							transformedChildSampleTimes.reserve( childBoundTimes.size() + childTransformTimes.size() );
-							transformedChildBoxes.reserve( childBoundTimes.size() + childTransformTimes.size() );
-
-							SampleTimes::const_iterator transformTimeIt, childTimeIt;
-							BoxSamples::const_iterator childBoxIt;
-							transformTimeIt = childTransformTimes.begin();
-							childTimeIt = childBoundTimes.begin();
-							TransformSamples::const_iterator transformIt = childTransformSamples.begin();
-							childBoxIt = childBoxSamples.begin();
-							Imath::Box3d tmpBox;
-							LinearInterpolator<Box3d> boxInterpolator;
-
-							while( childTimeIt != childBoundTimes.end() && transformTimeIt != childTransformTimes.end() )
-							{
-								if ( *childTimeIt < *transformTimeIt )
-								{
-									// Situation: child sample comes before the transform sample: interpolate transform.
-									transformedChildSampleTimes.push_back( *childTimeIt );
-									transformedChildBoxes.push_back( *childBoxIt );
-									childTimeIt++;
-									childBoxIt++;
-								}
-								else if ( *transformTimeIt < *childTimeIt )
-								{
-									// Situation: transform sample comes before the child sample: interpolate child bbox.
-									if ( childBoxIt == childBoxSamples.begin() )
-									{
-										// this is the first known sample so nothing to interpolate...
-										tmpBox = *childBoxIt;
-									}
-									else
-									{
-										// interpolate known samples.
-										double prevChildTime = *(childTimeIt-1);
-										double x = (*transformTimeIt -prevChildTime) /((*childTimeIt)-prevChildTime);
-										boxInterpolator( *(childBoxIt-1), *childBoxIt, x, tmpBox );
-									}
-									transformedChildSampleTimes.push_back( *transformTimeIt );
-									transformedChildBoxes.push_back( tmpBox );
-									transformTimeIt++;
-									transformIt++;
-								}
-								else
-								{
-									// Situation: child sample matches the time of the transform sample: transform child bbox.
-									transformedChildSampleTimes.push_back( *childTimeIt );
-									transformedChildBoxes.push_back( *childBoxIt );
-									childTimeIt++;
-									childBoxIt++;
-									transformTimeIt++;
-									transformIt++;
-								}
-							}
-
-							while( childTimeIt != childBoundTimes.end() )
-							{
-								// Situation: child samples exist after all the transform samples.
-								transformedChildSampleTimes.push_back( *childTimeIt );
-								transformedChildBoxes.push_back( *childBoxIt );
-								childTimeIt++;
-								childBoxIt++;
-							}
-
-							tmpBox = *(childBoxSamples.rbegin());
-							while( transformTimeIt != childTransformTimes.end() )
-							{
-								// Situation: transform samples exist after all the child samples
-								transformedChildSampleTimes.push_back( *transformTimeIt );
-								transformedChildBoxes.push_back( tmpBox );
-								transformTimeIt++;
-								transformIt++;
-							}
-
-							// We also want to add some border in the sampled bounding boxes to 
-							// guarantee that the interpolated rotations that trace curves in space
-							// would still be included in the linear interpolated bounding boxes.
-							// then we transform the child bboxes...
-							transformAndExpandBounds( childTransformTimes, childTransformSamples, transformedChildSampleTimes, transformedChildBoxes );
-
-							// accumulate the resulting transformed bounding boxes
-							accumulateBoxSamples( transformedChildSampleTimes, transformedChildBoxes );
-						}
-						else
-						{
-							// the child object does not vary in time, so we just have to transform at each transform 
-							// sample (and we can ignore the sample time for the box - if existent)
-
-							Imath::Box3d tmpBox;
-							if ( childBoxSamples.size() )
-							{
-								tmpBox = childBoxSamples[0];
-							}
-
-							transformedChildBoxes.resize( childTransformTimes.size(), tmpBox );
-
-							// We also want to add some border in the sampled bounding boxes to 
-							// guarantee that the interpolated rotations that trace curves in space
-							// would still be included in the linear interpolated bounding boxes.
-							// then we transform the child bboxes...
-							transformAndExpandBounds( childTransformTimes, childTransformSamples, childTransformTimes, transformedChildBoxes );
-							// accumulate the resulting transformed bounding boxes
-							accumulateBoxSamples( childTransformTimes, transformedChildBoxes );							
-						}
-					}
+					accumulateChildBounds( cit->second.get() );
 				}
 
 				if ( m_objectSampleTimes.size() && m_objectSamples.size() )
@@ -1918,18 +2428,245 @@ class SceneCache::WriterImplementation : public SceneCache::Implementation
 			// deallocate children since we now computed everything from them anyways...
 			m_children.clear();
 
-			if ( !m_parent && m_sampleTimesMap )
+			if ( !m_parent && m_sharedData )
 			{
 				// we are at the root...
-				// deallocate samples map stored in the root object.
-				delete m_sampleTimesMap;
+				writeTagIndex( true );
+				// deallocate the data shared by all the locations, stored in the root object.
+				delete m_sharedData;
 				// and make sure the cache does not contain this file, forcing it to reload it.
 				if ( m_indexedIO->typeId() == FileIndexedIOTypeId )
 				{
 					SharedSceneInterfaces::erase( static_cast< FileIndexedIO * >( m_indexedIO.get() )->fileName() );
 				}
 			}
-			m_sampleTimesMap = 0;
+			m_sharedData = 0;
+		}
+
+		/// Unions the bounding boxes of the given child, transformed by its transform, with
+		/// the bounds computed for this location.
+		void accumulateChildBounds( const WriterImplementation *child )
+		{
+			const SampleTimes &childBoundTimes = child->m_boundSampleTimes;
+			const BoxSamples &childBoxSamples = child->m_boundSamples;
+			const SampleTimes &childTransformTimes = child->m_transformSampleTimes;
+			const TransformSamples &childTransformSamples = child->m_transformSamples; 
+
+			if ( childBoundTimes.size() == 0 )
+			{
+				return;
+			}
+
+			if ( childTransformTimes.size() == 0 )
+			{
+				// no transform or animation applied to this child... we just accumulate it.
+				accumulateBoxSamples( childBoundTimes, childBoxSamples );
+			}
+			else if ( childTransformTimes.size() == 1 )
+			{
+				M44d m = dataToMatrix( childTransformSamples[0].get() );
+				// there's just one constant transform applied to the children, very simple case 
+				// (we can ignore it's time and just use the child box one)
+				BoxSamples transformedChildBoxes;
+				transformedChildBoxes.reserve( childBoundTimes.size() );
+				for ( BoxSamples::const_iterator cbit = childBoxSamples.begin(); cbit != childBoxSamples.end(); cbit++ )
+				{
+					transformedChildBoxes.push_back( transform( *cbit, m ) );
+				}
+				// accumulate the resulting transformed bounding boxes
+				accumulateBoxSamples( childBoundTimes, transformedChildBoxes );
+			}
+			else // childTransformTimes.size() > 1
+			{
+				BoxSamples transformedChildBoxes;
+
+				if ( childBoundTimes.size() > 1 )
+				{
+					// complex case: animated transforms. 
+
+					// Step 1: Apply bbox interpolation for each transform sample that doesn't have a corresponding bbox sample.
+					SampleTimes transformedChildSampleTimes;
+
+					transformedChildSampleTimes.reserve( childBoundTimes.size() + childTransformTimes.size() );
+					transformedChildBoxes.reserve( childBoundTimes.size() + childTransformTimes.size() );
+
+					SampleTimes::const_iterator transformTimeIt, childTimeIt;
+					BoxSamples::const_iterator childBoxIt;
+					transformTimeIt = childTransformTimes.begin();
+					childTimeIt = childBoundTimes.begin();
+					TransformSamples::const_iterator transformIt = childTransformSamples.begin();
+					childBoxIt = childBoxSamples.begin();
+					Imath::Box3d tmpBox;
+					LinearInterpolator<Box3d> boxInterpolator;
+
+					while( childTimeIt != childBoundTimes.end() && transformTimeIt != childTransformTimes.end() )
+					{
+						if ( *childTimeIt < *transformTimeIt )
+						{
+							// Situation: child sample comes before the transform sample: interpolate transform.
+							transformedChildSampleTimes.push_back( *childTimeIt );
+							transformedChildBoxes.push_back( *childBoxIt );
+							childTimeIt++;
+							childBoxIt++;
+						}
+						else if ( *transformTimeIt < *childTimeIt )
+						{
+							// Situation: transform sample comes before the child sample: interpolate child bbox.
+							if ( childBoxIt == childBoxSamples.begin() )
+							{
+								// this is the first known sample so nothing to interpolate...
+								tmpBox = *childBoxIt;
+							}
+							else
+							{
+								// interpolate known samples.
+								double prevChildTime = *(childTimeIt-1);
+								double x = (*transformTimeIt -prevChildTime) /((*childTimeIt)-prevChildTime);
+								boxInterpolator( *(childBoxIt-1), *childBoxIt, x, tmpBox );
+							}
+							transformedChildSampleTimes.push_back( *transformTimeIt );
+							transformedChildBoxes.push_back( tmpBox );
+							transformTimeIt++;
+							transformIt++;
+						}
+						else
+						{
+							// Situation: child sample matches the time of the transform sample: transform child bbox.
+							transformedChildSampleTimes.push_back( *childTimeIt );
+							transformedChildBoxes.push_back( *childBoxIt );
+							childTimeIt++;
+							childBoxIt++;
+							transformTimeIt++;
+							transformIt++;
+						}
+					}
+
+					while( childTimeIt != childBoundTimes.end() )
+					{
+						// Situation: child samples exist after all the transform samples.
+						transformedChildSampleTimes.push_back( *childTimeIt );
+						transformedChildBoxes.push_back( *childBoxIt );
+						childTimeIt++;
+						childBoxIt++;
+					}
+
+					tmpBox = *(childBoxSamples.rbegin());
+					while( transformTimeIt != childTransformTimes.end() )
+					{
+						// Situation: transform samples exist after all the child samples
+						transformedChildSampleTimes.push_back( *transformTimeIt );
+						transformedChildBoxes.push_back( tmpBox );
+						transformTimeIt++;
+						transformIt++;
+					}
+
+					// We also want to add some border in the sampled bounding boxes to 
+					// guarantee that the interpolated rotations that trace curves in space
+					// would still be included in the linear interpolated bounding boxes.
+					// then we transform the child bboxes...
+					transformAndExpandBounds( childTransformTimes, childTransformSamples, transformedChildSampleTimes, transformedChildBoxes );
+
+					// accumulate the resulting transformed bounding boxes
+					accumulateBoxSamples( transformedChildSampleTimes, transformedChildBoxes );
+				}
+				else
+				{
+					// the child object does not vary in time, so we just have to transform at each transform 
+					// sample (and we can ignore the sample time for the box - if existent)
+
+					Imath::Box3d tmpBox;
+					if ( childBoxSamples.size() )
+					{
+						tmpBox = childBoxSamples[0];
+					}
+
+					transformedChildBoxes.resize( childTransformTimes.size(), tmpBox );
+
+					// We also want to add some border in the sampled bounding boxes to 
+					// guarantee that the interpolated rotations that trace curves in space
+					// would still be included in the linear interpolated bounding boxes.
+					// then we transform the child bboxes...
+					transformAndExpandBounds( childTransformTimes, childTransformSamples, childTransformTimes, transformedChildBoxes );
+					// accumulate the resulting transformed bounding boxes
+					accumulateBoxSamples( childTransformTimes, transformedChildBoxes );							
+				}
+			}
+		}
+
+		/// Called by finalise() on a child location once it has been flushed. Its bounds are
+		/// accumulated straight away, so it can be released from memory.
+		void childFinalised( const WriterImplementation *child )
+		{
+			ChildrenMutex::scoped_lock lock( m_childrenMutex );
+			if ( !m_explicitBounds )
+			{
+				accumulateChildBounds( child );
+			}
+			m_children.erase( child->name() );
+		}
+
+		/// Stores the paths of the locations holding each local tag under the tagIndex entry of the root,
+		/// so readers can answer SceneInterface::taggedPaths() without traversing the hierarchy, and
+		/// releases them from memory. The paths are written in chunks, each in a numbered directory
+		/// below the tag. In each chunk the path list is front coded : for every path, the prefixes
+		/// entry holds the number of names shared with the previous path and the number of names that
+		/// follow, which are appended to the names entry. Unless force is true, nothing is written until
+		/// enough paths have accumulated, so finalising many small subtrees doesn't fragment the index.
+		/// Must be called on the root.
+		void writeTagIndex( bool force )
+		{
+			assert( !m_parent );
+
+			TagIndex tagIndex;
+			{
+				SharedData::Mutex::scoped_lock lock( m_sharedData->mutex );
+				if ( !force && m_sharedData->tagIndexSize < g_tagIndexChunkSize )
+				{
+					return;
+				}
+				tagIndex.swap( m_sharedData->tagIndex );
+				m_sharedData->tagIndexSize = 0;
+			}
+
+			boost::lock_guard<boost::mutex> lock( m_sharedData->tagIndexWriteMutex );
+			IndexedIOPtr indexIO = m_indexedIO->subdirectory( tagIndexEntry, IndexedIO::CreateIfMissing );
+			std::vector<unsigned int> prefixes;
+			std::vector<InternedString> names;
+			for ( TagIndex::iterator it = tagIndex.begin(); it != tagIndex.end(); it++ )
+			{
+				// locations may have been flushed in any order by concurrent threads, so we
+				// sort them, which also makes the front coding more effective.
+				std::sort( it->second.begin(), it->second.end(), PathNameLess() );
+
+				prefixes.clear();
+				names.clear();
+				const SceneCache::Path *previous = 0;
+				for ( std::vector<SceneCache::Path>::const_iterator pIt = it->second.begin(); pIt != it->second.end(); pIt++ )
+				{
+					size_t common = 0;
+					if ( previous )
+					{
+						size_t n = std::min( pIt->size(), previous->size() );
+						while( common < n && (*pIt)[common] == (*previous)[common] )
+						{
+							common++;
+						}
+					}
+					prefixes.push_back( common );
+					prefixes.push_back( pIt->size() - common );
+					names.insert( names.end(), pIt->begin() + common, pIt->end() );
+					previous = &(*pIt);
+				}
+
+				size_t &chunk = m_sharedData->tagIndexChunks[ it->first ];
+				IndexedIOPtr io = indexIO->subdirectory( it->first, IndexedIO::CreateIfMissing );
+				io = io->subdirectory( sampleEntry( chunk++ ), IndexedIO::CreateIfMissing );
+				io->write( tagIndexPrefixesEntry, &prefixes[0], prefixes.size() );
+				if ( names.size() )
+				{
+					io->write( tagIndexNamesEntry, &names[0], names.size() );
+				}
+			}
 		}
 
 		/// This functions transforms the bounding boxes with the animated transforms and also scales the bounding boxes in a way that it
@@ -2060,11 +2797,77 @@ class SceneCache::WriterImplementation : public SceneCache::Implementation
 
 		WriterImplementation* m_parent;
 		std::map< SceneCache::Name, WriterImplementationPtr > m_children;
+		// whether any location below this one was finalised
+		bool m_finalisedDescendants;
 
 		typedef std::map< SampleTimes, uint64_t > SampleTimesMap;
 		typedef std::map< SceneCache::Name, SampleTimes > AttributeSamplesMap;
 
-		SampleTimesMap *m_sampleTimesMap;
+		// Data owned by the root and shared by all the locations, which may be flushed concurrently.
+		struct SharedData
+		{
+			SharedData() : tagIndexSize( 0 )
+			{
+			}
+
+			typedef tbb::spin_mutex Mutex;
+			Mutex mutex;
+			SampleTimesMap sampleTimesMap;
+			// the paths registered in the tag index since it was last written
+			TagIndex tagIndex;
+			size_t tagIndexSize;
+			// serialises writeTagIndex(), which writes outside of the mutex
+			boost::mutex tagIndexWriteMutex;
+			// the number of chunks written for each tag so far
+			std::map< SceneCache::Name, size_t > tagIndexChunks;
+		};
+
+		// Orders paths by the names of their elements rather than by interned pointers,
+		// so that the tag index is the same from one session to the next.
+		struct PathNameLess
+		{
+			bool operator()( const SceneCache::Path &a, const SceneCache::Path &b ) const
+			{
+				size_t n = std::min( a.size(), b.size() );
+				for ( size_t i = 0; i < n; i++ )
+				{
+					if ( a[i] != b[i] )
+					{
+						return a[i].value() < b[i].value();
+					}
+				}
+				return a.size() < b.size();
+			}
+		};
+
+		// Flushes child locations from the tasks of a parallel_for.
+		class FlushChildren
+		{
+			public :
+
+				FlushChildren( const std::vector< WriterImplementation * > &children ) : m_children( children )
+				{
+				}
+
+				void operator()( const tbb::blocked_range<size_t> &range ) const
+				{
+					for ( size_t i = range.begin(); i != range.end(); i++ )
+					{
+						m_children[i]->flush();
+					}
+				}
+
+			private :
+
+				const std::vector< WriterImplementation * > &m_children;
+		};
+
+		SharedData *m_sharedData;
+		// protects m_children, m_finalisedDescendants and the bounds, when children are created or finalised concurrently.
+		// child() and createChild() hold it while creating the IndexedIO directory, so it must block rather than spin.
+		typedef boost::mutex ChildrenMutex;
+		ChildrenMutex m_childrenMutex;
+		bool m_explicitBounds;
 		SampleTimes m_boundSampleTimes;		// implicit or explicit bound sample times
 		SampleTimes m_transformSampleTimes;
 		AttributeSamplesMap m_attributeSampleTimes;
@@ -2081,6 +2884,14 @@ class SceneCache::WriterImplementation : public SceneCache::Implementation
 		
 		AnimatedHashTest m_animatedObjectTopology;
 		AnimatedPrimVarMap m_animatedObjectPrimVars;
+
+		// the budgets requested for proxy generation, largest first, and
+		// the subset used for this location's object along with their errors
+		// and the times of the object samples they were written for.
+		std::vector<size_t> m_proxyVertexBudgets;
+		std::vector<size_t> m_proxyLevelBudgets;
+		std::vector<float> m_proxyErrors;
+		SampleTimes m_proxySampleTimes;
 };
 
 //////////////////////////////////////////////////////////////////////////
@@ -2486,3 +3297,117 @@ bool SceneCache::readOnly() const
 {
 	return dynamic_cast< const ReaderImplementation* >( m_implementation.get() ) != NULL;
 }
+
+void SceneCache::taggedPaths( const Name &tag, std::vector<Path> &paths ) const
+{
+	ReaderImplementation *reader = ReaderImplementation::reader( m_implementation.get() );
+	if ( !reader->taggedPaths( tag, paths ) )
+	{
+		// files written before the tag index was introduced, or
+		// object type tags, which aren't indexed
+		SceneInterface::taggedPaths( tag, paths );
+	}
+}
+
+void SceneCache::readBounds( const std::vector<Path> &paths, double time, std::vector<Imath::Box3d> &bounds ) const
+{
+	ReaderImplementation *reader = ReaderImplementation::reader( m_implementation.get() );
+	std::vector<ReaderImplementation::ReaderImplementationPtr> locations;
+	reader->scenes( paths, locations );
+	ReaderImplementation::readBatch<Imath::Box3d, ReaderImplementation::BoundReader>( locations, time, bounds );
+}
+
+void SceneCache::readTransformsAsMatrices( const std::vector<Path> &paths, double time, std::vector<Imath::M44d> &transforms ) const
+{
+	ReaderImplementation *reader = ReaderImplementation::reader( m_implementation.get() );
+	std::vector<ReaderImplementation::ReaderImplementationPtr> locations;
+	reader->scenes( paths, locations );
+	ReaderImplementation::readBatch<Imath::M44d, ReaderImplementation::TransformReader>( locations, time, transforms );
+}
+
+void SceneCache::readObjects( const std::vector<Path> &paths, double time, std::vector<ConstObjectPtr> &objects ) const
+{
+	ReaderImplementation *reader = ReaderImplementation::reader( m_implementation.get() );
+	std::vector<ReaderImplementation::ReaderImplementationPtr> locations;
+	reader->scenes( paths, locations );
+	ReaderImplementation::readBatch<ConstObjectPtr, ReaderImplementation::ObjectReader>( locations, time, objects );
+}
+
+void SceneCache::setProxyVertexBudgets( const std::vector<size_t> &budgets )
+{
+	WriterImplementation *writer = WriterImplementation::writer( m_implementation.get() );
+	writer->setProxyVertexBudgets( budgets );
+}
+
+void SceneCache::proxyErrors( std::vector<float> &errors ) const
+{
+	ReaderImplementation *reader = ReaderImplementation::reader( m_implementation.get() );
+	reader->proxyErrors( errors );
+}
+
+ConstObjectPtr SceneCache::readProxy( size_t level, double time ) const
+{
+	ReaderImplementation *reader = ReaderImplementation::reader( m_implementation.get() );
+	return reader->readProxy( level, time );
+}
+
+ConstObjectPtr SceneCache::readObjectProxy( double time, float maxScreenError, float pixelsPerUnit ) const
+{
+	ReaderImplementation *reader = ReaderImplementation::reader( m_implementation.get() );
+
+	std::vector<float> errors;
+	reader->proxyErrors( errors );
+	for ( size_t level = errors.size(); level > 0; level-- )
+	{
+		if ( errors[level-1] * pixelsPerUnit <= maxScreenError )
+		{
+			return reader->readProxy( level - 1, time );
+		}
+	}
+	return reader->readObject( time );
+}
+
+void SceneCache::finalise()
+{
+	WriterImplementation *writer = WriterImplementation::writer( m_implementation.get() );
+	writer->finalise();
+}
+
+SceneCache::PrefetchPtr SceneCache::prefetch( const std::vector<Path> &paths, double time, int what ) const
+{
+	ReaderImplementation *reader = ReaderImplementation::reader( m_implementation.get() );
+
+	PrefetchPtr result = new Prefetch();
+	for ( std::vector<Path>::const_iterator it = paths.begin(); it != paths.end(); it++ )
+	{
+		ReaderImplementation::ReaderImplementationPtr location = static_cast< ReaderImplementation* >( reader->scene( *it, SceneInterface::NullIfMissing ).get() );
+		if ( location )
+		{
+			result->m_implementation->launch( location, time, what );
+		}
+	}
+	return result;
+}
+
+SceneCache::Prefetch::Prefetch() : m_implementation( new Implementation )
+{
+	m_implementation->addRef();
+}
+
+SceneCache::Prefetch::~Prefetch()
+{
+	// the tasks which are already running hold references to the
+	// implementation, and will release it when they complete.
+	m_implementation->cancel();
+	m_implementation->removeRef();
+}
+
+void SceneCache::Prefetch::wait()
+{
+	m_implementation->wait();
+}
+
+bool SceneCache::Prefetch::done() const
+{
+	return m_implementation->done();
+}
@@ -124,6 +124,64 @@ void SceneInterface::hash( HashType hashType, double time, MurmurHash &h ) const
 	h.append( typeId() );
 }
 
+void SceneInterface::readBounds( const std::vector<Path> &paths, double time, std::vector<Imath::Box3d> &bounds ) const
+{
+	bounds.resize( paths.size() );
+	for ( size_t i = 0; i < paths.size(); i++ )
+	{
+		bounds[i] = scene( paths[i] )->readBound( time );
+	}
+}
+
+void SceneInterface::readTransformsAsMatrices( const std::vector<Path> &paths, double time, std::vector<Imath::M44d> &transforms ) const
+{
+	transforms.resize( paths.size() );
+	for ( size_t i = 0; i < paths.size(); i++ )
+	{
+		transforms[i] = scene( paths[i] )->readTransformAsMatrix( time );
+	}
+}
+
+void SceneInterface::readObjects( const std::vector<Path> &paths, double time, std::vector<ConstObjectPtr> &objects ) const
+{
+	objects.resize( paths.size() );
+	for ( size_t i = 0; i < paths.size(); i++ )
+	{
+		ConstSceneInterfacePtr s = scene( paths[i] );
+		objects[i] = s->hasObject() ? s->readObject( time ) : ConstObjectPtr();
+	}
+}
+
+static void taggedPathsWalk( const SceneInterface *s, const SceneInterface::Name &tag, SceneInterface::Path &path, std::vector<SceneInterface::Path> &paths )
+{
+	if ( s->hasTag( tag, SceneInterface::LocalTag ) )
+	{
+		paths.push_back( path );
+	}
+
+	if ( !s->hasTag( tag, SceneInterface::DescendantTag ) )
+	{
+		return;
+	}
+
+	SceneInterface::NameList childNames;
+	s->childNames( childNames );
+	for ( SceneInterface::NameList::const_iterator it = childNames.begin(); it != childNames.end(); it++ )
+	{
+		path.push_back( *it );
+		taggedPathsWalk( s->child( *it ).get(), tag, path, paths );
+		path.pop_back();
+	}
+}
+
+void SceneInterface::taggedPaths( const Name &tag, std::vector<Path> &paths ) const
+{
+	paths.clear();
+	Path p;
+	path( p );
+	taggedPathsWalk( this, tag, p, paths );
+}
+
 void SceneInterface::pathToString( const SceneInterface::Path &p, std::string &path )
 {
 	if ( !p.size() )
@@ -40,6 +40,8 @@
 #include <cassert>
 #include <map>
 #include <set>
+#include <vector>
+#include <cstring>
 
 #include "boost/tokenizer.hpp"
 #include "boost/optional.hpp"
@@ -49,7 +51,13 @@
 #include "boost/iostreams/filtering_stream.hpp"
 #include "boost/iostreams/stream.hpp"
 #include "boost/iostreams/filter/gzip.hpp"
+#include "boost/iostreams/filter/zlib.hpp"
+#include "boost/iostreams/device/array.hpp"
+#include "boost/iostreams/device/back_inserter.hpp"
+#include "boost/type_traits/alignment_of.hpp"
 #include "tbb/spin_rw_mutex.h"
+#include "tbb/spin_mutex.h"
+#include "tbb/atomic.h"
 
 #include "IECore/ByteOrder.h"
 #include "IECore/MemoryStream.h"
@@ -57,6 +65,7 @@
 #include "IECore/StreamIndexedIO.h"
 #include "IECore/VectorTypedData.h"
 #include "IECore/MurmurHash.h"
+#include "IECore/BlobStore.h"
 
 #define HARDLINK				127
 #define SUBINDEX_DIR			126
@@ -69,16 +78,39 @@ static const Imf::Int64 g_versionedMagicNumber = 0xB00B1E50;
 /// Version 5: introduced subindex as zipped data blocks (to reduce size of the main index). 
 ///            Hard links are represented as regular data nodes, that points to same data on file (no removal of data ever). 
 ///            Removed the linkCount field on the data nodes.
+/// Version 6: introduced optional compression of array data blocks, recorded in the upper bits of the DataType field.
+/// Version 7: introduced references to data blocks held in a shared BlobStore, and the BlobStorePath field of the index.
 /// \todo Store SubIndexSize and NodeCount as unsigned 64bit integers
-static const Imf::Int64 g_currentVersion = 5;
+static const Imf::Int64 g_currentVersion = 7;
+/// Files are written with the oldest version able to represent their contents, so that
+/// files which don't use compression or a BlobStore remain readable by older readers.
+static const Imf::Int64 g_minimumWriteVersion = 5;
+
+/// Layout of the DataType field of data nodes. The lower bits hold the IndexedIO::DataType
+/// and the upper bits describe how the data block is compressed (always zero before version 6).
+#define DATATYPE_MASK			0x1f
+#define COMPRESSION_MASK		0x60
+#define COMPRESSION_SHIFT		5
+#define SHUFFLE_FLAG			0x80
+/// Value of the compression bits for data nodes whose block is held in the BlobStore. The block in the
+/// file then holds a BlobReference, which records how the blob itself is compressed.
+#define BLOB_REFERENCE			( 3 << COMPRESSION_SHIFT )
+
+/// Data blocks smaller than this are never compressed.
+static const size_t g_minCompressedSize = 128;
+
+/// Size of the BlobReference blocks.
+static const size_t g_blobReferenceSize = 3 * sizeof( Imf::Int64 ) + sizeof( char );
 
 /// FileFormat ::= Data Index IndexOffset Version MagicNumber
 /// Data ::= DataEntry*
-/// Index ::= zip(StringCache NodeTree FreePages)
+/// Index ::= zip(StringCache NodeTree FreePages BlobStorePath)
 
 /// DataEntry ::= Stores data from nodes: 
 ///                [Data nodes] binary data indexed by DataOffset/DataSize and 
 ///                [Subindex]   SubIndexSize zip(NodeCount NodeTree*) indexed by SubIndexOffset.
+///                [BlobReference] BlobHashH1 BlobHashH2 BlobSize BlobCompression ( int64 int64 int64 char )
+///                             for Data nodes with the BLOB_REFERENCE compression bits.
 /// SubIndexSize :: = uint32 - number of bytes in the zipped subindex that follows
 
 /// StringCache ::= NumStrings String*
@@ -92,12 +124,12 @@ static const Imf::Int64 g_currentVersion = 5;
 ///			 EntryType EntryStringCacheID SubIndexOffset ( If EntryType == SUBINDEX_DIR )
 /// EntryType ::= char ( value from IndexedIO::EntryType )
 /// EntryStringCacheID ::= int64 ( index in StringCache )
-/// DataType ::= char ( value from IndexedIO::DataType )
+/// DataType ::= char ( value from IndexedIO::DataType, combined with the DataCompression codec and shuffle flag since version 6 )
 /// ArrayLength ::= int64 ( if DataType is array, then this tells how long they are )
 /// NodeID ::= int64 ( unique Id of this node in the file )
 /// ParentNodeID ::= int64 ( Id for the parent node )
 /// DataOffset ::= int64 ( this is offset where the data is located )
-/// DataSize ::= int64 ( number of bytes stored in the data section )
+/// DataSize ::= int64 ( number of bytes stored in the data section - after compression, if any )
 /// NodeCount ::= uint32 ( number of child nodes in the directory - stored right after this node leading to recursive definition of a tree )
 /// SubIndexOffset :: = int64 ( offset in the Data block where there's a zipped index that contains all the child nodes from this node - and possibly other nodes )
 
@@ -107,6 +139,9 @@ static const Imf::Int64 g_currentVersion = 5;
 /// FreePageOffset ::= int64
 /// FreePageSize ::= int64
 
+/// BlobStorePath ::= StringLength char* ( directory of the BlobStore used by the file, empty if none. Relative to
+/// the directory holding the file, unless the file wasn't written to disk, in which case it is absolute )
+
 /// IndexOffset ::= int64 ( offset in the file where the Index zipped block starts )
 /// Version ::= int64 (file format version)
 /// MagicNumber ::= int64
@@ -140,6 +175,192 @@ void readLittleEndian( F &f, T &n )
 	}
 }
 
+/// Splits a path into its components, resolving "." and ".." lexically.
+static std::vector<std::string> pathComponents( const std::string &path )
+{
+	std::vector<std::string> result;
+	typedef boost::tokenizer<boost::char_separator<char> > Tokenizer;
+	Tokenizer tokens( path, boost::char_separator<char>( "/" ) );
+	for ( Tokenizer::iterator it = tokens.begin(); it != tokens.end(); ++it )
+	{
+		if ( *it == "." )
+		{
+			continue;
+		}
+		if ( *it == ".." && result.size() )
+		{
+			result.pop_back();
+			continue;
+		}
+		result.push_back( *it );
+	}
+	return result;
+}
+
+/// Returns the absolute path expressed relative to the absolute base directory.
+static std::string relativePath( const std::string &path, const std::string &base )
+{
+	const std::vector<std::string> pathNames = pathComponents( path );
+	const std::vector<std::string> baseNames = pathComponents( base );
+
+	size_t common = 0;
+	while ( common < pathNames.size() && common < baseNames.size() && pathNames[common] == baseNames[common] )
+	{
+		common++;
+	}
+
+	std::string result;
+	for ( size_t i = common; i < baseNames.size(); i++ )
+	{
+		result += "../";
+	}
+	for ( size_t i = common; i < pathNames.size(); i++ )
+	{
+		result += pathNames[i] + "/";
+	}
+
+	if ( result.empty() )
+	{
+		return ".";
+	}
+	result.resize( result.size() - 1 );
+	return result;
+}
+
+//// Data compression //////
+
+// Rearranges the bytes of an array of elements so that the first byte of every element
+// comes first, followed by the second byte of every element and so on. This groups the
+// slowly varying sign and exponent bytes of floating point data together, which greatly
+// improves how well it compresses.
+static void shuffleBytes( const char *data, size_t size, size_t elementSize, char *result )
+{
+	const size_t numElements = size / elementSize;
+	for ( size_t b = 0; b < elementSize; ++b )
+	{
+		char *out = result + b * numElements;
+		const char *in = data + b;
+		for ( size_t i = 0; i < numElements; ++i, in += elementSize )
+		{
+			*out++ = *in;
+		}
+	}
+	// copy any trailing bytes which don't form a whole element
+	const size_t shuffledSize = numElements * elementSize;
+	std::copy( data + shuffledSize, data + size, result + shuffledSize );
+}
+
+// The inverse of shuffleBytes().
+static void unshuffleBytes( const char *data, size_t size, size_t elementSize, char *result )
+{
+	const size_t numElements = size / elementSize;
+	for ( size_t b = 0; b < elementSize; ++b )
+	{
+		const char *in = data + b * numElements;
+		char *out = result + b;
+		for ( size_t i = 0; i < numElements; ++i, out += elementSize )
+		{
+			*out = *in++;
+		}
+	}
+	const size_t shuffledSize = numElements * elementSize;
+	std::copy( data + shuffledSize, data + size, result + shuffledSize );
+}
+
+// Compresses the data using the specified codec, returning false if that didn't reduce its size,
+// in which case the data should be stored uncompressed.
+static bool compressData( const char *data, size_t size, size_t elementSize, StreamIndexedIO::DataCompression codec, bool shuffle, std::vector<char> &result )
+{
+	std::vector<char> shuffled;
+	if ( shuffle )
+	{
+		shuffled.resize( size );
+		shuffleBytes( data, size, elementSize, &shuffled[0] );
+		data = &shuffled[0];
+	}
+
+	result.clear();
+	result.reserve( size / 2 );
+
+	io::filtering_ostream compressingStream;
+	switch( codec )
+	{
+		case StreamIndexedIO::GzipCompression :
+			compressingStream.push( io::gzip_compressor() );
+			break;
+		case StreamIndexedIO::FastCompression :
+			compressingStream.push( io::zlib_compressor( io::zlib::best_speed ) );
+			break;
+		default :
+			throw Exception( "StreamIndexedIO: Invalid compression codec!" );
+	}
+	compressingStream.push( io::back_inserter( result ) );
+	assert( compressingStream.is_complete() );
+
+	compressingStream.write( data, size );
+
+	/// To synchronize/close, etc.
+	compressingStream.pop();
+	compressingStream.pop();
+
+	return result.size() < size;
+}
+
+static void decompressData( const char *data, size_t size, char *result, size_t resultSize, size_t elementSize, StreamIndexedIO::DataCompression codec, bool shuffled )
+{
+	io::filtering_istream decompressingStream;
+	switch( codec )
+	{
+		case StreamIndexedIO::GzipCompression :
+			decompressingStream.push( io::gzip_decompressor() );
+			break;
+		case StreamIndexedIO::FastCompression :
+			decompressingStream.push( io::zlib_decompressor() );
+			break;
+		default :
+			throw IOException( "StreamIndexedIO: Unknown compression codec!" );
+	}
+	decompressingStream.push( io::array_source( data, size ) );
+	assert( decompressingStream.is_complete() );
+
+	std::vector<char> shuffledData;
+	char *buffer = result;
+	if ( shuffled )
+	{
+		shuffledData.resize( resultSize );
+		buffer = &shuffledData[0];
+	}
+
+	decompressingStream.read( buffer, resultSize );
+	if ( (size_t)decompressingStream.gcount() != resultSize )
+	{
+		throw IOException( "StreamIndexedIO: Compressed data block is shorter than expected!" );
+	}
+
+	if ( shuffled )
+	{
+		unshuffleBytes( buffer, resultSize, elementSize, result );
+	}
+}
+
+//// Blob references //////
+
+static void encodeBlobReference( const MurmurHash &hash, Imf::Int64 size, unsigned char compression, char *result )
+{
+	const Imf::Int64 fields[3] = { asLittleEndian<Imf::Int64>( hash.h1() ), asLittleEndian<Imf::Int64>( hash.h2() ), asLittleEndian( size ) };
+	memcpy( result, fields, sizeof( fields ) );
+	result[ sizeof( fields ) ] = compression;
+}
+
+static void decodeBlobReference( const char *data, MurmurHash &hash, Imf::Int64 &size, unsigned char &compression )
+{
+	Imf::Int64 fields[3];
+	memcpy( fields, data, sizeof( fields ) );
+	hash = MurmurHash( asLittleEndian( fields[0] ), asLittleEndian( fields[1] ) );
+	size = asLittleEndian( fields[2] );
+	compression = data[ sizeof( fields ) ];
+}
+
 class StreamIndexedIO::StringCache
 {
 	public:
@@ -200,8 +421,10 @@ class StreamIndexedIO::StringCache
 			return it->second;
 		}
 
+		// Thread-safe, so that concurrent writers can add new strings.
 		Imf::Int64 find( const IndexedIO::EntryID &s, bool errIfNotFound = true )
 		{
+			Mutex::scoped_lock lock( m_mutex );
 			StringToIdMap::const_iterator it = m_stringToIdMap.find( s );
 
 			if ( it == m_stringToIdMap.end() )
@@ -289,6 +512,9 @@ class StreamIndexedIO::StringCache
 
 		mutable char *m_ioBuffer;
 		mutable unsigned long m_ioBufferLen;
+
+		typedef tbb::spin_mutex Mutex;
+		Mutex m_mutex;
 };
 
 /// NodeBase is a base class for nodes representing the index
@@ -347,12 +573,24 @@ class SmallDataNode : public NodeBase
 		static const size_t maxArrayLength = UINT16_MAX;
 		static const size_t maxSize = UINT32_MAX;
 		
-		SmallDataNode( IndexedIO::EntryID name, IndexedIO::DataType dataType, Imf::Int64 arrayLength, Imf::Int64 size, Imf::Int64 offset ) : 
+		SmallDataNode( IndexedIO::EntryID name, char dataType, Imf::Int64 arrayLength, Imf::Int64 size, Imf::Int64 offset ) : 
 			NodeBase(NodeBase::SmallData, name), m_dataType(dataType), m_arrayLength((Length)arrayLength), m_size((Size)size), m_offset(offset) {}
 
 		inline IndexedIO::DataType dataType() 
 		{
-			return static_cast<IndexedIO::DataType>(m_dataType);
+			return static_cast<IndexedIO::DataType>( m_dataType & DATATYPE_MASK );
+		}
+
+		/// returns the compression bits from the DataType field.
+		inline unsigned char compression()
+		{
+			return m_dataType & ~DATATYPE_MASK;
+		}
+
+		/// returns the DataType field as stored in the file.
+		inline char encodedDataType()
+		{
+			return m_dataType;
 		}
 
 		inline Imf::Int64 arrayLength()
@@ -372,7 +610,7 @@ class SmallDataNode : public NodeBase
 
 	protected :
 
-		/// data fields from IndexedIO::Entry
+		/// data fields from IndexedIO::Entry, combined with the compression bits
 		// using char instead of enum to compact members in one word
 		const char m_dataType;
 
@@ -393,10 +631,22 @@ class DataNode : public NodeBase
 		static const size_t maxArrayLength = UINT64_MAX;
 		static const size_t maxSize = UINT64_MAX;
 		
-		DataNode( IndexedIO::EntryID name, IndexedIO::DataType dataType, Imf::Int64 arrayLength, Imf::Int64 size, Imf::Int64 offset ) : 
+		DataNode( IndexedIO::EntryID name, char dataType, Imf::Int64 arrayLength, Imf::Int64 size, Imf::Int64 offset ) : 
 			NodeBase(NodeBase::Data, name), m_dataType(dataType), m_arrayLength(arrayLength), m_size(size), m_offset(offset) {}
 
 		inline IndexedIO::DataType dataType() 
+		{
+			return static_cast<IndexedIO::DataType>( m_dataType & DATATYPE_MASK );
+		}
+
+		/// returns the compression bits from the DataType field.
+		inline unsigned char compression()
+		{
+			return m_dataType & ~DATATYPE_MASK;
+		}
+
+		/// returns the DataType field as stored in the file.
+		inline char encodedDataType()
 		{
 			return m_dataType;
 		}
@@ -426,8 +676,8 @@ class DataNode : public NodeBase
 
 	protected :
 
-		/// data fields from IndexedIO::Entry
-		IndexedIO::DataType m_dataType;
+		/// data fields from IndexedIO::Entry, combined with the compression bits
+		char m_dataType;
 
 		/// data fields from IndexedIO::Entry
 		Imf::Int64 m_arrayLength;
@@ -580,9 +830,15 @@ class StreamIndexedIO::Node
 		DirectoryNode* directoryChild( const IndexedIO::EntryID &name ) const;
 		/// returns information about the Data node
 		inline bool dataChildInfo( const IndexedIO::EntryID &name, size_t &offset, size_t &size ) const;
+		inline bool dataChildInfo( const IndexedIO::EntryID &name, IndexedIO::DataType &dataType, unsigned char &compression, size_t &arrayLength, size_t &offset, size_t &size ) const;
 
 		DirectoryNode* addChild( const IndexedIO::EntryID & childName );
-		void addDataChild( const IndexedIO::EntryID & childName, IndexedIO::DataType dataType, size_t arrayLen, size_t offset, size_t size );
+		void addDataChild( const IndexedIO::EntryID & childName, IndexedIO::DataType dataType, size_t arrayLen, size_t offset, size_t size, unsigned char compression = 0 );
+		/// writes array data to the file, compressing it according to the Index settings, and adds the Data node.
+		void addArrayDataChild( const IndexedIO::EntryID & childName, IndexedIO::DataType dataType, size_t arrayLen, const char *data, size_t size, size_t elementSize );
+		/// reads array data from the file, decompressing it if necessary.
+		/// \param elementSize The size of each array element, as used when the data was compressed.
+		void readArrayData( const IndexedIO::EntryID & childName, char *buffer, size_t bufferSize, size_t elementSize ) const;
 
 		void removeChild( const IndexedIO::EntryID &childName, bool throwException = true );
 
@@ -606,8 +862,9 @@ class StreamIndexedIO::Index : public RefCounted
 
 		DirectoryNode *root() const;
 
-		/// Allocate a new chunk of data of the requested size, returning its offset within the file
-		Imf::Int64 allocate( Imf::Int64 sz );
+		/// Allocate a new chunk of data of the requested size, returning its offset within the file.
+		/// New chunks at the end of the file are padded to start at a multiple of alignment.
+		Imf::Int64 allocate( Imf::Int64 sz, size_t alignment = 1 );
 
 		/// Deallocate a Data node's data block from the file.
 		template< typename D >
@@ -621,9 +878,14 @@ class StreamIndexedIO::Index : public RefCounted
 		/// flushes index to the file
 		void flush();
 
+		/// Ensures that the file is written with at least the given version. This is
+		/// threadsafe, as data nodes may be added concurrently.
+		void requireVersion( Imf::Int64 version );
+
 		/// Returns the offset after saving the data to file or the offset for a previouly saved data (with matching hash)
 		/// \param prefixSize If true than it will prepend to the block, the size of it
-		Imf::Int64 writeUniqueData( const char *data, size_t size, bool prefixSize = false );
+		/// \param alignment Requested alignment for the data, so that arrays can be accessed in place from memory mapped files.
+		Imf::Int64 writeUniqueData( const char *data, size_t size, bool prefixSize = false, size_t alignment = 1 );
 
 		/// flushes the children of the given directory node to a subindex in the file
 		void commitNodeToSubIndex( DirectoryNode *n );
@@ -631,6 +893,17 @@ class StreamIndexedIO::Index : public RefCounted
 		/// read the subindex that contains the children of the given node
 		void readNodeFromSubIndex( DirectoryNode *n );
 
+		/// compression applied to array data blocks written from now on.
+		StreamIndexedIO::DataCompression m_dataCompression;
+		bool m_dataShuffle;
+
+		/// store holding the large array data blocks, if any, and the size from which blocks go there.
+		BlobStorePtr m_blobStore;
+		size_t m_blobStoreMinSize;
+
+		/// Reads the BlobReference stored at the given offset, throwing if the file has no BlobStore.
+		void readBlobReference( Imf::Int64 offset, size_t size, MurmurHash &hash, Imf::Int64 &blobSize, unsigned char &compression ) const;
+
 		typedef tbb::spin_rw_mutex Mutex;
 		typedef Mutex::scoped_lock MutexLock;
 		/// Returns an appropriate mutex scoped lock to access the given Directory node.
@@ -651,7 +924,12 @@ class StreamIndexedIO::Index : public RefCounted
 
 		Imf::Int64 m_version;
 
-		bool m_hasChanged;
+		/// The version written to the file, raised by requireVersion() as entries
+		/// needing newer versions are added.
+		tbb::atomic<Imf::Int64> m_writeVersion;
+
+		// set by concurrent writers
+		tbb::atomic<bool> m_hasChanged;
 
 		Imf::Int64 m_offset;
 		Imf::Int64 m_next;
@@ -916,6 +1194,14 @@ DirectoryNode* StreamIndexedIO::Node::directoryChild( const IndexedIO::EntryID &
 }
 
 bool StreamIndexedIO::Node::dataChildInfo( const IndexedIO::EntryID &name, size_t &offset, size_t &size ) const
+{
+	IndexedIO::DataType dataType;
+	unsigned char compression;
+	size_t arrayLength;
+	return dataChildInfo( name, dataType, compression, arrayLength, offset, size );
+}
+
+bool StreamIndexedIO::Node::dataChildInfo( const IndexedIO::EntryID &name, IndexedIO::DataType &dataType, unsigned char &compression, size_t &arrayLength, size_t &offset, size_t &size ) const
 {
 	Index::MutexLock lock;
 	m_idx->lockDirectory( lock, m_node );
@@ -928,6 +1214,9 @@ bool StreamIndexedIO::Node::dataChildInfo( const IndexedIO::EntryID &name, size_
 		if ( p->nodeType() == NodeBase::Data )
 		{
 			DataNode *n = static_cast< DataNode *>( p );
+			dataType = n->dataType();
+			compression = n->compression();
+			arrayLength = n->arrayLength();
 			offset = n->offset();
 			size = n->size();
 			return true;
@@ -935,6 +1224,9 @@ bool StreamIndexedIO::Node::dataChildInfo( const IndexedIO::EntryID &name, size_
 		else if ( p->nodeType() == NodeBase::SmallData )
 		{
 			SmallDataNode *n = static_cast< SmallDataNode *>( p );
+			dataType = n->dataType();
+			compression = n->compression();
+			arrayLength = n->arrayLength();
 			offset = n->offset();
 			size = n->size();
 			return true;
@@ -945,12 +1237,15 @@ bool StreamIndexedIO::Node::dataChildInfo( const IndexedIO::EntryID &name, size_
 
 DirectoryNode* StreamIndexedIO::Node::addChild( const IndexedIO::EntryID &childName )
 {
+	Index::MutexLock lock;
+	m_idx->lockDirectory( lock, m_node, true );
+
 	if ( m_node->subindex() )
 	{
 		throw Exception( "Cannot modify the file at current location! It was already committed to the file." );
 	}
 
-	if ( hasChild(childName) )
+	if ( m_node->findChild( childName ) != m_node->children().end() )
 	{
 		return 0;
 	}
@@ -969,23 +1264,33 @@ DirectoryNode* StreamIndexedIO::Node::addChild( const IndexedIO::EntryID &childN
 	return child;
 }
 
-void StreamIndexedIO::Node::addDataChild( const IndexedIO::EntryID &childName, IndexedIO::DataType dataType, size_t arrayLen, size_t offset, size_t size )
+void StreamIndexedIO::Node::addDataChild( const IndexedIO::EntryID &childName, IndexedIO::DataType dataType, size_t arrayLen, size_t offset, size_t size, unsigned char compression )
 {
+	Index::MutexLock lock;
+	m_idx->lockDirectory( lock, m_node, true );
+
 	if ( m_node->subindex() )
 	{
 		throw Exception( "Cannot modify the file at current location! It was already committed to the file." );
 	}
 
-	if ( hasChild(childName) )
+	if ( m_node->findChild( childName ) != m_node->children().end() )
 	{
 		throw IOException( "StreamIndexedIO: Could not insert node '" + childName.value() + "' into index" );
 	}
 
 	m_idx->m_stringCache.add( childName );
 
+	if ( compression )
+	{
+		m_idx->requireVersion( ( compression & COMPRESSION_MASK ) == BLOB_REFERENCE ? 7 : 6 );
+	}
+
+	char encodedDataType = (char)( dataType | compression );
+
 	if ( arrayLen <= SmallDataNode::maxArrayLength && size <= SmallDataNode::maxSize )
 	{
-		SmallDataNode* child = new SmallDataNode(childName, dataType, arrayLen, size, offset);
+		SmallDataNode* child = new SmallDataNode(childName, encodedDataType, arrayLen, size, offset);
 		if ( !child )
 		{
 			throw Exception( "Failed to allocate node!" );
@@ -994,7 +1299,7 @@ void StreamIndexedIO::Node::addDataChild( const IndexedIO::EntryID &childName, I
 	}
 	else
 	{
-		DataNode* child = new DataNode(childName, dataType, arrayLen, size, offset);
+		DataNode* child = new DataNode(childName, encodedDataType, arrayLen, size, offset);
 		if ( !child )
 		{
 			throw Exception( "Failed to allocate node!" );
@@ -1004,6 +1309,87 @@ void StreamIndexedIO::Node::addDataChild( const IndexedIO::EntryID &childName, I
 	m_idx->m_hasChanged = true;
 }
 
+void StreamIndexedIO::Node::addArrayDataChild( const IndexedIO::EntryID &childName, IndexedIO::DataType dataType, size_t arrayLen, const char *data, size_t size, size_t elementSize )
+{
+	const char *block = data;
+	size_t blockSize = size;
+	unsigned char compression = 0;
+	std::vector<char> compressed;
+
+	StreamIndexedIO::DataCompression codec = m_idx->m_dataCompression;
+	if ( codec != StreamIndexedIO::Uncompressed && size >= g_minCompressedSize )
+	{
+		bool shuffle = m_idx->m_dataShuffle && elementSize > 1;
+		if ( compressData( data, size, elementSize, codec, shuffle, compressed ) )
+		{
+			compression = ( codec << COMPRESSION_SHIFT ) | ( shuffle ? SHUFFLE_FLAG : 0 );
+			block = &compressed[0];
+			blockSize = compressed.size();
+		}
+	}
+
+	if ( m_idx->m_blobStore && blockSize >= m_idx->m_blobStoreMinSize )
+	{
+		// the block goes to the shared store, and the file only keeps a reference to it
+		MurmurHash hash = m_idx->m_blobStore->write( block, blockSize );
+		char reference[ g_blobReferenceSize ];
+		encodeBlobReference( hash, blockSize, compression, reference );
+		Imf::Int64 offset = m_idx->writeUniqueData( reference, g_blobReferenceSize );
+		addDataChild( childName, dataType, arrayLen, offset, g_blobReferenceSize, BLOB_REFERENCE );
+		return;
+	}
+
+	Imf::Int64 offset = m_idx->writeUniqueData( block, blockSize, false, compression ? 1 : elementSize );
+	addDataChild( childName, dataType, arrayLen, offset, blockSize, compression );
+}
+
+void StreamIndexedIO::Node::readArrayData( const IndexedIO::EntryID &childName, char *buffer, size_t bufferSize, size_t elementSize ) const
+{
+	IndexedIO::DataType dataType;
+	unsigned char compression(0);
+	size_t arrayLength(0), dataOffset(0), dataSize(0);
+
+	if ( !dataChildInfo( childName, dataType, compression, arrayLength, dataOffset, dataSize ) )
+	{
+		throw IOException( "StreamIndexedIO::read: Data entry not found '" + childName.value() + "'" );
+	}
+
+	if ( ( compression & COMPRESSION_MASK ) == BLOB_REFERENCE )
+	{
+		MurmurHash hash;
+		Imf::Int64 blobSize;
+		m_idx->readBlobReference( dataOffset, dataSize, hash, blobSize, compression );
+		const BlobStore *store = m_idx->m_blobStore.get();
+		if ( !compression )
+		{
+			store->read( hash, buffer, bufferSize );
+			return;
+		}
+
+		std::vector<char> compressed( blobSize );
+		store->read( hash, &compressed[0], blobSize );
+		StreamIndexedIO::DataCompression codec = (StreamIndexedIO::DataCompression)( ( compression & COMPRESSION_MASK ) >> COMPRESSION_SHIFT );
+		decompressData( &compressed[0], blobSize, buffer, bufferSize, elementSize, codec, compression & SHUFFLE_FLAG );
+		return;
+	}
+
+	if ( !compression )
+	{
+		if ( dataSize > bufferSize )
+		{
+			throw IOException( "StreamIndexedIO::read: Data entry '" + childName.value() + "' is larger than expected" );
+		}
+		m_idx->streamFile().readAt( buffer, dataSize, dataOffset );
+		return;
+	}
+
+	std::vector<char> compressed( dataSize );
+	m_idx->streamFile().readAt( &compressed[0], dataSize, dataOffset );
+
+	StreamIndexedIO::DataCompression codec = (StreamIndexedIO::DataCompression)( ( compression & COMPRESSION_MASK ) >> COMPRESSION_SHIFT );
+	decompressData( &compressed[0], dataSize, buffer, bufferSize, elementSize, codec, compression & SHUFFLE_FLAG );
+}
+
 const IndexedIO::EntryID &StreamIndexedIO::Node::name() const
 {
 	return m_node->name();
@@ -1046,6 +1432,9 @@ void StreamIndexedIO::Node::childNames( IndexedIO::EntryIDList &names, IndexedIO
 
 void StreamIndexedIO::Node::removeChild( const IndexedIO::EntryID &childName, bool throwException )
 {
+	Index::MutexLock lock;
+	m_idx->lockDirectory( lock, m_node, true );
+
 	DirectoryNode::ChildMap::iterator it = m_node->findChild( childName );
 	if ( it == m_node->children().end() )
 	{
@@ -1058,9 +1447,13 @@ void StreamIndexedIO::Node::removeChild( const IndexedIO::EntryID &childName, bo
 
 	NodeBase *child = *it;
 
-	m_idx->deallocateWalk(child);
-
 	m_node->children().erase( it );
+
+	// the directory lock is never held while acquiring the file lock
+	lock.release();
+
+	StreamFile::MutexLock fileLock( m_idx->streamFile().mutex() );
+	m_idx->deallocateWalk(child);
 }
 
 ///////////////////////////////////////////////
@@ -1075,8 +1468,10 @@ void StreamIndexedIO::Node::removeChild( const IndexedIO::EntryID &childName, bo
 //
 ///////////////////////////////////////////////
 
-StreamIndexedIO::Index::Index( StreamIndexedIO::StreamFilePtr stream ) : m_root(0), m_version(g_currentVersion), m_hasChanged(false), m_offset(0), m_next(0), m_stream(stream)
+StreamIndexedIO::Index::Index( StreamIndexedIO::StreamFilePtr stream ) : m_dataCompression(StreamIndexedIO::Uncompressed), m_dataShuffle(true), m_blobStoreMinSize(0), m_root(0), m_version(g_currentVersion), m_offset(0), m_next(0), m_stream(stream)
 {
+	m_hasChanged = false;
+	m_writeVersion = g_minimumWriteVersion;
 	m_stringCache.add(IndexedIO::rootName);
 }
 
@@ -1113,6 +1508,20 @@ void StreamIndexedIO::Index::flush()
 	}
 }
 
+void StreamIndexedIO::Index::requireVersion( Imf::Int64 version )
+{
+	Imf::Int64 current = m_writeVersion;
+	while ( current < version )
+	{
+		const Imf::Int64 previous = m_writeVersion.compare_and_swap( version, current );
+		if ( previous == current )
+		{
+			return;
+		}
+		current = previous;
+	}
+}
+
 void StreamIndexedIO::Index::openStream()
 {
 	if ( m_stream->openMode() & (IndexedIO::Append|IndexedIO::Read) )
@@ -1147,6 +1556,10 @@ void StreamIndexedIO::Index::openStream()
 			throw IOException("Not a StreamIndexedIO file");
 		}
 
+		// existing entries may use features of the file's version, so
+		// we mustn't write an older one when appending.
+		requireVersion( m_version );
+
 		f.seekg( m_offset, std::ios::beg );
 
 		if (m_version >= 2 )
@@ -1334,10 +1747,9 @@ NodeBase *StreamIndexedIO::Index::readNode( F &f )
 	if ( entryType == IndexedIO::File )
 	{
 		char t;
-		IndexedIO::DataType dataType = IndexedIO::Invalid;
 		Imf::Int64 arrayLength = 0;
 		f.read( &t, sizeof(char) );
-		dataType = (IndexedIO::DataType)t;
+		IndexedIO::DataType dataType = (IndexedIO::DataType)( t & DATATYPE_MASK );
 	
 		if ( IndexedIO::Entry::isArray( dataType ) )
 		{
@@ -1348,14 +1760,15 @@ NodeBase *StreamIndexedIO::Index::readNode( F &f )
 		readLittleEndian( f, offset );
 		readLittleEndian( f, size );
 
+		// t includes the compression bits, which are stored in the node along with the type
 		if ( arrayLength <= SmallDataNode::maxArrayLength && size <= SmallDataNode::maxSize )
 		{
-			SmallDataNode *n = new SmallDataNode( m_stringCache.findById( stringId ), dataType, arrayLength, size, offset );
+			SmallDataNode *n = new SmallDataNode( m_stringCache.findById( stringId ), t, arrayLength, size, offset );
 			return n;
 		}
 		else
 		{
-			DataNode *n = new DataNode( m_stringCache.findById( stringId ), dataType, arrayLength, size, offset );
+			DataNode *n = new DataNode( m_stringCache.findById( stringId ), t, arrayLength, size, offset );
 			return n;
 		}
 	}
@@ -1486,6 +1899,23 @@ void StreamIndexedIO::Index::read( F &f )
 
 		addFreePage( offset, sz );
 	}
+
+	if ( m_version >= 7 )
+	{
+		Imf::Int64 pathLength;
+		readLittleEndian( f, pathLength );
+		if ( pathLength )
+		{
+			std::string path( pathLength, '\0' );
+			f.read( &path[0], pathLength );
+			const std::string directory = m_stream->directory();
+			if ( path[0] != '/' && directory.size() )
+			{
+				path = directory + "/" + path;
+			}
+			m_blobStore = BlobStore::open( path );
+		}
+	}
 }
 
 template < typename F, typename D >
@@ -1497,7 +1927,7 @@ void StreamIndexedIO::Index::writeDataNode( D *node, F &f )
 	Imf::Int64 id = m_stringCache.find( node->name() );
 	writeLittleEndian( f, id );
 
-	t = node->dataType();
+	t = node->encodedDataType();
 	f.write( &t, sizeof(char) );
 
 	if ( IndexedIO::Entry::isArray(node->dataType()) )
@@ -1615,6 +2045,24 @@ Imf::Int64 StreamIndexedIO::Index::write()
 		writeLittleEndian( compressingStream, it->second->m_size );
 	}
 
+	const Imf::Int64 version = m_writeVersion;
+	if ( version >= 7 )
+	{
+		std::string blobStorePath;
+		if ( m_blobStore )
+		{
+			// stored relative to the file, so the file and the store can be moved together
+			blobStorePath = m_blobStore->directory();
+			const std::string directory = m_stream->directory();
+			if ( directory.size() )
+			{
+				blobStorePath = relativePath( blobStorePath, directory );
+			}
+		}
+		writeLittleEndian<io::filtering_ostream, Imf::Int64>( compressingStream, blobStorePath.size() );
+		compressingStream.write( blobStorePath.c_str(), blobStorePath.size() );
+	}
+
 	/// To synchronize/close, etc.
 	compressingStream.pop();
 	compressingStream.pop();
@@ -1628,7 +2076,7 @@ Imf::Int64 StreamIndexedIO::Index::write()
 	f.write( data, sz );
 
 	writeLittleEndian( f, m_offset );
-	writeLittleEndian( f, g_currentVersion );
+	writeLittleEndian( f, version );
 	writeLittleEndian( f, g_versionedMagicNumber );
 
 	m_hasChanged = false;
@@ -1636,7 +2084,7 @@ Imf::Int64 StreamIndexedIO::Index::write()
 	return f.tellp();
 }
 
-Imf::Int64 StreamIndexedIO::Index::allocate( Imf::Int64 sz )
+Imf::Int64 StreamIndexedIO::Index::allocate( Imf::Int64 sz, size_t alignment )
 {
 	Imf::Int64 loc = 0;
 
@@ -1692,10 +2140,11 @@ Imf::Int64 StreamIndexedIO::Index::allocate( Imf::Int64 sz )
 	}
 	else
 	{
-		loc = m_next;
+		/// the padding isn't tracked as a free page - it's at most a few bytes.
+		loc = ( ( m_next + alignment - 1 ) / alignment ) * alignment;
 
 		/// update next location
-		m_next += sz;
+		m_next = loc + sz;
 	}
 
 	return loc;
@@ -1830,14 +2279,12 @@ void StreamIndexedIO::Index::addFreePage(  Imf::Int64 offset, Imf::Int64 sz )
 	assert( m_freePagesOffset.size() == m_freePagesSize.size() );
 }
 
-Imf::Int64 StreamIndexedIO::Index::writeUniqueData( const char *data, size_t size, bool prefixSize )
+Imf::Int64 StreamIndexedIO::Index::writeUniqueData( const char *data, size_t size, bool prefixSize, size_t alignment )
 {
-	m_hasChanged = true;
-
 	/// Find next writable location
 	Imf::Int64 loc;
 
-	// compute hash for the data
+	// compute hash for the data, before locking so concurrent writers can hash in parallel.
 	MurmurHash hash;
 	hash.append( data, size );
 
@@ -1853,6 +2300,10 @@ Imf::Int64 StreamIndexedIO::Index::writeUniqueData( const char *data, size_t siz
 		totalSize += sizeof( clampedSize );
 	}
 
+	// only the offset allocation and the actual writing are serialised.
+	StreamFile::MutexLock lock( m_stream->mutex() );
+	m_hasChanged = true;
+
 	// see if it's already stored by another node..
 	std::pair< HashToDataMap::iterator,bool > ret = m_hashToDataMap.insert( HashToDataMap::value_type( std::pair< MurmurHash,Imf::Int64>(hash,totalSize), 0 ) );
 	if ( !ret.second )
@@ -1862,7 +2313,7 @@ Imf::Int64 StreamIndexedIO::Index::writeUniqueData( const char *data, size_t siz
 	}
 
 	/// New data, find next writable location.
-	loc = allocate( totalSize );
+	loc = allocate( totalSize, prefixSize ? 1 : alignment );
 	ret.first->second = loc;
 
 	/// Seek 'write' pointer to writable location
@@ -1879,6 +2330,21 @@ Imf::Int64 StreamIndexedIO::Index::writeUniqueData( const char *data, size_t siz
 	return loc;
 }
 
+void StreamIndexedIO::Index::readBlobReference( Imf::Int64 offset, size_t size, MurmurHash &hash, Imf::Int64 &blobSize, unsigned char &compression ) const
+{
+	if ( !m_blobStore )
+	{
+		throw IOException( "StreamIndexedIO: Data entry refers to a BlobStore, but the file doesn't have one!" );
+	}
+	if ( size != g_blobReferenceSize )
+	{
+		throw IOException( "StreamIndexedIO: Corrupted BlobStore reference!" );
+	}
+	char reference[ g_blobReferenceSize ];
+	m_stream->readAt( reference, g_blobReferenceSize, offset );
+	decodeBlobReference( reference, hash, blobSize, compression );
+}
+
 void StreamIndexedIO::Index::deallocateWalk( NodeBase* n )
 {
 	assert(n);
@@ -1975,14 +2441,22 @@ void StreamIndexedIO::Index::readNodeFromSubIndex( DirectoryNode *n )
 
 void StreamIndexedIO::Index::lockDirectory( MutexLock &lock, const DirectoryNode *n, bool writeAccess ) const
 {
-	if ( n->subindexChildren() )
+	if ( m_stream->openMode() & ( IndexedIO::Write | IndexedIO::Append ) )
 	{
-		// choose one of the mutexes from the pool (in a deterministic way)
-		size_t v = (size_t)n / sizeof(DirectoryNode*);
-		unsigned int m = ( (v + 1) / 3 ) % MAX_MUTEXES;
-
-		lock.acquire( m_mutexes[ m ], writeAccess );
+		// Directories may be modified concurrently by several writers, and even lookups may sort
+		// the children, so we always take exclusive access.
+		writeAccess = true;
 	}
+	else if ( !n->subindexChildren() )
+	{
+		return;
+	}
+
+	// choose one of the mutexes from the pool (in a deterministic way)
+	size_t v = (size_t)n / sizeof(DirectoryNode*);
+	unsigned int m = ( (v + 1) / 3 ) % MAX_MUTEXES;
+
+	lock.acquire( m_mutexes[ m ], writeAccess );
 }
 
 ///////////////////////////////////////////////
@@ -2019,6 +2493,11 @@ IndexedIO::OpenMode StreamIndexedIO::StreamFile::openMode() const
 	return m_openmode;
 }
 
+std::string StreamIndexedIO::StreamFile::directory() const
+{
+	return "";
+}
+
 void StreamIndexedIO::StreamFile::setStream( std::iostream *stream, bool emptyFile )
 {
 	m_stream = stream;
@@ -2110,6 +2589,18 @@ void StreamIndexedIO::StreamFile::write( const char *buffer, size_t size )
 	m_stream->write( buffer, size );
 }
 
+void StreamIndexedIO::StreamFile::readAt( char *buffer, size_t size, Imf::Int64 pos )
+{
+	MutexLock lock( m_mutex );
+	m_stream->seekg( pos, std::ios::beg );
+	m_stream->read( buffer, size );
+}
+
+const char *StreamIndexedIO::StreamFile::mappedData( Imf::Int64 pos, size_t size ) const
+{
+	return 0;
+}
+
 ///////////////////////////////////////////////
 //
 // StreamIndexedIO::StreamFile (end)
@@ -2249,6 +2740,11 @@ IndexedIOPtr StreamIndexedIO::subdirectory( const IndexedIO::EntryID &name, Inde
 			writable( name );
 			childNode = m_node->addChild( name );
 			if ( !childNode )
+			{
+				// another thread may have created it in the meantime
+				childNode = m_node->directoryChild( name );
+			}
+			if ( !childNode )
 			{
 				throw IOException( "StreamIndexedIO: Could not insert child '" + name.value() + "'" );
 			}
@@ -2419,7 +2915,12 @@ IndexedIOPtr StreamIndexedIO::directory( const IndexedIO::EntryIDList &path, Ind
 			{
 				writable( name );
 				childNode = newNode->addChild( name );
-				if ( !childNode )	
+				if ( !childNode )
+				{
+					// another thread may have created it in the meantime
+					childNode = newNode->directoryChild( name );
+				}
+				if ( !childNode )
 				{
 					throw IOException( "StreamIndexedIO: Could not insert child '" + name.value() + "'" );
 				}
@@ -2448,6 +2949,37 @@ void StreamIndexedIO::commit()
 	m_node->m_idx->commitNodeToSubIndex( m_node->m_node );
 }
 
+void StreamIndexedIO::setDataCompression( DataCompression compression, bool shuffle )
+{
+	if ( compression != Uncompressed && compression != GzipCompression && compression != FastCompression )
+	{
+		throw InvalidArgumentException( "StreamIndexedIO::setDataCompression: Invalid compression" );
+	}
+	m_node->m_idx->m_dataCompression = compression;
+	m_node->m_idx->m_dataShuffle = shuffle;
+}
+
+StreamIndexedIO::DataCompression StreamIndexedIO::getDataCompression() const
+{
+	return m_node->m_idx->m_dataCompression;
+}
+
+void StreamIndexedIO::setBlobStore( BlobStorePtr store, size_t minSize )
+{
+	Index *index = m_node->m_idx.get();
+	if ( index->m_blobStore && index->m_blobStore != store )
+	{
+		throw InvalidArgumentException( "StreamIndexedIO::setBlobStore: The file already refers to the BlobStore in \"" + index->m_blobStore->directory() + "\"" );
+	}
+	index->m_blobStore = store;
+	index->m_blobStoreMinSize = minSize;
+}
+
+BlobStore *StreamIndexedIO::getBlobStore() const
+{
+	return m_node->m_idx->m_blobStore.get();
+}
+
 void StreamIndexedIO::write(const IndexedIO::EntryID &name, const InternedString *x, unsigned long arrayLength)
 {
 	writable(name);
@@ -2458,8 +2990,9 @@ void StreamIndexedIO::write(const IndexedIO::EntryID &name, const InternedString
 	unsigned long size = IndexedIO::DataSizeTraits<Imf::Int64 *>::size(constIds, arrayLength);
 	IndexedIO::DataType dataType = IndexedIO::InternedStringArray;
 
-	char *data = streamFile().ioBuffer(size);
-	assert(data);
+	// a local buffer rather than StreamFile::ioBuffer(), so that concurrent writes are possible.
+	std::vector<char> buffer( size );
+	char *data = size ? &buffer[0] : 0;
 
 	Index *index = m_node->m_idx.get();
 
@@ -2494,19 +3027,14 @@ void StreamIndexedIO::read(const IndexedIO::EntryID &name, InternedString *&x, u
 	Imf::Int64 *ids = new Imf::Int64[arrayLength];
 
 	StreamIndexedIO::StreamFile &f = streamFile();
-	{
-		StreamFile::MutexLock lock( f.mutex() );
-		f.seekg( dataOffset, std::ios::beg );
 
 #ifdef IE_CORE_LITTLE_ENDIAN
-		// raw read
-		f.read( (char*)ids, dataSize );
-	}
+	// raw read
+	f.readAt( (char*)ids, dataSize, dataOffset );
 #else
-		char *data = f.ioBuffer(dataSize);
-		f.read( data, dataSize );
-	}
-	IndexedIO::DataFlattenTraits<Imf::Int64*>::unflatten( data, ids, arrayLength );
+	std::vector<char> data( dataSize );
+	f.readAt( &data[0], dataSize, dataOffset );
+	IndexedIO::DataFlattenTraits<Imf::Int64*>::unflatten( &data[0], ids, arrayLength );
 #endif
 
 	const StringCache &stringCache = m_node->m_idx->stringCache();
@@ -2531,13 +3059,20 @@ void StreamIndexedIO::write(const IndexedIO::EntryID &name, const T *x, unsigned
 	unsigned long size = IndexedIO::DataSizeTraits<T*>::size(x, arrayLength);
 	IndexedIO::DataType dataType = IndexedIO::DataTypeTraits<T*>::type();
 
-	char *data = streamFile().ioBuffer(size);
-	assert(data);
+	// a local buffer rather than StreamFile::ioBuffer(), so that concurrent writes are possible.
+	std::vector<char> buffer( size );
+	char *data = size ? &buffer[0] : 0;
 	IndexedIO::DataFlattenTraits<T*>::flatten(x, arrayLength, data);
 
-	Imf::Int64 offset = m_node->m_idx->writeUniqueData( data, size );
-
-	m_node->addDataChild( name, dataType, arrayLength, offset, size );
+	if ( dataType == IndexedIO::StringArray )
+	{
+		Imf::Int64 offset = m_node->m_idx->writeUniqueData( data, size );
+		m_node->addDataChild( name, dataType, arrayLength, offset, size );
+	}
+	else
+	{
+		m_node->addArrayDataChild( name, dataType, arrayLength, data, size, sizeof(T) );
+	}
 }
 
 template<typename T>
@@ -2549,9 +3084,7 @@ void StreamIndexedIO::rawWrite(const IndexedIO::EntryID &name, const T *x, unsig
 	unsigned long size = IndexedIO::DataSizeTraits<T*>::size(x, arrayLength);
 	IndexedIO::DataType dataType = IndexedIO::DataTypeTraits<T*>::type();
 
-	Imf::Int64 offset =  m_node->m_idx->writeUniqueData( (char*)x, size );
-
-	m_node->addDataChild( name, dataType, arrayLength, offset, size );
+	m_node->addArrayDataChild( name, dataType, arrayLength, (const char*)x, size, sizeof(T) );
 }
 
 template<typename T>
@@ -2563,8 +3096,8 @@ void StreamIndexedIO::write(const IndexedIO::EntryID &name, const T &x)
 	unsigned long size = IndexedIO::DataSizeTraits<T>::size(x);
 	IndexedIO::DataType dataType = IndexedIO::DataTypeTraits<T>::type();
 
-	char *data = streamFile().ioBuffer(size);
-	assert(data);
+	std::vector<char> buffer( size );
+	char *data = size ? &buffer[0] : 0;
 	IndexedIO::DataFlattenTraits<T>::flatten(x, data);
 
 	Imf::Int64 offset =  m_node->m_idx->writeUniqueData( data, size );
@@ -2599,14 +3132,20 @@ void StreamIndexedIO::read(const IndexedIO::EntryID &name, T *&x, unsigned long
 		throw IOException( "StreamIndexedIO::read: Data entry not found '" + name.value() + "'" );
 	}
 
-	StreamIndexedIO::StreamFile &f = streamFile();
+	// we use a local buffer rather than StreamFile::ioBuffer() so that
+	// concurrent reads don't need to hold the file mutex.
+	if ( IndexedIO::DataTypeTraits<T*>::type() != IndexedIO::StringArray )
 	{
-		StreamFile::MutexLock lock( f.mutex() );
-		char *data = f.ioBuffer(dataSize);
-		f.seekg( dataOffset, std::ios::beg );
-		f.read( data, dataSize );
-		IndexedIO::DataFlattenTraits<T*>::unflatten( data, x, arrayLength );
+		// numeric arrays may have been compressed, so we size the buffer
+		// by the uncompressed size of the flattened data.
+		dataSize = arrayLength * sizeof( T );
 	}
+	std::vector<char> data( dataSize );
+	if ( dataSize )
+	{
+		m_node->readArrayData( name, &data[0], dataSize, sizeof( T ) );
+	}
+	IndexedIO::DataFlattenTraits<T*>::unflatten( dataSize ? &data[0] : 0, x, arrayLength );
 }
 
 template<typename T>
@@ -2627,12 +3166,7 @@ void StreamIndexedIO::rawRead(const IndexedIO::EntryID &name, T *&x, unsigned lo
 		x = new T[arrayLength];
 	}
 
-	StreamIndexedIO::StreamFile &f = streamFile();
-	{
-		StreamFile::MutexLock lock( f.mutex() );
-		f.seekg( dataOffset, std::ios::beg );
-		f.read( (char*)x, dataSize );
-	}
+	m_node->readArrayData( name, (char*)x, arrayLength * sizeof( T ), sizeof( T ) );
 }
 
 template<typename T>
@@ -2648,14 +3182,12 @@ void StreamIndexedIO::read(const IndexedIO::EntryID &name, T &x) const
 		throw IOException( "StreamIndexedIO::read Data entry not found '" + name.value() + "'" );
 	}
 
-	StreamIndexedIO::StreamFile &f = streamFile();
+	std::vector<char> data( dataSize );
+	if ( dataSize )
 	{
-		StreamFile::MutexLock lock( f.mutex() );
-		char *data = f.ioBuffer(dataSize);
-		f.seekg( dataOffset, std::ios::beg );
-		f.read( data, dataSize );
-		IndexedIO::DataFlattenTraits<T>::unflatten( data, x );
+		streamFile().readAt( &data[0], dataSize, dataOffset );
 	}
+	IndexedIO::DataFlattenTraits<T>::unflatten( dataSize ? &data[0] : 0, x );
 }
 
 template<typename T>
@@ -2671,14 +3203,85 @@ void StreamIndexedIO::rawRead(const IndexedIO::EntryID &name, T &x) const
 		throw IOException( "StreamIndexedIO::rawRead: Data entry not found '" + name.value() + "'" );
 	}
 
-	StreamIndexedIO::StreamFile &f = streamFile();
+	streamFile().readAt( (char*)&x, dataSize, dataOffset );
+}
+
+template<typename T>
+typename MappedVectorData<T>::Ptr StreamIndexedIO::readMapped( const IndexedIO::EntryID &name ) const
+{
+	assert( m_node );
+	readable(name);
+
+	IndexedIO::DataType dataType;
+	unsigned char compression(0);
+	size_t arrayLength(0), dataOffset(0), dataSize(0);
+
+	if ( !m_node->dataChildInfo( name, dataType, compression, arrayLength, dataOffset, dataSize ) )
+	{
+		throw IOException( "StreamIndexedIO::readMapped: Data entry not found '" + name.value() + "'" );
+	}
+
+	if ( dataType != IndexedIO::DataTypeTraits<T*>::type() )
+	{
+		throw IOException( "StreamIndexedIO::readMapped: Entry '" + name.value() + "' has incompatible type" );
+	}
+
+#ifdef IE_CORE_LITTLE_ENDIAN
+
+	if ( ( compression & COMPRESSION_MASK ) == BLOB_REFERENCE )
+	{
+		// uncompressed blobs can be used in place from the mapping of the BlobStore's pack,
+		// which is shared by all the files using the store.
+		MurmurHash hash;
+		Imf::Int64 blobSize;
+		m_node->m_idx->readBlobReference( dataOffset, dataSize, hash, blobSize, compression );
+		if ( compression || (size_t)blobSize != arrayLength * sizeof( T ) )
+		{
+			return 0;
+		}
+		ConstRefCountedPtr owner;
+		const char *data = m_node->m_idx->m_blobStore->mappedData( hash, owner );
+		if ( !data || ( (size_t)data % boost::alignment_of<T>::value ) )
+		{
+			return 0;
+		}
+		return new MappedVectorData<T>( reinterpret_cast<const T *>( data ), arrayLength, owner );
+	}
+
+	if ( compression || dataSize != arrayLength * sizeof( T ) )
+	{
+		return 0;
+	}
+
+	StreamFile &f = streamFile();
+	const char *data = f.mappedData( dataOffset, dataSize );
+	if ( !data || ( (size_t)data % boost::alignment_of<T>::value ) )
 	{
-		StreamFile::MutexLock lock( f.mutex() );
-		f.seekg( dataOffset, std::ios::beg );
-		f.read( (char*)&x, dataSize );
+		return 0;
 	}
+
+	return new MappedVectorData<T>( reinterpret_cast<const T *>( data ), arrayLength, &f );
+
+#else
+
+	// data is stored little endian, so can't be used in place
+	return 0;
+
+#endif
 }
 
+template MappedVectorData<float>::Ptr StreamIndexedIO::readMapped<float>( const IndexedIO::EntryID &name ) const;
+template MappedVectorData<double>::Ptr StreamIndexedIO::readMapped<double>( const IndexedIO::EntryID &name ) const;
+template MappedVectorData<half>::Ptr StreamIndexedIO::readMapped<half>( const IndexedIO::EntryID &name ) const;
+template MappedVectorData<int>::Ptr StreamIndexedIO::readMapped<int>( const IndexedIO::EntryID &name ) const;
+template MappedVectorData<int64_t>::Ptr StreamIndexedIO::readMapped<int64_t>( const IndexedIO::EntryID &name ) const;
+template MappedVectorData<uint64_t>::Ptr StreamIndexedIO::readMapped<uint64_t>( const IndexedIO::EntryID &name ) const;
+template MappedVectorData<unsigned int>::Ptr StreamIndexedIO::readMapped<unsigned int>( const IndexedIO::EntryID &name ) const;
+template MappedVectorData<char>::Ptr StreamIndexedIO::readMapped<char>( const IndexedIO::EntryID &name ) const;
+template MappedVectorData<unsigned char>::Ptr StreamIndexedIO::readMapped<unsigned char>( const IndexedIO::EntryID &name ) const;
+template MappedVectorData<short>::Ptr StreamIndexedIO::readMapped<short>( const IndexedIO::EntryID &name ) const;
+template MappedVectorData<unsigned short>::Ptr StreamIndexedIO::readMapped<unsigned short>( const IndexedIO::EntryID &name ) const;
+
 #ifdef IE_CORE_LITTLE_ENDIAN
 #define READ	rawRead
 #define WRITE	rawWrite
@@ -0,0 +1,567 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2014, Image Engine Design Inc. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+//     * Neither the name of Image Engine Design nor the names of any
+//       other contributors to this software may be used to endorse or
+//       promote products derived from this software without specific prior
+//       written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <cmath>
+
+#include "OpenEXR/ImathLimits.h"
+
+#include "IECore/TriangleBVH.h"
+#include "IECore/TriangleAlgo.h"
+#include "IECore/Exception.h"
+
+using namespace IECore;
+using namespace Imath;
+
+//////////////////////////////////////////////////////////////////////////
+// Internal utilities
+//////////////////////////////////////////////////////////////////////////
+
+// The number of bins used to evaluate candidate splits during the build.
+static const int g_numBins = 16;
+// The maximum depth of the traversal stacks used in the queries.
+static const int g_maxStackSize = 64;
+// Beyond this depth we stop using the surface area heuristic and split at the
+// median instead. This guarantees that the tree fits within the traversal stacks
+// even in pathological cases where the heuristic produces very unbalanced splits.
+static const int g_maxSAHDepth = 32;
+
+struct TriangleBVH::BuildTriangle
+{
+	Box3f bound;
+	V3f center;
+	unsigned index;
+};
+
+static inline float halfSurfaceArea( const Box3f &b )
+{
+	if( b.isEmpty() )
+	{
+		return 0.0f;
+	}
+	const V3f s = b.size();
+	return s.x * s.y + s.y * s.z + s.z * s.x;
+}
+
+static inline int binIndex( float center, float min, float scale )
+{
+	const int i = (int)( ( center - min ) * scale );
+	return std::max( 0, std::min( i, g_numBins - 1 ) );
+}
+
+template<typename T>
+class BinPredicate
+{
+	public :
+
+		BinPredicate( int axis, float min, float scale, int split )
+			:	m_axis( axis ), m_min( min ), m_scale( scale ), m_split( split )
+		{
+		}
+
+		bool operator()( const T &t ) const
+		{
+			return binIndex( t.center[m_axis], m_min, m_scale ) <= m_split;
+		}
+
+	private :
+
+		int m_axis;
+		float m_min;
+		float m_scale;
+		int m_split;
+
+};
+
+template<typename T>
+class CenterLess
+{
+	public :
+
+		CenterLess( int axis )
+			:	m_axis( axis )
+		{
+		}
+
+		bool operator()( const T &a, const T &b ) const
+		{
+			return a.center[m_axis] < b.center[m_axis];
+		}
+
+	private :
+
+		int m_axis;
+
+};
+
+// Slab test, returning false if the ray doesn't enter the box before tMax.
+// The reciprocal of the ray direction is precomputed by the caller so that the
+// test is free of divisions and branches other than the early outs.
+static inline bool rayBoxIntersects( const Box3f &b, const V3f &origin, const V3f &inverseDirection, float tMax )
+{
+	float t0 = 0.0f;
+	float t1 = tMax;
+	for( int i = 0; i < 3; ++i )
+	{
+		float tNear = ( b.min[i] - origin[i] ) * inverseDirection[i];
+		float tFar = ( b.max[i] - origin[i] ) * inverseDirection[i];
+		if( tNear > tFar )
+		{
+			std::swap( tNear, tFar );
+		}
+		// account for rounding errors so that rays grazing
+		// the edges of a box aren't erroneously rejected.
+		tFar *= 1.0f + 4.0f * limits<float>::epsilon();
+		t0 = tNear > t0 ? tNear : t0;
+		t1 = tFar < t1 ? tFar : t1;
+		if( t0 > t1 )
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+static inline float boxDistanceSquared( const Box3f &b, const V3f &p )
+{
+	float result = 0.0f;
+	for( int i = 0; i < 3; ++i )
+	{
+		const float d = std::max( std::max( b.min[i] - p[i], p[i] - b.max[i] ), 0.0f );
+		result += d * d;
+	}
+	return result;
+}
+
+// Moller-Trumbore intersection test, returning the distance t along the ray,
+// and the barycentric coordinates u and v of the hit with respect to p1 and p2.
+static inline bool rayTriangleIntersects( const V3f &p0, const V3f &p1, const V3f &p2, const V3f &origin, const V3f &direction, float &t, float &u, float &v )
+{
+	const V3f e1 = p1 - p0;
+	const V3f e2 = p2 - p0;
+	const V3f pv = direction.cross( e2 );
+	const float det = e1.dot( pv );
+	if( det == 0.0f )
+	{
+		return false;
+	}
+
+	const float inverseDet = 1.0f / det;
+	const V3f tv = origin - p0;
+	u = tv.dot( pv ) * inverseDet;
+	if( u < 0.0f || u > 1.0f )
+	{
+		return false;
+	}
+
+	const V3f qv = tv.cross( e1 );
+	v = direction.dot( qv ) * inverseDet;
+	if( v < 0.0f || u + v > 1.0f )
+	{
+		return false;
+	}
+
+	t = e2.dot( qv ) * inverseDet;
+	return t >= 0.0f;
+}
+
+static inline V3f inverse( const V3f &direction )
+{
+	// division by zero gives the infinities we want for the slab test
+	return V3f( 1.0f / direction.x, 1.0f / direction.y, 1.0f / direction.z );
+}
+
+//////////////////////////////////////////////////////////////////////////
+// TriangleBVH
+//////////////////////////////////////////////////////////////////////////
+
+TriangleBVH::TriangleBVH( const std::vector<Imath::V3f> &points, const std::vector<int> &vertexIds, int maxLeafSize )
+	:	m_maxLeafSize( std::max( 1, std::min( maxLeafSize, 65535 ) ) )
+{
+	if( vertexIds.size() % 3 )
+	{
+		throw InvalidArgumentException( "TriangleBVH : Number of vertex ids is not a multiple of 3" );
+	}
+
+	const size_t numTriangles = vertexIds.size() / 3;
+	std::vector<BuildTriangle> buildTriangles( numTriangles );
+	for( size_t i = 0; i < numTriangles; ++i )
+	{
+		BuildTriangle &t = buildTriangles[i];
+		for( int j = 0; j < 3; ++j )
+		{
+			const int vertexId = vertexIds[i*3+j];
+			if( vertexId < 0 || vertexId >= (int)points.size() )
+			{
+				throw InvalidArgumentException( "TriangleBVH : Vertex id out of range" );
+			}
+			t.bound.extendBy( points[vertexId] );
+		}
+		t.center = t.bound.center();
+		t.index = i;
+	}
+
+	m_nodes.reserve( 2 * ( numTriangles / m_maxLeafSize + 1 ) );
+	build( buildTriangles, 0, numTriangles, 0 );
+
+	// store the triangles in the order the leaves reference them, so that
+	// each leaf reads a contiguous block of memory.
+	m_triangles.resize( numTriangles );
+	m_triangleIndices.resize( numTriangles );
+	for( size_t i = 0; i < numTriangles; ++i )
+	{
+		const unsigned index = buildTriangles[i].index;
+		m_triangleIndices[i] = index;
+		m_triangles[i].p0 = points[vertexIds[index*3]];
+		m_triangles[i].p1 = points[vertexIds[index*3+1]];
+		m_triangles[i].p2 = points[vertexIds[index*3+2]];
+	}
+}
+
+size_t TriangleBVH::build( std::vector<BuildTriangle> &triangles, size_t first, size_t last, int depth )
+{
+	const size_t nodeIndex = m_nodes.size();
+	m_nodes.push_back( Node() );
+
+	Box3f bound, centerBound;
+	for( size_t i = first; i < last; ++i )
+	{
+		bound.extendBy( triangles[i].bound );
+		centerBound.extendBy( triangles[i].center );
+	}
+	m_nodes[nodeIndex].bound = bound;
+
+	const size_t numTriangles = last - first;
+	if( numTriangles <= (size_t)m_maxLeafSize )
+	{
+		m_nodes[nodeIndex].offset = first;
+		m_nodes[nodeIndex].numTriangles = numTriangles;
+		m_nodes[nodeIndex].axis = 0;
+		return nodeIndex;
+	}
+
+	const int axis = centerBound.majorAxis();
+	const float extent = centerBound.size()[axis];
+	std::vector<BuildTriangle>::iterator begin = triangles.begin();
+	size_t mid = first;
+
+	if( extent > 0.0f && depth < g_maxSAHDepth )
+	{
+		// bin the triangles by their centers along the major axis
+		const float scale = g_numBins / extent;
+		size_t binCounts[g_numBins];
+		Box3f binBounds[g_numBins];
+		std::fill( binCounts, binCounts + g_numBins, 0 );
+		for( size_t i = first; i < last; ++i )
+		{
+			const int b = binIndex( triangles[i].center[axis], centerBound.min[axis], scale );
+			binCounts[b]++;
+			binBounds[b].extendBy( triangles[i].bound );
+		}
+
+		// sweep from the high end to find the cost of everything
+		// above each split
+		float highAreas[g_numBins];
+		size_t highCounts[g_numBins];
+		Box3f b;
+		size_t count = 0;
+		for( int i = g_numBins - 1; i > 0; --i )
+		{
+			b.extendBy( binBounds[i] );
+			count += binCounts[i];
+			highAreas[i] = halfSurfaceArea( b );
+			highCounts[i] = count;
+		}
+
+		// and then from the low end to find the split with
+		// the lowest total cost
+		b.makeEmpty();
+		count = 0;
+		float bestCost = limits<float>::max();
+		int bestSplit = -1;
+		for( int i = 0; i < g_numBins - 1; ++i )
+		{
+			b.extendBy( binBounds[i] );
+			count += binCounts[i];
+			if( !count || !highCounts[i+1] )
+			{
+				continue;
+			}
+			const float cost = count * halfSurfaceArea( b ) + highCounts[i+1] * highAreas[i+1];
+			if( cost < bestCost )
+			{
+				bestCost = cost;
+				bestSplit = i;
+			}
+		}
+
+		if( bestSplit >= 0 )
+		{
+			mid = std::partition(
+				begin + first, begin + last,
+				BinPredicate<BuildTriangle>( axis, centerBound.min[axis], scale, bestSplit )
+			) - begin;
+		}
+	}
+
+	if( mid == first || mid == last )
+	{
+		// either the centers are coincident, or we're too deep to
+		// risk an unbalanced split - just split at the median.
+		mid = first + numTriangles / 2;
+		std::nth_element( begin + first, begin + mid, begin + last, CenterLess<BuildTriangle>( axis ) );
+	}
+
+	build( triangles, first, mid, depth + 1 );
+	const size_t highIndex = build( triangles, mid, last, depth + 1 );
+
+	m_nodes[nodeIndex].offset = highIndex;
+	m_nodes[nodeIndex].numTriangles = 0;
+	m_nodes[nodeIndex].axis = axis;
+
+	return nodeIndex;
+}
+
+bool TriangleBVH::intersect( const Imath::V3f &origin, const Imath::V3f &direction, float maxDistance, Hit &hit ) const
+{
+	if( m_triangles.empty() )
+	{
+		return false;
+	}
+
+	const V3f inverseDirection = inverse( direction );
+
+	bool result = false;
+	float tMax = maxDistance;
+
+	unsigned stack[g_maxStackSize];
+	int stackSize = 0;
+	unsigned nodeIndex = 0;
+	while( true )
+	{
+		const Node &node = m_nodes[nodeIndex];
+		if( rayBoxIntersects( node.bound, origin, inverseDirection, tMax ) )
+		{
+			if( node.numTriangles )
+			{
+				const Triangle *triangle = &m_triangles[node.offset];
+				const Triangle *lastTriangle = triangle + node.numTriangles;
+				for( ; triangle != lastTriangle; ++triangle )
+				{
+					float t, u, v;
+					if( rayTriangleIntersects( triangle->p0, triangle->p1, triangle->p2, origin, direction, t, u, v ) && t < tMax )
+					{
+						tMax = t;
+						hit.triangleIndex = m_triangleIndices[triangle - &m_triangles[0]];
+						hit.barycentricCoordinates = V3f( 1.0f - u - v, u, v );
+						hit.distance = t;
+						result = true;
+					}
+				}
+			}
+			else
+			{
+				// visit the nearer child first, so that tMax shrinks as
+				// quickly as possible.
+				if( direction[node.axis] < 0.0f )
+				{
+					stack[stackSize++] = nodeIndex + 1;
+					nodeIndex = node.offset;
+				}
+				else
+				{
+					stack[stackSize++] = node.offset;
+					nodeIndex = nodeIndex + 1;
+				}
+				continue;
+			}
+		}
+
+		if( !stackSize )
+		{
+			break;
+		}
+		nodeIndex = stack[--stackSize];
+	}
+
+	return result;
+}
+
+unsigned TriangleBVH::intersectAll( const Imath::V3f &origin, const Imath::V3f &direction, float maxDistance, std::vector<Hit> &hits ) const
+{
+	if( m_triangles.empty() )
+	{
+		return 0;
+	}
+
+	const V3f inverseDirection = inverse( direction );
+	const size_t initialSize = hits.size();
+
+	unsigned stack[g_maxStackSize];
+	int stackSize = 0;
+	unsigned nodeIndex = 0;
+	while( true )
+	{
+		const Node &node = m_nodes[nodeIndex];
+		if( rayBoxIntersects( node.bound, origin, inverseDirection, maxDistance ) )
+		{
+			if( node.numTriangles )
+			{
+				const Triangle *triangle = &m_triangles[node.offset];
+				const Triangle *lastTriangle = triangle + node.numTriangles;
+				for( ; triangle != lastTriangle; ++triangle )
+				{
+					float t, u, v;
+					if( rayTriangleIntersects( triangle->p0, triangle->p1, triangle->p2, origin, direction, t, u, v ) && t < maxDistance )
+					{
+						Hit hit;
+						hit.triangleIndex = m_triangleIndices[triangle - &m_triangles[0]];
+						hit.barycentricCoordinates = V3f( 1.0f - u - v, u, v );
+						hit.distance = t;
+						hits.push_back( hit );
+					}
+				}
+			}
+			else
+			{
+				stack[stackSize++] = node.offset;
+				nodeIndex = nodeIndex + 1;
+				continue;
+			}
+		}
+
+		if( !stackSize )
+		{
+			break;
+		}
+		nodeIndex = stack[--stackSize];
+	}
+
+	return hits.size() - initialSize;
+}
+
+bool TriangleBVH::closestPoint( const Imath::V3f &p, Hit &hit ) const
+{
+	if( m_triangles.empty() )
+	{
+		return false;
+	}
+
+	float closestDistanceSquared = limits<float>::max();
+
+	unsigned stack[g_maxStackSize];
+	float stackDistances[g_maxStackSize];
+	int stackSize = 0;
+	unsigned nodeIndex = 0;
+	while( true )
+	{
+		const Node &node = m_nodes[nodeIndex];
+		if( node.numTriangles )
+		{
+			const Triangle *triangle = &m_triangles[node.offset];
+			const Triangle *lastTriangle = triangle + node.numTriangles;
+			for( ; triangle != lastTriangle; ++triangle )
+			{
+				V3f barycentricCoordinates;
+				const float d = triangleClosestBarycentric( triangle->p0, triangle->p1, triangle->p2, p, barycentricCoordinates );
+				if( d < closestDistanceSquared )
+				{
+					closestDistanceSquared = d;
+					hit.triangleIndex = m_triangleIndices[triangle - &m_triangles[0]];
+					hit.barycentricCoordinates = barycentricCoordinates;
+				}
+			}
+		}
+		else
+		{
+			// descend into the closest child first, deferring the other
+			// until we know whether it could contain anything closer.
+			unsigned nearIndex = nodeIndex + 1;
+			unsigned farIndex = node.offset;
+			float nearDistance = boxDistanceSquared( m_nodes[nearIndex].bound, p );
+			float farDistance = boxDistanceSquared( m_nodes[farIndex].bound, p );
+			if( farDistance < nearDistance )
+			{
+				std::swap( nearIndex, farIndex );
+				std::swap( nearDistance, farDistance );
+			}
+
+			if( farDistance < closestDistanceSquared )
+			{
+				stack[stackSize] = farIndex;
+				stackDistances[stackSize++] = farDistance;
+			}
+			if( nearDistance < closestDistanceSquared )
+			{
+				nodeIndex = nearIndex;
+				continue;
+			}
+		}
+
+		// pop the next node which could still contain a closer point
+		bool found = false;
+		while( stackSize )
+		{
+			--stackSize;
+			if( stackDistances[stackSize] < closestDistanceSquared )
+			{
+				nodeIndex = stack[stackSize];
+				found = true;
+				break;
+			}
+		}
+		if( !found )
+		{
+			break;
+		}
+	}
+
+	hit.distance = sqrtf( std::max( closestDistanceSquared, 0.0f ) );
+	return true;
+}
+
+size_t TriangleBVH::numTriangles() const
+{
+	return m_triangles.size();
+}
+
+size_t TriangleBVH::numNodes() const
+{
+	return m_nodes.size();
+}
+
+const Imath::Box3f &TriangleBVH::bound() const
+{
+	return m_nodes[0].bound;
+}
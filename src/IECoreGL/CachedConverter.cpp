@@ -32,16 +32,25 @@
 //
 //////////////////////////////////////////////////////////////////////////
 
+#include <map>
+#include <deque>
+
 #include "boost/lexical_cast.hpp"
 #include "boost/format.hpp"
 #include "boost/bind.hpp"
 #include "boost/bind/placeholders.hpp"
 
+#include "tbb/spin_mutex.h"
+#include "tbb/task_group.h"
+#include "tbb/tick_count.h"
+
 #include "IECore/LRUCache.h"
 #include "IECore/MurmurHash.h"
+#include "IECore/MessageHandler.h"
 
 #include "IECoreGL/ToGLConverter.h"
 #include "IECoreGL/CachedConverter.h"
+#include "IECoreGL/Primitive.h"
 
 using namespace IECoreGL;
 
@@ -67,6 +76,13 @@ struct CacheKey
 		: object( o ), hash( o->hash() )
 	{
 	}
+
+	// Used only with LRUCache::set(), where the getter
+	// is never called.
+	CacheKey( const IECore::MurmurHash &h )
+		: object( NULL ), hash( h )
+	{
+	}
 	
 	bool operator == ( const CacheKey &other ) const
 	{
@@ -119,10 +135,103 @@ struct CachedConverter::MemberData
 		deferredRemovals.push_back( value );
 	}
 	
-	typedef IECore::LRUCache<CacheKey, IECore::RunTimeTypedPtr> Cache;
+	// Cache hits come from many threads during rendering, so we use the
+	// SecondChance policy to avoid contending on a single lock for them.
+	typedef IECore::LRUCache<CacheKey, IECore::RunTimeTypedPtr, IECore::LRUCachePolicy::SecondChance> Cache;
 	Cache cache;
 	std::vector<IECore::RunTimeTypedPtr> deferredRemovals;
-	
+
+	// State for a conversion scheduled by convertAsync(). The converter
+	// holds a reference to the source object, keeping it alive until
+	// the conversion is complete.
+	struct Pending
+	{
+		Pending()
+			:	cost( 0 ), background( false )
+		{
+		}
+
+		ToGLConverterPtr converter;
+		size_t cost;
+		bool background;
+		IECore::RunTimeTypedPtr result;
+		std::string error;
+	};
+
+	typedef std::map<IECore::MurmurHash, Pending> PendingMap;
+	typedef tbb::spin_mutex PendingMutex;
+
+	// Record of a failed conversion. Failures may be transient, so
+	// convertAsync() retries them, but only after retryInterval has
+	// elapsed, so that persistent failures don't eat into the time
+	// budget every frame. The interval doubles with each failure.
+	struct Failure
+	{
+		Failure()
+			:	time( tbb::tick_count::now() ), retryInterval( 1.0 )
+		{
+		}
+
+		tbb::tick_count time;
+		double retryInterval;
+	};
+
+	typedef std::map<IECore::MurmurHash, Failure> FailureMap;
+
+	// Performs a conversion which doesn't need a GL context, and
+	// then queues the result to be transferred into the cache by
+	// processPendingConversions().
+	class BackgroundConversion
+	{
+
+		public :
+
+			BackgroundConversion( MemberData *data, const IECore::MurmurHash &hash, ToGLConverterPtr converter )
+				:	m_data( data ), m_hash( hash ), m_converter( converter )
+			{
+			}
+
+			void operator()() const
+			{
+				IECore::RunTimeTypedPtr result;
+				std::string error;
+				try
+				{
+					result = m_converter->convert();
+				}
+				catch( const std::exception &e )
+				{
+					error = e.what();
+				}
+				catch( ... )
+				{
+					error = "Unknown error";
+				}
+
+				PendingMutex::scoped_lock lock( m_data->pendingMutex );
+				Pending &pending = m_data->pending[m_hash];
+				pending.result = result;
+				pending.error = error;
+				m_data->ready.push_back( m_hash );
+			}
+
+		private :
+
+			MemberData *m_data;
+			IECore::MurmurHash m_hash;
+			ToGLConverterPtr m_converter;
+
+	};
+
+	// Protects pending, ready and failed.
+	PendingMutex pendingMutex;
+	PendingMap pending;
+	// Conversions which processPendingConversions() should complete,
+	// in the order they became available.
+	std::deque<IECore::MurmurHash> ready;
+	FailureMap failed;
+	tbb::task_group backgroundTasks;
+
 };
 
 CachedConverter::CachedConverter( size_t maxMemory )
@@ -132,6 +241,7 @@ CachedConverter::CachedConverter( size_t maxMemory )
 
 CachedConverter::~CachedConverter()
 {
+	m_data->backgroundTasks.wait();
 	delete m_data;
 }
 
@@ -140,6 +250,152 @@ IECore::ConstRunTimeTypedPtr CachedConverter::convert( const IECore::Object *obj
 	return m_data->cache.get( CacheKey( object ) );
 }
 
+IECore::ConstRunTimeTypedPtr CachedConverter::convertAsync( const IECore::Object *object )
+{
+	CacheKey key( object );
+	if( m_data->cache.cached( key ) )
+	{
+		return m_data->cache.get( key );
+	}
+
+	MemberData::PendingMutex::scoped_lock lock( m_data->pendingMutex );
+
+	MemberData::FailureMap::const_iterator failure = m_data->failed.find( key.hash );
+	if(
+		failure != m_data->failed.end() &&
+		( tbb::tick_count::now() - failure->second.time ).seconds() < failure->second.retryInterval
+	)
+	{
+		return 0;
+	}
+
+	std::pair<MemberData::PendingMap::iterator, bool> inserted = m_data->pending.insert(
+		MemberData::PendingMap::value_type( key.hash, MemberData::Pending() )
+	);
+	if( !inserted.second )
+	{
+		// already scheduled
+		return 0;
+	}
+
+	MemberData::Pending &pending = inserted.first->second;
+	pending.converter = ToGLConverter::create( object );
+	if( !pending.converter )
+	{
+		m_data->pending.erase( inserted.first );
+		throw IECore::Exception(
+			boost::str(
+				boost::format(
+					"Unable to create converter for Object of type \"%s\""
+				) % object->typeName()
+			)
+		);
+	}
+
+	pending.cost = object->memoryUsage();
+	pending.background = !pending.converter->requiresGLContext();
+	if( pending.background )
+	{
+		m_data->backgroundTasks.run( MemberData::BackgroundConversion( m_data, key.hash, pending.converter ) );
+	}
+	else
+	{
+		m_data->ready.push_back( key.hash );
+	}
+
+	return 0;
+}
+
+size_t CachedConverter::processPendingConversions( double timeBudget )
+{
+	const tbb::tick_count startTime = tbb::tick_count::now();
+
+	size_t numProcessed = 0;
+	while( true )
+	{
+		IECore::MurmurHash hash;
+		MemberData::Pending pending;
+		{
+			MemberData::PendingMutex::scoped_lock lock( m_data->pendingMutex );
+			if(
+				m_data->ready.empty() ||
+				( numProcessed && ( tbb::tick_count::now() - startTime ).seconds() > timeBudget )
+			)
+			{
+				break;
+			}
+			hash = m_data->ready.front();
+			m_data->ready.pop_front();
+			// We leave the entry in the pending map while converting,
+			// so that convertAsync() doesn't schedule it again.
+			pending = m_data->pending[hash];
+		}
+
+		try
+		{
+			if( !pending.background )
+			{
+				pending.result = pending.converter->convert();
+			}
+			// Primitives create their GL buffers lazily on first draw, which
+			// would stall the frame we're trying to protect, so we upload them
+			// here instead, where the time is accounted for in the budget.
+			if( const Primitive *primitive = IECore::runTimeCast<const Primitive>( pending.result.get() ) )
+			{
+				primitive->uploadBuffers();
+			}
+		}
+		catch( const std::exception &e )
+		{
+			pending.result = 0;
+			pending.error = e.what();
+		}
+		catch( ... )
+		{
+			pending.result = 0;
+			pending.error = "Unknown error";
+		}
+
+		if( pending.result )
+		{
+			m_data->cache.set( CacheKey( hash ), pending.result, pending.cost );
+		}
+		else
+		{
+			IECore::msg(
+				IECore::Msg::Error, "CachedConverter::processPendingConversions",
+				pending.error.size() ? pending.error : "Conversion returned no result"
+			);
+		}
+
+		MemberData::PendingMutex::scoped_lock lock( m_data->pendingMutex );
+		m_data->pending.erase( hash );
+		MemberData::FailureMap::iterator failure = m_data->failed.find( hash );
+		if( pending.result )
+		{
+			if( failure != m_data->failed.end() )
+			{
+				m_data->failed.erase( failure );
+			}
+		}
+		else if( failure == m_data->failed.end() )
+		{
+			m_data->failed[hash] = MemberData::Failure();
+		}
+		else
+		{
+			failure->second.time = tbb::tick_count::now();
+			failure->second.retryInterval *= 2.0;
+		}
+		numProcessed++;
+	}
+
+	clearUnused();
+
+	MemberData::PendingMutex::scoped_lock lock( m_data->pendingMutex );
+	return m_data->pending.size();
+}
+
 size_t CachedConverter::getMaxMemory() const
 {
 	return m_data->cache.getMaxCost();
@@ -45,6 +45,7 @@
 #include "IECoreGL/CachedConverter.h"
 #include "IECoreGL/ShaderLoader.h"
 #include "IECoreGL/ShaderStateComponent.h"
+#include "IECoreGL/State.h"
 #include "IECoreGL/IECoreGL.h"
 
 using namespace IECoreGL;
@@ -242,6 +243,26 @@ void CurvesPrimitive::renderInstances( size_t numInstances ) const
 	glDrawElementsInstancedARB( GL_LINES, m_memberData->numVertIds, GL_UNSIGNED_INT, 0, numInstances );
 }
 
+void CurvesPrimitive::uploadBuffers() const
+{
+	Primitive::uploadBuffers();
+
+	bool linear, ribbons;
+	renderMode( State::defaultState(), linear, ribbons );
+	if( !ribbons && linear )
+	{
+		ensureVertIds();
+	}
+	else if( linear )
+	{
+		ensureLinearAdjacencyVertIds();
+	}
+	else
+	{
+		ensureAdjacencyVertIds();
+	}
+}
+
 void CurvesPrimitive::renderMode( const State *state, bool &linear, bool &ribbons ) const
 {
 	if( glslVersion() < 150 )
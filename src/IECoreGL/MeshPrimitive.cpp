@@ -34,11 +34,16 @@
 
 #include <cassert>
 
+#include "boost/format.hpp"
+
 #include "IECore/DespatchTypedData.h"
+#include "IECore/MessageHandler.h"
 
 #include "IECoreGL/MeshPrimitive.h"
 #include "IECoreGL/GL.h"
 #include "IECoreGL/State.h"
+#include "IECoreGL/Buffer.h"
+#include "IECoreGL/CachedConverter.h"
 
 #include "OpenEXR/ImathMath.h"
 
@@ -56,13 +61,30 @@ class MeshPrimitive::MemberData : public IECore::RefCounted
 	
 	public :
 	
-		MemberData( IECore::ConstIntVectorDataPtr verts ) : vertIds( verts )
+		MemberData( IECore::ConstIntVectorDataPtr verts, bool indexed, size_t numVertices )
+			:	vertIds( verts ), indexed( indexed ), numVertices( numVertices )
 		{
 		}
 
 		IECore::ConstIntVectorDataPtr vertIds;
 		Imath::Box3f bound;
 
+		bool indexed;
+		size_t numVertices;
+		// we don't build the index buffer until rendering, because we're
+		// not guaranteed a valid GL context before that.
+		mutable ConstBufferPtr vertIdsBuffer;
+
+		const Buffer *indexBuffer() const
+		{
+			if( !vertIdsBuffer )
+			{
+				CachedConverterPtr cachedConverter = CachedConverter::defaultCachedConverter();
+				vertIdsBuffer = IECore::runTimeCast<const Buffer>( cachedConverter->convert( vertIds.get() ) );
+			}
+			return vertIdsBuffer.get();
+		}
+
 		/// \todo This could be removed now the ToGLMeshConverter uses FaceVaryingPromotionOp
 		/// to convert everything to FaceVarying before being added. The only reason we're even
 		/// doing this still is in case client code is creating MeshPrimitives directly rather
@@ -110,7 +132,12 @@ class MeshPrimitive::MemberData : public IECore::RefCounted
 IE_CORE_DEFINERUNTIMETYPED( MeshPrimitive );
 
 MeshPrimitive::MeshPrimitive( IECore::ConstIntVectorDataPtr vertIds )
-	:	m_memberData( new MemberData( vertIds->copy() ) )
+	:	m_memberData( new MemberData( vertIds->copy(), false, 0 ) )
+{
+}
+
+MeshPrimitive::MeshPrimitive( IECore::ConstIntVectorDataPtr vertIds, size_t numVertices )
+	:	m_memberData( new MemberData( vertIds, true, numVertices ) )
 {
 }
 
@@ -140,7 +167,26 @@ void MeshPrimitive::addPrimitiveVariable( const std::string &name, const IECore:
 		}
 	}
 	
-	if ( primVar.interpolation==IECore::PrimitiveVariable::Vertex || primVar.interpolation==IECore::PrimitiveVariable::Varying )
+	if( m_memberData->indexed )
+	{
+		switch( primVar.interpolation )
+		{
+			case IECore::PrimitiveVariable::Constant :
+				addUniformAttribute( name, primVar.data );
+				break;
+			case IECore::PrimitiveVariable::Vertex :
+			case IECore::PrimitiveVariable::Varying :
+				if( IECore::despatchTypedData<IECore::TypedDataSize, IECore::TypeTraits::IsVectorTypedData, IECore::DespatchTypedDataIgnoreError>( primVar.data.get() ) == m_memberData->numVertices )
+				{
+					addVertexAttribute( name, primVar.data );
+					break;
+				}
+				// fall through
+			default :
+				IECore::msg( IECore::Msg::Warning, "MeshPrimitive::addPrimitiveVariable", boost::format( "Primitive variable \"%s\" has unsupported interpolation or size." ) % name );
+		}
+	}
+	else if ( primVar.interpolation==IECore::PrimitiveVariable::Vertex || primVar.interpolation==IECore::PrimitiveVariable::Varying )
 	{
 		MemberData::ToFaceVaryingConverter primVarConverter( m_memberData->vertIds );
 		// convert to facevarying
@@ -160,7 +206,23 @@ void MeshPrimitive::addPrimitiveVariable( const std::string &name, const IECore:
 void MeshPrimitive::renderInstances( size_t numInstances ) const
 {
 	unsigned vertexCount = m_memberData->vertIds->readable().size();
-	glDrawArraysInstancedARB( GL_TRIANGLES, 0, vertexCount, numInstances );
+	if( !m_memberData->indexed )
+	{
+		glDrawArraysInstancedARB( GL_TRIANGLES, 0, vertexCount, numInstances );
+		return;
+	}
+
+	Buffer::ScopedBinding indexBinding( *(m_memberData->indexBuffer()), GL_ELEMENT_ARRAY_BUFFER );
+	glDrawElementsInstancedARB( GL_TRIANGLES, vertexCount, GL_UNSIGNED_INT, 0, numInstances );
+}
+
+void MeshPrimitive::uploadBuffers() const
+{
+	Primitive::uploadBuffers();
+	if( m_memberData->indexed )
+	{
+		m_memberData->indexBuffer();
+	}
 }
 
 Imath::Box3f MeshPrimitive::bound() const
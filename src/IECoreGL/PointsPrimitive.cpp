@@ -38,6 +38,7 @@
 #include "IECore/MessageHandler.h"
 #include "IECore/SimpleTypedData.h"
 #include "IECore/VectorTypedData.h"
+#include "IECore/RadixSort.h"
 
 #include "IECoreGL/PointsPrimitive.h"
 #include "IECoreGL/DiskPrimitive.h"
@@ -415,31 +416,13 @@ std::string &PointsPrimitive::instancingVertexSource()
 	return s;
 }
 
-struct SortFn
-{
-	SortFn( const vector<float> &d ) : depths( d ) {};
-	bool operator()( int f, int s ) { return depths[f] > depths[s]; };
-	const vector<float> &depths;
-};
-
-/// \todo Use IECore::RadixSort (might still want to use std::sort for small numbers of points - profile to check this)
 void PointsPrimitive::depthSort() const
 {
 	V3f cameraDirection = Camera::viewDirectionInObjectSpace();
 	cameraDirection.normalize();
 
 	const vector<V3f> &points = m_memberData->points->readable();
-	if( !m_memberData->depthOrder.size() )
-	{
-		// never sorted before. initialize space.
-		m_memberData->depthOrder.resize( points.size() );
-		for( unsigned int i=0; i<m_memberData->depthOrder.size(); i++ )
-		{
-			m_memberData->depthOrder[i] = i;
-		}
-		m_memberData->depths.resize( points.size() );
-	}
-	else
+	if( m_memberData->depthOrder.size() )
 	{
 		// sorted before. see if the camera direction has changed enough
 		// to warrant resorting.
@@ -451,13 +434,16 @@ void PointsPrimitive::depthSort() const
 
 	m_memberData->depthCameraDirection = cameraDirection;
 
-	// calculate all distances
+	// calculate all distances, negated so that an ascending sort
+	// puts the furthest points first.
+	m_memberData->depths.resize( points.size() );
+	m_memberData->depthOrder.resize( points.size() );
 	for( unsigned int i=0; i<m_memberData->depths.size(); i++ )
 	{
-		m_memberData->depths[i] = points[i].dot( m_memberData->depthCameraDirection );
+		m_memberData->depths[i] = -points[i].dot( m_memberData->depthCameraDirection );
+		m_memberData->depthOrder[i] = i;
 	}
 
-	// sort based on those distances
-	SortFn sorter( m_memberData->depths );
-	sort( m_memberData->depthOrder.begin(), m_memberData->depthOrder.end(), sorter );
+	// sort the indices based on those distances
+	IECore::RadixSort::sort( m_memberData->depths, m_memberData->depthOrder );
 }
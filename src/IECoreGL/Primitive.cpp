@@ -309,6 +309,25 @@ void Primitive::render( const State *currentState, IECore::TypeId style ) const
 	renderInstances( 1 );
 }
 
+void Primitive::uploadBuffers() const
+{
+	CachedConverter *cachedConverter = CachedConverter::defaultCachedConverter();
+	for( AttributeMap::const_iterator it = m_vertexAttributes.begin(), eIt = m_vertexAttributes.end(); it != eIt; it++ )
+	{
+		cachedConverter->convert( it->second.get() );
+	}
+}
+
+IECore::ConstDataPtr Primitive::vertexAttribute( const std::string &name ) const
+{
+	AttributeMap::const_iterator it = m_vertexAttributes.find( name );
+	if( it == m_vertexAttributes.end() )
+	{
+		return 0;
+	}
+	return it->second;
+}
+
 void Primitive::addUniformAttribute( const std::string &name, IECore::ConstDataPtr data )
 {
 	m_uniformAttributes[name] = data->copy();
@@ -57,6 +57,11 @@ IECore::RunTimeTypedPtr ToGLConverter::convert()
 	return doConversion( srcParameter()->getValue(), operands );
 }
 
+bool ToGLConverter::requiresGLContext() const
+{
+	return true;
+}
+
 ToGLConverterPtr ToGLConverter::create( IECore::ConstObjectPtr object, IECore::TypeId resultType )
 {
 	Registrations &r = registrations();
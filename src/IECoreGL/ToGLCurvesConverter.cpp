@@ -58,6 +58,11 @@ ToGLCurvesConverter::~ToGLCurvesConverter()
 {
 }
 
+bool ToGLCurvesConverter::requiresGLContext() const
+{
+	return false;
+}
+
 /// \todo Maybe this same functionality should be wrapped up in an Op in IECore?
 class ToGLCurvesConverter::ToVertexConverter
 {
@@ -32,21 +32,354 @@
 //
 //////////////////////////////////////////////////////////////////////////
 
+
+#include <algorithm>
 #include <cassert>
+#include <cstring>
 
 #include "boost/format.hpp"
 
+#include "tbb/parallel_for.h"
+
 #include "IECore/MeshPrimitive.h"
-#include "IECore/TriangulateOp.h"
-#include "IECore/MeshNormalsOp.h"
 #include "IECore/DespatchTypedData.h"
 #include "IECore/MessageHandler.h"
-#include "IECore/FaceVaryingPromotionOp.h"
 
 #include "IECoreGL/ToGLMeshConverter.h"
 #include "IECoreGL/MeshPrimitive.h"
 
 using namespace IECoreGL;
+using namespace Imath;
+
+//////////////////////////////////////////////////////////////////////////
+// Implementation details
+//////////////////////////////////////////////////////////////////////////
+
+namespace
+{
+
+typedef tbb::blocked_range<size_t> Range;
+
+// Fills in the face each face-vertex belongs to.
+struct CornerFaces
+{
+	CornerFaces( const std::vector<int> &faceCorners, std::vector<int> &cornerFaces )
+		:	m_faceCorners( faceCorners ), m_cornerFaces( cornerFaces )
+	{
+	}
+
+	void operator()( const Range &range ) const
+	{
+		for( size_t f = range.begin(); f != range.end(); ++f )
+		{
+			std::fill( m_cornerFaces.begin() + m_faceCorners[f], m_cornerFaces.begin() + m_faceCorners[f+1], f );
+		}
+	}
+
+	const std::vector<int> &m_faceCorners;
+	std::vector<int> &m_cornerFaces;
+};
+
+// Computes a normal for each face, in the same way as the MeshNormalsOp.
+struct FaceNormals
+{
+	FaceNormals( const std::vector<V3f> &p, const std::vector<int> &vertexIds, const std::vector<int> &faceCorners, std::vector<V3f> &normals )
+		:	m_p( p ), m_vertexIds( vertexIds ), m_faceCorners( faceCorners ), m_normals( normals )
+	{
+	}
+
+	void operator()( const Range &range ) const
+	{
+		for( size_t f = range.begin(); f != range.end(); ++f )
+		{
+			const int c = m_faceCorners[f];
+			if( m_faceCorners[f+1] - c < 3 )
+			{
+				m_normals[f] = V3f( 0 );
+				continue;
+			}
+			const V3f &p0 = m_p[m_vertexIds[c]];
+			const V3f &p1 = m_p[m_vertexIds[c+1]];
+			const V3f &p2 = m_p[m_vertexIds[c+2]];
+			m_normals[f] = ( p2 - p1 ).cross( p0 - p1 ).normalized();
+		}
+	}
+
+	const std::vector<V3f> &m_p;
+	const std::vector<int> &m_vertexIds;
+	const std::vector<int> &m_faceCorners;
+	std::vector<V3f> &m_normals;
+};
+
+// Averages the normals of the faces around each vertex.
+struct VertexNormals
+{
+	VertexNormals( const std::vector<V3f> &faceNormals, const std::vector<int> &cornerFaces, const std::vector<int> &vertexCornerOffsets, const std::vector<int> &vertexCorners, std::vector<V3f> &normals )
+		:	m_faceNormals( faceNormals ), m_cornerFaces( cornerFaces ), m_vertexCornerOffsets( vertexCornerOffsets ), m_vertexCorners( vertexCorners ), m_normals( normals )
+	{
+	}
+
+	void operator()( const Range &range ) const
+	{
+		for( size_t v = range.begin(); v != range.end(); ++v )
+		{
+			V3f n( 0 );
+			for( int i = m_vertexCornerOffsets[v]; i < m_vertexCornerOffsets[v+1]; ++i )
+			{
+				n += m_faceNormals[m_cornerFaces[m_vertexCorners[i]]];
+			}
+			m_normals[v] = n.normalized();
+		}
+	}
+
+	const std::vector<V3f> &m_faceNormals;
+	const std::vector<int> &m_cornerFaces;
+	const std::vector<int> &m_vertexCornerOffsets;
+	const std::vector<int> &m_vertexCorners;
+	std::vector<V3f> &m_normals;
+};
+
+// The raw values of a Uniform or FaceVarying primitive variable, used to
+// decide whether or not two face-vertices can share a GL vertex.
+struct SplitVariable
+{
+	const char *data;
+	size_t elementSize;
+	bool uniform;
+};
+
+struct ElementSize
+{
+	typedef size_t ReturnType;
+
+	template<typename T>
+	ReturnType operator()( const T *data ) const
+	{
+		return sizeof( typename T::ValueType::value_type );
+	}
+};
+
+// Groups the face-vertices around each vertex by the values of the split
+// variables, so that a GL vertex is only made for each distinct group.
+struct SplitVertices
+{
+	SplitVertices(
+		const std::vector<SplitVariable> &splitVariables, const std::vector<int> &cornerFaces,
+		const std::vector<int> &vertexCornerOffsets, const std::vector<int> &vertexCorners,
+		std::vector<int> &cornerSplits, std::vector<char> &cornerIsFirst, std::vector<int> &vertexSplitCounts
+	)
+		:	m_splitVariables( splitVariables ), m_cornerFaces( cornerFaces ), m_vertexCornerOffsets( vertexCornerOffsets ),
+			m_vertexCorners( vertexCorners ), m_cornerSplits( cornerSplits ), m_cornerIsFirst( cornerIsFirst ),
+			m_vertexSplitCounts( vertexSplitCounts )
+	{
+	}
+
+	void operator()( const Range &range ) const
+	{
+		std::vector<int> firstCorners;
+		for( size_t v = range.begin(); v != range.end(); ++v )
+		{
+			firstCorners.clear();
+			for( int i = m_vertexCornerOffsets[v]; i < m_vertexCornerOffsets[v+1]; ++i )
+			{
+				const int c = m_vertexCorners[i];
+				size_t split = 0;
+				while( split < firstCorners.size() && !equal( c, firstCorners[split] ) )
+				{
+					split++;
+				}
+				if( split == firstCorners.size() )
+				{
+					firstCorners.push_back( c );
+					m_cornerIsFirst[c] = 1;
+				}
+				m_cornerSplits[c] = split;
+			}
+			m_vertexSplitCounts[v] = firstCorners.size();
+		}
+	}
+
+	bool equal( int c0, int c1 ) const
+	{
+		for( std::vector<SplitVariable>::const_iterator it = m_splitVariables.begin(); it != m_splitVariables.end(); ++it )
+		{
+			const size_t i0 = it->uniform ? m_cornerFaces[c0] : c0;
+			const size_t i1 = it->uniform ? m_cornerFaces[c1] : c1;
+			if( memcmp( it->data + i0 * it->elementSize, it->data + i1 * it->elementSize, it->elementSize ) )
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	const std::vector<SplitVariable> &m_splitVariables;
+	const std::vector<int> &m_cornerFaces;
+	const std::vector<int> &m_vertexCornerOffsets;
+	const std::vector<int> &m_vertexCorners;
+	std::vector<int> &m_cornerSplits;
+	std::vector<char> &m_cornerIsFirst;
+	std::vector<int> &m_vertexSplitCounts;
+};
+
+// Assigns each face-vertex its GL vertex, and records where the values
+// for each GL vertex should be taken from.
+struct AssignVertices
+{
+	AssignVertices(
+		const std::vector<int> &vertexIds, const std::vector<int> &cornerFaces, const std::vector<int> &cornerSplits,
+		const std::vector<char> &cornerIsFirst, const std::vector<int> &vertexOffsets, std::vector<int> &cornerGLVertices,
+		std::vector<int> &glVertexVertices, std::vector<int> &glVertexCorners, std::vector<int> &glVertexFaces
+	)
+		:	m_vertexIds( vertexIds ), m_cornerFaces( cornerFaces ), m_cornerSplits( cornerSplits ), m_cornerIsFirst( cornerIsFirst ),
+			m_vertexOffsets( vertexOffsets ), m_cornerGLVertices( cornerGLVertices ), m_glVertexVertices( glVertexVertices ),
+			m_glVertexCorners( glVertexCorners ), m_glVertexFaces( glVertexFaces )
+	{
+	}
+
+	void operator()( const Range &range ) const
+	{
+		for( size_t c = range.begin(); c != range.end(); ++c )
+		{
+			const int g = m_vertexOffsets[m_vertexIds[c]] + m_cornerSplits[c];
+			m_cornerGLVertices[c] = g;
+			if( m_cornerIsFirst[c] )
+			{
+				m_glVertexVertices[g] = m_vertexIds[c];
+				m_glVertexCorners[g] = c;
+				m_glVertexFaces[g] = m_cornerFaces[c];
+			}
+		}
+	}
+
+	const std::vector<int> &m_vertexIds;
+	const std::vector<int> &m_cornerFaces;
+	const std::vector<int> &m_cornerSplits;
+	const std::vector<char> &m_cornerIsFirst;
+	const std::vector<int> &m_vertexOffsets;
+	std::vector<int> &m_cornerGLVertices;
+	std::vector<int> &m_glVertexVertices;
+	std::vector<int> &m_glVertexCorners;
+	std::vector<int> &m_glVertexFaces;
+};
+
+// Triangulates each face as a simple fan, in the same way as the TriangulateOp.
+struct Triangulate
+{
+	Triangulate( const std::vector<int> &faceCorners, const std::vector<int> &faceTriangles, const std::vector<int> &cornerGLVertices, std::vector<int> &triangles )
+		:	m_faceCorners( faceCorners ), m_faceTriangles( faceTriangles ), m_cornerGLVertices( cornerGLVertices ), m_triangles( triangles )
+	{
+	}
+
+	void operator()( const Range &range ) const
+	{
+		for( size_t f = range.begin(); f != range.end(); ++f )
+		{
+			const int c0 = m_faceCorners[f];
+			std::vector<int>::iterator out = m_triangles.begin() + m_faceTriangles[f] * 3;
+			for( int c = c0 + 1; c < m_faceCorners[f+1] - 1; ++c )
+			{
+				*out++ = m_cornerGLVertices[c0];
+				*out++ = m_cornerGLVertices[c];
+				*out++ = m_cornerGLVertices[c+1];
+			}
+		}
+	}
+
+	const std::vector<int> &m_faceCorners;
+	const std::vector<int> &m_faceTriangles;
+	const std::vector<int> &m_cornerGLVertices;
+	std::vector<int> &m_triangles;
+};
+
+// Fills vertexCorners with the face-vertices around each vertex, with
+// vertexCornerOffsets giving the start of the range for each vertex.
+void buildVertexCorners( const std::vector<int> &vertexIds, size_t numVertices, std::vector<int> &vertexCornerOffsets, std::vector<int> &vertexCorners )
+{
+	if( vertexCornerOffsets.size() )
+	{
+		// already built
+		return;
+	}
+
+	vertexCornerOffsets.resize( numVertices + 1, 0 );
+	for( std::vector<int>::const_iterator it = vertexIds.begin(); it != vertexIds.end(); ++it )
+	{
+		vertexCornerOffsets[*it+1]++;
+	}
+	for( size_t v = 0; v < numVertices; ++v )
+	{
+		vertexCornerOffsets[v+1] += vertexCornerOffsets[v];
+	}
+
+	vertexCorners.resize( vertexIds.size() );
+	std::vector<int> next( vertexCornerOffsets.begin(), vertexCornerOffsets.end() - 1 );
+	for( size_t c = 0; c < vertexIds.size(); ++c )
+	{
+		vertexCorners[next[vertexIds[c]]++] = c;
+	}
+}
+
+template<typename T>
+void copyInterpretation( const T *from, T *to )
+{
+}
+
+template<typename T>
+void copyInterpretation( const IECore::GeometricTypedData<T> *from, IECore::GeometricTypedData<T> *to )
+{
+	to->setInterpretation( from->getInterpretation() );
+}
+
+template<typename T>
+struct RemapBody
+{
+	RemapBody( const T &data, const std::vector<int> &indices, T &result )
+		:	m_data( data ), m_indices( indices ), m_result( result )
+	{
+	}
+
+	void operator()( const Range &range ) const
+	{
+		for( size_t i = range.begin(); i != range.end(); ++i )
+		{
+			m_result[i] = m_data[m_indices[i]];
+		}
+	}
+
+	const T &m_data;
+	const std::vector<int> &m_indices;
+	T &m_result;
+};
+
+// Makes a copy of some vector data, taking the element for each index.
+struct Remap
+{
+	typedef IECore::DataPtr ReturnType;
+
+	Remap( const std::vector<int> &indices )
+		:	m_indices( indices )
+	{
+	}
+
+	template<typename T>
+	ReturnType operator()( const T *data ) const
+	{
+		typename T::Ptr result = new T;
+		copyInterpretation( data, result.get() );
+		result->writable().resize( m_indices.size() );
+		tbb::parallel_for( Range( 0, m_indices.size() ), RemapBody<typename T::ValueType>( data->readable(), m_indices, result->writable() ) );
+		return result;
+	}
+
+	const std::vector<int> &m_indices;
+};
+
+} // namespace
+
+//////////////////////////////////////////////////////////////////////////
+// ToGLMeshConverter
+//////////////////////////////////////////////////////////////////////////
 
 IE_CORE_DEFINERUNTIMETYPED( ToGLMeshConverter );
 
@@ -62,68 +395,194 @@ ToGLMeshConverter::~ToGLMeshConverter()
 {
 }
 
+bool ToGLMeshConverter::requiresGLContext() const
+{
+	return false;
+}
+
 IECore::RunTimeTypedPtr ToGLMeshConverter::doConversion( IECore::ConstObjectPtr src, IECore::ConstCompoundObjectPtr operands ) const
 {
-	IECore::MeshPrimitivePtr mesh = boost::static_pointer_cast<IECore::MeshPrimitive>( src->copy() ); // safe because the parameter validated it for us
-	
-	if( !mesh->variableData<IECore::V3fVectorData>( "P", IECore::PrimitiveVariable::Vertex ) )
+	IECore::ConstMeshPrimitivePtr mesh = boost::static_pointer_cast<const IECore::MeshPrimitive>( src ); // safe because the parameter validated it for us
+
+	const IECore::V3fVectorData *pData = mesh->variableData<IECore::V3fVectorData>( "P", IECore::PrimitiveVariable::Vertex );
+	if( !pData )
 	{
 		throw IECore::Exception( "Must specify primitive variable \"P\", of type V3fVectorData and interpolation type Vertex." );
 	}
 
-	if( mesh->variables.find( "N" )==mesh->variables.end() )
+	const std::vector<int> &verticesPerFace = mesh->verticesPerFace()->readable();
+	const std::vector<int> &vertexIds = mesh->vertexIds()->readable();
+	const size_t numFaces = verticesPerFace.size();
+	const size_t numCorners = vertexIds.size();
+	const size_t numVertices = mesh->variableSize( IECore::PrimitiveVariable::Vertex );
+
+	// the first face-vertex and first triangle of each face
+	std::vector<int> faceCorners( numFaces + 1, 0 );
+	std::vector<int> faceTriangles( numFaces + 1, 0 );
+	for( size_t f = 0; f < numFaces; ++f )
+	{
+		faceCorners[f+1] = faceCorners[f] + verticesPerFace[f];
+		faceTriangles[f+1] = faceTriangles[f] + std::max( verticesPerFace[f] - 2, 0 );
+	}
+
+	std::vector<int> cornerFaces( numCorners );
+	tbb::parallel_for( Range( 0, numFaces ), CornerFaces( faceCorners, cornerFaces ) );
+
+	// the face-vertices around each vertex, built on demand
+	std::vector<int> vertexCornerOffsets;
+	std::vector<int> vertexCorners;
+
+	// choose the primitive variables to output
+
+	IECore::PrimitiveVariableMap variables;
+	for( IECore::PrimitiveVariableMap::const_iterator pIt = mesh->variables.begin(); pIt != mesh->variables.end(); ++pIt )
+	{
+		if( !pIt->second.data )
+		{
+			IECore::msg( IECore::Msg::Warning, "ToGLMeshConverter", boost::format( "No data given for primvar \"%s\"" ) % pIt->first );
+		}
+		else if( !mesh->isPrimitiveVariableValid( pIt->second ) )
+		{
+			IECore::msg( IECore::Msg::Warning, "ToGLMeshConverter", boost::format( "Primvar \"%s\" has the wrong size for its interpolation" ) % pIt->first );
+		}
+		else if(
+			pIt->second.interpolation != IECore::PrimitiveVariable::Constant &&
+			!IECore::despatchTraitsTest<IECore::TypeTraits::IsNumericBasedVectorTypedData>( pIt->second.data.get() )
+		)
+		{
+			IECore::msg( IECore::Msg::Warning, "ToGLMeshConverter", boost::format( "Primvar \"%s\" has unsupported type \"%s\"" ) % pIt->first % pIt->second.data->typeName() );
+		}
+		else
+		{
+			variables.insert( *pIt );
+		}
+	}
+
+	if( variables.find( "N" )==variables.end() )
 	{
 		// the mesh has no normals - we need to explicitly add some. if it's a polygon
 		// mesh (interpolation==linear) then we add per-face normals for a faceted look
 		// and if it's a subdivision mesh we add smooth per-vertex normals.
-		IECore::MeshNormalsOpPtr normalOp = new IECore::MeshNormalsOp();
-		normalOp->inputParameter()->setValue( mesh );
-		normalOp->copyParameter()->setTypedValue( false );
-		normalOp->interpolationParameter()->setNumericValue(
-			mesh->interpolation() == "linear" ? IECore::PrimitiveVariable::Uniform : IECore::PrimitiveVariable::Vertex
+		IECore::V3fVectorDataPtr faceNormalsData = new IECore::V3fVectorData;
+		faceNormalsData->setInterpretation( IECore::GeometricData::Normal );
+		faceNormalsData->writable().resize( numFaces );
+		tbb::parallel_for( Range( 0, numFaces ), FaceNormals( pData->readable(), vertexIds, faceCorners, faceNormalsData->writable() ) );
+
+		if( mesh->interpolation() == "linear" )
+		{
+			variables["N"] = IECore::PrimitiveVariable( IECore::PrimitiveVariable::Uniform, faceNormalsData );
+		}
+		else
+		{
+			buildVertexCorners( vertexIds, numVertices, vertexCornerOffsets, vertexCorners );
+			IECore::V3fVectorDataPtr vertexNormalsData = new IECore::V3fVectorData;
+			vertexNormalsData->setInterpretation( IECore::GeometricData::Normal );
+			vertexNormalsData->writable().resize( numVertices );
+			tbb::parallel_for( Range( 0, numVertices ), VertexNormals( faceNormalsData->readable(), cornerFaces, vertexCornerOffsets, vertexCorners, vertexNormalsData->writable() ) );
+			variables["N"] = IECore::PrimitiveVariable( IECore::PrimitiveVariable::Vertex, vertexNormalsData );
+		}
+	}
+
+	// Uniform and FaceVarying primitive variables force us to split vertices
+	// where the values differ between the faces which share them.
+
+	std::vector<SplitVariable> splitVariables;
+	for( IECore::PrimitiveVariableMap::const_iterator pIt = variables.begin(); pIt != variables.end(); ++pIt )
+	{
+		if( pIt->second.interpolation == IECore::PrimitiveVariable::Uniform || pIt->second.interpolation == IECore::PrimitiveVariable::FaceVarying )
+		{
+			SplitVariable v;
+			v.data = static_cast<const char *>( IECore::despatchTypedData<IECore::TypedDataAddress, IECore::TypeTraits::IsNumericBasedVectorTypedData>( pIt->second.data.get() ) );
+			v.elementSize = IECore::despatchTypedData<ElementSize, IECore::TypeTraits::IsNumericBasedVectorTypedData>( pIt->second.data.get() );
+			v.uniform = pIt->second.interpolation == IECore::PrimitiveVariable::Uniform;
+			splitVariables.push_back( v );
+		}
+	}
+
+	size_t numGLVertices = numVertices;
+	const std::vector<int> *cornerGLVertices = &vertexIds;
+	std::vector<int> splitCornerGLVertices, glVertexVertices, glVertexCorners, glVertexFaces;
+	if( splitVariables.size() )
+	{
+		buildVertexCorners( vertexIds, numVertices, vertexCornerOffsets, vertexCorners );
+
+		std::vector<int> cornerSplits( numCorners );
+		std::vector<char> cornerIsFirst( numCorners, 0 );
+		std::vector<int> vertexOffsets( numVertices + 1, 0 );
+		tbb::parallel_for(
+			Range( 0, numVertices ),
+			SplitVertices( splitVariables, cornerFaces, vertexCornerOffsets, vertexCorners, cornerSplits, cornerIsFirst, vertexOffsets )
 		);
-		normalOp->operate();
+
+		// turn the split counts into offsets
+		int offset = 0;
+		for( size_t v = 0; v <= numVertices; ++v )
+		{
+			const int count = vertexOffsets[v];
+			vertexOffsets[v] = offset;
+			offset += count;
+		}
+		numGLVertices = vertexOffsets[numVertices];
+
+		splitCornerGLVertices.resize( numCorners );
+		glVertexVertices.resize( numGLVertices );
+		glVertexCorners.resize( numGLVertices );
+		glVertexFaces.resize( numGLVertices );
+		tbb::parallel_for(
+			Range( 0, numCorners ),
+			AssignVertices( vertexIds, cornerFaces, cornerSplits, cornerIsFirst, vertexOffsets, splitCornerGLVertices, glVertexVertices, glVertexCorners, glVertexFaces )
+		);
+		cornerGLVertices = &splitCornerGLVertices;
 	}
-	
-	IECore::TriangulateOpPtr op = new IECore::TriangulateOp();
-	op->inputParameter()->setValue( mesh );
-	op->throwExceptionsParameter()->setTypedValue( false ); // it's better to see something than nothing
-	op->copyParameter()->setTypedValue( false );
-	op->operate();
 
-	IECore::FaceVaryingPromotionOpPtr faceVaryingOp = new IECore::FaceVaryingPromotionOp;
-	faceVaryingOp->inputParameter()->setValue( mesh );
-	faceVaryingOp->copyParameter()->setTypedValue( false );
-	faceVaryingOp->operate();
+	IECore::IntVectorDataPtr trianglesData = new IECore::IntVectorData;
+	trianglesData->writable().resize( faceTriangles[numFaces] * 3 );
+	tbb::parallel_for( Range( 0, numFaces ), Triangulate( faceCorners, faceTriangles, *cornerGLVertices, trianglesData->writable() ) );
 
-	MeshPrimitivePtr glMesh = new MeshPrimitive( mesh->vertexIds() );
+	// output the primitive variables, with one value per GL vertex
 
-	for ( IECore::PrimitiveVariableMap::iterator pIt = mesh->variables.begin(); pIt != mesh->variables.end(); ++pIt )
+	MeshPrimitivePtr glMesh = new MeshPrimitive( trianglesData, numGLVertices );
+
+	IECore::PrimitiveVariableMap glVariables;
+	for( IECore::PrimitiveVariableMap::const_iterator pIt = variables.begin(); pIt != variables.end(); ++pIt )
 	{
-		if ( pIt->second.data )
+		IECore::PrimitiveVariable glVariable( IECore::PrimitiveVariable::Vertex, pIt->second.data );
+		if( pIt->second.interpolation == IECore::PrimitiveVariable::Constant )
 		{
-			glMesh->addPrimitiveVariable( pIt->first, pIt->second );
+			glVariable = pIt->second;
 		}
-		else
+		else if( splitVariables.size() )
 		{
-			IECore::msg( IECore::Msg::Warning, "ToGLMeshConverter", boost::format( "No data given for primvar \"%s\"" ) % pIt->first );
+			const std::vector<int> *indices = &glVertexVertices;
+			if( pIt->second.interpolation == IECore::PrimitiveVariable::FaceVarying )
+			{
+				indices = &glVertexCorners;
+			}
+			else if( pIt->second.interpolation == IECore::PrimitiveVariable::Uniform )
+			{
+				indices = &glVertexFaces;
+			}
+			Remap remap( *indices );
+			glVariable.data = IECore::despatchTypedData<Remap, IECore::TypeTraits::IsNumericBasedVectorTypedData>( pIt->second.data.get(), remap );
 		}
+
+		glMesh->addPrimitiveVariable( pIt->first, glVariable );
+		glVariables[pIt->first] = glVariable;
 	}
 
-	IECore::PrimitiveVariableMap::const_iterator sIt = mesh->variables.find( "s" );
-	IECore::PrimitiveVariableMap::const_iterator tIt = mesh->variables.find( "t" );
-	if ( sIt != mesh->variables.end() && tIt != mesh->variables.end() )
+	IECore::PrimitiveVariableMap::const_iterator sIt = glVariables.find( "s" );
+	IECore::PrimitiveVariableMap::const_iterator tIt = glVariables.find( "t" );
+	if ( sIt != glVariables.end() && tIt != glVariables.end() )
 	{
 		if ( sIt->second.interpolation != IECore::PrimitiveVariable::Constant  
-			&&  tIt->second.interpolation != IECore::PrimitiveVariable::Constant
-			&& sIt->second.interpolation == tIt->second.interpolation )
+			&&  tIt->second.interpolation != IECore::PrimitiveVariable::Constant )
 		{
 			IECore::ConstFloatVectorDataPtr s = IECore::runTimeCast< const IECore::FloatVectorData >( sIt->second.data );
 			IECore::ConstFloatVectorDataPtr t = IECore::runTimeCast< const IECore::FloatVectorData >( tIt->second.data );
 
 			if ( s && t )
 			{
-				/// Should hold true if primvarsAreValid
+				/// Should hold true as both have a value per GL vertex
 				assert( s->readable().size() == t->readable().size() );
 
 				IECore::V2fVectorDataPtr stData = new IECore::V2fVectorData();
@@ -133,11 +592,11 @@ IECore::RunTimeTypedPtr ToGLMeshConverter::doConversion( IECore::ConstObjectPtr
 				{
 					stData->writable()[i] = Imath::V2f( s->readable()[i], t->readable()[i] );
 				}
-				glMesh->addPrimitiveVariable( "st", IECore::PrimitiveVariable( sIt->second.interpolation, stData ) );
+				glMesh->addPrimitiveVariable( "st", IECore::PrimitiveVariable( IECore::PrimitiveVariable::Vertex, stData ) );
 			}
 			else
 			{
-				IECore::msg( IECore::Msg::Warning, "ToGLMeshConverter", "If specified, primitive variables \"s\" and \"t\" must be of type FloatVectorData and interpolation type FaceVarying." );
+				IECore::msg( IECore::Msg::Warning, "ToGLMeshConverter", "If specified, primitive variables \"s\" and \"t\" must be of type FloatVectorData." );
 			}
 		}
 		else
@@ -145,7 +604,7 @@ IECore::RunTimeTypedPtr ToGLMeshConverter::doConversion( IECore::ConstObjectPtr
 			IECore::msg( IECore::Msg::Warning, "ToGLMeshConverter", "If specified, primitive variables \"s\" and \"t\" must be of type FloatVectorData and non-Constant interpolation type." );
 		}
 	}
-	else if ( sIt != mesh->variables.end() || tIt != mesh->variables.end() )
+	else if ( sIt != glVariables.end() || tIt != glVariables.end() )
 	{
 		IECore::msg( IECore::Msg::Warning, "ToGLMeshConverter", "Primitive variable \"s\" or \"t\" found, but not both." );
 	}
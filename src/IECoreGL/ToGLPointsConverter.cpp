@@ -56,6 +56,11 @@ ToGLPointsConverter::~ToGLPointsConverter()
 {
 }
 
+bool ToGLPointsConverter::requiresGLContext() const
+{
+	return false;
+}
+
 IECore::RunTimeTypedPtr ToGLPointsConverter::doConversion( IECore::ConstObjectPtr src, IECore::ConstCompoundObjectPtr operands ) const
 {
 	IECore::PointsPrimitive::ConstPtr pointsPrim = boost::static_pointer_cast<const IECore::PointsPrimitive>( src ); // safe because the parameter validated it for us
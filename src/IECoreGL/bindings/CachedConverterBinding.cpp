@@ -50,11 +50,25 @@ static IECore::RunTimeTypedPtr convert( CachedConverter &c, IECore::ObjectPtr o
 	return boost::const_pointer_cast<IECore::RunTimeTyped>( c.convert( o.get() ) );
 }
 
+static IECore::RunTimeTypedPtr convertAsync( CachedConverter &c, IECore::ObjectPtr o )
+{
+	IECorePython::ScopedGILRelease gilRelease;
+	return boost::const_pointer_cast<IECore::RunTimeTyped>( c.convertAsync( o.get() ) );
+}
+
+static size_t processPendingConversions( CachedConverter &c, double timeBudget )
+{
+	IECorePython::ScopedGILRelease gilRelease;
+	return c.processPendingConversions( timeBudget );
+}
+
 void IECoreGL::bindCachedConverter()
 {
 	IECorePython::RefCountedClass<CachedConverter, IECore::RefCounted>( "CachedConverter" )
 		.def( init<size_t>() )
 		.def( "convert", &convert )
+		.def( "convertAsync", &convertAsync )
+		.def( "processPendingConversions", &processPendingConversions )
 		.def( "getMaxMemory", &CachedConverter::getMaxMemory )
 		.def( "setMaxMemory", &CachedConverter::setMaxMemory )
 		.def( "clearUnused", &CachedConverter::clearUnused )
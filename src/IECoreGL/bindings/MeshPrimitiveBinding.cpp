@@ -44,9 +44,15 @@ using namespace boost::python;
 namespace IECoreGL
 {
 
+static IECore::IntVectorDataPtr vertexIds( const MeshPrimitive &m )
+{
+	return m.vertexIds()->copy();
+}
+
 void bindMeshPrimitive()
 {
 	IECorePython::RunTimeTypedClass<MeshPrimitive>()
+		.def( "vertexIds", &vertexIds )
 	;
 }
 
@@ -47,10 +47,22 @@ using namespace boost::python;
 namespace IECoreGL
 {
 
+static IECore::DataPtr vertexAttribute( const Primitive &p, const std::string &name )
+{
+	IECore::ConstDataPtr d = p.vertexAttribute( name );
+	if( !d )
+	{
+		return 0;
+	}
+	return d->copy();
+}
+
 void bindPrimitive()
 {
 	scope s = IECorePython::RunTimeTypedClass<Primitive>()
 		.def( "addPrimitiveVariable", &Primitive::addPrimitiveVariable )
+		.def( "vertexAttribute", &vertexAttribute )
+		.def( "uploadBuffers", &Primitive::uploadBuffers )
 	;
 	bindTypedStateComponent< Primitive::DrawBound >( "DrawBound" );
 	bindTypedStateComponent< Primitive::DrawWireframe >( "DrawWireframe" );
@@ -39,6 +39,7 @@
 #include "IECorePython/CurvesPrimitiveEvaluatorBinding.h"
 #include "IECorePython/RunTimeTypedBinding.h"
 #include "IECorePython/RefCountedBinding.h"
+#include "IECorePython/ScopedGILRelease.h"
 
 using namespace IECore;
 using namespace boost::python;
@@ -50,9 +51,16 @@ namespace IECorePython
 static bool pointAtV( const CurvesPrimitiveEvaluator &e, unsigned curveIndex, float v, PrimitiveEvaluator::Result *r )
 {
 	e.validateResult( r );
+	ScopedGILRelease gilRelease;
 	return e.pointAtV( curveIndex, v, r );
 }
 
+static float curveLength( const CurvesPrimitiveEvaluator &e, unsigned curveIndex, float vStart, float vEnd )
+{
+	ScopedGILRelease gilRelease;
+	return e.curveLength( curveIndex, vStart, vEnd );
+}
+
 static IntVectorDataPtr verticesPerCurve( const CurvesPrimitiveEvaluator &e )
 {
 	return new IntVectorData( e.verticesPerCurve() );
@@ -73,7 +81,7 @@ void bindCurvesPrimitiveEvaluator()
 	scope s = RunTimeTypedClass<CurvesPrimitiveEvaluator>()
 		.def( init<CurvesPrimitivePtr>() )
 		.def( "pointAtV", &pointAtV )
-		.def( "curveLength", &CurvesPrimitiveEvaluator::curveLength,
+		.def( "curveLength", &curveLength,
 			(
 				arg( "curveIndex" ),
 				arg( "vStart" ) = 0.0f,
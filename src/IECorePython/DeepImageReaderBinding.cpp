@@ -61,6 +61,7 @@ void bindDeepImageReader()
 		.def( "worldToCameraMatrix", &DeepImageReader::worldToCameraMatrix )
 		.def( "worldToNDCMatrix", &DeepImageReader::worldToNDCMatrix )
 		.def( "readPixel", &DeepImageReader::readPixel, ( arg_( "x" ), arg_( "y" ) ) )
+		.def( "readTile", &DeepImageReader::readTile, ( arg_( "window" ) ) )
 	;
 }
 
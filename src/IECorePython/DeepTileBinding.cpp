@@ -0,0 +1,159 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2014, Image Engine Design Inc. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+//     * Neither the name of Image Engine Design nor the names of any
+//       other contributors to this software may be used to endorse or
+//       promote products derived from this software without specific prior
+//       written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#include "boost/python.hpp" // this include /must/ come first!
+
+#include "boost/format.hpp"
+#include "boost/python/suite/indexing/container_utils.hpp"
+
+#include "IECore/DeepTile.h"
+#include "IECore/VectorTypedData.h"
+#include "IECorePython/RefCountedBinding.h"
+
+using namespace boost::python;
+using namespace IECore;
+
+namespace IECorePython
+{
+
+struct DeepTileHelper
+{
+	static DeepTilePtr constructor( const Imath::Box2i &window, object names )
+	{
+		std::vector<std::string> channelNames;
+		container_utils::extend_container( channelNames, names );
+		
+		return new DeepTile( window, channelNames );
+	}
+	
+	static tuple channelNames( ConstDeepTilePtr tile )
+	{
+		list result;
+		
+		const std::vector<std::string> &names = tile->channelNames();
+		for ( std::vector<std::string>::const_iterator it=names.begin(); it != names.end(); ++it )
+		{
+			result.append( *it );
+		}
+
+		return tuple( result );
+	}
+	
+	static void setSampleCounts( DeepTilePtr tile, object sampleCounts )
+	{
+		std::vector<unsigned> counts;
+		container_utils::extend_container( counts, sampleCounts );
+		
+		tile->setSampleCounts( counts );
+	}
+	
+	static unsigned checkPixelIndex( ConstDeepTilePtr tile, unsigned pixelIndex )
+	{
+		if ( pixelIndex >= tile->numPixels() )
+		{
+			PyErr_SetString( PyExc_IndexError, "Index out of range" );
+			throw_error_already_set();
+		}
+		
+		return pixelIndex;
+	}
+	
+	static unsigned sampleCount( ConstDeepTilePtr tile, unsigned pixelIndex )
+	{
+		return tile->sampleCount( checkPixelIndex( tile, pixelIndex ) );
+	}
+	
+	static unsigned sampleOffset( ConstDeepTilePtr tile, unsigned pixelIndex )
+	{
+		return tile->sampleOffset( checkPixelIndex( tile, pixelIndex ) );
+	}
+	
+	static FloatVectorDataPtr depths( ConstDeepTilePtr tile )
+	{
+		return new FloatVectorData( tile->depths() );
+	}
+	
+	static void setSamples( std::vector<float> &samples, ConstFloatVectorDataPtr data )
+	{
+		if ( data->readable().size() != samples.size() )
+		{
+			PyErr_SetString( PyExc_ValueError, ( boost::format( "Data must contain %d samples" ) % samples.size() ).str().c_str() );
+			throw_error_already_set();
+		}
+		
+		samples = data->readable();
+	}
+	
+	static void setDepths( DeepTilePtr tile, ConstFloatVectorDataPtr data )
+	{
+		setSamples( tile->depths(), data );
+	}
+	
+	static FloatVectorDataPtr channelData( ConstDeepTilePtr tile, unsigned channelIndex )
+	{
+		return new FloatVectorData( tile->channelData( channelIndex ) );
+	}
+	
+	static void setChannelData( DeepTilePtr tile, unsigned channelIndex, ConstFloatVectorDataPtr data )
+	{
+		setSamples( tile->channelData( channelIndex ), data );
+	}
+};
+
+void bindDeepTile()
+{
+	RefCountedClass<DeepTile, RefCounted>( "DeepTile" )
+		.def( "__init__", make_constructor( &DeepTileHelper::constructor, default_call_policies(), ( boost::python::arg_( "window" ), boost::python::arg_( "channelNames" ) ) ) )
+		.def( "window", &DeepTile::window, return_value_policy<copy_const_reference>() )
+		.def( "numPixels", &DeepTile::numPixels )
+		.def( "pixelIndex", &DeepTile::pixelIndex )
+		.def( "numChannels", &DeepTile::numChannels )
+		.def( "channelIndex", &DeepTile::channelIndex )
+		.def( "channelNames", &DeepTileHelper::channelNames )
+		.def( "setSampleCounts", &DeepTileHelper::setSampleCounts )
+		.def( "numSamples", &DeepTile::numSamples )
+		.def( "sampleCount", &DeepTileHelper::sampleCount )
+		.def( "sampleOffset", &DeepTileHelper::sampleOffset )
+		.def( "depths", &DeepTileHelper::depths )
+		.def( "setDepths", &DeepTileHelper::setDepths )
+		.def( "channelData", &DeepTileHelper::channelData )
+		.def( "setChannelData", &DeepTileHelper::setChannelData )
+		.def( "pixel", &DeepTile::pixel )
+		.def( "sortSamples", &DeepTile::sortSamples )
+		.def( "merge", &DeepTile::merge )
+		.def( "composite", &DeepTile::composite )
+	;
+}
+
+} // namespace IECorePython
@@ -62,12 +62,12 @@ IECOREPYTHON_DEFINEVECTORDATASTRSPECIALISATION( Box3d )
 
 void bindImathBoxVectorTypedData()
 {
-	BIND_VECTOR_TYPEDDATA ( Box< V2i >, "Box2i")
-	BIND_VECTOR_TYPEDDATA ( Box< V2f >, "Box2f")
-	BIND_VECTOR_TYPEDDATA ( Box< V2d >, "Box2d")
-	BIND_VECTOR_TYPEDDATA ( Box< V3i >, "Box3i")
-	BIND_VECTOR_TYPEDDATA ( Box< V3f >, "Box3f")
-	BIND_VECTOR_TYPEDDATA ( Box< V3d >, "Box3d")
+	BIND_BUFFERED_VECTOR_TYPEDDATA ( Box< V2i >, "Box2i")
+	BIND_BUFFERED_VECTOR_TYPEDDATA ( Box< V2f >, "Box2f")
+	BIND_BUFFERED_VECTOR_TYPEDDATA ( Box< V2d >, "Box2d")
+	BIND_BUFFERED_VECTOR_TYPEDDATA ( Box< V3i >, "Box3i")
+	BIND_BUFFERED_VECTOR_TYPEDDATA ( Box< V3f >, "Box3f")
+	BIND_BUFFERED_VECTOR_TYPEDDATA ( Box< V3d >, "Box3d")
 }
 
 } // namespace IECorePython
@@ -42,16 +42,20 @@
 #include "IECore/IndexedIO.h"
 #include "IECore/FileIndexedIO.h"
 #include "IECore/MemoryIndexedIO.h"
+#include "IECore/BlobStore.h"
 #include "IECore/VectorTypedData.h"
 #include "IECore/SimpleTypedData.h"
 
 #include "IECorePython/RunTimeTypedBinding.h"
+#include "IECorePython/RefCountedBinding.h"
 #include "IECorePython/IECoreBinding.h"
+#include "IECorePython/ScopedGILRelease.h"
 
 using namespace boost::python;
 using namespace IECore;
 
 void bindIndexedIOBase();
+void bindBlobStore();
 void bindStreamIndexedIO();
 void bindFileIndexedIO();
 void bindMemoryIndexedIO();
@@ -59,6 +63,7 @@ void bindMemoryIndexedIO();
 void bindIndexedIO()
 {
 	bindIndexedIOBase();
+	bindBlobStore();
 	bindStreamIndexedIO();
 	bindFileIndexedIO();
 	bindMemoryIndexedIO();
@@ -93,6 +98,7 @@ struct IndexedIOHelper
 	template< typename T, typename P >
 	static typename T::Ptr constructorAtRoot( P firstParam, IndexedIO::OpenMode mode )
 	{
+		IECorePython::ScopedGILRelease gilRelease;
 		return new T( firstParam, IndexedIO::rootPath, mode );
 	}
 
@@ -101,11 +107,13 @@ struct IndexedIOHelper
 	{
 		IndexedIO::EntryIDList rootPath;
 		IndexedIOHelper::listToEntryIds( root, rootPath );
+		IECorePython::ScopedGILRelease gilRelease;
 		return new T( firstParam, rootPath, mode );
 	}
 
 	static IndexedIOPtr createAtRoot( const std::string &path, IndexedIO::OpenMode mode)
 	{
+		IECorePython::ScopedGILRelease gilRelease;
 		return IndexedIO::create( path, IndexedIO::rootPath, mode );
 	}
 
@@ -113,6 +121,7 @@ struct IndexedIOHelper
 	{
 		IndexedIO::EntryIDList rootPath;
 		IndexedIOHelper::listToEntryIds( root, rootPath );
+		IECorePython::ScopedGILRelease gilRelease;
 		return IndexedIO::create( path, rootPath, mode );
 	}
 
@@ -127,6 +136,7 @@ struct IndexedIOHelper
 	{
 		IndexedIO::EntryIDList path;
 		IndexedIOHelper::listToEntryIds( l, path );
+		IECorePython::ScopedGILRelease gilRelease;
 		return p->directory(path, missingBehaviour);
 	}
 
@@ -134,7 +144,10 @@ struct IndexedIOHelper
 	{
 		assert(p);
 		IndexedIO::EntryIDList l;
-		p->entryIds(l);
+		{
+			IECorePython::ScopedGILRelease gilRelease;
+			p->entryIds(l);
+		}
 		return IndexedIOHelper::entryIDsToList( l );
 	}
 
@@ -142,7 +155,10 @@ struct IndexedIOHelper
 	{
 		assert(p);
 		IndexedIO::EntryIDList l;
-		p->entryIds(l, type);
+		{
+			IECorePython::ScopedGILRelease gilRelease;
+			p->entryIds(l, type);
+		}
 		return IndexedIOHelper::entryIDsToList( l );
 	}
 	
@@ -165,6 +181,7 @@ struct IndexedIOHelper
 	{
 		assert(p);
 
+		IECorePython::ScopedGILRelease gilRelease;
 		const typename T::value_type *data = &(x->readable())[0];
 		p->write( name, data, (unsigned long)x->readable().size() );
 	}
@@ -193,60 +210,70 @@ struct IndexedIOHelper
 	{
 		assert(p);
 
+		DataPtr data;
+		{
+			IECorePython::ScopedGILRelease gilRelease;
+			data = readData( p, name );
+		}
+		return object( data );
+	}
+
+	static DataPtr readData(IndexedIOPtr p, const IndexedIO::EntryID &name)
+	{
 		IndexedIO::Entry entry = p->entry(name);
 
 		switch( entry.dataType() )
 		{
 			case IndexedIO::Float:
-				return object( readSingle<float>(p, name, entry) );
+				return readSingle<float>(p, name, entry);
 			case IndexedIO::Double:
-				return object( readSingle<double>(p, name, entry) );
+				return readSingle<double>(p, name, entry);
 			case IndexedIO::Int:
-				return object( readSingle<int>(p, name, entry) );
+				return readSingle<int>(p, name, entry);
 			case IndexedIO::Long:
-				return object( readSingle<int>(p, name, entry) );
+				return readSingle<int>(p, name, entry);
 			case IndexedIO::String:
-				return object( readSingle<std::string>(p, name, entry) );
+				return readSingle<std::string>(p, name, entry);
 			case IndexedIO::StringArray:
-				return object( readArray<std::string>(p, name, entry) );
+				return readArray<std::string>(p, name, entry);
 			case IndexedIO::FloatArray:
-				return object( readArray<float>(p, name, entry) );
+				return readArray<float>(p, name, entry);
 			case IndexedIO::DoubleArray:
-				return object( readArray<double>(p, name, entry) );
+				return readArray<double>(p, name, entry);
 			case IndexedIO::IntArray:
-				return object( readArray<int>(p, name, entry) );
+				return readArray<int>(p, name, entry);
 			case IndexedIO::LongArray:
-				return object( readArray<int>(p, name, entry) );
+				return readArray<int>(p, name, entry);
 			case IndexedIO::UInt:
-				return object( readSingle<unsigned int>(p, name, entry) );
+				return readSingle<unsigned int>(p, name, entry);
 			case IndexedIO::UIntArray:
-				return object( readArray<unsigned int>(p, name, entry) );
+				return readArray<unsigned int>(p, name, entry);
 			case IndexedIO::Char:
-				return object( readSingle<char>(p, name, entry) );
+				return readSingle<char>(p, name, entry);
 			case IndexedIO::CharArray:
-				return object( readArray<char>(p, name, entry) );
+				return readArray<char>(p, name, entry);
 			case IndexedIO::UChar:
-				return object( readSingle<unsigned char>(p, name, entry) );
+				return readSingle<unsigned char>(p, name, entry);
 			case IndexedIO::UCharArray:
-				return object( readArray<unsigned char>(p, name, entry) );
+				return readArray<unsigned char>(p, name, entry);
 			case IndexedIO::Short:
-				return object( readSingle<short>(p, name, entry) );
+				return readSingle<short>(p, name, entry);
 			case IndexedIO::ShortArray:
-				return object( readArray<short>(p, name, entry) );
+				return readArray<short>(p, name, entry);
 			case IndexedIO::UShort:
-				return object( readSingle<unsigned short>(p, name, entry) );
+				return readSingle<unsigned short>(p, name, entry);
 			case IndexedIO::UShortArray:
-				return object( readArray<unsigned short>(p, name, entry) );
+				return readArray<unsigned short>(p, name, entry);
 			case IndexedIO::Int64:
-				return object( readSingle<int64_t>(p, name, entry) );
+				return readSingle<int64_t>(p, name, entry);
 			case IndexedIO::Int64Array:
-				return object( readArray<int64_t>(p, name, entry) );
+				return readArray<int64_t>(p, name, entry);
 			case IndexedIO::UInt64:
-				return object( readSingle<uint64_t>(p, name, entry) );
+				return readSingle<uint64_t>(p, name, entry);
 			case IndexedIO::UInt64Array:
-				return object( readArray<uint64_t>(p, name, entry) );		
+				return readArray<uint64_t>(p, name, entry);		
 			case IndexedIO::InternedStringArray:
-				return object( readArray<InternedString>(p, name, entry) );
+				return readArray<InternedString>(p, name, entry);
 			default:
 				throw IOException(name);
 		}
@@ -256,6 +283,7 @@ struct IndexedIOHelper
 	{
 		assert(p);
 
+		IECorePython::ScopedGILRelease gilRelease;
 		std::string x;
 		p->read(name, x);
 		return x;
@@ -405,9 +433,72 @@ void bindIndexedIOBase()
 
 }
 
+static MurmurHash blobStoreWrite( BlobStore &store, ConstCharVectorDataPtr data )
+{
+	IECorePython::ScopedGILRelease gilRelease;
+	const std::vector<char> &d = data->readable();
+	return store.write( d.size() ? &d[0] : 0, d.size() );
+}
+
+static CharVectorDataPtr blobStoreRead( const BlobStore &store, const MurmurHash &hash )
+{
+	CharVectorDataPtr result = new CharVectorData;
+	IECorePython::ScopedGILRelease gilRelease;
+	std::vector<char> &d = result->writable();
+	d.resize( store.size( hash ) );
+	if ( d.size() )
+	{
+		store.read( hash, &d[0], d.size() );
+	}
+	return result;
+}
+
+static tuple blobStoreStats( const BlobStore &store )
+{
+	size_t numPacked, numLoose;
+	store.stats( numPacked, numLoose );
+	return make_tuple( numPacked, numLoose );
+}
+
+void bindBlobStore()
+{
+	IECorePython::RefCountedClass<BlobStore, RefCounted>( "BlobStore" )
+		.def( "open", &BlobStore::open ).staticmethod( "open" )
+		.def( "directory", &BlobStore::directory, return_value_policy<copy_const_reference>() )
+		.def( "write", &blobStoreWrite )
+		.def( "read", &blobStoreRead )
+		.def( "contains", &BlobStore::contains )
+		.def( "size", &BlobStore::size )
+		.def( "repack", &BlobStore::repack )
+		.def( "stats", &blobStoreStats )
+	;
+}
+
+static BlobStorePtr getBlobStore( const StreamIndexedIO &io )
+{
+	return io.getBlobStore();
+}
+
 void bindStreamIndexedIO()
 {
-	IECorePython::RunTimeTypedClass<StreamIndexedIO>();
+	IECorePython::RunTimeTypedClass<StreamIndexedIO> streamIndexedIOClass;
+	{
+		scope s( streamIndexedIOClass );
+
+		enum_< StreamIndexedIO::DataCompression >( "DataCompression" )
+			.value( "Uncompressed", StreamIndexedIO::Uncompressed )
+			.value( "GzipCompression", StreamIndexedIO::GzipCompression )
+			.value( "FastCompression", StreamIndexedIO::FastCompression )
+			.export_values()
+		;
+	}
+
+	streamIndexedIOClass
+		.def( "setDataCompression", &StreamIndexedIO::setDataCompression, ( arg( "compression" ), arg( "shuffle" ) = true ) )
+		.def( "getDataCompression", &StreamIndexedIO::getDataCompression )
+		.def( "setBlobStore", &StreamIndexedIO::setBlobStore, ( arg( "store" ), arg( "minSize" ) = 4096 ) )
+		.def( "getBlobStore", &getBlobStore )
+	;
 }
 
 void bindFileIndexedIO()
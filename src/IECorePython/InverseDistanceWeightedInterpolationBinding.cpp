@@ -45,6 +45,7 @@
 #include "IECore/VectorTypedData.h"
 
 #include "IECorePython/InverseDistanceWeightedInterpolationBinding.h"
+#include "IECorePython/ScopedGILRelease.h"
 
 using namespace boost::python;
 using namespace IECore;
@@ -119,10 +120,9 @@ struct InverseDistanceWeightedInterpolationWrapper
 		
 		v.resize( p.size() );
 		
-		typename T::NeighbourVector neighbours;
-		for( unsigned i=0; i<p.size(); i++ )
 		{
-			v[i] = (*m_idw)( p[i], neighbours );
+			ScopedGILRelease gilRelease;
+			(*m_idw)( p.begin(), p.end(), v.begin() );
 		}
 		
 		return resultData;
@@ -38,6 +38,7 @@
 #include "IECorePython/MeshPrimitiveEvaluatorBinding.h"
 #include "IECorePython/RunTimeTypedBinding.h"
 #include "IECorePython/RefCountedBinding.h"
+#include "IECorePython/ScopedGILRelease.h"
 
 using namespace IECore;
 using namespace boost::python;
@@ -46,23 +47,62 @@ using namespace IECore;
 namespace IECorePython
 {
 
+static MeshPrimitiveEvaluatorPtr constructor( MeshPrimitivePtr mesh, MeshPrimitiveEvaluator::Accelerator accelerator )
+{
+	ScopedGILRelease gilRelease;
+	return new MeshPrimitiveEvaluator( mesh, accelerator );
+}
+
 static bool barycentricPosition( const MeshPrimitiveEvaluator &e, unsigned int t, const Imath::V3f &b, PrimitiveEvaluator::Result *r )
 {
 	e.validateResult( r );
 	return e.barycentricPosition( t, b, r );
 }
 
+static tuple closestPoints( const MeshPrimitiveEvaluator &e, ConstV3fVectorDataPtr points )
+{
+	IntVectorDataPtr triangleIndices = new IntVectorData;
+	V3fVectorDataPtr barycentricCoordinates = new V3fVectorData;
+	V3fVectorDataPtr positions = new V3fVectorData;
+	V3fVectorDataPtr normals = new V3fVectorData;
+	{
+		ScopedGILRelease gilRelease;
+		e.closestPoints( points->readable(), triangleIndices->writable(), barycentricCoordinates->writable(), &positions->writable(), &normals->writable() );
+	}
+	return make_tuple( triangleIndices, barycentricCoordinates, positions, normals );
+}
+
+static tuple nearestIntersections( const MeshPrimitiveEvaluator &e, ConstV3fVectorDataPtr origins, ConstV3fVectorDataPtr directions, float maxDistance )
+{
+	IntVectorDataPtr triangleIndices = new IntVectorData;
+	V3fVectorDataPtr barycentricCoordinates = new V3fVectorData;
+	V3fVectorDataPtr positions = new V3fVectorData;
+	V3fVectorDataPtr normals = new V3fVectorData;
+	{
+		ScopedGILRelease gilRelease;
+		e.nearestIntersections( origins->readable(), directions->readable(), triangleIndices->writable(), barycentricCoordinates->writable(), &positions->writable(), &normals->writable(), maxDistance );
+	}
+	return make_tuple( triangleIndices, barycentricCoordinates, positions, normals );
+}
+
 void bindMeshPrimitiveEvaluator()
 {
 	object m = RunTimeTypedClass<MeshPrimitiveEvaluator>()
-		.def( init< MeshPrimitivePtr > () )
+		.def( "__init__", make_constructor( &constructor, default_call_policies(), ( arg( "mesh" ), arg( "accelerator" ) = MeshPrimitiveEvaluator::KDTreeAccelerator ) ) )
 		.def( "barycentricPosition", &barycentricPosition )
 		.def( "uvBound", &MeshPrimitiveEvaluator::uvBound )	
+		.def( "closestPoints", &closestPoints )
+		.def( "nearestIntersections", &nearestIntersections, ( arg( "origins" ), arg( "directions" ), arg( "maxDistance" ) = Imath::limits<float>::max() ) )
 	;
 
 	{
 		scope ms( m );
 
+		enum_<MeshPrimitiveEvaluator::Accelerator>( "Accelerator" )
+			.value( "KDTree", MeshPrimitiveEvaluator::KDTreeAccelerator )
+			.value( "BVH", MeshPrimitiveEvaluator::BVHAccelerator )
+		;
+
 		RefCountedClass<MeshPrimitiveEvaluator::Result, PrimitiveEvaluator::Result>( "Result" )
 			.def( "triangleIndex", &MeshPrimitiveEvaluator::Result::triangleIndex )
 			.def( "barycentricCoordinates", &MeshPrimitiveEvaluator::Result::barycentricCoordinates, return_value_policy<copy_const_reference>() )
@@ -37,6 +37,7 @@
 #include "IECore/PrimitiveEvaluator.h"
 #include "IECorePython/PrimitiveEvaluatorBinding.h"
 #include "IECorePython/RunTimeTypedBinding.h"
+#include "IECorePython/ScopedGILRelease.h"
 
 using namespace IECore;
 using namespace boost::python;
@@ -54,12 +55,14 @@ struct PrimitiveEvaluatorHelper
 			PyErr_SetString( PyExc_ValueError, "Null primitive" );
 			throw_error_already_set();
 		}
+		ScopedGILRelease gilRelease;
 		return PrimitiveEvaluator::create( primitive );
 	}
 
 	static float signedDistance( PrimitiveEvaluator &evaluator, const Imath::V3f &p )
 	{
 
+		ScopedGILRelease gilRelease;
 		float distance = 0.0;
 		bool success = evaluator.signedDistance( p, distance );
 
@@ -74,6 +77,7 @@ struct PrimitiveEvaluatorHelper
 	{
 		evaluator.validateResult( result );
 
+		ScopedGILRelease gilRelease;
 		return evaluator.closestPoint( p, result );
 	}
 
@@ -81,6 +85,7 @@ struct PrimitiveEvaluatorHelper
 	{
 		evaluator.validateResult( result );
 
+		ScopedGILRelease gilRelease;
 		return evaluator.pointAtUV( uv, result );
 	}
 
@@ -88,6 +93,7 @@ struct PrimitiveEvaluatorHelper
 	{
 		evaluator.validateResult( result );
 
+		ScopedGILRelease gilRelease;
 		return evaluator.intersectionPoint( origin, direction, result );
 	}
 
@@ -95,13 +101,17 @@ struct PrimitiveEvaluatorHelper
 	{
 		evaluator.validateResult( result );
 
+		ScopedGILRelease gilRelease;
 		return evaluator.intersectionPoint( origin, direction, result, maxDist );
 	}
 
 	static list intersectionPoints( PrimitiveEvaluator& evaluator, const Imath::V3f &origin, const Imath::V3f &direction )
 	{
 		std::vector< PrimitiveEvaluator::ResultPtr > results;
-		evaluator.intersectionPoints( origin, direction, results );
+		{
+			ScopedGILRelease gilRelease;
+			evaluator.intersectionPoints( origin, direction, results );
+		}
 
 		list result;
 
@@ -116,7 +126,10 @@ struct PrimitiveEvaluatorHelper
 	static list intersectionPoints( PrimitiveEvaluator& evaluator, const Imath::V3f &origin, const Imath::V3f &direction, float maxDistance )
 	{
 		std::vector< PrimitiveEvaluator::ResultPtr > results;
-		evaluator.intersectionPoints( origin, direction, results, maxDistance );
+		{
+			ScopedGILRelease gilRelease;
+			evaluator.intersectionPoints( origin, direction, results, maxDistance );
+		}
 
 		list result;
 
@@ -133,6 +146,24 @@ struct PrimitiveEvaluatorHelper
 		return evaluator.primitive()->copy();
 	}
 
+	static float volume( PrimitiveEvaluator &evaluator )
+	{
+		ScopedGILRelease gilRelease;
+		return evaluator.volume();
+	}
+
+	static Imath::V3f centerOfGravity( PrimitiveEvaluator &evaluator )
+	{
+		ScopedGILRelease gilRelease;
+		return evaluator.centerOfGravity();
+	}
+
+	static float surfaceArea( PrimitiveEvaluator &evaluator )
+	{
+		ScopedGILRelease gilRelease;
+		return evaluator.surfaceArea();
+	}
+
 };
 
 static object primVar( PrimitiveEvaluator::Result &r, PrimitiveVariable &v )
@@ -182,9 +213,9 @@ void bindPrimitiveEvaluator()
 		.def( "intersectionPoints", intersectionPoints )
 		.def( "intersectionPoints", intersectionPointsMaxDist )
 		.def( "primitive", &PrimitiveEvaluatorHelper::primitive )
-		.def( "volume", &PrimitiveEvaluator::volume )
-		.def( "centerOfGravity", &PrimitiveEvaluator::centerOfGravity )
-		.def( "surfaceArea", &PrimitiveEvaluator::surfaceArea )
+		.def( "volume", &PrimitiveEvaluatorHelper::volume )
+		.def( "centerOfGravity", &PrimitiveEvaluatorHelper::centerOfGravity )
+		.def( "surfaceArea", &PrimitiveEvaluatorHelper::surfaceArea )
 	;
 
 	{
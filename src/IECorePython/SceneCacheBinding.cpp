@@ -38,6 +38,9 @@
 
 #include "IECore/SceneCache.h"
 #include "IECorePython/RunTimeTypedBinding.h"
+#include "IECorePython/IECoreBinding.h"
+#include "IECorePython/SceneInterfaceBinding.h"
+#include "IECorePython/ScopedGILRelease.h"
 
 using namespace boost::python;
 using namespace IECore;
@@ -47,19 +50,116 @@ namespace IECorePython
 
 static SceneCachePtr constructor( const std::string &fileName, IndexedIO::OpenMode mode )
 {
+	ScopedGILRelease gilRelease;
 	return new SceneCache( fileName, mode );
 }
 
 static SceneCachePtr constructor2( IECore::IndexedIOPtr indexedIO )
 {
+	ScopedGILRelease gilRelease;
 	return new SceneCache( indexedIO );
 }
 
+static void finalise( SceneCache &m )
+{
+	ScopedGILRelease gilRelease;
+	m.finalise();
+}
+
+static SceneCache::PrefetchPtr prefetch( const SceneCache &m, list pathList, double time, int what )
+{
+	std::vector<SceneInterface::Path> paths( IECorePython::len( pathList ) );
+	for ( size_t i = 0; i < paths.size(); i++ )
+	{
+		listToSceneInterfaceNameList( extract<list>( pathList[i] ), paths[i] );
+	}
+	return m.prefetch( paths, time, what );
+}
+
+static void setProxyVertexBudgets( SceneCache &m, list budgetList )
+{
+	std::vector<size_t> budgets( IECorePython::len( budgetList ) );
+	for ( size_t i = 0; i < budgets.size(); i++ )
+	{
+		budgets[i] = extract<size_t>( budgetList[i] );
+	}
+	m.setProxyVertexBudgets( budgets );
+}
+
+static list proxyErrors( const SceneCache &m )
+{
+	std::vector<float> errors;
+	{
+		ScopedGILRelease gilRelease;
+		m.proxyErrors( errors );
+	}
+	list result;
+	for ( std::vector<float>::const_iterator it = errors.begin(); it != errors.end(); it++ )
+	{
+		result.append( *it );
+	}
+	return result;
+}
+
+static ObjectPtr readProxy( const SceneCache &m, size_t level, double time )
+{
+	ScopedGILRelease gilRelease;
+	ConstObjectPtr o = m.readProxy( level, time );
+	if ( o )
+	{
+		return o->copy();
+	}
+	return 0;
+}
+
+static ObjectPtr readObjectProxy( const SceneCache &m, double time, float maxScreenError, float pixelsPerUnit )
+{
+	ScopedGILRelease gilRelease;
+	ConstObjectPtr o = m.readObjectProxy( time, maxScreenError, pixelsPerUnit );
+	if ( o )
+	{
+		return o->copy();
+	}
+	return 0;
+}
+
+static void prefetchWait( SceneCache::Prefetch &p )
+{
+	ScopedGILRelease gilRelease;
+	p.wait();
+}
+
 void bindSceneCache()
 {
-	RunTimeTypedClass<SceneCache>()
+	RunTimeTypedClass<SceneCache> sceneCacheClass;
+
+	{
+		scope s( sceneCacheClass );
+
+		enum_< SceneCache::PrefetchData > ("PrefetchData")
+			.value("PrefetchBound", SceneCache::PrefetchBound)
+			.value("PrefetchTransform", SceneCache::PrefetchTransform)
+			.value("PrefetchAttributes", SceneCache::PrefetchAttributes)
+			.value("PrefetchObject", SceneCache::PrefetchObject)
+			.value("PrefetchAll", SceneCache::PrefetchAll)
+			.export_values()
+		;
+
+		RefCountedClass<SceneCache::Prefetch, RefCounted>( "Prefetch" )
+			.def( "wait", &prefetchWait, "Blocks until all the data requested by the prefetch is loaded." )
+			.def( "done", &SceneCache::Prefetch::done, "Returns True if all the data requested by the prefetch is loaded." )
+		;
+	}
+
+	sceneCacheClass
 		.def( "__init__", make_constructor( &constructor ), "Opens a scene file for read or write." )
 		.def( "__init__", make_constructor( &constructor2 ), "Opens a scene from a previously opened file handle." )
+		.def( "finalise", &finalise, "Finalises this location and everything below it, writing their data to the file and releasing them from memory. They can't be modified afterwards." )
+		.def( "prefetch", &prefetch, ( arg( "paths" ), arg( "time" ), arg( "what" ) = SceneCache::PrefetchAll ), "Starts loading in background threads the data for the given paths and all the locations below them. Returns a Prefetch object which can be used to wait for completion." )
+		.def( "setProxyVertexBudgets", &setProxyVertexBudgets, "Sets the vertex budgets of the level of detail proxies generated for objects written from now on, here and in new child locations." )
+		.def( "proxyErrors", &proxyErrors, "Returns the object space error of each level of detail proxy stored for the object, finest first." )
+		.def( "readProxy", &readProxy, ( arg( "level" ), arg( "time" ) ) )
+		.def( "readObjectProxy", &readObjectProxy, ( arg( "time" ), arg( "maxScreenError" ), arg( "pixelsPerUnit" ) ), "Returns the coarsest proxy whose error in pixels doesn't exceed maxScreenError, or the object itself if none is accurate enough." )
 	;
 }
 
@@ -38,6 +38,7 @@
 #include "IECore/SharedSceneInterfaces.h"
 #include "IECorePython/RunTimeTypedBinding.h"
 #include "IECorePython/IECoreBinding.h"
+#include "IECorePython/ScopedGILRelease.h"
 
 using namespace boost::python;
 using namespace IECore;
@@ -58,7 +59,10 @@ inline list arrayToList( std::vector<IndexedIO::EntryID> &ids )
 static list childNames( const SceneInterface &m )
 {
 	SceneInterface::NameList n;
-	m.childNames( n );
+	{
+		ScopedGILRelease gilRelease;
+		m.childNames( n );
+	}
 	return arrayToList( n );
 }
 
@@ -105,13 +109,29 @@ static SceneInterfacePtr nonConstScene( SceneInterface &m, list l, SceneInterfac
 {
 	SceneInterface::Path p;
 	listToSceneInterfaceNameList( l, p );
+	ScopedGILRelease gilRelease;
 	return m.scene( p, b );
 }
 
+static SceneInterfacePtr nonConstChild( SceneInterface &m, const SceneInterface::Name &name, SceneInterface::MissingBehaviour b )
+{
+	ScopedGILRelease gilRelease;
+	return m.child( name, b );
+}
+
+static SceneInterfacePtr createChild( SceneInterface &m, const SceneInterface::Name &name )
+{
+	ScopedGILRelease gilRelease;
+	return m.createChild( name );
+}
+
 static list attributeNames( const SceneInterface &m )
 {
 	SceneInterface::NameList a;
-	m.attributeNames( a );
+	{
+		ScopedGILRelease gilRelease;
+		m.attributeNames( a );
+	}
 	return arrayToList( a );
 }
 
@@ -147,7 +167,11 @@ static dict readObjectPrimitiveVariables( const SceneInterface &m, list varNameL
 	SceneInterface::NameList v;
 	listToSceneInterfaceNameList( varNameList, v );
 
-	PrimitiveVariableMap varMap = m.readObjectPrimitiveVariables( v, time );
+	PrimitiveVariableMap varMap;
+	{
+		ScopedGILRelease gilRelease;
+		varMap = m.readObjectPrimitiveVariables( v, time );
+	}
 	dict result;
 	for ( PrimitiveVariableMap::const_iterator it = varMap.begin(); it != varMap.end(); it++ )
 	{
@@ -172,11 +196,25 @@ void writeTags( SceneInterface &m, list tagList )
 {
 	SceneInterface::NameList v;
 	listToSceneInterfaceNameList( tagList, v );
-	m.writeTags(v);	
+	ScopedGILRelease gilRelease;
+	m.writeTags( v );
+}
+
+static Imath::Box3d readBound( const SceneInterface &m, double time )
+{
+	ScopedGILRelease gilRelease;
+	return m.readBound( time );
+}
+
+static void writeBound( SceneInterface &m, const Imath::Box3d &bound, double time )
+{
+	ScopedGILRelease gilRelease;
+	m.writeBound( bound, time );
 }
 
 DataPtr readTransform( SceneInterface &m, double time )
 {
+	ScopedGILRelease gilRelease;
 	ConstDataPtr t = m.readTransform(time);
 	if ( t )
 	{
@@ -185,8 +223,21 @@ DataPtr readTransform( SceneInterface &m, double time )
 	return 0;
 }
 
+static Imath::M44d readTransformAsMatrix( const SceneInterface &m, double time )
+{
+	ScopedGILRelease gilRelease;
+	return m.readTransformAsMatrix( time );
+}
+
+static void writeTransform( SceneInterface &m, const Data *transform, double time )
+{
+	ScopedGILRelease gilRelease;
+	m.writeTransform( transform, time );
+}
+
 ObjectPtr readAttribute( SceneInterface &m, const SceneInterface::Name &name, double time )
 {
+	ScopedGILRelease gilRelease;
 	ConstObjectPtr o = m.readAttribute(name,time);
 	if ( o )
 	{
@@ -195,8 +246,15 @@ ObjectPtr readAttribute( SceneInterface &m, const SceneInterface::Name &name, do
 	return 0;
 }
 
+static void writeAttribute( SceneInterface &m, const SceneInterface::Name &name, const Object *attribute, double time )
+{
+	ScopedGILRelease gilRelease;
+	m.writeAttribute( name, attribute, time );
+}
+
 ObjectPtr readObject( SceneInterface &m, double time )
 {
+	ScopedGILRelease gilRelease;
 	ConstObjectPtr o = m.readObject(time);
 	if ( o )
 	{
@@ -205,17 +263,110 @@ ObjectPtr readObject( SceneInterface &m, double time )
 	return 0;
 }
 
+static void writeObject( SceneInterface &m, const Object *object, double time )
+{
+	ScopedGILRelease gilRelease;
+	m.writeObject( object, time );
+}
+
+static void listToPaths( list pathList, std::vector<SceneInterface::Path> &paths )
+{
+	paths.resize( IECorePython::len( pathList ) );
+	for ( size_t i = 0; i < paths.size(); i++ )
+	{
+		listToSceneInterfaceNameList( extract<list>( pathList[i] ), paths[i] );
+	}
+}
+
+static list readBounds( const SceneInterface &m, list pathList, double time )
+{
+	std::vector<SceneInterface::Path> paths;
+	listToPaths( pathList, paths );
+	std::vector<Imath::Box3d> bounds;
+	{
+		ScopedGILRelease gilRelease;
+		m.readBounds( paths, time, bounds );
+	}
+	list result;
+	for ( std::vector<Imath::Box3d>::const_iterator it = bounds.begin(); it != bounds.end(); it++ )
+	{
+		result.append( *it );
+	}
+	return result;
+}
+
+static list readTransformsAsMatrices( const SceneInterface &m, list pathList, double time )
+{
+	std::vector<SceneInterface::Path> paths;
+	listToPaths( pathList, paths );
+	std::vector<Imath::M44d> transforms;
+	{
+		ScopedGILRelease gilRelease;
+		m.readTransformsAsMatrices( paths, time, transforms );
+	}
+	list result;
+	for ( std::vector<Imath::M44d>::const_iterator it = transforms.begin(); it != transforms.end(); it++ )
+	{
+		result.append( *it );
+	}
+	return result;
+}
+
+static list readObjects( const SceneInterface &m, list pathList, double time )
+{
+	std::vector<SceneInterface::Path> paths;
+	listToPaths( pathList, paths );
+	std::vector<ConstObjectPtr> objects;
+	{
+		ScopedGILRelease gilRelease;
+		m.readObjects( paths, time, objects );
+	}
+	list result;
+	for ( std::vector<ConstObjectPtr>::const_iterator it = objects.begin(); it != objects.end(); it++ )
+	{
+		if ( *it )
+		{
+			result.append( (*it)->copy() );
+		}
+		else
+		{
+			result.append( object() );
+		}
+	}
+	return result;
+}
+
+static list taggedPaths( const SceneInterface &m, const SceneInterface::Name &tag )
+{
+	std::vector<SceneInterface::Path> paths;
+	{
+		ScopedGILRelease gilRelease;
+		m.taggedPaths( tag, paths );
+	}
+	list result;
+	for ( std::vector<SceneInterface::Path>::iterator it = paths.begin(); it != paths.end(); it++ )
+	{
+		result.append( arrayToList( *it ) );
+	}
+	return result;
+}
+
 static MurmurHash sceneHash( SceneInterface &m, SceneInterface::HashType hashType, double time )
 {
+	ScopedGILRelease gilRelease;
 	MurmurHash h;
 	m.hash( hashType, time, h );
 	return h;
 }
 
+static SceneInterfacePtr create( const std::string &path, IndexedIO::OpenMode mode )
+{
+	ScopedGILRelease gilRelease;
+	return SceneInterface::create( path, mode );
+}
+
 void bindSceneInterface()
 {
-	SceneInterfacePtr (SceneInterface::*nonConstChild)(const SceneInterface::Name &, SceneInterface::MissingBehaviour) = &SceneInterface::child;
-	
 	// make the SceneInterface class first
 	IECorePython::RunTimeTypedClass<SceneInterface> sceneInterfaceClass;
 	
@@ -258,32 +409,36 @@ void bindSceneInterface()
 		.def( "fileName", &SceneInterface::fileName )
 		.def( "pathAsString", pathAsString )
 		.def( "name", &SceneInterface::name )
-		.def( "readBound", &SceneInterface::readBound )
-		.def( "writeBound", &SceneInterface::writeBound )
+		.def( "readBound", &readBound )
+		.def( "writeBound", &writeBound )
 		.def( "readTransform", &readTransform )
-		.def( "readTransformAsMatrix", &SceneInterface::readTransformAsMatrix )
-		.def( "writeTransform", &SceneInterface::writeTransform )
+		.def( "readTransformAsMatrix", &readTransformAsMatrix )
+		.def( "writeTransform", &writeTransform )
 		.def( "hasAttribute", &SceneInterface::hasAttribute )
 		.def( "attributeNames", attributeNames )
 		.def( "readAttribute", &readAttribute )
-		.def( "writeAttribute", &SceneInterface::writeAttribute )
+		.def( "writeAttribute", &writeAttribute )
 		.def( "hasTag", &SceneInterface::hasTag, ( arg( "name" ), arg( "filter" ) = SceneInterface::LocalTag ) )
 		.def( "readTags", readTags, ( arg( "filter" ) = SceneInterface::LocalTag ) )
 		.def( "writeTags", writeTags )
 		.def( "readObject", &readObject )
 		.def( "readObjectPrimitiveVariables", &readObjectPrimitiveVariables )
-		.def( "writeObject", &SceneInterface::writeObject )
+		.def( "writeObject", &writeObject )
 		.def( "hasObject", &SceneInterface::hasObject )
 		.def( "hasChild", &SceneInterface::hasChild )
 		.def( "childNames", &childNames )
-		.def( "child", nonConstChild, ( arg( "name" ), arg( "missingBehaviour" ) = SceneInterface::ThrowIfMissing ) )
-		.def( "createChild", &SceneInterface::createChild )
+		.def( "child", &nonConstChild, ( arg( "name" ), arg( "missingBehaviour" ) = SceneInterface::ThrowIfMissing ) )
+		.def( "createChild", &createChild )
 		.def( "scene", &nonConstScene, ( arg( "path" ), arg( "missingBehaviour" ) = SceneInterface::ThrowIfMissing ) )
+		.def( "readBounds", &readBounds, ( arg( "paths" ), arg( "time" ) ) )
+		.def( "readTransformsAsMatrices", &readTransformsAsMatrices, ( arg( "paths" ), arg( "time" ) ) )
+		.def( "readObjects", &readObjects, ( arg( "paths" ), arg( "time" ) ) )
+		.def( "taggedPaths", &taggedPaths )
 		.def( "hash", &sceneHash )
 
 		.def( "pathToString", pathToString ).staticmethod("pathToString")
 		.def( "stringToPath", stringToPath ).staticmethod("stringToPath")
-		.def( "create", SceneInterface::create ).staticmethod( "create" )
+		.def( "create", &create ).staticmethod( "create" )
 		.def( "supportedExtensions", supportedExtensions, ( arg("modes") = IndexedIO::Read|IndexedIO::Write|IndexedIO::Append ) ).staticmethod( "supportedExtensions" )
 		
 		.def_readonly("visibilityName", &SceneInterface::visibilityName )
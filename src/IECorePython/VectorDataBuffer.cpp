@@ -0,0 +1,215 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2014, Image Engine Design Inc. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+//     * Neither the name of Image Engine Design nor the names of any
+//       other contributors to this software may be used to endorse or
+//       promote products derived from this software without specific prior
+//       written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#include <map>
+
+#include "boost/python.hpp"
+
+#include "IECorePython/VectorDataBuffer.h"
+
+using namespace boost::python;
+using namespace IECore;
+
+namespace
+{
+
+struct BufferObject
+{
+	PyObject_HEAD
+	// We hold a reference to this for the
+	// lifetime of the BufferObject.
+	Data *data;
+	IECorePython::VectorDataBufferAddressFn address;
+	const char *format;
+	int ndim;
+	Py_ssize_t itemSize;
+	Py_ssize_t shape[2];
+	Py_ssize_t strides[2];
+	IECorePython::VectorDataBufferModifiedFn modified;
+	// The number of writable views currently exported.
+	int numWritableViews;
+};
+
+// The number of writable views exported for each Data object,
+// across all BufferObjects. Protected by the GIL.
+typedef std::map<const Data *, int> WritableViewCounts;
+WritableViewCounts g_writableViewCounts;
+
+void dealloc( PyObject *self )
+{
+	BufferObject *buffer = reinterpret_cast<BufferObject *>( self );
+	buffer->data->removeRef();
+	self->ob_type->tp_free( self );
+}
+
+int getBuffer( PyObject *self, Py_buffer *view, int flags )
+{
+	BufferObject *buffer = reinterpret_cast<BufferObject *>( self );
+
+	const bool readOnly = !buffer->modified;
+	if( ( flags & PyBUF_WRITABLE ) && readOnly )
+	{
+		PyErr_SetString( PyExc_BufferError, "Buffer is read only - use toBuffer( writable = True ) to modify data" );
+		view->obj = NULL;
+		return -1;
+	}
+
+	// The data may have been resized or shared since the buffer was
+	// created, so we must look up the address afresh for each view.
+	size_t numElements = 0;
+	void *address = buffer->address( buffer->data, !readOnly, numElements );
+	buffer->shape[0] = numElements;
+
+	view->obj = self;
+	Py_INCREF( self );
+	view->buf = address;
+	view->len = buffer->shape[0] * buffer->strides[0];
+	view->readonly = readOnly;
+	view->itemsize = buffer->itemSize;
+	view->format = ( flags & PyBUF_FORMAT ) ? const_cast<char *>( buffer->format ) : NULL;
+	if( ( flags & PyBUF_ND ) == PyBUF_ND )
+	{
+		view->ndim = buffer->ndim;
+		view->shape = buffer->shape;
+	}
+	else
+	{
+		view->ndim = 1;
+		view->shape = NULL;
+	}
+	view->strides = ( flags & PyBUF_STRIDES ) == PyBUF_STRIDES ? buffer->strides : NULL;
+	view->suboffsets = NULL;
+	view->internal = NULL;
+
+	if( !readOnly )
+	{
+		buffer->numWritableViews++;
+		g_writableViewCounts[buffer->data]++;
+	}
+
+	return 0;
+}
+
+void releaseBuffer( PyObject *self, Py_buffer *view )
+{
+	BufferObject *buffer = reinterpret_cast<BufferObject *>( self );
+	if( !buffer->modified )
+	{
+		return;
+	}
+
+	WritableViewCounts::iterator it = g_writableViewCounts.find( buffer->data );
+	if( !--it->second )
+	{
+		g_writableViewCounts.erase( it );
+	}
+
+	if( !--buffer->numWritableViews )
+	{
+		// Let the data know it has been modified, so that
+		// it can invalidate its cached hash.
+		buffer->modified( buffer->data );
+	}
+}
+
+PyBufferProcs g_bufferProcs;
+PyTypeObject g_bufferType = {
+	PyVarObject_HEAD_INIT( NULL, 0 )
+};
+
+} // namespace
+
+namespace IECorePython
+{
+
+boost::python::object createVectorDataBuffer(
+	IECore::DataPtr data, size_t numComponents, size_t componentSize, const char *format,
+	VectorDataBufferAddressFn address, VectorDataBufferModifiedFn modified
+)
+{
+	BufferObject *buffer = PyObject_New( BufferObject, &g_bufferType );
+	if( !buffer )
+	{
+		throw_error_already_set();
+	}
+
+	data->addRef();
+	buffer->data = data.get();
+	buffer->address = address;
+	buffer->format = format;
+	buffer->itemSize = componentSize;
+	buffer->ndim = numComponents > 1 ? 2 : 1;
+	buffer->shape[0] = 0;
+	buffer->shape[1] = numComponents;
+	buffer->strides[0] = numComponents * componentSize;
+	buffer->strides[1] = componentSize;
+	buffer->modified = modified;
+	buffer->numWritableViews = 0;
+
+	return object( handle<>( reinterpret_cast<PyObject *>( buffer ) ) );
+}
+
+void checkNoWritableVectorDataBufferViews( const IECore::Data *data )
+{
+	if( g_writableViewCounts.empty() || g_writableViewCounts.find( data ) == g_writableViewCounts.end() )
+	{
+		return;
+	}
+
+	PyErr_SetString( PyExc_BufferError, "Existing writable exports of data: object cannot be resized or copied" );
+	throw_error_already_set();
+}
+
+void bindVectorDataBuffer()
+{
+	g_bufferProcs.bf_getbuffer = getBuffer;
+	g_bufferProcs.bf_releasebuffer = releaseBuffer;
+
+	g_bufferType.tp_name = "IECore.VectorDataBuffer";
+	g_bufferType.tp_basicsize = sizeof( BufferObject );
+	g_bufferType.tp_dealloc = dealloc;
+	g_bufferType.tp_as_buffer = &g_bufferProcs;
+	g_bufferType.tp_flags = Py_TPFLAGS_DEFAULT | Py_TPFLAGS_HAVE_NEWBUFFER;
+	g_bufferType.tp_doc = "Provides access to the contents of a VectorTypedData object via the buffer protocol. Created using VectorTypedData.toBuffer().";
+
+	if( PyType_Ready( &g_bufferType ) < 0 )
+	{
+		throw_error_already_set();
+	}
+
+	Py_INCREF( &g_bufferType );
+	scope().attr( "VectorDataBuffer" ) = object( handle<>( reinterpret_cast<PyObject *>( &g_bufferType ) ) );
+}
+
+} // namespace IECorePython
@@ -119,6 +119,8 @@ std::string str<BoolVectorData>( BoolVectorData &x )
 
 void bindAllVectorTypedData()
 {
+	bindVectorDataBuffer();
+
 	// basic types
 	BIND_VECTOR_TYPEDDATA(
 		bool,
@@ -284,6 +284,7 @@
 #include "IECorePython/DataConvertOpBinding.h"
 #include "IECorePython/PNGImageReaderBinding.h"
 #include "IECorePython/DeepPixelBinding.h"
+#include "IECorePython/DeepTileBinding.h"
 #include "IECorePython/DeepImageReaderBinding.h"
 #include "IECorePython/DeepImageWriterBinding.h"
 #include "IECorePython/DeepImageConverterBinding.h"
@@ -301,6 +302,7 @@
 #include "IECorePython/SampledSceneInterfaceBinding.h"
 #include "IECorePython/SceneCacheBinding.h"
 #include "IECorePython/LinkedSceneBinding.h"
+#include "IECorePython/ObjectPlaybackReaderBinding.h"
 #include "IECorePython/LensModelBinding.h"
 #include "IECorePython/StandardRadialLensModelBinding.h"
 #include "IECorePython/LensDistortOpBinding.h"
@@ -593,6 +595,7 @@ BOOST_PYTHON_MODULE(_IECore)
 #endif
 	
 	bindDeepPixel();
+	bindDeepTile();
 	bindDeepImageReader();
 	bindDeepImageWriter();
 	bindDeepImageConverter();
@@ -610,6 +613,7 @@ BOOST_PYTHON_MODULE(_IECore)
 	bindSampledSceneInterface();
 	bindSceneCache();
 	bindLinkedScene();
+	bindObjectPlaybackReader();
 	bindLensModel();
 	bindStandardRadialLensModel();
 	bindLensDistortOp();
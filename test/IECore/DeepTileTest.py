@@ -0,0 +1,135 @@
+##########################################################################
+#
+#  Copyright (c) 2014, Image Engine Design Inc. All rights reserved.
+#
+#  Redistribution and use in source and binary forms, with or without
+#  modification, are permitted provided that the following conditions are
+#  met:
+#
+#     * Redistributions of source code must retain the above copyright
+#       notice, this list of conditions and the following disclaimer.
+#
+#     * Redistributions in binary form must reproduce the above copyright
+#       notice, this list of conditions and the following disclaimer in the
+#       documentation and/or other materials provided with the distribution.
+#
+#     * Neither the name of Image Engine Design nor the names of any
+#       other contributors to this software may be used to endorse or
+#       promote products derived from this software without specific prior
+#       written permission.
+#
+#  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+#  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+#  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+#  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+#  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+#  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+#  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+#  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+#  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+#  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+#  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#
+##########################################################################
+
+
+import unittest
+import IECore
+
+class DeepTileTest( unittest.TestCase ) :
+
+	def __tile( self ) :
+
+		# a 2x2 tile with unsorted samples in two pixels
+		# and no samples in the others.
+		t = IECore.DeepTile( IECore.Box2i( IECore.V2i( 0 ), IECore.V2i( 1 ) ), [ "R", "G", "B", "A" ] )
+		t.setSampleCounts( [ 3, 0, 0, 2 ] )
+		t.setDepths( IECore.FloatVectorData( [ 3, 1, 2, 5, 4 ] ) )
+		t.setChannelData( 0, IECore.FloatVectorData( [ 0.3, 0.1, 0.2, 0.5, 0.4 ] ) )
+		t.setChannelData( 1, IECore.FloatVectorData( [ 0, 0, 0, 0, 0 ] ) )
+		t.setChannelData( 2, IECore.FloatVectorData( [ 1, 1, 1, 1, 1 ] ) )
+		t.setChannelData( 3, IECore.FloatVectorData( [ 0.5, 0.25, 0.75, 1, 0.5 ] ) )
+
+		return t
+
+	def testConstructor( self ) :
+
+		t = IECore.DeepTile( IECore.Box2i( IECore.V2i( 10, 20 ), IECore.V2i( 13, 21 ) ), [ "R", "G", "B", "A" ] )
+		self.assertEqual( t.window(), IECore.Box2i( IECore.V2i( 10, 20 ), IECore.V2i( 13, 21 ) ) )
+		self.assertEqual( t.numPixels(), 8 )
+		self.assertEqual( t.numSamples(), 0 )
+		self.assertEqual( t.channelNames(), ( "R", "G", "B", "A" ) )
+		self.assertEqual( t.numChannels(), 4 )
+		self.assertEqual( t.channelIndex( "B" ), 2 )
+		self.assertEqual( t.channelIndex( "Z" ), -1 )
+		self.assertEqual( t.pixelIndex( 10, 20 ), 0 )
+		self.assertEqual( t.pixelIndex( 11, 21 ), 5 )
+		self.assertRaises( Exception, t.pixelIndex, 0, 0 )
+		self.assertEqual( t.pixel( 10, 20 ), None )
+
+	def testSamples( self ) :
+
+		t = self.__tile()
+		self.assertEqual( t.numSamples(), 5 )
+		self.assertEqual( [ t.sampleCount( i ) for i in range( 0, 4 ) ], [ 3, 0, 0, 2 ] )
+		self.assertEqual( [ t.sampleOffset( i ) for i in range( 0, 4 ) ], [ 0, 3, 3, 3 ] )
+		self.assertRaises( IndexError, t.sampleCount, 4 )
+		self.assertRaises( ValueError, t.setDepths, IECore.FloatVectorData( [ 1 ] ) )
+
+		p = t.pixel( 0, 0 )
+		self.assertEqual( p.numSamples(), 3 )
+		self.assertEqual( p.channelNames(), ( "R", "G", "B", "A" ) )
+		self.assertEqual( p.getDepth( 0 ), 1 )
+		self.assertAlmostEqual( p.channelData( 0 )[0], 0.1, 6 )
+		self.assertEqual( t.pixel( 1, 0 ), None )
+
+	def testSortSamples( self ) :
+
+		t = self.__tile()
+		t.sortSamples()
+		self.assertEqual( t.depths(), IECore.FloatVectorData( [ 1, 2, 3, 4, 5 ] ) )
+		self.assertEqual( t.channelData( 3 ), IECore.FloatVectorData( [ 0.25, 0.75, 0.5, 0.5, 1 ] ) )
+
+	def testComposite( self ) :
+
+		t = self.__tile()
+		t.sortSamples()
+		image = t.composite()
+
+		self.assertEqual( image.dataWindow, t.window() )
+		for y in range( 0, 2 ) :
+			for x in range( 0, 2 ) :
+				i = t.pixelIndex( x, y )
+				p = t.pixel( x, y )
+				expected = p.composite() if p else [ 0 ] * 4
+				for c, name in enumerate( t.channelNames() ) :
+					self.assertAlmostEqual( image[name].data[i], expected[c], 6 )
+
+	def testMerge( self ) :
+
+		t = self.__tile()
+		t.sortSamples()
+
+		t2 = IECore.DeepTile( t.window(), t.channelNames() )
+		t2.setSampleCounts( [ 1, 1, 0, 0 ] )
+		t2.setDepths( IECore.FloatVectorData( [ 1.5, 6 ] ) )
+		t2.setChannelData( 0, IECore.FloatVectorData( [ 0.15, 0.6 ] ) )
+
+		expected = [ t.pixel( 0, 0 ), t2.pixel( 1, 0 ) ]
+		expected[0].merge( t2.pixel( 0, 0 ) )
+
+		t.merge( t2 )
+		self.assertEqual( t.numSamples(), 7 )
+		self.assertEqual( [ t.sampleCount( i ) for i in range( 0, 4 ) ], [ 4, 1, 0, 2 ] )
+		self.assertEqual( t.depths(), IECore.FloatVectorData( [ 1, 1.5, 2, 3, 6, 4, 5 ] ) )
+
+		for i, p in enumerate( [ t.pixel( 0, 0 ), t.pixel( 1, 0 ) ] ) :
+			self.assertEqual( p.numSamples(), expected[i].numSamples() )
+			for s in range( 0, p.numSamples() ) :
+				self.assertEqual( p.getDepth( s ), expected[i].getDepth( s ) )
+				self.assertEqual( p.channelData( s ), expected[i].channelData( s ) )
+
+		self.assertRaises( Exception, t.merge, IECore.DeepTile( IECore.Box2i( IECore.V2i( 0 ), IECore.V2i( 2 ) ), [ "R", "G", "B", "A" ] ) )
+
+if __name__ == "__main__":
+    unittest.main()
@@ -113,6 +113,43 @@ class EXRDeepImageReaderTest(unittest.TestCase):
 		self.assertEqual( d.getDepth(7), 9.751317024230957 )
 		self.assertEqual( d.getDepth(8), 9.7521572113037109 )
 
+	def testReadTile( self ) :
+
+		reader = DeepImageReader.create( "test/IECoreRI/data/exr/primitives.exr" )
+		window = Box2i( V2i( 150, 280 ), V2i( 159, 289 ) )
+		tile = reader.readTile( window )
+		self.assertEqual( tile.window(), window )
+		self.assertEqual( tile.channelNames(), tuple( reader.channelNames() ) )
+		self.assertTrue( tile.numSamples() > 0 )
+
+		for y in range( window.min.y, window.max.y + 1 ) :
+			for x in range( window.min.x, window.max.x + 1 ) :
+				p = reader.readPixel( x, y )
+				t = tile.pixel( x, y )
+				if p is None :
+					self.assertEqual( t, None )
+					continue
+				self.assertEqual( t.numSamples(), p.numSamples() )
+				for s in range( 0, p.numSamples() ) :
+					self.assertEqual( t.getDepth( s ), p.getDepth( s ) )
+					self.assertEqual( t.channelData( s ), p.channelData( s ) )
+
+		self.assertRaises( RuntimeError, reader.readTile, Box2i( V2i( 500 ), V2i( 600 ) ) )
+
+	def testCompositeMatchesReadPixel( self ) :
+
+		reader = DeepImageReader.create( "test/IECoreRI/data/exr/primitives.exr" )
+		image = reader.read()
+		dataWindow = reader.dataWindow()
+		width = dataWindow.size().x + 1
+
+		for x, y in [ ( 154, 285 ), ( 0, 0 ), ( 300, 200 ) ] :
+			p = reader.readPixel( x, y )
+			expected = p.composite() if p else [ 0 ] * len( reader.channelNames() )
+			i = ( y - dataWindow.min.y ) * width + x - dataWindow.min.x
+			for c, name in enumerate( reader.channelNames() ) :
+				self.assertAlmostEqual( image[name].data[i], expected[c], 5 )
+
 if __name__ == "__main__":
 	unittest.main()
 
@@ -40,6 +40,7 @@ import os
 class EXRDeepImageWriterTest(unittest.TestCase):
 	
 	__output = "test/IECoreRI/data/exr/written.exr"
+	__pixelsOutput = "test/IECoreRI/data/exr/writtenPixels.exr"
 
 	def testCreator( self ) :
 		
@@ -129,10 +130,152 @@ class EXRDeepImageWriterTest(unittest.TestCase):
 		self.assertEqual( dict( zip( rp3.channelNames(), rp3[1] ) ), { "R" : 0.0625,  "G" : 0.25, "A" : 0.0625 } )
 		self.failUnless( reader.readPixel( 1, 0 ) is None )
 	
+	def __tile( self, window ) :
+		
+		# a tile where every third pixel is empty, and the others
+		# have between one and three samples, with values which can be
+		# represented exactly at half precision.
+		t = DeepTile( window, [ "R", "G", "A" ] )
+		t.setSampleCounts( [ i % 3 and ( i % 4 ) + 1 or 0 for i in range( 0, t.numPixels() ) ] )
+		t.setDepths( FloatVectorData( [ i + 1 for i in range( 0, t.numSamples() ) ] ) )
+		for c in range( 0, 3 ) :
+			t.setChannelData( c, FloatVectorData( [ ( ( i + c ) % 8 ) / 8.0 for i in range( 0, t.numSamples() ) ] ) )
+		
+		return t
+	
+	def __writer( self, fileName ) :
+		
+		writer = EXRDeepImageWriter( fileName )
+		writer.parameters()['channelNames'].setValue( StringVectorData( [ "R", "G", "A" ] ) )
+		writer.parameters()['halfPrecisionChannels'].setValue( StringVectorData( [ "R", "A" ] ) )
+		writer.parameters()['resolution'].setTypedValue( V2i( 5, 6 ) )
+		
+		return writer
+	
+	def __writePixels( self, writer, tile ) :
+		
+		window = tile.window()
+		for y in range( window.min.y, window.max.y + 1 ) :
+			for x in range( window.min.x, window.max.x + 1 ) :
+				p = tile.pixel( x, y )
+				if p is not None :
+					writer.writePixel( x, y, p )
+	
+	def __assertImagesEqual( self, fileName1, fileName2 ) :
+		
+		reader1 = EXRDeepImageReader( fileName1 )
+		reader2 = EXRDeepImageReader( fileName2 )
+		self.assertEqual( reader1.dataWindow(), reader2.dataWindow() )
+		self.assertEqual( reader1.channelNames(), reader2.channelNames() )
+		
+		dataWindow = reader1.dataWindow()
+		numPixels = 0
+		for y in range( dataWindow.min.y, dataWindow.max.y + 1 ) :
+			for x in range( dataWindow.min.x, dataWindow.max.x + 1 ) :
+				p1 = reader1.readPixel( x, y )
+				p2 = reader2.readPixel( x, y )
+				if p1 is None :
+					self.failUnless( p2 is None )
+					continue
+				numPixels += 1
+				self.failUnless( p2 is not None )
+				self.assertEqual( p1.numSamples(), p2.numSamples() )
+				for i in range( 0, p1.numSamples() ) :
+					self.assertEqual( p1.getDepth( i ), p2.getDepth( i ) )
+					self.assertEqual( p1[i], p2[i] )
+		
+		return numPixels
+	
+	def testWriteTile( self ) :
+		
+		# spans the full width, so is written in one go
+		tile = self.__tile( Box2i( V2i( 0, 1 ), V2i( 4, 3 ) ) )
+		
+		writer = self.__writer( EXRDeepImageWriterTest.__output )
+		writer.writeTile( tile )
+		del writer
+		
+		writer = self.__writer( EXRDeepImageWriterTest.__pixelsOutput )
+		self.__writePixels( writer, tile )
+		del writer
+		
+		self.assertEqual( self.__assertImagesEqual( EXRDeepImageWriterTest.__output, EXRDeepImageWriterTest.__pixelsOutput ), 10 )
+	
+	def testWritePartialTiles( self ) :
+		
+		# these don't span the full width, so are written pixel by pixel
+		tiles = [
+			self.__tile( Box2i( V2i( 1, 0 ), V2i( 3, 2 ) ) ),
+			self.__tile( Box2i( V2i( 0, 3 ), V2i( 3, 4 ) ) ),
+			self.__tile( Box2i( V2i( 2, 5 ), V2i( 3, 5 ) ) ),
+		]
+		
+		writer = self.__writer( EXRDeepImageWriterTest.__output )
+		for tile in tiles :
+			writer.writeTile( tile )
+		del writer
+		
+		writer = self.__writer( EXRDeepImageWriterTest.__pixelsOutput )
+		for tile in tiles :
+			self.__writePixels( writer, tile )
+		del writer
+		
+		self.assertEqual( self.__assertImagesEqual( EXRDeepImageWriterTest.__output, EXRDeepImageWriterTest.__pixelsOutput ), 12 )
+		
+		# tiles must still be written in scanline order
+		writer = self.__writer( EXRDeepImageWriterTest.__output )
+		writer.writeTile( tiles[1] )
+		self.assertRaises( RuntimeError, writer.writeTile, tiles[0] )
+	
+	def testWritePixelThenTile( self ) :
+		
+		p = DeepPixel( [ "R", "G", "A" ] )
+		p.addSample( 10, [ 0.5, 0.25, 0.125 ] )
+		
+		# the tile has no samples at ( 0, 1 ) or ( 3, 1 ), but
+		# does at ( 1, 1 ).
+		tile = self.__tile( Box2i( V2i( 0, 1 ), V2i( 4, 3 ) ) )
+		self.assertEqual( tile.pixel( 0, 1 ), None )
+		self.assertEqual( tile.pixel( 3, 1 ), None )
+		self.failUnless( tile.pixel( 1, 1 ) is not None )
+		
+		writer = self.__writer( EXRDeepImageWriterTest.__output )
+		for x in ( 0, 1, 3 ) :
+			writer.writePixel( x, 1, p )
+		writer.writeTile( tile )
+		del writer
+		
+		writer = self.__writer( EXRDeepImageWriterTest.__pixelsOutput )
+		for x in ( 0, 1, 3 ) :
+			writer.writePixel( x, 1, p )
+		self.__writePixels( writer, tile )
+		del writer
+		
+		self.assertEqual( self.__assertImagesEqual( EXRDeepImageWriterTest.__output, EXRDeepImageWriterTest.__pixelsOutput ), 12 )
+		
+		# the pixels without samples in the tile were kept, and the others were replaced
+		reader = EXRDeepImageReader( EXRDeepImageWriterTest.__output )
+		for x in ( 0, 3 ) :
+			self.assertEqual( reader.readPixel( x, 1 ).getDepth( 0 ), 10 )
+		self.assertEqual( reader.readPixel( 1, 1 ).getDepth( 0 ), 1 )
+		
+		# and the same applies to a tile of a single scanline
+		writer = self.__writer( EXRDeepImageWriterTest.__output )
+		writer.writePixel( 0, 1, p )
+		writer.writeTile( self.__tile( Box2i( V2i( 0, 1 ), V2i( 4, 1 ) ) ) )
+		writer.writePixel( 0, 2, p )
+		del writer
+		
+		reader = EXRDeepImageReader( EXRDeepImageWriterTest.__output )
+		self.assertEqual( reader.readPixel( 0, 1 ).getDepth( 0 ), 10 )
+		self.assertEqual( reader.readPixel( 1, 1 ).getDepth( 0 ), 1 )
+		self.assertEqual( reader.readPixel( 0, 2 ).getDepth( 0 ), 10 )
+	
 	def tearDown( self ) :
 		
-		if os.path.isfile( EXRDeepImageWriterTest.__output ) :
-			os.remove( EXRDeepImageWriterTest.__output )
+		for f in ( EXRDeepImageWriterTest.__output, EXRDeepImageWriterTest.__pixelsOutput ) :
+			if os.path.isfile( f ) :
+				os.remove( f )
 
 if __name__ == "__main__":
 	unittest.main()
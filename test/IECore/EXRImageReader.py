@@ -158,6 +158,40 @@ class TestEXRReader(unittest.TestCase):
 			cd = r.readChannel( c )
 			self.assertEqual( i[c].data, cd )
 
+	def testReadManyChannels( self ) :
+
+		r = EXRImageReader( "test/IECore/data/exrFiles/manyChannels.exr" )
+		names = r.channelNames()
+		self.failUnless( len( names ) > 3 )
+
+		for raw in ( False, True ) :
+
+			r.parameters()["rawChannels"].setTypedValue( raw )
+			i = r.read()
+			self.assertEqual( set( i.keys() ), set( names ) )
+			for c in names :
+				self.assertEqual( i[c].data, r.readChannel( c, raw ) )
+
+		# a data window narrower than the file reads all the channels in one pass too
+		r.parameters()["rawChannels"].setTypedValue( False )
+		iWhole = r.read()
+		w = iWhole.dataWindow
+		window = Box2i( w.min + V2i( 1, 2 ), w.max - V2i( 3, 1 ) )
+		r.parameters()["dataWindow"].setTypedValue( window )
+		iSliced = r.read()
+		self.assertEqual( iSliced.dataWindow, window )
+		self.failUnless( iSliced.arePrimitiveVariablesValid() )
+
+		wholeWidth = w.size().x + 1
+		slicedWidth = window.size().x + 1
+		for c in names :
+			whole = iWhole[c].data
+			sliced = iSliced[c].data
+			for y in range( window.min.y, window.max.y + 1 ) :
+				wholeStart = ( y - w.min.y ) * wholeWidth + window.min.x - w.min.x
+				slicedStart = ( y - window.min.y ) * slicedWidth
+				self.assertEqual( list( whole[wholeStart:wholeStart+slicedWidth] ), list( sliced[slicedStart:slicedStart+slicedWidth] ) )
+
 	def testReadWithChangedDisplayWindow( self ) :
 
 		r = EXRImageReader( "test/IECore/data/exrFiles/uvMap.256x256.exr" )
@@ -318,11 +352,14 @@ class TestEXRReader(unittest.TestCase):
 
 		self.assert_( i.arePrimitiveVariablesValid() )
 
-		# check a warning message has been output for each channel
+		# check a warning message naming the channel has been output for each channel
 		self.assertEqual( len( m.messages ), 3 )
-		self.assertEqual( m.messages[0].level, Msg.Level.Warning )
-		self.assertEqual( m.messages[1].level, Msg.Level.Warning )
-		self.assertEqual( m.messages[2].level, Msg.Level.Warning )
+		for message in m.messages :
+			self.assertEqual( message.level, Msg.Level.Warning )
+		self.assertEqual(
+			set( [ message.message.split( '"' )[1] for message in m.messages ] ),
+			set( [ "R", "G", "B" ] )
+		)
 
 	def testHeaderToBlindData( self ) :
 
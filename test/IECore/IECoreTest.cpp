@@ -78,6 +78,11 @@
 #include "CompoundObjectTest.h"
 #include "ComputationCacheTest.h"
 #include "SceneCacheThreadingTest.h"
+#include "IndexedIOThreadingTest.h"
+#include "MappedVectorDataTest.h"
+#include "TriangleBVHTest.h"
+#include "PointSmoothSkinningOpTest.h"
+#include "KDTreeThreadingTest.h"
 
 using namespace boost::unit_test;
 using boost::test_tools::output_test_stream;
@@ -123,6 +128,11 @@ test_suite* init_unit_test_suite( int argc, char* argv[] )
 		addCompoundObjectTest(test);
 		addComputationCacheTest(test);
 		addSceneCacheThreadingTest(test);
+		addIndexedIOThreadingTest(test);
+		addMappedVectorDataTest(test);
+		addTriangleBVHTest(test);
+		addPointSmoothSkinningOpTest(test);
+		addKDTreeThreadingTest(test);
 	}
 	catch (std::exception &ex)
 	{
@@ -38,6 +38,8 @@ import os
 import unittest
 import math
 import random
+import shutil
+import struct
 
 from IECore import *
 
@@ -573,6 +575,221 @@ class TestFileIndexedIO(unittest.TestCase):
 		self.failIf(fv is gv)
 		self.assertEqual(fv, gv)
 
+	def testDataCompression( self ) :
+
+		data = FloatVectorData( [ math.sin( i * 0.001 ) for i in range( 0, 100000 ) ] )
+		ints = IntVectorData( range( 0, 100000 ) )
+		strings = StringVectorData( [ "a", "b", "c" ] * 1000 )
+
+		sizes = {}
+		for compression in ( StreamIndexedIO.DataCompression.Uncompressed, StreamIndexedIO.DataCompression.GzipCompression, StreamIndexedIO.DataCompression.FastCompression ) :
+			for shuffle in ( False, True ) :
+
+				f = FileIndexedIO( "./test/FileIndexedIO.fio", [], IndexedIO.OpenMode.Write )
+				f.setDataCompression( compression, shuffle )
+				self.assertEqual( f.getDataCompression(), compression )
+				f.write( "floats", data )
+				f.write( "ints", ints )
+				f.write( "strings", strings )
+				f.write( "small", FloatVectorData( [ 1, 2, 3 ] ) )
+				del f
+
+				sizes[(compression,shuffle)] = os.path.getsize( "./test/FileIndexedIO.fio" )
+
+				f = FileIndexedIO( "./test/FileIndexedIO.fio", [], IndexedIO.OpenMode.Read )
+				self.assertEqual( f.entry( "floats" ).dataType(), IndexedIO.DataType.FloatArray )
+				self.assertEqual( f.entry( "floats" ).arrayLength(), len( data ) )
+				self.assertEqual( f.read( "floats" ), data )
+				self.assertEqual( f.read( "ints" ), ints )
+				self.assertEqual( f.read( "strings" ), strings )
+				self.assertEqual( f.read( "small" ), FloatVectorData( [ 1, 2, 3 ] ) )
+
+		uncompressedSize = sizes[(StreamIndexedIO.DataCompression.Uncompressed,False)]
+		self.assertEqual( sizes[(StreamIndexedIO.DataCompression.Uncompressed,True)], uncompressedSize )
+		for shuffle in ( False, True ) :
+			self.failUnless( sizes[(StreamIndexedIO.DataCompression.GzipCompression,shuffle)] < uncompressedSize )
+			self.failUnless( sizes[(StreamIndexedIO.DataCompression.FastCompression,shuffle)] < uncompressedSize )
+
+		self.failUnless( sizes[(StreamIndexedIO.DataCompression.FastCompression,True)] < sizes[(StreamIndexedIO.DataCompression.FastCompression,False)] )
+
+	def testCompressedObjectLoading( self ) :
+
+		data = V3fVectorData( [ V3f( math.sin( i * 0.01 ), math.cos( i * 0.01 ), i * 0.001 ) for i in range( 0, 100000 ) ] )
+		numEntries = 20
+
+		sizes = {}
+		for compression in ( StreamIndexedIO.DataCompression.Uncompressed, StreamIndexedIO.DataCompression.GzipCompression, StreamIndexedIO.DataCompression.FastCompression ) :
+
+			f = FileIndexedIO( "./test/FileIndexedIO.fio", [], IndexedIO.OpenMode.Write )
+			f.setDataCompression( compression )
+			for i in range( 0, numEntries ) :
+				# vary the data so it isn't deduplicated
+				data[0] = V3f( i )
+				data.save( f, "data%d" % i )
+			del f
+
+			sizes[compression] = os.path.getsize( "./test/FileIndexedIO.fio" )
+
+			f = FileIndexedIO( "./test/FileIndexedIO.fio", [], IndexedIO.OpenMode.Read )
+			for i in range( 0, numEntries ) :
+				data[0] = V3f( i )
+				self.assertEqual( Object.load( f, "data%d" % i ), data )
+
+		uncompressedSize = sizes[StreamIndexedIO.DataCompression.Uncompressed]
+		self.failUnless( sizes[StreamIndexedIO.DataCompression.GzipCompression] < uncompressedSize )
+		self.failUnless( sizes[StreamIndexedIO.DataCompression.FastCompression] < uncompressedSize )
+
+	def testFileVersion( self ) :
+
+		def version( fileName ) :
+			# the version is the second of the three int64s at the end of the file
+			f = open( fileName, "rb" )
+			f.seek( -16, os.SEEK_END )
+			return struct.unpack( "<q", f.read( 8 ) )[0]
+
+		data = FloatVectorData( [ math.sin( i * 0.001 ) for i in range( 0, 100000 ) ] )
+
+		# files not using any newer features remain readable by older versions of the library
+		f = FileIndexedIO( "./test/FileIndexedIO.fio", [], IndexedIO.OpenMode.Write )
+		f.write( "floats", data )
+		del f
+		self.assertEqual( version( "./test/FileIndexedIO.fio" ), 5 )
+
+		# as do files where compression was enabled, but nothing was compressed
+		f = FileIndexedIO( "./test/FileIndexedIO.fio", [], IndexedIO.OpenMode.Write )
+		f.setDataCompression( StreamIndexedIO.DataCompression.GzipCompression )
+		f.write( "small", FloatVectorData( [ 1, 2, 3 ] ) )
+		del f
+		self.assertEqual( version( "./test/FileIndexedIO.fio" ), 5 )
+
+		f = FileIndexedIO( "./test/FileIndexedIO.fio", [], IndexedIO.OpenMode.Append )
+		f.setDataCompression( StreamIndexedIO.DataCompression.GzipCompression )
+		f.write( "floats", data )
+		del f
+		self.assertEqual( version( "./test/FileIndexedIO.fio" ), 6 )
+
+		# appending uncompressed data mustn't lower the version
+		f = FileIndexedIO( "./test/FileIndexedIO.fio", [], IndexedIO.OpenMode.Append )
+		f.write( "moreFloats", data )
+		del f
+		self.assertEqual( version( "./test/FileIndexedIO.fio" ), 6 )
+
+		f = FileIndexedIO( "./test/FileIndexedIO.fio", [], IndexedIO.OpenMode.Read )
+		self.assertEqual( f.read( "floats" ), data )
+		self.assertEqual( f.read( "moreFloats" ), data )
+		del f
+
+		f = FileIndexedIO( "./test/FileIndexedIO.fio", [], IndexedIO.OpenMode.Write )
+		f.setBlobStore( BlobStore.open( "./test/blobStore" ) )
+		f.write( "floats", data )
+		del f
+		self.assertEqual( version( "./test/FileIndexedIO.fio" ), 7 )
+
+	def testBlobStore( self ) :
+
+		data = FloatVectorData( [ math.sin( i * 0.001 ) for i in range( 0, 100000 ) ] )
+		small = FloatVectorData( [ 1, 2, 3 ] )
+
+		store = BlobStore.open( "./test/blobStore" )
+		self.assertEqual( store.directory(), os.path.abspath( "./test/blobStore" ) )
+		self.failUnless( BlobStore.open( "./test/blobStore" ).isSame( store ) )
+
+		for fileName in ( "./test/FileIndexedIO.fio", "./test/FileIndexedIO2.fio" ) :
+			f = FileIndexedIO( fileName, [], IndexedIO.OpenMode.Write )
+			f.setBlobStore( store )
+			self.failUnless( f.getBlobStore().isSame( store ) )
+			f.write( "floats", data )
+			f.write( "small", small )
+			del f
+			# only the reference to the blob is stored in the file
+			self.failUnless( os.path.getsize( fileName ) < len( data ) )
+
+		# both files share the same blob
+		self.assertEqual( store.stats(), ( 0, 1 ) )
+
+		def check() :
+			for fileName in ( "./test/FileIndexedIO.fio", "./test/FileIndexedIO2.fio" ) :
+				f = FileIndexedIO( fileName, [], IndexedIO.OpenMode.Read )
+				self.assertEqual( f.getBlobStore().directory(), store.directory() )
+				self.assertEqual( f.entry( "floats" ).arrayLength(), len( data ) )
+				self.assertEqual( f.read( "floats" ), data )
+				self.assertEqual( f.read( "small" ), small )
+
+		check()
+
+		op = BlobStoreRepackOp()
+		self.assertEqual( op( store = "./test/blobStore" ), IntData( 1 ) )
+		self.assertEqual( store.stats(), ( 1, 0 ) )
+		check()
+
+		# nothing left to pack
+		self.assertEqual( store.repack(), 0 )
+
+		# blobs written after the repack are loose again, until the next repack
+		h = store.write( CharVectorData( [ "a" ] * 100 ) )
+		self.failUnless( store.contains( h ) )
+		self.assertEqual( store.size( h ), 100 )
+		self.assertEqual( store.stats(), ( 1, 1 ) )
+		self.assertEqual( store.repack(), 1 )
+		self.assertEqual( store.stats(), ( 2, 0 ) )
+		self.assertEqual( store.read( h ), CharVectorData( [ "a" ] * 100 ) )
+		check()
+
+		# a file can't be switched to a different store
+		f = FileIndexedIO( "./test/FileIndexedIO.fio", [], IndexedIO.OpenMode.Append )
+		self.assertRaises( Exception, f.setBlobStore, BlobStore.open( "./test/otherBlobStore" ) )
+
+	def testBlobStorePathIsRelative( self ) :
+
+		data = FloatVectorData( [ math.sin( i * 0.001 ) for i in range( 0, 100000 ) ] )
+
+		os.makedirs( "./test/blobStoreFiles" )
+		f = FileIndexedIO( "./test/blobStoreFiles/file.fio", [], IndexedIO.OpenMode.Write )
+		f.setBlobStore( BlobStore.open( "./test/blobStoreFiles/store" ) )
+		f.write( "floats", data )
+		del f
+
+		# the absolute location of the store isn't in the file
+		self.failIf( os.path.abspath( "./test/blobStoreFiles" ) in open( "./test/blobStoreFiles/file.fio", "rb" ).read() )
+
+		# so the file and the store can be moved together
+		shutil.move( "./test/blobStoreFiles", "./test/movedBlobStoreFiles" )
+		f = FileIndexedIO( "./test/movedBlobStoreFiles/file.fio", [], IndexedIO.OpenMode.Read )
+		self.assertEqual( f.getBlobStore().directory(), os.path.abspath( "./test/movedBlobStoreFiles/store" ) )
+		self.assertEqual( f.read( "floats" ), data )
+		del f
+
+		# and appending keeps referring to the same store
+		f = FileIndexedIO( "./test/movedBlobStoreFiles/file.fio", [], IndexedIO.OpenMode.Append )
+		f.setBlobStore( BlobStore.open( "./test/movedBlobStoreFiles/store" ) )
+		f.write( "moreFloats", data )
+		del f
+
+		f = FileIndexedIO( "./test/movedBlobStoreFiles/file.fio", [], IndexedIO.OpenMode.Read )
+		self.assertEqual( f.read( "moreFloats" ), data )
+		self.assertEqual( f.getBlobStore().stats(), ( 0, 1 ) )
+
+	def testBlobStoreSizeMismatch( self ) :
+
+		data = FloatVectorData( [ math.sin( i * 0.001 ) for i in range( 0, 100000 ) ] )
+
+		store = BlobStore.open( "./test/blobStore" )
+		f = FileIndexedIO( "./test/FileIndexedIO.fio", [], IndexedIO.OpenMode.Write )
+		f.setBlobStore( store )
+		f.write( "floats", data )
+		del f
+
+		# truncate the loose blob, as if it had been damaged
+		self.assertEqual( store.stats(), ( 0, 1 ) )
+		looseDirectory = os.path.join( store.directory(), "loose" )
+		for d in os.listdir( looseDirectory ) :
+			for b in os.listdir( os.path.join( looseDirectory, d ) ) :
+				blob = os.path.join( looseDirectory, d, b )
+				open( blob, "r+b" ).truncate( os.path.getsize( blob ) / 2 )
+
+		f = FileIndexedIO( "./test/FileIndexedIO.fio", [], IndexedIO.OpenMode.Read )
+		self.assertRaises( Exception, f.read, "floats" )
+
 	def setUp( self ):
 
 		if os.path.isfile("./test/FileIndexedIO.fio") :
@@ -581,8 +798,13 @@ class TestFileIndexedIO(unittest.TestCase):
 	def tearDown(self):
 
 		# cleanup
-		if os.path.isfile("./test/FileIndexedIO.fio") :
-			os.remove("./test/FileIndexedIO.fio")
+		for f in ( "./test/FileIndexedIO.fio", "./test/FileIndexedIO2.fio" ) :
+			if os.path.isfile( f ) :
+				os.remove( f )
+
+		for d in ( "./test/blobStore", "./test/blobStoreFiles", "./test/movedBlobStoreFiles" ) :
+			if os.path.isdir( d ) :
+				shutil.rmtree( d )
 
 
 if __name__ == "__main__":
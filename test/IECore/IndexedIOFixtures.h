@@ -0,0 +1,128 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2014, Image Engine Design Inc. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+//     * Neither the name of Image Engine Design nor the names of any
+//       other contributors to this software may be used to endorse or
+//       promote products derived from this software without specific prior
+//       written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#ifndef IECORE_INDEXEDIOFIXTURES_H
+#define IECORE_INDEXEDIOFIXTURES_H
+
+#include <vector>
+#include <algorithm>
+
+#include "boost/format.hpp"
+
+#include "tbb/tbb.h"
+
+#include "IECore/IndexedIO.h"
+
+namespace IECore
+{
+
+/// Fixtures shared by IndexedIOThreadingTest and IndexedIOBenchmark.
+namespace IndexedIOFixtures
+{
+
+inline IndexedIO::EntryID entryName( size_t i )
+{
+	return ( boost::format( "entry%d" ) % i ).str();
+}
+
+/// Writes numEntries arrays of arrayLength floats, each filled with
+/// its own index.
+inline void writeEntries( IndexedIOPtr io, size_t numEntries, size_t arrayLength )
+{
+	std::vector<float> data( arrayLength );
+	for ( size_t i = 0; i < numEntries; i++ )
+	{
+		std::fill( data.begin(), data.end(), (float)i );
+		io->write( entryName( i ), &data[0], arrayLength );
+	}
+}
+
+/// Body for tbb::parallel_reduce, reading the entries written by
+/// writeEntries() and counting any which don't contain the expected
+/// values.
+class ReadEntries
+{
+
+	public :
+
+		ReadEntries( ConstIndexedIOPtr io, size_t numEntries, size_t arrayLength )
+			:	m_io( io ), m_numEntries( numEntries ), m_arrayLength( arrayLength ), m_errors( 0 )
+		{
+		}
+
+		ReadEntries( ReadEntries &that, tbb::split )
+			:	m_io( that.m_io ), m_numEntries( that.m_numEntries ), m_arrayLength( that.m_arrayLength ), m_errors( 0 )
+		{
+		}
+
+		void operator()( const tbb::blocked_range<size_t> &r ) const
+		{
+			std::vector<float> buffer( m_arrayLength );
+			for ( size_t i = r.begin(); i != r.end(); ++i )
+			{
+				size_t entry = i % m_numEntries;
+				float *data = &buffer[0];
+				m_io->read( entryName( entry ), data, m_arrayLength );
+				// can't use boost unit test assertions from threads
+				if ( data[0] != (float)entry || data[m_arrayLength-1] != (float)entry )
+				{
+					m_errors++;
+				}
+			}
+		}
+
+		void join( const ReadEntries &that )
+		{
+			m_errors += that.m_errors;
+		}
+
+		size_t errors() const
+		{
+			return m_errors;
+		}
+
+	private :
+
+		ConstIndexedIOPtr m_io;
+		size_t m_numEntries;
+		size_t m_arrayLength;
+		mutable size_t m_errors;
+
+};
+
+} // namespace IndexedIOFixtures
+
+} // namespace IECore
+
+#endif // IECORE_INDEXEDIOFIXTURES_H
@@ -0,0 +1,99 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2014, Image Engine Design Inc. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+//     * Neither the name of Image Engine Design nor the names of any
+//       other contributors to this software may be used to endorse or
+//       promote products derived from this software without specific prior
+//       written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#include "boost/filesystem/operations.hpp"
+
+#include "tbb/tbb.h"
+
+#include "IECore/FileIndexedIO.h"
+
+#include "IndexedIOFixtures.h"
+#include "IndexedIOThreadingTest.h"
+
+using namespace boost;
+using namespace boost::unit_test;
+using namespace tbb;
+
+namespace IECore
+{
+
+struct IndexedIOThreadingTest
+{
+
+	static const size_t numEntries = 16;
+	static const size_t arrayLength = 16 * 1024;
+
+	IndexedIOThreadingTest() : m_fileName( "test/IECore/indexedIOThreadingTest.fio" )
+	{
+		IndexedIOFixtures::writeEntries( new FileIndexedIO( m_fileName, IndexedIO::rootPath, IndexedIO::Write ), numEntries, arrayLength );
+	}
+
+	~IndexedIOThreadingTest()
+	{
+		boost::filesystem::remove( m_fileName );
+	}
+
+	/// Reads every entry many times from concurrent threads, checking the results.
+	/// See IndexedIOBenchmark for the throughput timings.
+	void testConcurrentReads()
+	{
+		ConstIndexedIOPtr io = new FileIndexedIO( m_fileName, IndexedIO::rootPath, IndexedIO::Read );
+
+		IndexedIOFixtures::ReadEntries task( io, numEntries, arrayLength );
+		parallel_reduce( blocked_range<size_t>( 0, numEntries * 64, 1 ), task );
+
+		BOOST_CHECK_EQUAL( task.errors(), 0u );
+	}
+
+	std::string m_fileName;
+
+};
+
+struct IndexedIOThreadingTestSuite : public boost::unit_test::test_suite
+{
+
+	IndexedIOThreadingTestSuite() : boost::unit_test::test_suite( "IndexedIOThreadingTestSuite" )
+	{
+		boost::shared_ptr<IndexedIOThreadingTest> instance( new IndexedIOThreadingTest() );
+
+		add( BOOST_CLASS_TEST_CASE( &IndexedIOThreadingTest::testConcurrentReads, instance ) );
+	}
+};
+
+void addIndexedIOThreadingTest( boost::unit_test::test_suite *test )
+{
+	test->add( new IndexedIOThreadingTestSuite( ) );
+}
+
+} // namespace IECore
@@ -79,6 +79,52 @@ struct InternedStringTest
 		size_t numIterations = 10000000;
 		parallel_for( blocked_range<size_t>( 0, numIterations ), Constructor() );
 	}
+
+	struct UniqueConstructor
+	{
+		public :
+
+			UniqueConstructor( std::vector<InternedString> &strings )
+				:	m_strings( strings )
+			{
+			}
+
+			void operator()( const blocked_range<size_t> &r ) const
+			{
+				for( size_t i=r.begin(); i!=r.end(); ++i )
+				{
+					m_strings[i] = InternedString( "InternedStringTest" + lexical_cast<std::string>( i % 20000 ) );
+				}
+			}
+
+		private :
+
+			std::vector<InternedString> &m_strings;
+
+	};
+
+	// Many threads interning the same new strings at once, enough
+	// of them to make the table grow while they're being read.
+	void testConcurrentInsertion()
+	{
+		const size_t numStrings = 200000;
+		const size_t numUniqueStringsBefore = InternedString::numUniqueStrings();
+
+		std::vector<InternedString> strings( numStrings );
+		parallel_for( blocked_range<size_t>( 0, numStrings ), UniqueConstructor( strings ) );
+
+		BOOST_CHECK_EQUAL( InternedString::numUniqueStrings(), numUniqueStringsBefore + 20000 );
+
+		size_t numMismatches = 0;
+		for( size_t i = 0; i < numStrings; ++i )
+		{
+			if( strings[i] != strings[i % 20000] || strings[i].value() != "InternedStringTest" + lexical_cast<std::string>( i % 20000 ) )
+			{
+				numMismatches++;
+			}
+		}
+		BOOST_CHECK_EQUAL( numMismatches, 0u );
+	}
 };
 
 
@@ -90,6 +136,7 @@ struct InternedStringTestSuite : public boost::unit_test::test_suite
 		boost::shared_ptr<InternedStringTest> instance( new InternedStringTest() );
 
 		add( BOOST_CLASS_TEST_CASE( &InternedStringTest::testConcurrentConstruction, instance ) );
+		add( BOOST_CLASS_TEST_CASE( &InternedStringTest::testConcurrentInsertion, instance ) );
 
 	}
 };
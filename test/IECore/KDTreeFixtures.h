@@ -0,0 +1,70 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2014, Image Engine Design Inc. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+//     * Neither the name of Image Engine Design nor the names of any
+//       other contributors to this software may be used to endorse or
+//       promote products derived from this software without specific prior
+//       written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#ifndef IECORE_KDTREEFIXTURES_H
+#define IECORE_KDTREEFIXTURES_H
+
+#include "OpenEXR/ImathRandom.h"
+
+#include "IECore/VectorTypedData.h"
+
+namespace IECore
+{
+
+/// Fixtures shared by KDTreeThreadingTest and KDTreeBenchmark.
+namespace KDTreeFixtures
+{
+
+/// Returns numPoints points scattered randomly through a cube of side 20
+/// centred on the origin.
+inline V3fVectorDataPtr makePoints( unsigned numPoints )
+{
+	Imath::Rand32 rand( 1 );
+
+	V3fVectorDataPtr result = new V3fVectorData;
+	std::vector<Imath::V3f> &p = result->writable();
+	p.reserve( numPoints );
+	for( unsigned i = 0; i < numPoints; ++i )
+	{
+		p.push_back( Imath::V3f( rand.nextf( -10, 10 ), rand.nextf( -10, 10 ), rand.nextf( -10, 10 ) ) );
+	}
+
+	return result;
+}
+
+} // namespace KDTreeFixtures
+
+} // namespace IECore
+
+#endif // IECORE_KDTREEFIXTURES_H
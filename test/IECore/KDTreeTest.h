@@ -60,6 +60,8 @@ class KDTreeTest
 		void testNearestNeighour();
 		void testNearestNeighours();
 		void testNearestNNeighours();
+		void testBatchedNearestNeighbours();
+		void testBatchedNearestNNeighbours();
 
 	private:
 
@@ -99,6 +101,8 @@ struct KDTreeTestSuite : public boost::unit_test::test_suite
 		add( BOOST_CLASS_TEST_CASE( &KDTreeTest<T>::testNearestNeighour, instance ) );
 		add( BOOST_CLASS_TEST_CASE( &KDTreeTest<T>::testNearestNeighours, instance ) );
 		add( BOOST_CLASS_TEST_CASE( &KDTreeTest<T>::testNearestNNeighours, instance ) );
+		add( BOOST_CLASS_TEST_CASE( &KDTreeTest<T>::testBatchedNearestNeighbours, instance ) );
+		add( BOOST_CLASS_TEST_CASE( &KDTreeTest<T>::testBatchedNearestNNeighbours, instance ) );
 	}
 };
 
@@ -192,4 +192,50 @@ void KDTreeTest<T>::testNearestNNeighours()
 
 }
 
+template<typename T>
+void KDTreeTest<T>::testBatchedNearestNeighbours()
+{
+	typename T::BaseType radius = 0.05;
+	IteratorVector batchedNeighbours;
+	std::vector<size_t> offsets;
+	m_tree->nearestNeighbours( m_points.begin(), m_points.end(), radius, batchedNeighbours, offsets );
+
+	BOOST_CHECK_EQUAL( offsets.size(), m_points.size() + 1 );
+	BOOST_CHECK_EQUAL( offsets.back(), batchedNeighbours.size() );
+
+	// the batched results should be identical to those of individual queries
+	IteratorVector nearNeighbours;
+	for( size_t i=0; i<m_points.size(); i++ )
+	{
+		m_tree->nearestNeighbours( m_points[i], radius, nearNeighbours );
+		BOOST_CHECK_EQUAL( offsets[i+1] - offsets[i], nearNeighbours.size() );
+		BOOST_CHECK( std::equal( nearNeighbours.begin(), nearNeighbours.end(), batchedNeighbours.begin() + offsets[i] ) );
+	}
+}
+
+template<typename T>
+void KDTreeTest<T>::testBatchedNearestNNeighbours()
+{
+	unsigned int neighboursRequested = 4;
+	NeighbourVector batchedNeighbours;
+	std::vector<unsigned int> numFound;
+	m_tree->nearestNNeighbours( m_points.begin(), m_points.end(), neighboursRequested, batchedNeighbours, numFound );
+
+	BOOST_CHECK_EQUAL( numFound.size(), m_points.size() );
+	BOOST_CHECK_EQUAL( batchedNeighbours.size(), m_points.size() * neighboursRequested );
+
+	// the batched results should be identical to those of individual queries
+	NeighbourVector nearNeighbours;
+	for( size_t i=0; i<m_points.size(); i++ )
+	{
+		unsigned int numNeighbours = m_tree->nearestNNeighbours( m_points[i], neighboursRequested, nearNeighbours );
+		BOOST_CHECK_EQUAL( numFound[i], numNeighbours );
+		for( unsigned int j=0; j<numNeighbours; j++ )
+		{
+			BOOST_CHECK( batchedNeighbours[i*neighboursRequested+j].point == nearNeighbours[j].point );
+			BOOST_CHECK_EQUAL( batchedNeighbours[i*neighboursRequested+j].distSquared, nearNeighbours[j].distSquared );
+		}
+	}
+}
+
 }
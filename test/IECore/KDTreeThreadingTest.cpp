@@ -0,0 +1,103 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2014, Image Engine Design Inc. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+//     * Neither the name of Image Engine Design nor the names of any
+//       other contributors to this software may be used to endorse or
+//       promote products derived from this software without specific prior
+//       written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#include "tbb/tbb.h"
+
+#include "IECore/PointDensitiesOp.h"
+#include "IECore/PointNormalsOp.h"
+#include "IECore/ObjectParameter.h"
+#include "IECore/VectorTypedData.h"
+
+#include "KDTreeFixtures.h"
+#include "KDTreeThreadingTest.h"
+
+using namespace boost::unit_test;
+using namespace tbb;
+using namespace Imath;
+
+namespace IECore
+{
+
+struct KDTreeThreadingTest
+{
+
+		return result;
+	}
+
+	ObjectPtr densities( ConstV3fVectorDataPtr points, int numThreads )
+	{
+		task_scheduler_init scheduler( numThreads );
+
+		PointDensitiesOpPtr op = new PointDensitiesOp;
+		op->pointParameter()->setValue( points->copy() );
+		return op->operate();
+	}
+
+	ObjectPtr normals( ConstV3fVectorDataPtr points, int numThreads )
+	{
+		task_scheduler_init scheduler( numThreads );
+
+		PointNormalsOpPtr op = new PointNormalsOp;
+		op->pointParameter()->setValue( points->copy() );
+		return op->operate();
+	}
+
+	void testOpsMatchSerial()
+	{
+		V3fVectorDataPtr points = KDTreeFixtures::makePoints( 10000 );
+
+		// we expect bit-identical results, not just close ones
+		BOOST_CHECK( densities( points, 1 )->isEqualTo( densities( points, task_scheduler_init::automatic ).get() ) );
+		BOOST_CHECK( normals( points, 1 )->isEqualTo( normals( points, task_scheduler_init::automatic ).get() ) );
+	}
+
+};
+
+struct KDTreeThreadingTestSuite : public boost::unit_test::test_suite
+{
+
+	KDTreeThreadingTestSuite() : boost::unit_test::test_suite( "KDTreeThreadingTestSuite" )
+	{
+		boost::shared_ptr<KDTreeThreadingTest> instance( new KDTreeThreadingTest() );
+
+		add( BOOST_CLASS_TEST_CASE( &KDTreeThreadingTest::testOpsMatchSerial, instance ) );
+	}
+};
+
+void addKDTreeThreadingTest( boost::unit_test::test_suite *test )
+{
+	test->add( new KDTreeThreadingTestSuite() );
+}
+
+} // namespace IECore
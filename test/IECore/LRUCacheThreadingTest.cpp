@@ -51,11 +51,12 @@ namespace IECore
 struct LRUCacheThreadingTest
 {
 		
+	template<typename Cache>
 	struct GetFromCache
 	{
 		public :
 		
-			GetFromCache( LRUCache<int, IntDataPtr> &cache )
+			GetFromCache( Cache &cache )
 				:	m_cache( cache )
 			{
 			}
@@ -72,7 +73,7 @@ struct LRUCacheThreadingTest
 			
 		private :
 		
-			LRUCache<int, IntDataPtr> &m_cache;
+			Cache &m_cache;
 			
 	};
 
@@ -86,7 +87,59 @@ struct LRUCacheThreadingTest
 	{
 		LRUCache<int, IntDataPtr> cache( get, 1000 );
 		
-		parallel_for( blocked_range<size_t>( 0, 10000 ), GetFromCache( cache ) );
+		parallel_for( blocked_range<size_t>( 0, 10000 ), GetFromCache<LRUCache<int, IntDataPtr> >( cache ) );
+	}
+
+	void testSecondChance()
+	{
+		typedef LRUCache<int, IntDataPtr, LRUCachePolicy::SecondChance> Cache;
+		Cache cache( get, 1000 );
+
+		parallel_for( blocked_range<size_t>( 0, 10000 ), GetFromCache<Cache>( cache ) );
+		BOOST_CHECK( cache.currentCost() <= 1000 );
+
+		cache.clear();
+		BOOST_CHECK_EQUAL( cache.currentCost(), size_t( 0 ) );
+	}
+
+	// Checks that a recently used item survives eviction when an
+	// item which hasn't been used since is available instead. The
+	// ObjectPool and ComputationCache rely on this behaviour from
+	// the SecondChance policy.
+	template<typename Policy>
+	void testEvictionOrder()
+	{
+		// room for three items
+		LRUCache<int, IntDataPtr, Policy> cache( get, 30 );
+
+		cache.get( 1 );
+		cache.get( 2 );
+		cache.get( 3 );
+		BOOST_CHECK_EQUAL( cache.currentCost(), size_t( 30 ) );
+
+		// adding a fourth item evicts the first
+		cache.get( 4 );
+		BOOST_CHECK( !cache.cached( 1 ) );
+		BOOST_CHECK( cache.cached( 2 ) );
+		BOOST_CHECK( cache.cached( 3 ) );
+		BOOST_CHECK( cache.cached( 4 ) );
+
+		// touching the oldest item means the next
+		// oldest is evicted in its place
+		BOOST_CHECK_EQUAL( cache.get( 2 )->readable(), 2 );
+		cache.get( 5 );
+		BOOST_CHECK( cache.cached( 2 ) );
+		BOOST_CHECK( !cache.cached( 3 ) );
+		BOOST_CHECK( cache.cached( 4 ) );
+		BOOST_CHECK( cache.cached( 5 ) );
+		BOOST_CHECK_EQUAL( cache.currentCost(), size_t( 30 ) );
+
+		// items stored with set() count as touched too
+		BOOST_CHECK( cache.set( 6, new IntData( 6 ), 10 ) );
+		BOOST_CHECK( cache.cached( 2 ) );
+		BOOST_CHECK( !cache.cached( 4 ) );
+		BOOST_CHECK( cache.cached( 5 ) );
+		BOOST_CHECK( cache.cached( 6 ) );
 	}
 };
 
@@ -99,6 +152,9 @@ struct LRUCacheThreadingTestSuite : public boost::unit_test::test_suite
 		boost::shared_ptr<LRUCacheThreadingTest> instance( new LRUCacheThreadingTest() );
 
 		add( BOOST_CLASS_TEST_CASE( &LRUCacheThreadingTest::test, instance ) );
+		add( BOOST_CLASS_TEST_CASE( &LRUCacheThreadingTest::testSecondChance, instance ) );
+		add( BOOST_CLASS_TEST_CASE( &LRUCacheThreadingTest::testEvictionOrder<LRUCachePolicy::Exact>, instance ) );
+		add( BOOST_CLASS_TEST_CASE( &LRUCacheThreadingTest::testEvictionOrder<LRUCachePolicy::SecondChance>, instance ) );
 	}
 };
 
@@ -0,0 +1,193 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2014, Image Engine Design Inc. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+//     * Neither the name of Image Engine Design nor the names of any
+//       other contributors to this software may be used to endorse or
+//       promote products derived from this software without specific prior
+//       written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#include <vector>
+
+#include "boost/filesystem/operations.hpp"
+
+#include "IECore/FileIndexedIO.h"
+#include "IECore/BlobStore.h"
+#include "IECore/MappedVectorData.h"
+
+#include "MappedVectorDataTest.h"
+
+using namespace boost;
+using namespace boost::unit_test;
+
+namespace IECore
+{
+
+struct MappedVectorDataTest
+{
+
+	MappedVectorDataTest()
+		:	m_fileName( "test/IECore/mappedVectorDataTest.fio" ), m_blobStoreDirectory( "test/IECore/mappedVectorDataTestBlobs" )
+	{
+	}
+
+	~MappedVectorDataTest()
+	{
+		boost::filesystem::remove( m_fileName );
+		boost::filesystem::remove_all( m_blobStoreDirectory );
+	}
+
+	void writeFile()
+	{
+		IndexedIOPtr io = new FileIndexedIO( m_fileName, IndexedIO::rootPath, IndexedIO::Write );
+
+		// write a char first, so that the arrays following it
+		// need padding to be aligned.
+		io->write( "c", 'c' );
+
+		std::vector<float> f;
+		std::vector<double> d;
+		for( int i = 0; i < 1000; i++ )
+		{
+			f.push_back( i );
+			d.push_back( -i );
+		}
+		io->write( "f", &f[0], f.size() );
+		io->write( "d", &d[0], d.size() );
+	}
+
+	void testMappedRead()
+	{
+		writeFile();
+
+		FileIndexedIOPtr io = new FileIndexedIO( m_fileName, IndexedIO::rootPath, IndexedIO::Read );
+
+		MappedVectorData<float>::Ptr f = io->readMapped<float>( "f" );
+		BOOST_REQUIRE( f );
+		BOOST_CHECK( f->isMapped() );
+		BOOST_CHECK_EQUAL( f->size(), 1000u );
+		for( int i = 0; i < 1000; i++ )
+		{
+			BOOST_CHECK_EQUAL( (*f)[i], (float)i );
+		}
+
+		MappedVectorData<double>::Ptr d = io->readMapped<double>( "d" );
+		BOOST_REQUIRE( d );
+		BOOST_CHECK( d->isMapped() );
+		BOOST_CHECK_EQUAL( d->size(), 1000u );
+		BOOST_CHECK_EQUAL( d->end() - d->begin(), 1000 );
+		BOOST_CHECK_EQUAL( (*d)[999], -999.0 );
+
+		BOOST_CHECK_THROW( io->readMapped<int>( "f" ), IOException );
+		BOOST_CHECK_THROW( io->readMapped<float>( "notThere" ), IOException );
+	}
+
+	void testCopyOnWrite()
+	{
+		writeFile();
+
+		FileIndexedIOPtr io = new FileIndexedIO( m_fileName, IndexedIO::rootPath, IndexedIO::Read );
+		MappedVectorData<float>::Ptr f = io->readMapped<float>( "f" );
+		BOOST_REQUIRE( f );
+
+		// the mapping must outlive the file handle
+		io = 0;
+		BOOST_CHECK_EQUAL( (*f)[10], 10.0f );
+
+		f->writable()[10] = 100.0f;
+		BOOST_CHECK( !f->isMapped() );
+		BOOST_CHECK_EQUAL( (*f)[10], 100.0f );
+		BOOST_CHECK_EQUAL( (*f)[11], 11.0f );
+
+		FloatVectorDataPtr data = f->data();
+		BOOST_CHECK_EQUAL( data->readable().size(), 1000u );
+		BOOST_CHECK_EQUAL( data->readable()[10], 100.0f );
+
+		// and the file itself must be unchanged
+		io = new FileIndexedIO( m_fileName, IndexedIO::rootPath, IndexedIO::Read );
+		MappedVectorData<float>::Ptr f2 = io->readMapped<float>( "f" );
+		BOOST_REQUIRE( f2 );
+		BOOST_CHECK_EQUAL( (*f2)[10], 10.0f );
+	}
+
+	void testMappedBlobStoreRead()
+	{
+		std::vector<float> f;
+		for( int i = 0; i < 1000; i++ )
+		{
+			f.push_back( i );
+		}
+
+		FileIndexedIOPtr io = new FileIndexedIO( m_fileName, IndexedIO::rootPath, IndexedIO::Write );
+		io->setBlobStore( BlobStore::open( m_blobStoreDirectory ), 0 );
+		io->write( "f", &f[0], f.size() );
+		io = 0;
+
+		// loose blobs can't be mapped
+		io = new FileIndexedIO( m_fileName, IndexedIO::rootPath, IndexedIO::Read );
+		BOOST_CHECK( !io->readMapped<float>( "f" ) );
+
+		// but packed ones can
+		BlobStore::open( m_blobStoreDirectory )->repack();
+		MappedVectorData<float>::Ptr m = io->readMapped<float>( "f" );
+		BOOST_REQUIRE( m );
+		BOOST_CHECK( m->isMapped() );
+		BOOST_CHECK_EQUAL( m->size(), 1000u );
+
+		// and the view keeps the pack alive
+		io = 0;
+		for( int i = 0; i < 1000; i++ )
+		{
+			BOOST_CHECK_EQUAL( (*m)[i], (float)i );
+		}
+	}
+
+	std::string m_fileName;
+	std::string m_blobStoreDirectory;
+
+};
+
+struct MappedVectorDataTestSuite : public boost::unit_test::test_suite
+{
+
+	MappedVectorDataTestSuite() : boost::unit_test::test_suite( "MappedVectorDataTestSuite" )
+	{
+		boost::shared_ptr<MappedVectorDataTest> instance( new MappedVectorDataTest() );
+
+		add( BOOST_CLASS_TEST_CASE( &MappedVectorDataTest::testMappedRead, instance ) );
+		add( BOOST_CLASS_TEST_CASE( &MappedVectorDataTest::testCopyOnWrite, instance ) );
+		add( BOOST_CLASS_TEST_CASE( &MappedVectorDataTest::testMappedBlobStoreRead, instance ) );
+	}
+};
+
+void addMappedVectorDataTest( boost::unit_test::test_suite *test )
+{
+	test->add( new MappedVectorDataTestSuite( ) );
+}
+
+} // namespace IECore
@@ -374,6 +374,68 @@ class TestMeshPrimitiveEvaluator( unittest.TestCase ) :
 					hits = mpe.intersectionPoints( origin, direction )
 					self.failIf( hits )
 
+	def testBatchedQueries( self ) :
+
+		m = Reader.create( "test/IECore/data/cobFiles/pSphereShape1.cob" ).read()
+		e = MeshPrimitiveEvaluator( m )
+		r = e.createResult()
+
+		random.seed( 1 )
+		points = V3fVectorData()
+		directions = V3fVectorData()
+		for i in range( 0, 1000 ) :
+			points.append( V3f( random.uniform( -2, 2 ), random.uniform( -2, 2 ), random.uniform( -2, 2 ) ) )
+			directions.append( V3f( random.uniform( -1, 1 ), random.uniform( -1, 1 ), random.uniform( -1, 1 ) ) )
+
+		triangleIndices, barycentrics, positions, normals = e.closestPoints( points )
+		self.assertEqual( len( triangleIndices ), len( points ) )
+		for i in range( 0, len( points ) ) :
+			self.failUnless( e.closestPoint( points[i], r ) )
+			self.assertEqual( triangleIndices[i], r.triangleIndex() )
+			self.failUnless( barycentrics[i].equalWithAbsError( r.barycentricCoordinates(), 0.00001 ) )
+			self.failUnless( positions[i].equalWithAbsError( r.point(), 0.00001 ) )
+			self.failUnless( normals[i].equalWithAbsError( r.normal(), 0.00001 ) )
+
+		for maxDistance in ( 0.5, 100000 ) :
+			triangleIndices, barycentrics, positions, normals = e.nearestIntersections( points, directions, maxDistance )
+			self.assertEqual( len( triangleIndices ), len( points ) )
+			for i in range( 0, len( points ) ) :
+				hit = e.intersectionPoint( points[i], directions[i], r, maxDistance )
+				if hit :
+					self.assertEqual( triangleIndices[i], r.triangleIndex() )
+					self.failUnless( positions[i].equalWithAbsError( r.point(), 0.00001 ) )
+					self.failUnless( normals[i].equalWithAbsError( r.normal(), 0.00001 ) )
+				else :
+					self.assertEqual( triangleIndices[i], -1 )
+
+		self.assertRaises( Exception, e.nearestIntersections, points, V3fVectorData() )
+
+	def testBVHAccelerator( self ) :
+
+		m = Reader.create( "test/IECore/data/cobFiles/pSphereShape1.cob" ).read()
+		kd = MeshPrimitiveEvaluator( m )
+		bvh = MeshPrimitiveEvaluator( m, MeshPrimitiveEvaluator.Accelerator.BVH )
+
+		r1 = kd.createResult()
+		r2 = bvh.createResult()
+
+		random.seed( 2 )
+		for i in range( 0, 1000 ) :
+
+			origin = V3f( random.uniform( -2, 2 ), random.uniform( -2, 2 ), random.uniform( -2, 2 ) )
+			direction = V3f( random.uniform( -1, 1 ), random.uniform( -1, 1 ), random.uniform( -1, 1 ) )
+
+			self.failUnless( kd.closestPoint( origin, r1 ) )
+			self.failUnless( bvh.closestPoint( origin, r2 ) )
+			self.assertAlmostEqual( ( r1.point() - origin ).length(), ( r2.point() - origin ).length(), 4 )
+
+			hit = kd.intersectionPoint( origin, direction, r1 )
+			self.assertEqual( bvh.intersectionPoint( origin, direction, r2 ), hit )
+			if hit :
+				self.failUnless( r1.point().equalWithAbsError( r2.point(), 0.0001 ) )
+
+			self.assertEqual( len( kd.intersectionPoints( origin, direction ) ), len( bvh.intersectionPoints( origin, direction ) ) )
+
 if __name__ == "__main__":
 	unittest.main()
 
@@ -0,0 +1,137 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2014, Image Engine Design Inc. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+//     * Neither the name of Image Engine Design nor the names of any
+//       other contributors to this software may be used to endorse or
+//       promote products derived from this software without specific prior
+//       written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#ifndef IECORE_POINTSMOOTHSKINNINGOPFIXTURES_H
+#define IECORE_POINTSMOOTHSKINNINGOPFIXTURES_H
+
+#include "boost/format.hpp"
+
+#include "OpenEXR/ImathRandom.h"
+
+#include "IECore/PointSmoothSkinningOp.h"
+#include "IECore/PointsPrimitive.h"
+#include "IECore/SmoothSkinningData.h"
+
+namespace IECore
+{
+
+/// Fixtures shared by PointSmoothSkinningOpTest and PointSmoothSkinningOpBenchmark.
+namespace PointSmoothSkinningOpFixtures
+{
+
+const unsigned numInfluences = 50;
+
+/// Returns numPoints randomly placed points with random normals.
+inline PointsPrimitivePtr makePoints( unsigned numPoints )
+{
+	Imath::Rand32 rand( 1 );
+
+	V3fVectorDataPtr p = new V3fVectorData;
+	V3fVectorDataPtr n = new V3fVectorData;
+	for( unsigned i = 0; i < numPoints; ++i )
+	{
+		p->writable().push_back( Imath::V3f( rand.nextf( -10, 10 ), rand.nextf( -10, 10 ), rand.nextf( -10, 10 ) ) );
+		n->writable().push_back( Imath::V3f( rand.nextf( -1, 1 ), rand.nextf( -1, 1 ), rand.nextf( -1, 1 ) ).normalized() );
+	}
+
+	PointsPrimitivePtr result = new PointsPrimitive( p );
+	result->variables["N"] = PrimitiveVariable( PrimitiveVariable::Vertex, n );
+	return result;
+}
+
+/// Returns skinning data binding each point to influencesPerPoint
+/// consecutive influences, weighted equally.
+inline SmoothSkinningDataPtr makeSmoothSkinningData( unsigned numPoints, unsigned influencesPerPoint )
+{
+	Imath::Rand32 rand( 2 );
+
+	StringVectorDataPtr names = new StringVectorData;
+	M44fVectorDataPtr pose = new M44fVectorData;
+	for( unsigned i = 0; i < numInfluences; ++i )
+	{
+		names->writable().push_back( boost::str( boost::format( "joint%d" ) % i ) );
+		pose->writable().push_back( Imath::M44f().translate( Imath::V3f( rand.nextf( -10, 10 ), rand.nextf( -10, 10 ), rand.nextf( -10, 10 ) ) ).inverse() );
+	}
+
+	IntVectorDataPtr offsets = new IntVectorData;
+	IntVectorDataPtr counts = new IntVectorData;
+	IntVectorDataPtr indices = new IntVectorData;
+	FloatVectorDataPtr weights = new FloatVectorData;
+	for( unsigned i = 0; i < numPoints; ++i )
+	{
+		offsets->writable().push_back( indices->readable().size() );
+		counts->writable().push_back( influencesPerPoint );
+		unsigned firstInfluence = rand.nexti() % ( numInfluences - influencesPerPoint );
+		for( unsigned j = 0; j < influencesPerPoint; ++j )
+		{
+			indices->writable().push_back( firstInfluence + j );
+			weights->writable().push_back( 1.0f / influencesPerPoint );
+		}
+	}
+
+	return new SmoothSkinningData( names, pose, offsets, counts, indices, weights );
+}
+
+/// Returns a random pose for the numInfluences influences.
+inline M44fVectorDataPtr makeDeformationPose()
+{
+	Imath::Rand32 rand( 3 );
+
+	M44fVectorDataPtr result = new M44fVectorData;
+	for( unsigned i = 0; i < numInfluences; ++i )
+	{
+		Imath::M44f m;
+		m.rotate( Imath::V3f( rand.nextf( -1, 1 ), rand.nextf( -1, 1 ), rand.nextf( -1, 1 ) ) );
+		m.translate( Imath::V3f( rand.nextf( -10, 10 ), rand.nextf( -10, 10 ), rand.nextf( -10, 10 ) ) );
+		result->writable().push_back( m );
+	}
+	return result;
+}
+
+/// Returns an op which deforms points and normals in place.
+inline PointSmoothSkinningOpPtr makeOp( SmoothSkinningDataPtr ssd, M44fVectorDataPtr pose )
+{
+	PointSmoothSkinningOpPtr op = new PointSmoothSkinningOp;
+	op->copyParameter()->setTypedValue( false );
+	op->deformNormalsParameter()->setTypedValue( true );
+	op->smoothSkinningDataParameter()->setValue( ssd );
+	op->deformationPoseParameter()->setValue( pose );
+	return op;
+}
+
+} // namespace PointSmoothSkinningOpFixtures
+
+} // namespace IECore
+
+#endif // IECORE_POINTSMOOTHSKINNINGOPFIXTURES_H
@@ -0,0 +1,124 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2014, Image Engine Design Inc. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+//     * Neither the name of Image Engine Design nor the names of any
+//       other contributors to this software may be used to endorse or
+//       promote products derived from this software without specific prior
+//       written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#include "boost/format.hpp"
+
+#include "IECore/PointSmoothSkinningOp.h"
+#include "IECore/PointsPrimitive.h"
+#include "IECore/SmoothSkinningData.h"
+
+#include "PointSmoothSkinningOpFixtures.h"
+#include "PointSmoothSkinningOpTest.h"
+
+using namespace boost;
+using namespace boost::unit_test;
+using namespace Imath;
+
+namespace IECore
+{
+
+struct PointSmoothSkinningOpTest
+{
+
+	// The straightforward serial implementation, which the op must match exactly.
+	void skin( std::vector<V3f> &p, std::vector<V3f> &n, const SmoothSkinningData *ssd, const std::vector<M44f> &pose )
+	{
+		std::vector<M44f> skinningMatrices;
+		for( size_t i = 0; i < pose.size(); ++i )
+		{
+			skinningMatrices.push_back( ssd->influencePose()->readable()[i] * pose[i] );
+		}
+
+		const std::vector<int> &offsets = ssd->pointIndexOffsets()->readable();
+		const std::vector<int> &counts = ssd->pointInfluenceCounts()->readable();
+		const std::vector<int> &indices = ssd->pointInfluenceIndices()->readable();
+		const std::vector<float> &weights = ssd->pointInfluenceWeights()->readable();
+
+		for( size_t i = 0; i < p.size(); ++i )
+		{
+			V3f pNew( 0 ), nNew( 0 );
+			for( int j = offsets[i]; j < offsets[i] + counts[i]; ++j )
+			{
+				pNew += p[i] * skinningMatrices[indices[j]] * weights[j];
+				V3f nUnweighted;
+				skinningMatrices[indices[j]].multDirMatrix( n[i], nUnweighted );
+				nNew += nUnweighted * weights[j];
+			}
+			p[i] = pNew;
+			n[i] = nNew;
+		}
+	}
+
+	void testMatchesSerial()
+	{
+		const unsigned numPoints = 10000;
+		for( unsigned influencesPerPoint = 1; influencesPerPoint <= 8; ++influencesPerPoint )
+		{
+			PointsPrimitivePtr points = PointSmoothSkinningOpFixtures::makePoints( numPoints );
+			SmoothSkinningDataPtr ssd = PointSmoothSkinningOpFixtures::makeSmoothSkinningData( numPoints, influencesPerPoint );
+			M44fVectorDataPtr pose = PointSmoothSkinningOpFixtures::makeDeformationPose();
+
+			std::vector<V3f> p = points->variableData<V3fVectorData>( "P" )->readable();
+			std::vector<V3f> n = points->variableData<V3fVectorData>( "N" )->readable();
+			skin( p, n, ssd.get(), pose->readable() );
+
+			PointSmoothSkinningOpPtr op = PointSmoothSkinningOpFixtures::makeOp( ssd, pose );
+			op->inputParameter()->setValue( points );
+			op->operate();
+
+			// we expect bit-identical results, not just close ones
+			BOOST_CHECK( p == points->variableData<V3fVectorData>( "P" )->readable() );
+			BOOST_CHECK( n == points->variableData<V3fVectorData>( "N" )->readable() );
+		}
+	}
+
+};
+
+struct PointSmoothSkinningOpTestSuite : public boost::unit_test::test_suite
+{
+
+	PointSmoothSkinningOpTestSuite() : boost::unit_test::test_suite( "PointSmoothSkinningOpTestSuite" )
+	{
+		boost::shared_ptr<PointSmoothSkinningOpTest> instance( new PointSmoothSkinningOpTest() );
+
+		add( BOOST_CLASS_TEST_CASE( &PointSmoothSkinningOpTest::testMatchesSerial, instance ) );
+	}
+};
+
+void addPointSmoothSkinningOpTest( boost::unit_test::test_suite *test )
+{
+	test->add( new PointSmoothSkinningOpTestSuite() );
+}
+
+} // namespace IECore
@@ -41,12 +41,14 @@
 #include <iostream>
 #include <vector>
 #include <string>
+#include <algorithm>
 
 #include "boost/test/unit_test.hpp"
 #include "boost/test/floating_point_comparison.hpp"
 #include "boost/random.hpp"
 
 #include "IECore/RadixSort.h"
+#include "IECore/Exception.h"
 
 using namespace Imath;
 
@@ -90,6 +92,58 @@ struct RadixSortTest
 			}
 		}
 	}
+
+	template<typename T>
+	void testSortInPlace()
+	{
+		boost::mt19937 generator( 42 );
+		boost::uniform_real<> uni_dist( 0, 1 );
+		boost::variate_generator<boost::mt19937&, boost::uniform_real<> > uni( generator, uni_dist );
+
+		const double max = 0.5 * (double)std::numeric_limits<T>::max();
+		const double min = std::numeric_limits<T>::is_signed ? -max : 0;
+
+		// sizes either side of the block size used to divide the work between threads
+		const unsigned sizes[] = { 0, 1, 2, 1000, 65536, 65537, 1000000 };
+		for( unsigned s = 0; s < sizeof( sizes ) / sizeof( unsigned ); s++ )
+		{
+			std::vector<T> keys;
+			std::vector<unsigned int> values;
+			std::vector<std::pair<T, unsigned int> > expected;
+			for( unsigned n = 0; n < sizes[s]; n++ )
+			{
+				// few enough distinct keys that there are plenty of duplicates to check stability with
+				const T key = static_cast<T>( min + ( max - min ) * ( floor( uni() * 1000 ) / 1000 ) );
+				keys.push_back( key );
+				values.push_back( n );
+				expected.push_back( std::pair<T, unsigned int>( key, n ) );
+			}
+
+			std::vector<T> keysOnly = keys;
+
+			std::stable_sort( expected.begin(), expected.end(), firstLess<T> );
+			RadixSort::sort( keys, values );
+			RadixSort::sort( keysOnly );
+
+			for( unsigned n = 0; n < sizes[s]; n++ )
+			{
+				BOOST_CHECK( keys[n] == expected[n].first );
+				BOOST_CHECK( keysOnly[n] == expected[n].first );
+				BOOST_CHECK_EQUAL( values[n], expected[n].second );
+			}
+		}
+
+		std::vector<T> keys( 2 );
+		std::vector<unsigned int> values( 1 );
+		BOOST_CHECK_THROW( RadixSort::sort( keys, values ), InvalidArgumentException );
+	}
+
+	template<typename T>
+	static bool firstLess( const std::pair<T, unsigned int> &a, const std::pair<T, unsigned int> &b )
+	{
+		return a.first < b.first;
+	}
+
 };
 
 struct RadixSortTestSuite : public boost::unit_test::test_suite
@@ -102,6 +156,12 @@ struct RadixSortTestSuite : public boost::unit_test::test_suite
 		add( BOOST_CLASS_TEST_CASE( &RadixSortTest::test<float>, instance ) );
 		add( BOOST_CLASS_TEST_CASE( &RadixSortTest::test<unsigned int>, instance ) );
 		add( BOOST_CLASS_TEST_CASE( &RadixSortTest::test<int>, instance ) );
+		add( BOOST_CLASS_TEST_CASE( &RadixSortTest::testSortInPlace<float>, instance ) );
+		add( BOOST_CLASS_TEST_CASE( &RadixSortTest::testSortInPlace<double>, instance ) );
+		add( BOOST_CLASS_TEST_CASE( &RadixSortTest::testSortInPlace<int>, instance ) );
+		add( BOOST_CLASS_TEST_CASE( &RadixSortTest::testSortInPlace<unsigned int>, instance ) );
+		add( BOOST_CLASS_TEST_CASE( &RadixSortTest::testSortInPlace<int64_t>, instance ) );
+		add( BOOST_CLASS_TEST_CASE( &RadixSortTest::testSortInPlace<uint64_t>, instance ) );
 	}
 
 };
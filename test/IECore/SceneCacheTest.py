@@ -647,6 +647,18 @@ class SceneCacheTest( unittest.TestCase ) :
 		self.assertTrue( B.hasTag( "t3", IECore.SceneInterface.TagFilter.EveryTag ) )
 		self.assertTrue( B.hasTag( "ObjectType:SpherePrimitive", IECore.SceneInterface.TagFilter.EveryTag ) )
 		self.assertTrue( d.hasTag( "ObjectType:SpherePrimitive", IECore.SceneInterface.TagFilter.EveryTag ) )
+
+		self.assertEqual( sorted( m.taggedPaths( "t1" ) ), [ [ "A" ], [ "A", "a", "aa" ], [ "A", "a", "ab" ] ] )
+		self.assertEqual( m.taggedPaths( "t3" ), [ [ "B", "c" ] ] )
+		self.assertEqual( B.taggedPaths( "t4" ), [ [ "B" ] ] )
+		self.assertEqual( B.taggedPaths( "t1" ), [] )
+		self.assertEqual( m.taggedPaths( "t5" ), [] )
+
+		# object type tags are found by traversal, as they're left out of the tag index
+		self.assertEqual( m.taggedPaths( "ObjectType:MeshPrimitive" ), [ [ "A", "a", "ab" ] ] )
+		self.assertEqual( B.taggedPaths( "ObjectType:SpherePrimitive" ), [ [ "B", "d" ] ] )
+		tagIndex = IECore.FileIndexedIO( "/tmp/test.scc", [ "root", "tagIndex" ], IECore.IndexedIO.OpenMode.Read )
+		self.assertEqual( set( [ str( t ) for t in tagIndex.entryIds() ] ), set( [ "t1", "t2", "t3", "t4" ] ) )
 	
 	def testSampleTimeOrder( self ):
 		
@@ -773,6 +785,276 @@ class SceneCacheTest( unittest.TestCase ) :
 		t1 = checkHash( IECore.SceneInterface.HashType.HierarchyHash, m, 1 )
 		self.assertEqual( t0[0] + t1[0], len(t0[1].union(t1[1])) )		# all locations differ
 
+	def testPrefetch( self ):
+
+		def collect( scene, time, result ) :
+
+			result[ IECore.SceneInterface.pathToString( scene.path() ) ] = (
+				scene.readBound( time ),
+				scene.readTransform( time ),
+				[ scene.readAttribute( a, time ) for a in scene.attributeNames() ],
+				scene.readObject( time ) if scene.hasObject() else None,
+			)
+			for c in scene.childNames() :
+				collect( scene.child( c ), time, result )
+
+		expected = {}
+		collect( IECore.SceneCache( "test/IECore/data/sccFiles/animatedSpheres.scc", IECore.IndexedIO.OpenMode.Read ), 1.5, expected )
+
+		m = IECore.SceneCache( "test/IECore/data/sccFiles/animatedSpheres.scc", IECore.IndexedIO.OpenMode.Read )
+		p = m.prefetch( [ [] ], 1.5 )
+		self.failUnless( isinstance( p, IECore.SceneCache.Prefetch ) )
+		p.wait()
+		self.failUnless( p.done() )
+
+		result = {}
+		collect( m, 1.5, result )
+		self.assertEqual( result, expected )
+
+		# prefetching a subset of the data and missing paths should be fine too
+		p = m.prefetch( [ [ "A" ], [ "B", "b" ], [ "iDontExist" ] ], 0.5, IECore.SceneCache.PrefetchData.PrefetchObject | IECore.SceneCache.PrefetchData.PrefetchTransform )
+		p.wait()
+
+		# destroying the handle cancels the prefetch rather than waiting for it,
+		# and mustn't affect subsequent reads.
+		m = IECore.SceneCache( "test/IECore/data/sccFiles/animatedSpheres.scc", IECore.IndexedIO.OpenMode.Read )
+		p = m.prefetch( [ [] ], 1.5 )
+		del p
+
+		result = {}
+		collect( m, 1.5, result )
+		self.assertEqual( result, expected )
+
+		m = IECore.SceneCache( "/tmp/test.scc", IECore.IndexedIO.OpenMode.Write )
+		self.assertRaises( RuntimeError, m.prefetch, [ [] ], 0 )
+
+	def testFinalise( self ):
+
+		def write( fileName, finalise ) :
+
+			m = IECore.SceneCache( fileName, IECore.IndexedIO.OpenMode.Write )
+			m.writeTags( [ "root" ] )
+			for i in range( 0, 4 ) :
+				a = m.createChild( "a%d" % i )
+				a.writeTags( [ "a" ] )
+				for j in range( 0, 3 ) :
+					b = a.createChild( "b%d" % j )
+					b.writeTags( [ "b" ] )
+					for t in ( 0.0, 1.0, 2.0 ) :
+						b.writeTransform( IECore.M44dData( IECore.M44d.createTranslated( IECore.V3d( i, j, t ) ) * IECore.M44d.createRotated( IECore.V3d( 0, t, 0 ) ) ), t )
+					for t in ( 0.5, 1.5 ) :
+						b.writeObject( IECore.SpherePrimitive( t + i ), t )
+					if finalise :
+						b.finalise()
+						self.assertRaises( RuntimeError, b.writeObject, IECore.SpherePrimitive( 1 ), 3.0 )
+						self.assertRaises( RuntimeError, a.child, "b%d" % j )
+						self.assertRaises( RuntimeError, a.createChild, "b%d" % j )
+						# b has already recorded its ancestor tags
+						self.assertRaises( RuntimeError, a.writeTags, [ "late" ] )
+						self.assertRaises( RuntimeError, m.writeTags, [ "late" ] )
+				if i == 3 :
+					# overrides the bounds already accumulated from the finalised children
+					a.writeBound( IECore.Box3d( IECore.V3d( -10 ), IECore.V3d( 10 ) ), 0.0 )
+				if finalise and i % 2 :
+					a.finalise()
+
+			if finalise :
+				self.assertRaises( RuntimeError, m.finalise )
+
+		def collect( scene, result ) :
+
+			for t in ( 0.0, 0.5, 1.0, 1.5, 2.0 ) :
+				result.append( (
+					scene.path(),
+					scene.readBound( t ),
+					scene.readTransformAsMatrix( t ),
+					scene.readObject( t ) if scene.hasObject() else None,
+					sorted( scene.readTags( IECore.SceneInterface.TagFilter.EveryTag ) ),
+				) )
+			for c in sorted( scene.childNames() ) :
+				collect( scene.child( c ), result )
+
+		write( "/tmp/test.scc", False )
+		write( "/tmp/testFinalised.scc", True )
+
+		expected = []
+		collect( IECore.SceneCache( "/tmp/test.scc", IECore.IndexedIO.OpenMode.Read ), expected )
+		result = []
+		m = IECore.SceneCache( "/tmp/testFinalised.scc", IECore.IndexedIO.OpenMode.Read )
+		collect( m, result )
+		self.assertEqual( result, expected )
+		self.assertEqual( sorted( m.taggedPaths( "b" ) ), sorted( IECore.SceneCache( "/tmp/test.scc", IECore.IndexedIO.OpenMode.Read ).taggedPaths( "b" ) ) )
+
+	def testFinaliseWritesTagIndexInChunks( self ):
+
+		m = IECore.SceneCache( "/tmp/test.scc", IECore.IndexedIO.OpenMode.Write )
+		for i in range( 0, 12 ) :
+			a = m.createChild( "a%d" % i )
+			for j in range( 0, 1000 ) :
+				b = a.createChild( "b%d" % j )
+				b.writeTags( [ "b" ] )
+				if j % 100 == 0 :
+					b.writeTags( [ "rare" ] )
+			a.finalise()
+		del m, a, b
+
+		# the paths accumulated by the first finalised subtrees were written
+		# out before the root was flushed, so the index has several chunks
+		tagIndex = IECore.FileIndexedIO( "/tmp/test.scc", [ "root", "tagIndex" ], IECore.IndexedIO.OpenMode.Read )
+		self.assertTrue( len( tagIndex.subdirectory( "b" ).entryIds() ) > 1 )
+
+		def walk( scene, tag, result ) :
+
+			if scene.hasTag( tag, IECore.SceneInterface.TagFilter.LocalTag ) :
+				result.append( scene.path() )
+			for c in scene.childNames() :
+				walk( scene.child( c ), tag, result )
+
+		m = IECore.SceneCache( "/tmp/test.scc", IECore.IndexedIO.OpenMode.Read )
+		for tag, count in ( ( "b", 12000 ), ( "rare", 120 ) ) :
+			paths = m.taggedPaths( tag )
+			self.assertEqual( len( paths ), count )
+			walked = []
+			walk( m, tag, walked )
+			self.assertEqual( sorted( paths ), sorted( walked ) )
+
+		a3 = m.child( "a3" )
+		self.assertEqual( sorted( a3.taggedPaths( "rare" ) ), sorted( [ [ "a3", "b%d" % j ] for j in range( 0, 1000, 100 ) ] ) )
+
+	def testBatchReads( self ):
+
+		m = IECore.SceneCache( "test/IECore/data/sccFiles/animatedSpheres.scc", IECore.IndexedIO.OpenMode.Read )
+
+		paths = []
+		def collect( scene ) :
+			paths.append( scene.path() )
+			for c in scene.childNames() :
+				collect( scene.child( c ) )
+		collect( m )
+
+		# shuffle the order, so the results must be mapped back to the requested paths
+		paths = list( reversed( paths[1:] ) ) + [ paths[0] ] + paths[1:3]
+
+		for time in ( 0, 0.5, 1.5 ) :
+
+			bounds = m.readBounds( paths, time )
+			transforms = m.readTransformsAsMatrices( paths, time )
+			objects = m.readObjects( paths, time )
+			self.assertEqual( len( bounds ), len( paths ) )
+			self.assertEqual( len( transforms ), len( paths ) )
+			self.assertEqual( len( objects ), len( paths ) )
+
+			for i, p in enumerate( paths ) :
+				s = m.scene( p )
+				self.assertEqual( bounds[i], s.readBound( time ) )
+				self.assertEqual( transforms[i], s.readTransformAsMatrix( time ) )
+				self.assertEqual( objects[i], s.readObject( time ) if s.hasObject() else None )
+
+		# paths are absolute, even when queried from a child location
+		a = m.child( "A" )
+		self.assertEqual( a.readBounds( [ [ "A" ] ], 0 ), [ a.readBound( 0 ) ] )
+
+		self.assertEqual( m.readBounds( [], 0 ), [] )
+		self.assertRaises( RuntimeError, m.readBounds, [ [ "A" ], [ "iDontExist" ] ], 0 )
+
+		w = IECore.SceneCache( "/tmp/test.scc", IECore.IndexedIO.OpenMode.Write )
+		self.assertRaises( RuntimeError, w.readBounds, [ [] ], 0 )
+
+	def testObjectPlaybackReader( self ) :
+
+		box = IECore.MeshPrimitive.createBox( IECore.Box3f( IECore.V3f( 0 ), IECore.V3f( 1 ) ) )
+		box["name"] = IECore.PrimitiveVariable( IECore.PrimitiveVariable.Interpolation.Constant, IECore.StringData( "box" ) )
+		box2 = box.copy()
+		box2["P"] = IECore.PrimitiveVariable( IECore.PrimitiveVariable.Interpolation.Vertex, IECore.V3fVectorData( [ p * 2 for p in box["P"].data ] ) )
+		plane = IECore.MeshPrimitive.createPlane( IECore.Box2f( IECore.V2f( 0 ), IECore.V2f( 1 ) ) )
+
+		s = IECore.SceneCache( "/tmp/test.scc", IECore.IndexedIO.OpenMode.Write )
+		# animated primitive variables
+		a = s.createChild( "a" )
+		a.writeObject( box, 0 )
+		a.writeObject( box2, 1 )
+		a.writeObject( box, 2 )
+		# animated topology
+		b = s.createChild( "b" )
+		b.writeObject( box, 0 )
+		b.writeObject( plane, 1 )
+		# static
+		c = s.createChild( "c" )
+		c.writeObject( box, 0 )
+
+		del s, a, b, c
+
+		s = IECore.SceneCache( "/tmp/test.scc", IECore.IndexedIO.OpenMode.Read )
+		for name in [ "a", "b", "c" ] :
+			c = s.child( name )
+			r = IECore.ObjectPlaybackReader( c )
+			self.assertTrue( r.scene().isSame( c ) )
+			for time in [ 0, 0.25, 0.5, 0.75, 1, 1.25, 1.5, 2, 1.5, 0.5, 0.1 ] :
+				self.assertEqual( r.readObject( time ), c.readObject( time ) )
+
+		# the in place interpolation mustn't have modified the samples
+		a = s.child( "a" )
+		self.assertEqual( a.readObject( 0 ), box )
+		self.assertEqual( a.readObject( 1 ), box2 )
+
+		self.assertRaises( Exception, IECore.ObjectPlaybackReader, None )
+
+	def testProxies( self ) :
+
+		sphere = IECore.MeshPrimitive.createSphere( 1, divisions = IECore.V2i( 40, 80 ) )
+		sphere2 = sphere.copy()
+		sphere2["P"] = IECore.PrimitiveVariable( IECore.PrimitiveVariable.Interpolation.Vertex, IECore.V3fVectorData( [ p * 2 for p in sphere["P"].data ] ) )
+		points = IECore.PointsPrimitive( IECore.V3fVectorData( [ IECore.V3f( x, y, 0 ) for x in range( 20 ) for y in range( 20 ) ] ) )
+
+		s = IECore.SceneCache( "/tmp/test.scc", IECore.IndexedIO.OpenMode.Write )
+		s.setProxyVertexBudgets( [ 50, 100000, 500 ] )
+		a = s.createChild( "a" )
+		a.writeObject( sphere, 0 )
+		a.writeObject( sphere2, 1 )
+		b = s.createChild( "b" )
+		b.writeObject( points, 0 )
+		c = s.createChild( "c" )
+		c.writeObject( IECore.SpherePrimitive( 1 ), 0 )
+
+		del s, a, b, c
+
+		s = IECore.SceneCache( "/tmp/test.scc", IECore.IndexedIO.OpenMode.Read )
+
+		# the 100000 vertex level is omitted, as the sphere is smaller than that
+		a = s.child( "a" )
+		errors = a.proxyErrors()
+		self.assertEqual( len( errors ), 2 )
+		self.assertTrue( 0 < errors[0] < errors[1] )
+		for level, budget in enumerate( [ 500, 50 ] ) :
+			for time in ( 0, 1 ) :
+				proxy = a.readProxy( level, time )
+				self.assertTrue( isinstance( proxy, IECore.MeshPrimitive ) )
+				self.assertEqual( proxy.keys(), [ "P" ] )
+				self.assertTrue( proxy.arePrimitiveVariablesValid() )
+				self.assertTrue( 0 < len( proxy["P"].data ) <= budget )
+
+		# the proxies aren't attributes
+		self.assertEqual( a.attributeNames(), [ "sceneInterface:animatedObjectPrimVars" ] )
+		# so the animated proxies don't make the attributes hash vary
+		self.assertEqual( a.hash( IECore.SceneInterface.HashType.AttributesHash, 0 ), a.hash( IECore.SceneInterface.HashType.AttributesHash, 1 ) )
+		self.assertRaises( Exception, a.readProxy, 2, 0 )
+
+		# the coarsest level which is accurate enough is chosen
+		self.assertEqual( a.readObjectProxy( 0, 1, 1e6 ), a.readObject( 0 ) )
+		self.assertEqual( a.readObjectProxy( 0, ( errors[0] + errors[1] ) / 2, 1 ), a.readProxy( 0, 0 ) )
+		self.assertEqual( a.readObjectProxy( 0, 1, 1e-6 ), a.readProxy( 1, 0 ) )
+
+		b = s.child( "b" )
+		self.assertEqual( len( b.proxyErrors() ), 1 )
+		proxy = b.readProxy( 0, 0 )
+		self.assertTrue( isinstance( proxy, IECore.PointsPrimitive ) )
+		self.assertTrue( 0 < proxy.numPoints <= 50 )
+
+		# no proxies for other object types
+		c = s.child( "c" )
+		self.assertEqual( c.proxyErrors(), [] )
+		self.assertEqual( c.readObjectProxy( 0, 1, 1e-6 ), c.readObject( 0 ) )
+
 if __name__ == "__main__":
 	unittest.main()
 
@@ -34,10 +34,16 @@
 
 #include <vector>
 #include <iostream>
+#include <set>
 
 #include "tbb/tbb.h"
 
+#include "boost/format.hpp"
+
 #include "IECore/SharedSceneInterfaces.h"
+#include "IECore/SceneCache.h"
+#include "IECore/MeshPrimitive.h"
+#include "IECore/SimpleTypedData.h"
 
 #include "SceneCacheThreadingTest.h"
 
@@ -103,6 +109,114 @@ struct SceneCacheThreadingTest
 			SceneInterface::Name m_attribute;
 	};
 
+	struct WriteSubtrees
+	{
+		public :
+
+			WriteSubtrees( SceneInterface *root ) : m_root( root )
+			{
+			}
+
+			void operator()( const blocked_range<size_t> &r ) const
+			{
+				for ( size_t i = r.begin(); i != r.end(); ++i )
+				{
+					writeSubtree( m_root, i );
+				}
+			}
+
+			static void writeSubtree( SceneInterface *root, size_t i )
+			{
+				SceneInterfacePtr child = root->createChild( str( format( "child%d" ) % i ) );
+				child->writeTransform( new M44dData( Imath::M44d().translate( Imath::V3d( i, 0, 0 ) ) ), 0.0 );
+				child->writeAttribute( "index", new IntData( i ), 0.0 );
+				if ( i % 3 == 0 )
+				{
+					NameList tags( 1, "multipleOfThree" );
+					child->writeTags( tags );
+				}
+				for ( size_t j = 0; j < 20; j++ )
+				{
+					SceneInterfacePtr grandChild = child->createChild( str( format( "grandChild%d" ) % j ) );
+					grandChild->writeTransform( new M44dData( Imath::M44d().translate( Imath::V3d( 0, j, 0 ) ) ), 0.0 );
+					grandChild->writeObject( MeshPrimitive::createBox( Imath::Box3f( Imath::V3f( 0 ), Imath::V3f( i + 1, j + 1, 1 ) ) ), 0.0 );
+					if ( j % 2 )
+					{
+						NameList tags( 1, "odd" );
+						grandChild->writeTags( tags );
+					}
+				}
+				if ( i % 2 )
+				{
+					// exercise concurrent finalisation of sibling locations as well
+					static_cast<SceneCache *>( child.get() )->finalise();
+				}
+			}
+
+		private :
+
+			typedef SceneInterface::NameList NameList;
+			SceneInterface *m_root;
+	};
+
+	void checkSameLocation( ConstSceneInterfacePtr a, ConstSceneInterfacePtr b )
+	{
+		BOOST_CHECK( a->readBound( 0.0 ) == b->readBound( 0.0 ) );
+		if ( a->hasObject() || b->hasObject() )
+		{
+			BOOST_CHECK( a->readObject( 0.0 )->isEqualTo( b->readObject( 0.0 ) ) );
+		}
+		if ( a->name() != SceneInterface::rootName )
+		{
+			BOOST_CHECK( a->readTransformAsMatrix( 0.0 ) == b->readTransformAsMatrix( 0.0 ) );
+		}
+
+		for ( int tagType = SceneInterface::DescendantTag; tagType <= SceneInterface::AncestorTag; tagType <<= 1 )
+		{
+			SceneInterface::NameList tagsA, tagsB;
+			a->readTags( tagsA, tagType );
+			b->readTags( tagsB, tagType );
+			std::set<SceneInterface::Name> setA( tagsA.begin(), tagsA.end() ), setB( tagsB.begin(), tagsB.end() );
+			BOOST_CHECK( setA == setB );
+		}
+
+		SceneInterface::NameList namesA, namesB;
+		a->childNames( namesA );
+		b->childNames( namesB );
+		std::set<SceneInterface::Name> childrenA( namesA.begin(), namesA.end() ), childrenB( namesB.begin(), namesB.end() );
+		BOOST_CHECK( childrenA == childrenB );
+		for ( SceneInterface::NameList::const_iterator it = namesA.begin(); it != namesA.end(); it++ )
+		{
+			checkSameLocation( a->child( *it ), b->child( *it, SceneInterface::ThrowIfMissing ) );
+		}
+	}
+
+	void testParallelWrite()
+	{
+		const size_t numChildren = 50;
+		{
+			SceneInterfacePtr root = new SceneCache( "/tmp/parallelWrite.scc", IndexedIO::Write );
+			parallel_for( blocked_range<size_t>( 0, numChildren ), WriteSubtrees( root.get() ) );
+		}
+		{
+			SceneInterfacePtr root = new SceneCache( "/tmp/serialWrite.scc", IndexedIO::Write );
+			for ( size_t i = 0; i < numChildren; i++ )
+			{
+				WriteSubtrees::writeSubtree( root.get(), i );
+			}
+		}
+
+		ConstSceneInterfacePtr parallel = new SceneCache( "/tmp/parallelWrite.scc", IndexedIO::Read );
+		ConstSceneInterfacePtr serial = new SceneCache( "/tmp/serialWrite.scc", IndexedIO::Read );
+		checkSameLocation( parallel, serial );
+
+		std::vector<SceneInterface::Path> parallelPaths, serialPaths;
+		parallel->taggedPaths( "odd", parallelPaths );
+		serial->taggedPaths( "odd", serialPaths );
+		BOOST_CHECK( parallelPaths == serialPaths );
+		BOOST_CHECK_EQUAL( parallelPaths.size(), numChildren * 10 );
+	}
+
 	void testAttributeRead()
 	{
 		task_scheduler_init scheduler( 100 );
@@ -134,6 +248,7 @@ struct SceneCacheThreadingTestSuite : public boost::unit_test::test_suite
 
 		add( BOOST_CLASS_TEST_CASE( &SceneCacheThreadingTest::testAttributeRead, instance ) );
 		add( BOOST_CLASS_TEST_CASE( &SceneCacheThreadingTest::testFakeAttributeRead, instance ) );
+		add( BOOST_CLASS_TEST_CASE( &SceneCacheThreadingTest::testParallelWrite, instance ) );
 	}
 };
 
@@ -41,6 +41,7 @@
 #include <iostream>
 #include <vector>
 #include <string>
+#include <set>
 
 #include "boost/test/unit_test.hpp"
 #include "boost/test/floating_point_comparison.hpp"
@@ -166,6 +167,121 @@ struct SweepAndPruneTest
 			}
 		}
 	}
+
+	template<typename T>
+	std::vector<T> randomBounds( boost::mt19937 &generator, unsigned numBounds, float worldSize )
+	{
+		typedef typename BoxTraits<T>::BaseType VecType;
+
+		boost::uniform_real<> uni_dist( 0.0f, 1.0f );
+		boost::variate_generator<boost::mt19937&, boost::uniform_real<> > uni( generator, uni_dist );
+
+		std::vector<T> result;
+		for ( unsigned n = 0; n < numBounds; n++ )
+		{
+			VecType corner( uni() * worldSize, uni() * worldSize, uni() * worldSize );
+			VecType size( uni(), uni(), uni() );
+
+			T b;
+			b.extendBy( corner );
+			b.extendBy( corner + size );
+			result.push_back( b );
+		}
+
+		return result;
+	}
+
+	template<typename T>
+	void checkAllPairs( const std::vector<T> &input, const typename TestCallback<typename std::vector<T>::const_iterator>::IntersectingBoundIndices &indices )
+	{
+		typedef typename TestCallback<typename std::vector<T>::const_iterator>::IntersectingBoundIndices Indices;
+
+		size_t numIntersecting = 0;
+		for ( unsigned i = 0; i < input.size(); i++ )
+		{
+			for ( unsigned j = i + 1; j < input.size(); j++ )
+			{
+				if ( input[i].intersects( input[j] ) )
+				{
+					BOOST_CHECK( indices.find( typename Indices::value_type( i, j ) ) != indices.end() );
+					numIntersecting++;
+				}
+			}
+		}
+
+		BOOST_CHECK_EQUAL( indices.size(), numIntersecting * 2 );
+	}
+
+	/// Uses enough bounds that the sweep is split into several slabs,
+	/// and checks the results exhaustively.
+	template<typename T>
+	void testManySlabs()
+	{
+		boost::mt19937 generator( 42 );
+
+		const unsigned numBoxes = 10000u;
+		std::vector<T> input = randomBounds<T>( generator, numBoxes, 50.0f );
+
+		typedef typename std::vector<T>::const_iterator BoundIterator;
+		typedef SweepAndPrune<BoundIterator, TestCallback> SAP;
+
+		for ( int axisOrder = SAP::XYZ; axisOrder <= SAP::ZYX; axisOrder++ )
+		{
+			SAP sap;
+			typename SAP::Callback cb( input.begin(), numBoxes );
+			sap.intersectingBounds( input.begin(), input.end(), cb, (typename SAP::AxisOrder)axisOrder );
+
+			checkAllPairs( input, cb.m_indices );
+		}
+	}
+
+	/// Animates the bounds over a number of frames, checking that the
+	/// incremental update finds the same pairs as a full sort and sweep.
+	template<typename T>
+	void testIncremental()
+	{
+		typedef typename BoxTraits<T>::BaseType VecType;
+
+		boost::mt19937 generator( 42 );
+		boost::uniform_real<> uni_dist( -0.1f, 0.1f );
+		boost::variate_generator<boost::mt19937&, boost::uniform_real<> > velocity( generator, uni_dist );
+
+		const unsigned numBoxes = 5000u;
+		std::vector<T> input = randomBounds<T>( generator, numBoxes, 25.0f );
+
+		typedef typename std::vector<T>::const_iterator BoundIterator;
+		typedef SweepAndPrune<BoundIterator, TestCallback> SAP;
+
+		SAP incrementalSAP;
+		for ( unsigned frame = 0; frame < 10; frame++ )
+		{
+			typename SAP::Callback incrementalCB( input.begin(), numBoxes );
+			incrementalSAP.incrementalIntersectingBounds( input.begin(), input.end(), incrementalCB );
+
+			SAP sap;
+			typename SAP::Callback cb( input.begin(), numBoxes );
+			sap.intersectingBounds( input.begin(), input.end(), cb );
+
+			BOOST_CHECK( incrementalCB.m_indices == cb.m_indices );
+			if ( frame == 0 || frame == 9 )
+			{
+				checkAllPairs( input, incrementalCB.m_indices );
+			}
+
+			for ( typename std::vector<T>::iterator it = input.begin(); it != input.end(); ++it )
+			{
+				VecType offset( velocity(), velocity(), velocity() );
+				it->min += offset;
+				it->max += offset;
+			}
+		}
+
+		// a different range must trigger a full sort
+		std::vector<T> subset( input.begin(), input.begin() + numBoxes / 2 );
+		typename SAP::Callback subsetCB( subset.begin(), numBoxes / 2 );
+		incrementalSAP.incrementalIntersectingBounds( subset.begin(), subset.end(), subsetCB );
+		checkAllPairs( subset, subsetCB.m_indices );
+	}
 };
 
 struct SweepAndPruneTestSuite : public boost::unit_test::test_suite
@@ -177,6 +293,8 @@ struct SweepAndPruneTestSuite : public boost::unit_test::test_suite
 
 		add( BOOST_CLASS_TEST_CASE( &SweepAndPruneTest::test<Imath::Box3f>, instance ) );
 		add( BOOST_CLASS_TEST_CASE( &SweepAndPruneTest::test<Imath::Box3d>, instance ) );
+		add( BOOST_CLASS_TEST_CASE( &SweepAndPruneTest::testManySlabs<Imath::Box3f>, instance ) );
+		add( BOOST_CLASS_TEST_CASE( &SweepAndPruneTest::testIncremental<Imath::Box3f>, instance ) );
 	}
 
 };
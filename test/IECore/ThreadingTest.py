@@ -302,6 +302,75 @@ class ThreadingTest( unittest.TestCase ) :
 						
 		self.failUnless( threadedTime < nonThreadedTime ) # this could plausibly fail due to varying load on the machine / io but generally shouldn't
 
+	def testSceneCacheGains( self ) :
+
+		## Checks that reading objects from a SceneCache in several threads
+		# is faster than reading them one after another.
+
+		numLocations = 16
+
+		m = IECore.MeshPrimitive.createPlane( IECore.Box2f( IECore.V2f( -1 ), IECore.V2f( 1 ) ), IECore.V2i( 200 ) )
+		scene = IECore.SceneCache( "test/IECore/threadingTest.scc", IECore.IndexedIO.OpenMode.Write )
+		for i in range( 0, numLocations ) :
+			scene.createChild( "object%d" % i ).writeObject( m, 0.0 )
+		del scene
+
+		def readObjects( scene, names ) :
+
+			for name in names :
+				scene.child( name ).readObject( 0.0 )
+
+		def callReads( threaded ) :
+
+			# use a fresh scene each time, so we don't benefit from the
+			# object cache populated by a previous run.
+			IECore.ObjectPool.defaultObjectPool().clear()
+			scene = IECore.SceneCache( "test/IECore/threadingTest.scc", IECore.IndexedIO.OpenMode.Read )
+			calls = [ readObjects ] * 4
+			args = [ ( scene, [ "object%d" % i for i in range( j, numLocations, 4 ) ] ) for j in range( 0, 4 ) ]
+			tStart = time.time()
+			self.callSomeThings( calls, args, threaded=threaded )
+			return time.time() - tStart
+
+		nonThreadedTime = callReads( threaded=False )
+		threadedTime = callReads( threaded=True )
+
+		self.failUnless( threadedTime < nonThreadedTime ) # this could plausibly fail due to varying load on the machine / io but generally shouldn't
+
+	def testPrimitiveEvaluatorGains( self ) :
+
+		## Checks that building MeshPrimitiveEvaluators in several threads is
+		# faster than building them one after another. The meshes are too small
+		# for the tree to be built in parallel, and have no UVs to build a second
+		# tree alongside it, so any gain comes from releasing the GIL rather than
+		# from TBB.
+
+		meshes = []
+		for i in range( 0, 16 ) :
+			m = IECore.MeshPrimitive.createPlane( IECore.Box2f( IECore.V2f( -1 ), IECore.V2f( 1 ) ), IECore.V2i( 40 ) )
+			del m["s"]
+			del m["t"]
+			IECore.TriangulateOp()( input = m, copyInput = False )
+			meshes.append( m )
+
+		def evaluate( meshes ) :
+
+			for mesh in meshes :
+				IECore.MeshPrimitiveEvaluator( mesh )
+
+		calls = [ evaluate ] * 4
+		args = [ ( meshes, ) ] * 4
+
+		tStart = time.time()
+		self.callSomeThings( calls, args, threaded=False )
+		nonThreadedTime = time.time() - tStart
+
+		tStart = time.time()
+		self.callSomeThings( calls, args, threaded=True )
+		threadedTime = time.time() - tStart
+
+		self.failUnless( threadedTime < nonThreadedTime ) # this could plausibly fail due to varying load on the machine / io but generally shouldn't
+
 	def tearDown( self ) :
 		
 		for f in [
@@ -311,6 +380,7 @@ class ThreadingTest( unittest.TestCase ) :
 			"test/IECore/test3.jpg",
 			"test/IECore/interpolatedCache.0250.fio",
 			"test/IECore/interpolatedCache.0500.fio",
+			"test/IECore/threadingTest.scc",
 		] :
 			if os.path.exists( f ) :
 				os.remove( f )
@@ -0,0 +1,93 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2014, Image Engine Design Inc. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+//     * Neither the name of Image Engine Design nor the names of any
+//       other contributors to this software may be used to endorse or
+//       promote products derived from this software without specific prior
+//       written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#ifndef IECORE_TRIANGLEBVHFIXTURES_H
+#define IECORE_TRIANGLEBVHFIXTURES_H
+
+#include <vector>
+
+#include "OpenEXR/ImathRandom.h"
+
+#include "IECore/MeshPrimitive.h"
+
+namespace IECore
+{
+
+/// Fixtures shared by TriangleBVHTest and TriangleBVHBenchmark.
+namespace TriangleBVHFixtures
+{
+
+/// Returns a mesh of numTriangles small triangles scattered through
+/// the unit cube.
+inline MeshPrimitivePtr makeMesh( unsigned numTriangles )
+{
+	Imath::Rand32 rand( 10 );
+
+	IntVectorDataPtr verticesPerFaceData = new IntVectorData;
+	IntVectorDataPtr vertexIdsData = new IntVectorData;
+	V3fVectorDataPtr pointsData = new V3fVectorData;
+	std::vector<Imath::V3f> &points = pointsData->writable();
+	for( unsigned i = 0; i < numTriangles; ++i )
+	{
+		Imath::V3f center( rand.nextf(), rand.nextf(), rand.nextf() );
+		for( unsigned j = 0; j < 3; ++j )
+		{
+			vertexIdsData->writable().push_back( points.size() );
+			points.push_back( center + Imath::V3f( rand.nextf( -0.02, 0.02 ), rand.nextf( -0.02, 0.02 ), rand.nextf( -0.02, 0.02 ) ) );
+		}
+		verticesPerFaceData->writable().push_back( 3 );
+	}
+
+	MeshPrimitivePtr result = new MeshPrimitive( verticesPerFaceData, vertexIdsData );
+	result->variables["P"] = PrimitiveVariable( PrimitiveVariable::Vertex, pointsData );
+	return result;
+}
+
+/// Makes numRays rays starting around the unit cube and aimed roughly
+/// at its centre, so that most of them hit a mesh made by makeMesh().
+inline void makeRays( unsigned numRays, std::vector<Imath::V3f> &origins, std::vector<Imath::V3f> &directions )
+{
+	Imath::Rand32 rand( 20 );
+	for( unsigned i = 0; i < numRays; ++i )
+	{
+		origins.push_back( Imath::V3f( rand.nextf( -1, 2 ), rand.nextf( -1, 2 ), rand.nextf( -1, 2 ) ) );
+		directions.push_back( Imath::V3f( 0.5 ) - origins.back() + Imath::V3f( rand.nextf( -0.5, 0.5 ), rand.nextf( -0.5, 0.5 ), rand.nextf( -0.5, 0.5 ) ) );
+	}
+}
+
+} // namespace TriangleBVHFixtures
+
+} // namespace IECore
+
+#endif // IECORE_TRIANGLEBVHFIXTURES_H
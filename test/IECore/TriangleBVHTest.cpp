@@ -0,0 +1,133 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2014, Image Engine Design Inc. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+//     * Neither the name of Image Engine Design nor the names of any
+//       other contributors to this software may be used to endorse or
+//       promote products derived from this software without specific prior
+//       written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#include "IECore/MeshPrimitiveEvaluator.h"
+#include "IECore/TriangleBVH.h"
+
+#include "TriangleBVHFixtures.h"
+#include "TriangleBVHTest.h"
+
+using namespace boost;
+using namespace boost::unit_test;
+using namespace Imath;
+
+namespace IECore
+{
+
+struct TriangleBVHTest
+{
+
+	void testEmpty()
+	{
+		std::vector<V3f> points;
+		std::vector<int> vertexIds;
+		TriangleBVH bvh( points, vertexIds );
+		BOOST_CHECK_EQUAL( bvh.numTriangles(), 0u );
+
+		TriangleBVH::Hit hit;
+		BOOST_CHECK( !bvh.intersect( V3f( 0 ), V3f( 1, 0, 0 ), limits<float>::max(), hit ) );
+		BOOST_CHECK( !bvh.closestPoint( V3f( 0 ), hit ) );
+
+		std::vector<TriangleBVH::Hit> hits;
+		BOOST_CHECK_EQUAL( bvh.intersectAll( V3f( 0 ), V3f( 1, 0, 0 ), limits<float>::max(), hits ), 0u );
+	}
+
+	void testMatchesKDTree()
+	{
+		MeshPrimitivePtr mesh = TriangleBVHFixtures::makeMesh( 10000 );
+		MeshPrimitiveEvaluatorPtr kdEvaluator = new MeshPrimitiveEvaluator( mesh, MeshPrimitiveEvaluator::KDTreeAccelerator );
+		MeshPrimitiveEvaluatorPtr bvhEvaluator = new MeshPrimitiveEvaluator( mesh, MeshPrimitiveEvaluator::BVHAccelerator );
+		BOOST_CHECK( kdEvaluator->triangleBoundTree() );
+		BOOST_CHECK( !kdEvaluator->triangleBVH() );
+		BOOST_CHECK( !bvhEvaluator->triangleBoundTree() );
+		BOOST_CHECK( bvhEvaluator->triangleBVH() );
+
+		std::vector<V3f> origins, directions;
+		TriangleBVHFixtures::makeRays( 10000, origins, directions );
+
+		std::vector<int> kdTriangles, bvhTriangles;
+		std::vector<V3f> kdBarycentrics, bvhBarycentrics, kdPositions, bvhPositions;
+
+		kdEvaluator->nearestIntersections( origins, directions, kdTriangles, kdBarycentrics, &kdPositions );
+		bvhEvaluator->nearestIntersections( origins, directions, bvhTriangles, bvhBarycentrics, &bvhPositions );
+
+		unsigned numHits = 0;
+		for( size_t i = 0; i < origins.size(); ++i )
+		{
+			BOOST_CHECK_EQUAL( kdTriangles[i] == -1, bvhTriangles[i] == -1 );
+			if( kdTriangles[i] != -1 && bvhTriangles[i] != -1 )
+			{
+				BOOST_CHECK( kdPositions[i].equalWithAbsError( bvhPositions[i], 1e-4 ) );
+				numHits++;
+			}
+		}
+		// make sure the test is meaningful
+		BOOST_CHECK( numHits > origins.size() / 2 );
+
+		kdEvaluator->closestPoints( origins, kdTriangles, kdBarycentrics, &kdPositions );
+		bvhEvaluator->closestPoints( origins, bvhTriangles, bvhBarycentrics, &bvhPositions );
+		for( size_t i = 0; i < origins.size(); ++i )
+		{
+			BOOST_CHECK_CLOSE( ( kdPositions[i] - origins[i] ).length(), ( bvhPositions[i] - origins[i] ).length(), 1e-3 );
+		}
+
+		for( size_t i = 0; i < 100; ++i )
+		{
+			std::vector<PrimitiveEvaluator::ResultPtr> kdResults, bvhResults;
+			kdEvaluator->intersectionPoints( origins[i], directions[i], kdResults );
+			bvhEvaluator->intersectionPoints( origins[i], directions[i], bvhResults );
+			BOOST_CHECK_EQUAL( kdResults.size(), bvhResults.size() );
+		}
+	}
+
+};
+
+struct TriangleBVHTestSuite : public boost::unit_test::test_suite
+{
+
+	TriangleBVHTestSuite() : boost::unit_test::test_suite( "TriangleBVHTestSuite" )
+	{
+		boost::shared_ptr<TriangleBVHTest> instance( new TriangleBVHTest() );
+
+		add( BOOST_CLASS_TEST_CASE( &TriangleBVHTest::testEmpty, instance ) );
+		add( BOOST_CLASS_TEST_CASE( &TriangleBVHTest::testMatchesKDTree, instance ) );
+	}
+};
+
+void addTriangleBVHTest( boost::unit_test::test_suite *test )
+{
+	test->add( new TriangleBVHTestSuite() );
+}
+
+} // namespace IECore
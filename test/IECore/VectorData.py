@@ -35,6 +35,7 @@
 """Unit test for VectorData binding"""
 
 import math
+import struct
 import unittest
 
 from IECore import *
@@ -1206,6 +1207,165 @@ class TestVectorDataToString( unittest.TestCase ) :
 		for i in range( 0, 255 ) :
 			self.assertEqual( s[i], chr( i ) )
 
+class TestVectorDataToBuffer( unittest.TestCase ) :
+
+	def testReadOnly( self ) :
+
+		d = FloatVectorData( [ 1, 2, 3 ] )
+		m = memoryview( d.toBuffer() )
+
+		self.assertTrue( m.readonly )
+		self.assertEqual( m.format, "f" )
+		self.assertEqual( m.itemsize, 4 )
+		self.assertEqual( m.shape, ( 3, ) )
+		self.assertEqual( m.tobytes(), d.toString() )
+
+		def f() :
+			m[0] = struct.pack( "f", 10 )
+
+		self.assertRaises( TypeError, f )
+
+	def testCompoundTypes( self ) :
+
+		d = V3fVectorData( [ V3f( 1, 2, 3 ), V3f( 4, 5, 6 ) ] )
+		m = memoryview( d.toBuffer() )
+		self.assertEqual( m.format, "f" )
+		self.assertEqual( m.shape, ( 2, 3 ) )
+		self.assertEqual( m.tobytes(), d.toString() )
+
+		self.assertEqual( memoryview( M44dVectorData( [ M44d() ] ).toBuffer() ).shape, ( 1, 16 ) )
+		self.assertEqual( memoryview( Box3fVectorData( [ Box3f() ] * 4 ).toBuffer() ).shape, ( 4, 6 ) )
+		self.assertEqual( memoryview( HalfVectorData( [ 1, 2 ] ).toBuffer() ).format, "e" )
+
+	def testEmpty( self ) :
+
+		m = memoryview( IntVectorData().toBuffer() )
+		self.assertEqual( m.shape, ( 0, ) )
+		self.assertEqual( m.tobytes(), "" )
+
+	def testWritable( self ) :
+
+		d = IntVectorData( [ 1, 2, 3 ] )
+		h = d.hash()
+
+		d2 = d.copy()
+		m = memoryview( d2.toBuffer( writable = True ) )
+		self.assertFalse( m.readonly )
+		m[0] = struct.pack( "i", 10 )
+		del m
+
+		self.assertEqual( d2, IntVectorData( [ 10, 2, 3 ] ) )
+		self.assertNotEqual( d2.hash(), h )
+		# the original must be unaffected, thanks to copy-on-write
+		self.assertEqual( d, IntVectorData( [ 1, 2, 3 ] ) )
+		self.assertEqual( d.hash(), h )
+
+	def testBufferKeepsDataAlive( self ) :
+
+		d = FloatVectorData( [ 1, 2 ] )
+		b = d.toBuffer()
+		del d
+
+		self.assertEqual( memoryview( b ).tobytes(), struct.pack( "ff", 1, 2 ) )
+
+	def testNumPy( self ) :
+
+		try :
+			import numpy
+		except ImportError :
+			return
+
+		d = V3fVectorData( [ V3f( i ) for i in range( 0, 10 ) ] )
+		a = numpy.asarray( d.toBuffer() )
+		self.assertEqual( a.shape, ( 10, 3 ) )
+		self.assertEqual( a.dtype, numpy.float32 )
+		self.assertEqual( a[5,1], 5 )
+
+		a = numpy.asarray( d.toBuffer( writable = True ) )
+		a *= 2
+		del a
+		self.assertEqual( d[5], V3f( 10 ) )
+
+		# arrays must remain valid when the vector is reallocated
+		d = FloatVectorData( [ 1, 2, 3 ] )
+		a = numpy.asarray( d.toBuffer() )
+		d.resize( 100000 )
+		self.assertEqual( list( a ), [ 1, 2, 3 ] )
+
+		# which means it can't be done while a writable array exists
+		a = numpy.asarray( d.toBuffer( writable = True ) )
+		self.assertRaises( BufferError, d.append, 1 )
+		self.assertEqual( a.shape, ( 100000, ) )
+		del a
+		d.append( 1 )
+		self.assertEqual( len( d ), 100001 )
+
+	def testReadOnlyViewsOutliveModification( self ) :
+
+		d = IntVectorData( [ 1, 2, 3 ] )
+		m = memoryview( d.toBuffer() )
+
+		# the vector is reallocated, but the view keeps the
+		# original contents alive and unchanged.
+		for i in range( 0, 1000 ) :
+			d.append( i )
+		d[0] = 10
+
+		self.assertEqual( len( d ), 1003 )
+		self.assertEqual( m.tobytes(), struct.pack( "iii", 1, 2, 3 ) )
+
+	def testResizeWithWritableViews( self ) :
+
+		d = IntVectorData( [ 1, 2, 3 ] )
+		b = d.toBuffer( writable = True )
+		m = memoryview( b )
+
+		def delItem() :
+			del d[0]
+
+		def setSlice() :
+			d[0:1] = [ 4, 5 ]
+
+		self.assertRaises( BufferError, d.append, 4 )
+		self.assertRaises( BufferError, d.extend, [ 4 ] )
+		self.assertRaises( BufferError, d.insert, 0, 4 )
+		self.assertRaises( BufferError, d.resize, 10 )
+		self.assertRaises( BufferError, delItem )
+		self.assertRaises( BufferError, setSlice )
+		self.assertEqual( d, IntVectorData( [ 1, 2, 3 ] ) )
+
+		# modifications which don't reallocate are fine
+		d[0] = 10
+		self.assertEqual( m.tobytes(), struct.pack( "iii", 10, 2, 3 ) )
+
+		# and once the view is released, resizing is permitted
+		# and new views see the new contents
+		del m
+		d.append( 4 )
+		m = memoryview( b )
+		self.assertEqual( m.shape, ( 4, ) )
+		self.assertEqual( m.tobytes(), struct.pack( "iiii", 10, 2, 3, 4 ) )
+
+	def testCopyWithWritableViews( self ) :
+
+		d = IntVectorData( [ 1, 2, 3 ] )
+		b = d.toBuffer( writable = True )
+
+		# copying before a view is taken is fine, and the view
+		# then modifies only the original.
+		c = d.copy()
+		m = memoryview( b )
+		m[0] = struct.pack( "i", 10 )
+		self.assertEqual( d, IntVectorData( [ 10, 2, 3 ] ) )
+		self.assertEqual( c, IntVectorData( [ 1, 2, 3 ] ) )
+
+		# but copying while the view exists would let it
+		# modify the copy too.
+		self.assertRaises( BufferError, d.copy )
+
+		del m
+		self.assertEqual( d.copy(), d )
+
 class TestVectorDataHashOptimisation( unittest.TestCase ) :
 
 	def test( self ) :
@@ -0,0 +1,210 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2014, Image Engine Design Inc. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+//     * Neither the name of Image Engine Design nor the names of any
+//       other contributors to this software may be used to endorse or
+//       promote products derived from this software without specific prior
+//       written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#include <iostream>
+#include <vector>
+#include <cmath>
+
+#include "boost/format.hpp"
+#include "boost/filesystem/operations.hpp"
+
+#include "tbb/tbb.h"
+
+#include "IECore/FileIndexedIO.h"
+
+#include "IndexedIOFixtures.h"
+#include "IndexedIOBenchmark.h"
+
+using namespace boost;
+using namespace boost::unit_test;
+using namespace tbb;
+
+namespace IECore
+{
+
+struct IndexedIOBenchmark
+{
+
+	static const size_t numEntries = 64;
+	static const size_t arrayLength = 256 * 1024;
+
+	IndexedIOBenchmark() : m_fileName( "test/IECore/indexedIOBenchmark.fio" )
+	{
+	}
+
+	~IndexedIOBenchmark()
+	{
+		boost::filesystem::remove( m_fileName );
+	}
+
+	/// Reads the same file with increasing numbers of threads, reporting the
+	/// throughput at each step.
+	void benchmarkConcurrentReads()
+	{
+		IndexedIOFixtures::writeEntries( new FileIndexedIO( m_fileName, IndexedIO::rootPath, IndexedIO::Write ), numEntries, arrayLength );
+		ConstIndexedIOPtr io = new FileIndexedIO( m_fileName, IndexedIO::rootPath, IndexedIO::Read );
+
+		const size_t numReads = numEntries * 16;
+		const double megabytes = (double)( numReads * arrayLength * sizeof( float ) ) / ( 1024.0 * 1024.0 );
+
+		for ( int numThreads = 1; numThreads <= 16; numThreads *= 2 )
+		{
+			task_scheduler_init scheduler( numThreads );
+
+			IndexedIOFixtures::ReadEntries task( io, numEntries, arrayLength );
+			tick_count t0 = tick_count::now();
+			parallel_reduce( blocked_range<size_t>( 0, numReads, 1 ), task );
+			double time = ( tick_count::now() - t0 ).seconds();
+
+			BOOST_CHECK( task.errors() == 0 );
+			std::cout << format( "IndexedIO reads with %d threads : %.2f MB/s" ) % numThreads % ( megabytes / time ) << std::endl;
+		}
+	}
+
+	/// Fills p and n with the positions and normals of a dense, slightly
+	/// deformed sphere, varying with frame so that each frame is unique.
+	static void makePointsAndNormals( int frame, std::vector<float> &p, std::vector<float> &n )
+	{
+		const int resolution = 512;
+		p.clear();
+		n.clear();
+		for ( int j = 0; j < resolution; j++ )
+		{
+			const float v = M_PI * (float)j / (float)( resolution - 1 );
+			for ( int i = 0; i < resolution; i++ )
+			{
+				const float u = 2.0f * M_PI * (float)i / (float)resolution;
+				const float r = 10.0f + 0.5f * sin( 4.0f * u + 0.1f * frame ) * sin( 3.0f * v );
+				const float x = sin( v ) * cos( u );
+				const float y = cos( v );
+				const float z = sin( v ) * sin( u );
+				p.push_back( r * x );
+				p.push_back( r * y );
+				p.push_back( r * z );
+				// Not the true surface normal, but it varies per frame in the
+				// same way, which is all that matters to the codecs.
+				const float l = sqrt( r * r * ( x * x + z * z ) + y * y );
+				n.push_back( r * x / l );
+				n.push_back( y / l );
+				n.push_back( r * z / l );
+			}
+		}
+	}
+
+	/// Writes the same P and N arrays using each codec, with and without
+	/// shuffling, and reports the file size and the speed of reading them
+	/// back. The file is read from the page cache, so this measures the
+	/// decoding cost rather than the I/O saved.
+	void benchmarkCompressedReads()
+	{
+		const int numFrames = 10;
+		const int numReads = 3;
+
+		struct Mode
+		{
+			const char *name;
+			StreamIndexedIO::DataCompression compression;
+			bool shuffle;
+		};
+
+		const Mode modes[] = {
+			{ "raw", StreamIndexedIO::Uncompressed, false },
+			{ "gzip", StreamIndexedIO::GzipCompression, false },
+			{ "gzip+shuffle", StreamIndexedIO::GzipCompression, true },
+			{ "fast", StreamIndexedIO::FastCompression, false },
+			{ "fast+shuffle", StreamIndexedIO::FastCompression, true },
+		};
+
+		std::vector<float> p, n;
+		for ( size_t m = 0; m < sizeof( modes ) / sizeof( Mode ); m++ )
+		{
+			size_t pointsLength = 0;
+			{
+				FileIndexedIOPtr io = new FileIndexedIO( m_fileName, IndexedIO::rootPath, IndexedIO::Write );
+				io->setDataCompression( modes[m].compression, modes[m].shuffle );
+				for ( int f = 0; f < numFrames; f++ )
+				{
+					makePointsAndNormals( f, p, n );
+					pointsLength = p.size();
+					IndexedIOPtr frame = io->createSubdirectory( ( boost::format( "frame%d" ) % f ).str() );
+					frame->write( "P", &p[0], pointsLength );
+					frame->write( "N", &n[0], pointsLength );
+				}
+			}
+
+			const double fileMegabytes = (double)boost::filesystem::file_size( m_fileName ) / ( 1024.0 * 1024.0 );
+			const double megabytes = (double)( numReads * numFrames * 2 * pointsLength * sizeof( float ) ) / ( 1024.0 * 1024.0 );
+
+			ConstIndexedIOPtr io = new FileIndexedIO( m_fileName, IndexedIO::rootPath, IndexedIO::Read );
+			std::vector<float> buffer( pointsLength );
+			float *data = &buffer[0];
+
+			tick_count t0 = tick_count::now();
+			for ( int r = 0; r < numReads; r++ )
+			{
+				for ( int f = 0; f < numFrames; f++ )
+				{
+					ConstIndexedIOPtr frame = io->subdirectory( ( boost::format( "frame%d" ) % f ).str() );
+					frame->read( "P", data, pointsLength );
+					frame->read( "N", data, pointsLength );
+				}
+			}
+			double time = ( tick_count::now() - t0 ).seconds();
+
+			std::cout << format( "IndexedIO P and N reads (%s) : file size %.1f MB, %.2f MB/s" ) % modes[m].name % fileMegabytes % ( megabytes / time ) << std::endl;
+		}
+	}
+
+	std::string m_fileName;
+
+};
+
+struct IndexedIOBenchmarkSuite : public boost::unit_test::test_suite
+{
+
+	IndexedIOBenchmarkSuite() : boost::unit_test::test_suite( "IndexedIOBenchmarkSuite" )
+	{
+		boost::shared_ptr<IndexedIOBenchmark> instance( new IndexedIOBenchmark() );
+
+		add( BOOST_CLASS_TEST_CASE( &IndexedIOBenchmark::benchmarkConcurrentReads, instance ) );
+		add( BOOST_CLASS_TEST_CASE( &IndexedIOBenchmark::benchmarkCompressedReads, instance ) );
+	}
+};
+
+void addIndexedIOBenchmark( boost::unit_test::test_suite *test )
+{
+	test->add( new IndexedIOBenchmarkSuite() );
+}
+
+} // namespace IECore
@@ -0,0 +1,211 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2014, Image Engine Design Inc. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+//     * Neither the name of Image Engine Design nor the names of any
+//       other contributors to this software may be used to endorse or
+//       promote products derived from this software without specific prior
+//       written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#include <iostream>
+#include <string.h>
+
+#include "tbb/tbb.h"
+
+#include "boost/lexical_cast.hpp"
+#include "boost/format.hpp"
+#include "boost/multi_index_container.hpp"
+#include "boost/multi_index/hashed_index.hpp"
+#include "boost/multi_index/identity.hpp"
+
+#include "IECore/InternedString.h"
+#include "IECore/HashTable.h"
+
+#include "InternedStringBenchmark.h"
+
+using namespace boost;
+using namespace boost::unit_test;
+using namespace tbb;
+
+namespace IECore
+{
+
+struct InternedStringBenchmark
+{
+
+	// The table used by InternedString prior to the lock free lookups,
+	// which we keep here to measure our progress against.
+	class LockedStringTable
+	{
+		public :
+
+			const std::string *internedString( const char *value )
+			{
+				Index &hashIndex = m_hashSet.get<0>();
+				Mutex::scoped_lock lock( m_mutex, false ); // read-only lock
+				HashSet::const_iterator it = hashIndex.find( value, Hash<const char *>(), StringCStringEqual() );
+				if( it!=hashIndex.end() )
+				{
+					return &(*it);
+				}
+				else
+				{
+					lock.upgrade_to_writer();
+					return &(*(m_hashSet.insert( std::string( value ) ).first ) );
+				}
+			}
+
+		private :
+
+			typedef boost::multi_index::multi_index_container<
+				std::string,
+				boost::multi_index::indexed_by<
+					boost::multi_index::hashed_unique<
+						boost::multi_index::identity<std::string>,
+						Hash<std::string>
+					>
+				>
+			> HashSet;
+
+			typedef HashSet::nth_index<0>::type Index;
+			typedef tbb::spin_rw_mutex Mutex;
+
+			struct StringCStringEqual
+			{
+				bool operator()( const char *c, const std::string &s ) const
+				{
+					return strcmp( c, s.c_str() )==0;
+				}
+				bool operator()( const std::string &s, const char *c ) const
+				{
+					return strcmp( c, s.c_str() )==0;
+				}
+			};
+
+			HashSet m_hashSet;
+			Mutex m_mutex;
+
+	};
+
+	struct LockedLookup
+	{
+		public :
+
+			LockedLookup( LockedStringTable &table, const std::vector<std::string> &strings )
+				:	m_table( table ), m_strings( strings )
+			{
+			}
+
+			void operator()( const blocked_range<size_t> &r ) const
+			{
+				for( size_t i=r.begin(); i!=r.end(); ++i )
+				{
+					m_table.internedString( m_strings[i % m_strings.size()].c_str() );
+				}
+			}
+
+		private :
+
+			LockedStringTable &m_table;
+			const std::vector<std::string> &m_strings;
+
+	};
+
+	struct Lookup
+	{
+		public :
+
+			Lookup( const std::vector<std::string> &strings )
+				:	m_strings( strings )
+			{
+			}
+
+			void operator()( const blocked_range<size_t> &r ) const
+			{
+				for( size_t i=r.begin(); i!=r.end(); ++i )
+				{
+					InternedString s( m_strings[i % m_strings.size()].c_str() );
+				}
+			}
+
+		private :
+
+			const std::vector<std::string> &m_strings;
+
+	};
+
+	// Compares how lookups of existing strings scale with the number
+	// of threads, for the old locked table and for InternedString.
+	void benchmarkLookupScaling()
+	{
+		std::vector<std::string> strings;
+		LockedStringTable lockedTable;
+		for( size_t i = 0; i < 1000; ++i )
+		{
+			strings.push_back( "InternedStringTestLookup" + lexical_cast<std::string>( i ) );
+			lockedTable.internedString( strings.back().c_str() );
+			InternedString s( strings.back() );
+		}
+
+		const size_t numIterations = 10000000;
+		const int maxThreads = task_scheduler_init::default_num_threads();
+		for( int numThreads = 1; numThreads <= maxThreads; numThreads *= 2 )
+		{
+			task_scheduler_init scheduler( numThreads );
+
+			tick_count t = tick_count::now();
+			parallel_for( blocked_range<size_t>( 0, numIterations ), LockedLookup( lockedTable, strings ) );
+			double lockedTime = ( tick_count::now() - t ).seconds();
+
+			t = tick_count::now();
+			parallel_for( blocked_range<size_t>( 0, numIterations ), Lookup( strings ) );
+			double time = ( tick_count::now() - t ).seconds();
+
+			std::cout << format( "InternedString lookups with %d threads : locked table %fs, lock free table %fs" ) % numThreads % lockedTime % time << std::endl;
+		}
+	}
+
+};
+
+struct InternedStringBenchmarkSuite : public boost::unit_test::test_suite
+{
+
+	InternedStringBenchmarkSuite() : boost::unit_test::test_suite( "InternedStringBenchmarkSuite" )
+	{
+		boost::shared_ptr<InternedStringBenchmark> instance( new InternedStringBenchmark() );
+
+		add( BOOST_CLASS_TEST_CASE( &InternedStringBenchmark::benchmarkLookupScaling, instance ) );
+	}
+};
+
+void addInternedStringBenchmark( boost::unit_test::test_suite *test )
+{
+	test->add( new InternedStringBenchmarkSuite() );
+}
+
+} // namespace IECore
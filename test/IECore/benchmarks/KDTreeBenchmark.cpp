@@ -0,0 +1,178 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2014, Image Engine Design Inc. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+//     * Neither the name of Image Engine Design nor the names of any
+//       other contributors to this software may be used to endorse or
+//       promote products derived from this software without specific prior
+//       written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#include <iostream>
+
+#include "boost/format.hpp"
+
+#include "tbb/tbb.h"
+
+#include "IECore/KDTree.h"
+#include "IECore/InverseDistanceWeightedInterpolation.h"
+#include "IECore/PointDensitiesOp.h"
+#include "IECore/PointNormalsOp.h"
+#include "IECore/ObjectParameter.h"
+#include "IECore/VectorTypedData.h"
+
+#include "KDTreeFixtures.h"
+#include "KDTreeBenchmark.h"
+
+using namespace boost;
+using namespace boost::unit_test;
+using namespace tbb;
+using namespace Imath;
+
+namespace IECore
+{
+
+struct KDTreeBenchmark
+{
+
+		return result;
+	}
+
+	ObjectPtr densities( ConstV3fVectorDataPtr points, int numThreads )
+	{
+		task_scheduler_init scheduler( numThreads );
+
+		PointDensitiesOpPtr op = new PointDensitiesOp;
+		op->pointParameter()->setValue( points->copy() );
+		return op->operate();
+	}
+
+	ObjectPtr normals( ConstV3fVectorDataPtr points, int numThreads )
+	{
+		task_scheduler_init scheduler( numThreads );
+
+		PointNormalsOpPtr op = new PointNormalsOp;
+		op->pointParameter()->setValue( points->copy() );
+		return op->operate();
+	}
+
+	double timeBuild( const std::vector<V3f> &points, int numThreads )
+	{
+		task_scheduler_init scheduler( numThreads );
+
+		tick_count t = tick_count::now();
+		V3fTree tree( points.begin(), points.end() );
+		return ( tick_count::now() - t ).seconds();
+	}
+
+	double timeNearestNNeighbours( const V3fTree &tree, const std::vector<V3f> &points, int numThreads )
+	{
+		task_scheduler_init scheduler( numThreads );
+
+		std::vector<V3fTree::Neighbour> neighbours;
+		std::vector<unsigned int> numFound;
+
+		tick_count t = tick_count::now();
+		tree.nearestNNeighbours( points.begin(), points.end(), 10, neighbours, numFound );
+		return ( tick_count::now() - t ).seconds();
+	}
+
+	double timeNearestNeighbours( const V3fTree &tree, const std::vector<V3f> &points, int numThreads )
+	{
+		task_scheduler_init scheduler( numThreads );
+
+		std::vector<V3fTree::Iterator> neighbours;
+		std::vector<size_t> offsets;
+
+		tick_count t = tick_count::now();
+		tree.nearestNeighbours( points.begin(), points.end(), 0.2f, neighbours, offsets );
+		return ( tick_count::now() - t ).seconds();
+	}
+
+	double timeInterpolation( const InverseDistanceWeightedInterpolationV3fV3f &interpolation, const std::vector<V3f> &points, int numThreads )
+	{
+		task_scheduler_init scheduler( numThreads );
+
+		std::vector<V3f> result( points.size() );
+
+		tick_count t = tick_count::now();
+		interpolation( points.begin(), points.end(), result.begin() );
+		return ( tick_count::now() - t ).seconds();
+	}
+
+	double timeDensities( ConstV3fVectorDataPtr points, int numThreads )
+	{
+		tick_count t = tick_count::now();
+		densities( points, numThreads );
+		return ( tick_count::now() - t ).seconds();
+	}
+
+	double timeNormals( ConstV3fVectorDataPtr points, int numThreads )
+	{
+		tick_count t = tick_count::now();
+		normals( points, numThreads );
+		return ( tick_count::now() - t ).seconds();
+	}
+
+	void benchmarkParallelism()
+	{
+		V3fVectorDataPtr pointsData = KDTreeFixtures::makePoints( 1000000 );
+		const std::vector<V3f> &points = pointsData->readable();
+
+		V3fTree tree( points.begin(), points.end() );
+		InverseDistanceWeightedInterpolationV3fV3f interpolation( points.begin(), points.end(), points.begin(), points.end(), 10 );
+
+		const char *message = "%s 1M points : 1 thread %fs, all threads %fs";
+		const int automatic = task_scheduler_init::automatic;
+
+		std::cout << format( message ) % "KDTree construction" % timeBuild( points, 1 ) % timeBuild( points, automatic ) << std::endl;
+		std::cout << format( message ) % "KDTree::nearestNNeighbours" % timeNearestNNeighbours( tree, points, 1 ) % timeNearestNNeighbours( tree, points, automatic ) << std::endl;
+		std::cout << format( message ) % "KDTree::nearestNeighbours" % timeNearestNeighbours( tree, points, 1 ) % timeNearestNeighbours( tree, points, automatic ) << std::endl;
+		std::cout << format( message ) % "InverseDistanceWeightedInterpolation" % timeInterpolation( interpolation, points, 1 ) % timeInterpolation( interpolation, points, automatic ) << std::endl;
+		std::cout << format( message ) % "PointDensitiesOp" % timeDensities( pointsData, 1 ) % timeDensities( pointsData, automatic ) << std::endl;
+		std::cout << format( message ) % "PointNormalsOp" % timeNormals( pointsData, 1 ) % timeNormals( pointsData, automatic ) << std::endl;
+	}
+
+};
+
+struct KDTreeBenchmarkSuite : public boost::unit_test::test_suite
+{
+
+	KDTreeBenchmarkSuite() : boost::unit_test::test_suite( "KDTreeBenchmarkSuite" )
+	{
+		boost::shared_ptr<KDTreeBenchmark> instance( new KDTreeBenchmark() );
+
+		add( BOOST_CLASS_TEST_CASE( &KDTreeBenchmark::benchmarkParallelism, instance ) );
+	}
+};
+
+void addKDTreeBenchmark( boost::unit_test::test_suite *test )
+{
+	test->add( new KDTreeBenchmarkSuite() );
+}
+
+} // namespace IECore
@@ -0,0 +1,137 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2014, Image Engine Design Inc. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+//     * Neither the name of Image Engine Design nor the names of any
+//       other contributors to this software may be used to endorse or
+//       promote products derived from this software without specific prior
+//       written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#include <iostream>
+
+#include "boost/format.hpp"
+
+#include "tbb/tbb.h"
+
+#include "IECore/LRUCache.h"
+#include "IECore/SimpleTypedData.h"
+
+#include "LRUCacheBenchmark.h"
+
+using namespace boost;
+using namespace boost::unit_test;
+using namespace tbb;
+
+namespace IECore
+{
+
+struct LRUCacheBenchmark
+{
+
+	template<typename Cache>
+	struct GetFromCache
+	{
+		public :
+
+			GetFromCache( Cache &cache, size_t numKeys )
+				:	m_cache( cache ), m_numKeys( numKeys )
+			{
+			}
+
+			void operator()( const blocked_range<size_t> &r ) const
+			{
+				for( size_t i=r.begin(); i!=r.end(); ++i )
+				{
+					m_cache.get( i % m_numKeys );
+				}
+			}
+
+		private :
+
+			Cache &m_cache;
+			size_t m_numKeys;
+
+	};
+
+	static IntDataPtr get( int key, size_t &cost )
+	{
+		cost = 10;
+		return new IntData( key );
+	}
+
+	// Measures the time taken for lookups which all hit the cache,
+	// which is the case we're most interested in for the SceneCache.
+	template<typename Cache>
+	static double timeCacheHits( Cache &cache, size_t numKeys, int numThreads )
+	{
+		task_scheduler_init scheduler( numThreads );
+
+		GetFromCache<Cache> getter( cache, numKeys );
+		// populate the cache
+		getter( blocked_range<size_t>( 0, numKeys ) );
+
+		tick_count t = tick_count::now();
+		parallel_for( blocked_range<size_t>( 0, numKeys * 1000 ), getter );
+		return ( tick_count::now() - t ).seconds();
+	}
+
+	void benchmarkCacheHits()
+	{
+		const size_t numKeys = 1000;
+
+		for( int numThreads = 1; numThreads <= 64; numThreads *= 2 )
+		{
+			LRUCache<int, IntDataPtr> cache( get, numKeys * 10 );
+			LRUCache<int, IntDataPtr, LRUCachePolicy::SecondChance> secondChanceCache( get, numKeys * 10 );
+
+			double t = timeCacheHits( cache, numKeys, numThreads );
+			double secondChanceT = timeCacheHits( secondChanceCache, numKeys, numThreads );
+
+			std::cout << format( "LRUCache hits with %d threads : Exact %fs, SecondChance %fs" ) % numThreads % t % secondChanceT << std::endl;
+		}
+	}
+
+};
+
+struct LRUCacheBenchmarkSuite : public boost::unit_test::test_suite
+{
+
+	LRUCacheBenchmarkSuite() : boost::unit_test::test_suite( "LRUCacheBenchmarkSuite" )
+	{
+		boost::shared_ptr<LRUCacheBenchmark> instance( new LRUCacheBenchmark() );
+
+		add( BOOST_CLASS_TEST_CASE( &LRUCacheBenchmark::benchmarkCacheHits, instance ) );
+	}
+};
+
+void addLRUCacheBenchmark( boost::unit_test::test_suite *test )
+{
+	test->add( new LRUCacheBenchmarkSuite() );
+}
+
+} // namespace IECore
@@ -0,0 +1,102 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2014, Image Engine Design Inc. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+//     * Neither the name of Image Engine Design nor the names of any
+//       other contributors to this software may be used to endorse or
+//       promote products derived from this software without specific prior
+//       written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#include <iostream>
+
+#include "boost/format.hpp"
+
+#include "tbb/tbb.h"
+
+#include "IECore/PointSmoothSkinningOp.h"
+#include "IECore/PointsPrimitive.h"
+#include "IECore/SmoothSkinningData.h"
+
+#include "PointSmoothSkinningOpFixtures.h"
+#include "PointSmoothSkinningOpBenchmark.h"
+
+using namespace boost;
+using namespace boost::unit_test;
+using namespace tbb;
+using namespace Imath;
+
+namespace IECore
+{
+
+struct PointSmoothSkinningOpBenchmark
+{
+
+	double timeSkinning( unsigned numPoints, unsigned influencesPerPoint, int numThreads )
+	{
+		task_scheduler_init scheduler( numThreads );
+
+		PointsPrimitivePtr points = PointSmoothSkinningOpFixtures::makePoints( numPoints );
+		PointSmoothSkinningOpPtr op = PointSmoothSkinningOpFixtures::makeOp( PointSmoothSkinningOpFixtures::makeSmoothSkinningData( numPoints, influencesPerPoint ), PointSmoothSkinningOpFixtures::makeDeformationPose() );
+		op->inputParameter()->setValue( points );
+
+		tick_count t = tick_count::now();
+		op->operate();
+		return ( tick_count::now() - t ).seconds();
+	}
+
+	void benchmarkSkinning()
+	{
+		const unsigned numPoints = 1000000;
+		const unsigned influenceCounts[] = { 1, 4, 8 };
+		for( unsigned i = 0; i < 3; ++i )
+		{
+			double serial = timeSkinning( numPoints, influenceCounts[i], 1 );
+			double parallel = timeSkinning( numPoints, influenceCounts[i], task_scheduler_init::automatic );
+			std::cout << format( "PointSmoothSkinningOp 1M points, %d influences : 1 thread %fs, all threads %fs" ) % influenceCounts[i] % serial % parallel << std::endl;
+		}
+	}
+
+};
+
+struct PointSmoothSkinningOpBenchmarkSuite : public boost::unit_test::test_suite
+{
+
+	PointSmoothSkinningOpBenchmarkSuite() : boost::unit_test::test_suite( "PointSmoothSkinningOpBenchmarkSuite" )
+	{
+		boost::shared_ptr<PointSmoothSkinningOpBenchmark> instance( new PointSmoothSkinningOpBenchmark() );
+
+		add( BOOST_CLASS_TEST_CASE( &PointSmoothSkinningOpBenchmark::benchmarkSkinning, instance ) );
+	}
+};
+
+void addPointSmoothSkinningOpBenchmark( boost::unit_test::test_suite *test )
+{
+	test->add( new PointSmoothSkinningOpBenchmarkSuite() );
+}
+
+} // namespace IECore
@@ -0,0 +1,160 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2014, Image Engine Design Inc. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+//     * Neither the name of Image Engine Design nor the names of any
+//       other contributors to this software may be used to endorse or
+//       promote products derived from this software without specific prior
+//       written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#include <iostream>
+
+#include "boost/format.hpp"
+#include "boost/filesystem/operations.hpp"
+
+#include "tbb/tbb.h"
+
+#include "IECore/SceneCache.h"
+
+#include "SceneCacheTagIndexBenchmark.h"
+
+using namespace boost;
+using namespace boost::unit_test;
+using namespace tbb;
+
+namespace IECore
+{
+
+struct SceneCacheTagIndexBenchmark
+{
+
+	SceneCacheTagIndexBenchmark() : m_fileName( "test/IECore/sceneCacheTagIndexBenchmark.scc" )
+	{
+	}
+
+	~SceneCacheTagIndexBenchmark()
+	{
+		boost::filesystem::remove( m_fileName );
+	}
+
+	// Writes a three level hierarchy of 50 x 100 x 100 locations, where
+	// every group is tagged "group", every 10000th leaf is tagged "rare"
+	// and the first leaf of each group is tagged "first".
+	void writeScene()
+	{
+		SceneCachePtr root = new SceneCache( m_fileName, IndexedIO::Write );
+		SceneInterface::NameList groupTag( 1, "group" );
+		SceneInterface::NameList rareTag( 1, "rare" );
+		SceneInterface::NameList firstTag( 1, "first" );
+
+		size_t leafIndex = 0;
+		for ( int i = 0; i < 50; i++ )
+		{
+			SceneInterfacePtr a = root->createChild( str( format( "a%d" ) % i ) );
+			a->writeTags( groupTag );
+			for ( int j = 0; j < 100; j++ )
+			{
+				SceneInterfacePtr b = a->createChild( str( format( "b%d" ) % j ) );
+				b->writeTags( groupTag );
+				for ( int k = 0; k < 100; k++, leafIndex++ )
+				{
+					SceneInterfacePtr c = b->createChild( str( format( "c%d" ) % k ) );
+					if ( leafIndex % 10000 == 0 )
+					{
+						c->writeTags( rareTag );
+					}
+					if ( k == 0 )
+					{
+						c->writeTags( firstTag );
+					}
+				}
+			}
+		}
+	}
+
+	void timeTag( const SceneInterface *scene, const SceneInterface::Name &tag )
+	{
+		std::vector<SceneInterface::Path> paths;
+		tick_count t = tick_count::now();
+		scene->taggedPaths( tag, paths );
+		double indexTime = ( tick_count::now() - t ).seconds();
+
+		// The base class implementation is the walk pruned by
+		// DescendantTag, which files without an index fall back to.
+		t = tick_count::now();
+		scene->SceneInterface::taggedPaths( tag, paths );
+		double walkTime = ( tick_count::now() - t ).seconds();
+
+		SceneInterface::Path path;
+		scene->path( path );
+		std::string pathString;
+		SceneInterface::pathToString( path, pathString );
+		std::cout << format( "SceneCache taggedPaths( \"%s\" ) from \"%s\", %d paths : index %fs, walk %fs" ) % tag.value() % pathString % paths.size() % indexTime % walkTime << std::endl;
+	}
+
+	void benchmarkTaggedPaths()
+	{
+		writeScene();
+
+		// Each timing opens the file afresh, so that neither method
+		// benefits from locations cached by the other.
+		const char *tags[] = { "rare", "first", "group" };
+		for ( size_t i = 0; i < sizeof( tags ) / sizeof( const char * ); i++ )
+		{
+			ConstSceneInterfacePtr root = new SceneCache( m_fileName, IndexedIO::Read );
+			timeTag( root.get(), tags[i] );
+		}
+
+		for ( size_t i = 0; i < sizeof( tags ) / sizeof( const char * ); i++ )
+		{
+			ConstSceneInterfacePtr root = new SceneCache( m_fileName, IndexedIO::Read );
+			timeTag( root->child( "a3" ).get(), tags[i] );
+		}
+	}
+
+	std::string m_fileName;
+
+};
+
+struct SceneCacheTagIndexBenchmarkSuite : public boost::unit_test::test_suite
+{
+
+	SceneCacheTagIndexBenchmarkSuite() : boost::unit_test::test_suite( "SceneCacheTagIndexBenchmarkSuite" )
+	{
+		boost::shared_ptr<SceneCacheTagIndexBenchmark> instance( new SceneCacheTagIndexBenchmark() );
+
+		add( BOOST_CLASS_TEST_CASE( &SceneCacheTagIndexBenchmark::benchmarkTaggedPaths, instance ) );
+	}
+};
+
+void addSceneCacheTagIndexBenchmark( boost::unit_test::test_suite *test )
+{
+	test->add( new SceneCacheTagIndexBenchmarkSuite() );
+}
+
+} // namespace IECore
@@ -0,0 +1,179 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2014, Image Engine Design Inc. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+//     * Neither the name of Image Engine Design nor the names of any
+//       other contributors to this software may be used to endorse or
+//       promote products derived from this software without specific prior
+//       written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#include <iostream>
+
+#include "boost/format.hpp"
+
+#include "tbb/tbb.h"
+
+#include "OpenEXR/ImathBox.h"
+#include "OpenEXR/ImathRandom.h"
+
+#include "IECore/SweepAndPrune.h"
+
+#include "SweepAndPruneBenchmark.h"
+
+using namespace boost;
+using namespace boost::unit_test;
+using namespace tbb;
+using namespace Imath;
+
+namespace IECore
+{
+
+struct SweepAndPruneBenchmark
+{
+
+	typedef std::vector<Box3f>::const_iterator BoundIterator;
+
+	template<typename Iterator>
+	struct CountingCallback
+	{
+		CountingCallback() : numPairs( 0 )
+		{
+		}
+
+		void operator()( Iterator b1, Iterator b2 )
+		{
+			numPairs++;
+		}
+
+		size_t numPairs;
+	};
+
+	typedef SweepAndPrune<BoundIterator, CountingCallback> SAP;
+
+	/// A crowd of agents of roughly unit size, each given a random
+	/// velocity which is used to animate them from frame to frame.
+	struct Crowd
+	{
+
+		Crowd( unsigned numAgents, float worldSize )
+		{
+			Rand32 rand( 1 );
+			for( unsigned i = 0; i < numAgents; ++i )
+			{
+				V3f p( rand.nextf( 0, worldSize ), rand.nextf( 0, worldSize * 0.1f ), rand.nextf( 0, worldSize ) );
+				bounds.push_back( Box3f( p, p + V3f( rand.nextf( 0.5, 1 ), rand.nextf( 1.5, 2 ), rand.nextf( 0.5, 1 ) ) ) );
+				velocities.push_back( V3f( rand.nextf( -0.1, 0.1 ), 0, rand.nextf( -0.1, 0.1 ) ) );
+			}
+		}
+
+		void step()
+		{
+			for( size_t i = 0, e = bounds.size(); i < e; ++i )
+			{
+				bounds[i].min += velocities[i];
+				bounds[i].max += velocities[i];
+			}
+		}
+
+		std::vector<Box3f> bounds;
+		std::vector<V3f> velocities;
+
+	};
+
+	double timeFrames( bool incremental, unsigned numFrames, int numThreads, size_t &numPairs )
+	{
+		task_scheduler_init scheduler( numThreads );
+
+		Crowd crowd( 100000, 1000.0f );
+		SAP sap;
+		numPairs = 0;
+
+		double result = 0;
+		for( unsigned i = 0; i < numFrames; ++i )
+		{
+			SAP::Callback cb;
+
+			tick_count t = tick_count::now();
+			if( incremental )
+			{
+				sap.incrementalIntersectingBounds( crowd.bounds.begin(), crowd.bounds.end(), cb );
+			}
+			else
+			{
+				sap.intersectingBounds( crowd.bounds.begin(), crowd.bounds.end(), cb );
+			}
+			result += ( tick_count::now() - t ).seconds();
+
+			numPairs += cb.numPairs;
+			crowd.step();
+		}
+
+		return result;
+	}
+
+	void benchmarkCrowd()
+	{
+		const char *message = "SweepAndPrune %s 100K bounds, %d frames : 1 thread %fs, all threads %fs";
+		const int automatic = task_scheduler_init::automatic;
+		const unsigned numFrames = 50;
+
+		size_t serialPairs = 0, parallelPairs = 0, incrementalPairs = 0, parallelIncrementalPairs = 0;
+
+		const double serial = timeFrames( false, numFrames, 1, serialPairs );
+		const double parallel = timeFrames( false, numFrames, automatic, parallelPairs );
+		std::cout << format( message ) % "intersectingBounds" % numFrames % serial % parallel << std::endl;
+
+		const double serialIncremental = timeFrames( true, numFrames, 1, incrementalPairs );
+		const double parallelIncremental = timeFrames( true, numFrames, automatic, parallelIncrementalPairs );
+		std::cout << format( message ) % "incrementalIntersectingBounds" % numFrames % serialIncremental % parallelIncremental << std::endl;
+
+		BOOST_CHECK( serialPairs > 0 );
+		BOOST_CHECK_EQUAL( serialPairs, parallelPairs );
+		BOOST_CHECK_EQUAL( serialPairs, incrementalPairs );
+		BOOST_CHECK_EQUAL( serialPairs, parallelIncrementalPairs );
+	}
+
+};
+
+struct SweepAndPruneBenchmarkSuite : public boost::unit_test::test_suite
+{
+
+	SweepAndPruneBenchmarkSuite() : boost::unit_test::test_suite( "SweepAndPruneBenchmarkSuite" )
+	{
+		boost::shared_ptr<SweepAndPruneBenchmark> instance( new SweepAndPruneBenchmark() );
+
+		add( BOOST_CLASS_TEST_CASE( &SweepAndPruneBenchmark::benchmarkCrowd, instance ) );
+	}
+};
+
+void addSweepAndPruneBenchmark( boost::unit_test::test_suite *test )
+{
+	test->add( new SweepAndPruneBenchmarkSuite() );
+}
+
+} // namespace IECore
@@ -0,0 +1,107 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2014, Image Engine Design Inc. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+//     * Neither the name of Image Engine Design nor the names of any
+//       other contributors to this software may be used to endorse or
+//       promote products derived from this software without specific prior
+//       written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#include <iostream>
+
+#include "boost/format.hpp"
+
+#include "tbb/tbb.h"
+
+#include "IECore/MeshPrimitiveEvaluator.h"
+
+#include "TriangleBVHFixtures.h"
+#include "TriangleBVHBenchmark.h"
+
+using namespace boost;
+using namespace boost::unit_test;
+using namespace tbb;
+using namespace Imath;
+
+namespace IECore
+{
+
+struct TriangleBVHBenchmark
+{
+
+	double timeIntersections( const MeshPrimitiveEvaluator *evaluator, const std::vector<V3f> &origins, const std::vector<V3f> &directions )
+	{
+		std::vector<int> triangleIndices;
+		std::vector<V3f> barycentrics;
+
+		tick_count t = tick_count::now();
+		evaluator->nearestIntersections( origins, directions, triangleIndices, barycentrics );
+		return ( tick_count::now() - t ).seconds();
+	}
+
+	void benchmarkIntersections()
+	{
+		MeshPrimitivePtr mesh = TriangleBVHFixtures::makeMesh( 500000 );
+
+		tick_count t = tick_count::now();
+		MeshPrimitiveEvaluatorPtr kdEvaluator = new MeshPrimitiveEvaluator( mesh, MeshPrimitiveEvaluator::KDTreeAccelerator );
+		double kdBuild = ( tick_count::now() - t ).seconds();
+
+		t = tick_count::now();
+		MeshPrimitiveEvaluatorPtr bvhEvaluator = new MeshPrimitiveEvaluator( mesh, MeshPrimitiveEvaluator::BVHAccelerator );
+		double bvhBuild = ( tick_count::now() - t ).seconds();
+
+		std::vector<V3f> origins, directions;
+		TriangleBVHFixtures::makeRays( 1000000, origins, directions );
+
+		double kdQuery = timeIntersections( kdEvaluator.get(), origins, directions );
+		double bvhQuery = timeIntersections( bvhEvaluator.get(), origins, directions );
+
+		std::cout << format( "MeshPrimitiveEvaluator build : KDTree %fs, BVH %fs" ) % kdBuild % bvhBuild << std::endl;
+		std::cout << format( "MeshPrimitiveEvaluator 1M ray intersections : KDTree %fs, BVH %fs" ) % kdQuery % bvhQuery << std::endl;
+	}
+
+};
+
+struct TriangleBVHBenchmarkSuite : public boost::unit_test::test_suite
+{
+
+	TriangleBVHBenchmarkSuite() : boost::unit_test::test_suite( "TriangleBVHBenchmarkSuite" )
+	{
+		boost::shared_ptr<TriangleBVHBenchmark> instance( new TriangleBVHBenchmark() );
+
+		add( BOOST_CLASS_TEST_CASE( &TriangleBVHBenchmark::benchmarkIntersections, instance ) );
+	}
+};
+
+void addTriangleBVHBenchmark( boost::unit_test::test_suite *test )
+{
+	test->add( new TriangleBVHBenchmarkSuite() );
+}
+
+} // namespace IECore
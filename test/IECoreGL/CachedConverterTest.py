@@ -34,6 +34,7 @@
 
 import unittest
 import threading
+import time
 
 import IECore
 import IECoreGL
@@ -169,6 +170,86 @@ class CachedConverterTest( unittest.TestCase ) :
 			
 			# do the deferred removals now we're back on the main thread
 			c.clearUnused()
-		
+
+	def testConvertAsync( self ) :
+
+		c = IECoreGL.CachedConverter( 500 * 1024 * 1024 ) # 500 megs
+
+		m = IECore.MeshPrimitive.createPlane( IECore.Box2f( IECore.V2f( -1 ), IECore.V2f( 1 ) ) )
+		dataWindow = IECore.Box2i( IECore.V2i( 0 ), IECore.V2i( 15 ) )
+		i = IECore.ImagePrimitive.createRGBFloat( IECore.Color3f( 1, 0.5, 0.25 ), dataWindow, dataWindow )
+
+		# nothing is available until the conversions have been processed,
+		# and scheduling the same object twice is harmless.
+		self.assertEqual( c.convertAsync( m ), None )
+		self.assertEqual( c.convertAsync( m ), None )
+		self.assertEqual( c.convertAsync( i ), None )
+
+		while c.processPendingConversions( 0.01 ) :
+			pass
+
+		gm = c.convertAsync( m )
+		self.failUnless( isinstance( gm, IECoreGL.MeshPrimitive ) )
+		self.failUnless( gm.isSame( c.convert( m ) ) )
+
+		gi = c.convertAsync( i )
+		self.failUnless( isinstance( gi, IECoreGL.Texture ) )
+		self.failUnless( gi.isSame( c.convert( i ) ) )
+
+		self.assertRaises( RuntimeError, c.convertAsync, IECore.StringData( "noConverter" ) )
+
+	def testConvertAsyncUploadsBuffers( self ) :
+
+		c = IECoreGL.CachedConverter( 500 * 1024 * 1024 ) # 500 megs
+
+		m = IECore.MeshPrimitive.createPlane( IECore.Box2f( IECore.V2f( -1 ), IECore.V2f( 1 ) ), IECore.V2i( 10 ) )
+		self.assertEqual( c.convertAsync( m ), None )
+		while c.processPendingConversions( 0.01 ) :
+			pass
+
+		gm = c.convertAsync( m )
+		self.failUnless( isinstance( gm, IECoreGL.MeshPrimitive ) )
+
+		# the buffers needed to draw the mesh should have been created by
+		# processPendingConversions(), rather than being left for the first draw.
+		defaultConverter = IECoreGL.CachedConverter.defaultCachedConverter()
+		for data in ( gm.vertexAttribute( "P" ), gm.vertexIds() ) :
+			self.failUnless( isinstance( defaultConverter.convertAsync( data ), IECoreGL.Buffer ) )
+
+	def testConvertAsyncRetriesFailures( self ) :
+
+		c = IECoreGL.CachedConverter( 500 * 1024 * 1024 ) # 500 megs
+
+		# no "P", so the conversion will fail
+		m = IECore.MeshPrimitive( IECore.IntVectorData( [ 3 ] ), IECore.IntVectorData( [ 0, 1, 2 ] ) )
+
+		with IECore.CapturingMessageHandler() as mh :
+			self.assertEqual( c.convertAsync( m ), None )
+			while c.processPendingConversions( 0.01 ) :
+				pass
+		self.assertEqual( len( mh.messages ), 1 )
+		self.assertEqual( mh.messages[0].level, IECore.Msg.Level.Error )
+
+		# the failure isn't retried immediately
+		with IECore.CapturingMessageHandler() as mh :
+			self.assertEqual( c.convertAsync( m ), None )
+			self.assertEqual( c.processPendingConversions( 0.01 ), 0 )
+		self.assertEqual( len( mh.messages ), 0 )
+
+		# but is once the retry interval has elapsed
+		time.sleep( 1.1 )
+		with IECore.CapturingMessageHandler() as mh :
+			self.assertEqual( c.convertAsync( m ), None )
+			while c.processPendingConversions( 0.01 ) :
+				pass
+		self.assertEqual( len( mh.messages ), 1 )
+
+		# and the interval has doubled after the second failure
+		time.sleep( 1.1 )
+		with IECore.CapturingMessageHandler() as mh :
+			self.assertEqual( c.convertAsync( m ), None )
+			self.assertEqual( c.processPendingConversions( 0.01 ), 0 )
+		self.assertEqual( len( mh.messages ), 0 )
+
 if __name__ == "__main__":
     unittest.main()
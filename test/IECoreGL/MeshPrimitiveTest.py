@@ -227,6 +227,113 @@ class MeshPrimitiveTest( unittest.TestCase ) :
 		self.assertEqual( r.floatPrimVar( image["G"] ), 0 )
 		self.assertEqual( r.floatPrimVar( image["B"] ), 1 )
 		 
+	def __render( self, mesh, fileName, fragmentSource ) :
+
+		r = IECoreGL.Renderer()
+		r.setOption( "gl:mode", IECore.StringData( "immediate" ) )
+
+		r.camera( "main", {
+				"projection" : IECore.StringData( "orthographic" ),
+				"resolution" : IECore.V2iData( IECore.V2i( 256 ) ),
+				"clippingPlanes" : IECore.V2fData( IECore.V2f( 1, 1000 ) ),
+				"screenWindow" : IECore.Box2fData( IECore.Box2f( IECore.V2f( -1 ), IECore.V2f( 1 ) ) )
+			}
+		)
+		r.display( fileName, "tif", "rgba", {} )
+
+		with IECore.WorldBlock( r ) :
+
+			r.concatTransform( IECore.M44f.createTranslated( IECore.V3f( 0, 0, -15 ) ) )
+			r.shader( "surface", "test", { "gl:fragmentSource" : IECore.StringData( fragmentSource ) } )
+			mesh.render( r )
+
+		return IECore.Reader.create( fileName ).read()
+
+	def __expanded( self, mesh ) :
+
+		# the form the ToGLMeshConverter used to draw, with every triangle corner
+		# having its own values.
+		mesh = mesh.copy()
+		if "N" not in mesh :
+			IECore.MeshNormalsOp()( input = mesh, copyInput = False, interpolation = int( IECore.PrimitiveVariable.Interpolation.Uniform ) )
+		IECore.TriangulateOp()( input = mesh, copyInput = False, throwExceptions = False )
+		IECore.FaceVaryingPromotionOp()( input = mesh, copyInput = False )
+		return mesh
+
+	def testIndexedRenderingMatchesExpanded( self ) :
+
+		# meshes are drawn with vertices shared between faces where possible,
+		# which must look just the same as drawing each triangle corner separately.
+
+		stSource = """
+		#include "IECoreGL/FragmentShader.h"
+
+		IECOREGL_FRAGMENTSHADER_IN vec2 fragmentst;
+
+		void main()
+		{
+			gl_FragColor = vec4( fragmentst.x, fragmentst.y, 0.0, 1.0 );
+		}
+		"""
+
+		csSource = """
+		#include "IECoreGL/FragmentShader.h"
+
+		IECOREGL_FRAGMENTSHADER_IN vec3 fragmentCs;
+
+		void main()
+		{
+			gl_FragColor = vec4( fragmentCs, 1.0 );
+		}
+		"""
+
+		nSource = """
+		#include "IECoreGL/FragmentShader.h"
+
+		IECOREGL_FRAGMENTSHADER_IN vec3 fragmentN;
+
+		void main()
+		{
+			gl_FragColor = vec4( fragmentN, 1.0 );
+		}
+		"""
+
+		# FaceVarying st with seams
+		sphere = IECore.Reader.create( "test/IECore/data/cobFiles/pSphereShape1.cob" ).read()
+
+		# Uniform Cs
+		plane = IECore.MeshPrimitive.createPlane( IECore.Box2f( IECore.V2f( -1 ), IECore.V2f( 1 ) ), IECore.V2i( 2 ) )
+		plane["Cs"] = IECore.PrimitiveVariable(
+			IECore.PrimitiveVariable.Interpolation.Uniform,
+			IECore.Color3fVectorData( [
+				IECore.Color3f( 1, 0, 0 ),
+				IECore.Color3f( 0, 1, 0 ),
+				IECore.Color3f( 0, 0, 1 ),
+				IECore.Color3f( 1, 1, 1, ),
+			] )
+		)
+
+		# Vertex Cs
+		vertexPlane = IECore.MeshPrimitive.createPlane( IECore.Box2f( IECore.V2f( -1 ), IECore.V2f( 1 ) ), IECore.V2i( 10 ) )
+		vertexPlane["Cs"] = IECore.PrimitiveVariable(
+			IECore.PrimitiveVariable.Interpolation.Vertex,
+			IECore.Color3fVectorData( [ IECore.Color3f( p.x * 0.5 + 0.5, p.y * 0.5 + 0.5, 0 ) for p in vertexPlane["P"].data ] )
+		)
+
+		# generated face normals
+		facetedSphere = IECore.MeshPrimitive.createSphere( 0.9 )
+
+		for mesh, fragmentSource in (
+			( sphere, stSource ),
+			( plane, csSource ),
+			( vertexPlane, csSource ),
+			( facetedSphere, nSource ),
+		) :
+
+			indexedImage = self.__render( mesh, self.outputFileName, fragmentSource )
+			expandedImage = self.__render( self.__expanded( mesh ), os.path.dirname( __file__ ) + "/output/testMeshExpanded.tif", fragmentSource )
+			self.assertEqual( IECore.ImageDiffOp()( imageA = indexedImage, imageB = expandedImage, maxError = 0.01 ).value, False )
+
 	def setUp( self ) :
 		
 		if not os.path.isdir( "test/IECoreGL/output" ) :
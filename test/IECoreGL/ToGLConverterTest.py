@@ -150,5 +150,121 @@ class ToGLConverterTest( unittest.TestCase ) :
 		c = IECoreGL.ToGLConverter.create( compoundData )
 		self.failUnless( isinstance( c, IECoreGL.ToGLTextureConverter ) )
 
+	def __cornerValues( self, glMesh, name ) :
+
+		# the value of a vertex attribute at each triangle corner
+		data = glMesh.vertexAttribute( name )
+		return [ data[i] for i in glMesh.vertexIds() ]
+
+	def __oldCornerValues( self, mesh, name ) :
+
+		# the values the converter used to output before it shared vertices, when it
+		# triangulated the mesh and promoted everything to FaceVarying
+		mesh = mesh.copy()
+		if "N" not in mesh :
+			interpolation = IECore.PrimitiveVariable.Interpolation.Uniform if mesh.interpolation == "linear" else IECore.PrimitiveVariable.Interpolation.Vertex
+			IECore.MeshNormalsOp()( input = mesh, copyInput = False, interpolation = int( interpolation ) )
+		IECore.TriangulateOp()( input = mesh, copyInput = False, throwExceptions = False )
+		IECore.FaceVaryingPromotionOp()( input = mesh, copyInput = False )
+		return list( mesh[name].data )
+
+	def __assertMatchesOldConversion( self, mesh, glMesh, names ) :
+
+		for name in names :
+			values = self.__cornerValues( glMesh, name )
+			oldValues = self.__oldCornerValues( mesh, name )
+			self.assertEqual( len( values ), len( oldValues ) )
+			for value, oldValue in zip( values, oldValues ) :
+				if isinstance( value, float ) :
+					self.assertAlmostEqual( value, oldValue, 5 )
+				else :
+					self.failUnless( value.equalWithAbsError( oldValue, 1e-5 ) )
+
+	def testMeshSharesVertices( self ) :
+
+		m = IECore.MeshPrimitive.createPlane( IECore.Box2f( IECore.V2f( -1 ), IECore.V2f( 1 ) ), IECore.V2i( 10 ) )
+		IECore.MeshNormalsOp()( input = m, copyInput = False )
+		m["Cs"] = IECore.PrimitiveVariable(
+			IECore.PrimitiveVariable.Interpolation.Vertex,
+			IECore.Color3fVectorData( [ IECore.Color3f( p.x, p.y, 0 ) for p in m["P"].data ] )
+		)
+
+		glMesh = IECoreGL.ToGLMeshConverter( m ).convert()
+
+		# everything is Vertex interpolated, or FaceVarying with the same value for each
+		# face around a vertex, so there's one GL vertex per mesh vertex, rather than
+		# one per triangle corner as there used to be.
+		numVertices = m.variableSize( IECore.PrimitiveVariable.Interpolation.Vertex )
+		self.assertEqual( len( glMesh.vertexIds() ), 10 * 10 * 6 )
+		for name in ( "P", "N", "Cs", "s", "t" ) :
+			self.assertEqual( len( glMesh.vertexAttribute( name ) ), numVertices )
+		self.assertEqual( glMesh.vertexAttribute( "P" ), m["P"].data )
+
+		self.__assertMatchesOldConversion( m, glMesh, ( "P", "N", "Cs", "s", "t" ) )
+
+	def testMeshSplitsVerticesAtFaceVaryingSeams( self ) :
+
+		m = IECore.MeshPrimitive.createPlane( IECore.Box2f( IECore.V2f( -1 ), IECore.V2f( 1 ) ), IECore.V2i( 2, 1 ) )
+		IECore.MeshNormalsOp()( input = m, copyInput = False )
+
+		# make a seam along the edge between the two faces
+		self.assertEqual( m.verticesPerFace, IECore.IntVectorData( [ 4, 4 ] ) )
+		m["s"] = IECore.PrimitiveVariable(
+			IECore.PrimitiveVariable.Interpolation.FaceVarying,
+			IECore.FloatVectorData( [ s + 1 if i >= 4 else s for i, s in enumerate( m["s"].data ) ] )
+		)
+
+		glMesh = IECoreGL.ToGLMeshConverter( m ).convert()
+
+		# the two vertices on the seam are split
+		self.assertEqual( m.variableSize( IECore.PrimitiveVariable.Interpolation.Vertex ), 6 )
+		self.assertEqual( len( glMesh.vertexAttribute( "P" ) ), 8 )
+		self.assertEqual( len( glMesh.vertexIds() ), 12 )
+
+		self.__assertMatchesOldConversion( m, glMesh, ( "P", "N", "s", "t" ) )
+
+	def testMeshSplitsVerticesForUniformValues( self ) :
+
+		m = IECore.MeshPrimitive.createPlane( IECore.Box2f( IECore.V2f( -1 ), IECore.V2f( 1 ) ), IECore.V2i( 2 ) )
+		IECore.MeshNormalsOp()( input = m, copyInput = False )
+		m["Cs"] = IECore.PrimitiveVariable(
+			IECore.PrimitiveVariable.Interpolation.Uniform,
+			IECore.Color3fVectorData( [
+				IECore.Color3f( 1, 0, 0 ),
+				IECore.Color3f( 0, 1, 0 ),
+				IECore.Color3f( 0, 0, 1 ),
+				IECore.Color3f( 1, 1, 1, ),
+			] )
+		)
+
+		glMesh = IECoreGL.ToGLMeshConverter( m ).convert()
+
+		# each face gets its own vertices, but that's still fewer
+		# than the 24 triangle corners the old conversion output
+		self.assertEqual( m.variableSize( IECore.PrimitiveVariable.Interpolation.Vertex ), 9 )
+		self.assertEqual( len( glMesh.vertexAttribute( "Cs" ) ), 16 )
+		self.assertEqual( len( glMesh.vertexIds() ), 24 )
+
+		self.__assertMatchesOldConversion( m, glMesh, ( "P", "N", "Cs", "s", "t" ) )
+
+	def testMeshFaceNormals( self ) :
+
+		# without normals, a polygon mesh gets Uniform normals, so the vertices are split
+		# between faces, and a subdivision mesh gets smooth Vertex normals, so they're not.
+
+		m = IECore.Reader.create( "test/IECore/data/cobFiles/pSphereShape1.cob" ).read()
+		if "N" in m :
+			del m["N"]
+		m.interpolation = "linear"
+		glMesh = IECoreGL.ToGLMeshConverter( m ).convert()
+		self.failUnless( len( glMesh.vertexAttribute( "P" ) ) > m.variableSize( IECore.PrimitiveVariable.Interpolation.Vertex ) )
+		self.failUnless( len( glMesh.vertexAttribute( "P" ) ) < len( glMesh.vertexIds() ) )
+		self.__assertMatchesOldConversion( m, glMesh, ( "P", "N" ) )
+
+		m.interpolation = "catmullClark"
+		glMesh = IECoreGL.ToGLMeshConverter( m ).convert()
+		self.failUnless( len( glMesh.vertexAttribute( "P" ) ) < len( glMesh.vertexIds() ) )
+		self.__assertMatchesOldConversion( m, glMesh, ( "P", "N" ) )
+
 if __name__ == "__main__":
     unittest.main()